@@ -19,21 +19,30 @@ struct ThreadSafeContext;
 
 namespace JS {
 
+/*
+ * A single Latin-1 code unit. Latin-1 text is stored one byte per character
+ * and widens losslessly to jschar by zero extension.
+ */
+typedef unsigned char Latin1Char;
+
 /*
  * By default, all C/C++ 1-byte-per-character strings passed into the JSAPI
  * are treated as ISO/IEC 8859-1, also known as Latin-1. That is, each
  * byte is treated as a 2-byte character, and there is no way to pass in a
  * string containing characters beyond U+00FF.
  */
-class Latin1Chars : public mozilla::Range<unsigned char>
+class Latin1Chars : public mozilla::Range<Latin1Char>
 {
-    typedef mozilla::Range<unsigned char> Base;
+    typedef mozilla::Range<Latin1Char> Base;
 
   public:
     Latin1Chars() : Base() {}
-    Latin1Chars(char *aBytes, size_t aLength) : Base(reinterpret_cast<unsigned char *>(aBytes), aLength) {}
+    Latin1Chars(char *aBytes, size_t aLength) : Base(reinterpret_cast<Latin1Char *>(aBytes), aLength) {}
     Latin1Chars(const char *aBytes, size_t aLength)
-      : Base(reinterpret_cast<unsigned char *>(const_cast<char *>(aBytes)), aLength)
+      : Base(reinterpret_cast<Latin1Char *>(const_cast<char *>(aBytes)), aLength)
+    {}
+    Latin1Chars(const Latin1Char *aChars, size_t aLength)
+      : Base(const_cast<Latin1Char *>(aChars), aLength)
     {}
 };
 
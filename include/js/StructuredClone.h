@@ -55,13 +55,32 @@ typedef void (*StructuredCloneErrorOp)(JSContext *cx, uint32_t errorid);
 // they are never saved to persistent storage.
 #define JS_STRUCTURED_CLONE_VERSION 2
 
+namespace JS {
+
+// Where a clone buffer may be read. By default all of the data is held in the
+// buffer itself, so it can be stored, copied or sent to another process.
+//
+// A buffer written for SameProcessCloneScope instead keeps the contents of
+// large ArrayBuffers and the chars of long strings in separate allocations,
+// which are listed in the buffer's transfer map and adopted when it is read.
+// Writing then costs one flat copy of those payloads and reading none. Such
+// a buffer holds pointers: it must not leave the process, and, like a buffer
+// with transferables, it can be read only once.
+enum StructuredCloneScope {
+    AnyProcessCloneScope,
+    SameProcessCloneScope
+};
+
+} /* namespace JS */
+
 struct JSStructuredCloneCallbacks {
     ReadStructuredCloneOp read;
     WriteStructuredCloneOp write;
     StructuredCloneErrorOp reportError;
 };
 
-// Note: if the *data contains transferable objects, it can be read only once.
+// Note: if the *data contains transferable objects or was written for
+// SameProcessCloneScope, it can be read only once.
 JS_PUBLIC_API(bool)
 JS_ReadStructuredClone(JSContext *cx, uint64_t *data, size_t nbytes, uint32_t version,
                        JS::MutableHandleValue vp,
@@ -72,7 +91,8 @@ JS_ReadStructuredClone(JSContext *cx, uint64_t *data, size_t nbytes, uint32_t ve
 JS_PUBLIC_API(bool)
 JS_WriteStructuredClone(JSContext *cx, JS::HandleValue v, uint64_t **datap, size_t *nbytesp,
                         const JSStructuredCloneCallbacks *optionalCallbacks,
-                        void *closure, JS::HandleValue transferable);
+                        void *closure, JS::HandleValue transferable,
+                        JS::StructuredCloneScope scope = JS::AnyProcessCloneScope);
 
 JS_PUBLIC_API(bool)
 JS_ClearStructuredClone(const uint64_t *data, size_t nbytes);
@@ -121,7 +141,8 @@ class JS_PUBLIC_API(JSAutoStructuredCloneBuffer) {
                const JSStructuredCloneCallbacks *optionalCallbacks=nullptr, void *closure=nullptr);
 
     bool write(JSContext *cx, JS::HandleValue v, JS::HandleValue transferable,
-               const JSStructuredCloneCallbacks *optionalCallbacks=nullptr, void *closure=nullptr);
+               const JSStructuredCloneCallbacks *optionalCallbacks=nullptr, void *closure=nullptr,
+               JS::StructuredCloneScope scope=JS::AnyProcessCloneScope);
 
     // Swap ownership with another JSAutoStructuredCloneBuffer.
     void swap(JSAutoStructuredCloneBuffer &other);
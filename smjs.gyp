@@ -417,6 +417,7 @@
 
       'sources': [
         'src/js/assembler/jit/ExecutableAllocator.cpp',
+        'src/js/builtin/AtomicsObject.cpp',
         'src/js/builtin/Eval.cpp',
         'src/js/builtin/Intl.cpp',
         'src/js/builtin/MapObject.cpp',
@@ -442,6 +443,7 @@
         'src/js/gc/Marking.cpp',
         'src/js/gc/Memory.cpp',
         'src/js/gc/Nursery.cpp',
+        'src/js/gc/ParallelMarking.cpp',
         'src/js/gc/RootMarking.cpp',
         'src/js/gc/Statistics.cpp',
         'src/js/gc/StoreBuffer.cpp',
@@ -486,8 +488,10 @@
         'src/js/perf/jsperf.cpp',
         'src/js/prmjtime.cpp',
         'src/js/vm/ArgumentsObject.cpp',
+        'src/js/vm/BytecodeCache.cpp',
         'src/js/vm/CallNonGenericMethod.cpp',
         'src/js/vm/CharacterEncoding.cpp',
+        'src/js/vm/Compression.cpp',
         'src/js/vm/DateTime.cpp',
         'src/js/vm/Debugger.cpp',
         'src/js/vm/ErrorObject.cpp',
@@ -506,9 +510,11 @@
         'src/js/vm/RegExpStatics.cpp',
         'src/js/vm/Runtime.cpp',
         'src/js/vm/SPSProfiler.cpp',
+        'src/js/vm/SamplingProfiler.cpp',
         'src/js/vm/ScopeObject.cpp',
         'src/js/vm/SelfHosting.cpp',
         'src/js/vm/Shape.cpp',
+        'src/js/vm/SharedArrayObject.cpp',
         'src/js/vm/Stack.cpp',
         'src/js/vm/String.cpp',
         'src/js/vm/StringBuffer.cpp',
@@ -20,6 +20,8 @@
 // by the headers included above.
 namespace JS {
 
+typedef unsigned char Latin1Char;
+
 class Latin1CharsZ;
 class StableCharPtr;
 class TwoByteChars;
@@ -61,6 +63,7 @@ using JS::UndefinedValue;
 
 using JS::IsPoisonedPtr;
 
+using JS::Latin1Char;
 using JS::Latin1CharsZ;
 using JS::StableCharPtr;
 using JS::TwoByteChars;
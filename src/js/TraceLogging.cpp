@@ -89,7 +89,7 @@ const char* const TraceLogging::typeName[] = {
     "e,b",  // engine baseline
     "e,o"   // engine ionmonkey
 };
-TraceLogging* TraceLogging::loggers[] = {nullptr, nullptr, nullptr};
+TraceLogging* TraceLogging::loggers[LAST_LOGGER] = {};
 bool TraceLogging::atexitSet = false;
 uint64_t TraceLogging::startupTime = 0;
 
@@ -206,6 +206,14 @@ TraceLogging::flush()
             out = fopen(TRACE_LOG_DIR "tracelogging-gc.log", "w");
             break;
           default:
+            if (id > ION_BACKGROUND_COMPILER && id <= ION_BACKGROUND_COMPILER_LAST) {
+                char filename[64];
+                snprintf(filename, sizeof(filename),
+                         TRACE_LOG_DIR "tracelogging-compile-%d.log",
+                         int(id - ION_BACKGROUND_COMPILER));
+                out = fopen(filename, "w");
+                break;
+            }
             MOZ_ASSUME_UNREACHABLE("Bad trigger");
             return;
         }
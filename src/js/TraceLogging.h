@@ -52,11 +52,18 @@ class TraceLogging
     };
     enum Logger {
         DEFAULT,
+
+        // Off thread Ion compilations may run concurrently, and each one in
+        // progress logs to a separate logger in this range.
         ION_BACKGROUND_COMPILER,
+        ION_BACKGROUND_COMPILER_LAST = ION_BACKGROUND_COMPILER + 7,
+
         GC_BACKGROUND,
 
         LAST_LOGGER
     };
+    static const size_t NUM_ION_COMPILER_LOGGERS =
+        ION_BACKGROUND_COMPILER_LAST - ION_BACKGROUND_COMPILER + 1;
 
   private:
     struct Entry {
@@ -214,6 +214,12 @@ public:
         return m_size;
     }
 
+    // Offset of the (possibly null) code address, for jitcode that calls the
+    // referenced code directly.
+    static size_t offsetOfCode() {
+        return offsetof(MacroAssemblerCodeRef, m_code);
+    }
+
     MacroAssemblerCodePtr m_code;
     ExecutablePool* m_executablePool;
     size_t m_size;
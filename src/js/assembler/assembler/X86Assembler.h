@@ -287,6 +287,8 @@ private:
         OP2_UD2             = 0x0B,
         OP2_MOVSD_VsdWsd    = 0x10,
         OP2_MOVSD_WsdVsd    = 0x11,
+        OP2_MOVUPS_VpsWps   = 0x10,
+        OP2_MOVUPS_WpsVps   = 0x11,
         OP2_UNPCKLPS_VsdWsd = 0x14,
         OP2_MOVAPD_VsdWsd   = 0x28,
         OP2_MOVAPS_VsdWsd   = 0x28,
@@ -304,24 +306,46 @@ private:
         OP2_MAXSD_VsdWsd    = 0x5F,
         OP2_SQRTSD_VsdWsd   = 0x51,
         OP2_SQRTSS_VssWss   = 0x51,
+        OP2_SQRTPS_VpsWps   = 0x51,
         OP2_ANDPD_VpdWpd    = 0x54,
+        OP2_ANDNPS_VpsWps   = 0x55,
         OP2_ORPD_VpdWpd     = 0x56,
         OP2_XORPD_VpdWpd    = 0x57,
+        OP2_ADDPS_VpsWps    = 0x58,
+        OP2_MULPS_VpsWps    = 0x59,
+        OP2_CVTDQ2PS_VpsWdq = 0x5B,
+        OP2_CVTTPS2DQ_VdqWps = 0x5B,
+        OP2_SUBPS_VpsWps    = 0x5C,
+        OP2_MINPS_VpsWps    = 0x5D,
+        OP2_DIVPS_VpsWps    = 0x5E,
+        OP2_MAXPS_VpsWps    = 0x5F,
         OP2_MOVD_VdEd       = 0x6E,
         OP2_MOVDQA_VsdWsd   = 0x6F,
+        OP2_PSHUFD_VdqWdqIb = 0x70,
         OP2_PSRLDQ_Vd       = 0x73,
         OP2_PCMPEQW         = 0x75,
         OP2_MOVD_EdVd       = 0x7E,
         OP2_MOVDQA_WsdVsd   = 0x7F,
         OP2_JCC_rel32       = 0x80,
         OP_SETCC            = 0x90,
+        OP2_FENCE           = 0xAE,
         OP2_IMUL_GvEv       = 0xAF,
+        OP2_CMPXCHG_GvEb    = 0xB0,
+        OP2_CMPXCHG_GvEw    = 0xB1,
         OP2_MOVSX_GvEb      = 0xBE,
         OP2_MOVSX_GvEw      = 0xBF,
         OP2_MOVZX_GvEb      = 0xB6,
         OP2_MOVZX_GvEw      = 0xB7,
+        OP2_XADD_EbGb       = 0xC0,
         OP2_XADD_EvGv       = 0xC1,
-        OP2_PEXTRW_GdUdIb   = 0xC5
+        OP2_CMPPS_VpsWpsIb  = 0xC2,
+        OP2_PEXTRW_GdUdIb   = 0xC5,
+        OP2_SHUFPS_VpsWpsIb = 0xC6,
+        OP2_PAND_VdqWdq     = 0xDB,
+        OP2_POR_VdqWdq      = 0xEB,
+        OP2_PXOR_VdqWdq     = 0xEF,
+        OP2_PSUBD_VdqWdq    = 0xFA,
+        OP2_PADDD_VdqWdq    = 0xFE
     } TwoByteOpcodeID;
 
     typedef enum {
@@ -376,7 +400,9 @@ private:
         FPU6_OP_FISTTP  = 1,
         FPU6_OP_FSTP    = 3,
 
-        GROUP11_MOV = 0
+        GROUP11_MOV = 0,
+
+        GROUP15_OP_MFENCE = 6
     } GroupOpcodeID;
 
     class X86InstructionFormatter;
@@ -643,6 +669,103 @@ public:
         m_formatter.twoByteOp(OP2_XADD_EvGv, srcdest, base, index, scale, offset);
     }
 
+    void xaddw_rm(RegisterID srcdest, int offset, RegisterID base)
+    {
+        spew("lock xaddw %s, %s0x%x(%s)",
+            nameIReg(2,srcdest), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.prefix(PRE_OPERAND_SIZE);
+        m_formatter.twoByteOp(OP2_XADD_EvGv, srcdest, base, offset);
+    }
+
+    void xaddw_rm(RegisterID srcdest, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        spew("lock xaddw %s, %s0x%x(%s,%s,%d)",
+            nameIReg(2, srcdest), PRETTY_PRINT_OFFSET(offset),
+            nameIReg(base), nameIReg(index), 1<<scale);
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.prefix(PRE_OPERAND_SIZE);
+        m_formatter.twoByteOp(OP2_XADD_EvGv, srcdest, base, index, scale, offset);
+    }
+
+    void xaddb_rm(RegisterID srcdest, int offset, RegisterID base)
+    {
+        spew("lock xaddb %s, %s0x%x(%s)",
+            nameIReg(1,srcdest), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp8(OP2_XADD_EbGb, srcdest, base, offset);
+    }
+
+    void xaddb_rm(RegisterID srcdest, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        spew("lock xaddb %s, %s0x%x(%s,%s,%d)",
+            nameIReg(1, srcdest), PRETTY_PRINT_OFFSET(offset),
+            nameIReg(base), nameIReg(index), 1<<scale);
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp8(OP2_XADD_EbGb, srcdest, base, index, scale, offset);
+    }
+
+    // Compare eax (ax, al) with the memory operand; if equal, store src in
+    // it, otherwise load it into eax (ax, al).
+    void cmpxchgl_rm(RegisterID src, int offset, RegisterID base)
+    {
+        spew("lock cmpxchgl %s, %s0x%x(%s)",
+            nameIReg(4,src), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp(OP2_CMPXCHG_GvEw, src, base, offset);
+    }
+
+    void cmpxchgl_rm(RegisterID src, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        spew("lock cmpxchgl %s, %s0x%x(%s,%s,%d)",
+            nameIReg(4, src), PRETTY_PRINT_OFFSET(offset),
+            nameIReg(base), nameIReg(index), 1<<scale);
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp(OP2_CMPXCHG_GvEw, src, base, index, scale, offset);
+    }
+
+    void cmpxchgw_rm(RegisterID src, int offset, RegisterID base)
+    {
+        spew("lock cmpxchgw %s, %s0x%x(%s)",
+            nameIReg(2,src), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.prefix(PRE_OPERAND_SIZE);
+        m_formatter.twoByteOp(OP2_CMPXCHG_GvEw, src, base, offset);
+    }
+
+    void cmpxchgw_rm(RegisterID src, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        spew("lock cmpxchgw %s, %s0x%x(%s,%s,%d)",
+            nameIReg(2, src), PRETTY_PRINT_OFFSET(offset),
+            nameIReg(base), nameIReg(index), 1<<scale);
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.prefix(PRE_OPERAND_SIZE);
+        m_formatter.twoByteOp(OP2_CMPXCHG_GvEw, src, base, index, scale, offset);
+    }
+
+    void cmpxchgb_rm(RegisterID src, int offset, RegisterID base)
+    {
+        spew("lock cmpxchgb %s, %s0x%x(%s)",
+            nameIReg(1,src), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp8(OP2_CMPXCHG_GvEb, src, base, offset);
+    }
+
+    void cmpxchgb_rm(RegisterID src, int offset, RegisterID base, RegisterID index, int scale)
+    {
+        spew("lock cmpxchgb %s, %s0x%x(%s,%s,%d)",
+            nameIReg(1, src), PRETTY_PRINT_OFFSET(offset),
+            nameIReg(base), nameIReg(index), 1<<scale);
+        m_formatter.oneByteOp(PRE_LOCK);
+        m_formatter.twoByteOp8(OP2_CMPXCHG_GvEb, src, base, index, scale, offset);
+    }
+
+    void mfence()
+    {
+        spew("mfence");
+        m_formatter.twoByteOp(OP2_FENCE, GROUP15_OP_MFENCE, X86Registers::eax);
+    }
+
     void andl_rr(RegisterID src, RegisterID dst)
     {
         spew("andl       %s, %s",
@@ -2098,6 +2221,27 @@ public:
         m_formatter.twoByteOp8_movx(OP2_MOVZX_GvEb, dst, src);
     }
 
+    void movsbl_rr(RegisterID src, RegisterID dst)
+    {
+        spew("movsbl     %s, %s",
+             nameIReg(1,src), nameIReg(4,dst));
+        m_formatter.twoByteOp8_movx(OP2_MOVSX_GvEb, dst, src);
+    }
+
+    void movzwl_rr(RegisterID src, RegisterID dst)
+    {
+        spew("movzwl     %s, %s",
+             nameIReg(2,src), nameIReg(4,dst));
+        m_formatter.twoByteOp(OP2_MOVZX_GvEw, dst, src);
+    }
+
+    void movswl_rr(RegisterID src, RegisterID dst)
+    {
+        spew("movswl     %s, %s",
+             nameIReg(2,src), nameIReg(4,dst));
+        m_formatter.twoByteOp(OP2_MOVSX_GvEw, dst, src);
+    }
+
     void leal_mr(int offset, RegisterID base, RegisterID index, int scale, RegisterID dst)
     {
         spew("leal       %d(%s,%s,%d), %s",
@@ -2787,6 +2931,163 @@ public:
         m_formatter.twoByteOp(OP2_MOVDQA_VsdWsd, (RegisterID)dst, base, index, scale, offset);
     }
 
+    void movups_rm(XMMRegisterID src, int offset, RegisterID base)
+    {
+        spew("movups     %s, %s0x%x(%s)",
+             nameFPReg(src), PRETTY_PRINT_OFFSET(offset), nameIReg(base));
+        m_formatter.twoByteOp(OP2_MOVUPS_WpsVps, (RegisterID)src, base, offset);
+    }
+
+    void movups_mr(int offset, RegisterID base, XMMRegisterID dst)
+    {
+        spew("movups     %s0x%x(%s), %s",
+             PRETTY_PRINT_OFFSET(offset), nameIReg(base), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_MOVUPS_VpsWps, (RegisterID)dst, base, offset);
+    }
+
+    void addps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("addps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_ADDPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void subps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("subps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_SUBPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void mulps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("mulps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_MULPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void divps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("divps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_DIVPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void minps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("minps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_MINPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void maxps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("maxps      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_MAXPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void sqrtps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("sqrtps     %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_SQRTPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void andnps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("andnps     %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_ANDNPS_VpsWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void orps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("orps       %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_ORPD_VpdWpd, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void cvtdq2ps_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("cvtdq2ps   %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_CVTDQ2PS_VpsWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void cvttps2dq_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("cvttps2dq  %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_F3);
+        m_formatter.twoByteOp(OP2_CVTTPS2DQ_VdqWps, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void paddd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("paddd      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PADDD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void psubd_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("psubd      %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSUBD_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pand_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("pand       %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PAND_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void por_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("por        %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_POR_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void pxor_rr(XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("pxor       %s, %s",
+             nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PXOR_VdqWdq, (RegisterID)dst, (RegisterID)src);
+    }
+
+    void cmpps_rr(XMMRegisterID src, XMMRegisterID dst, int predicate)
+    {
+        spew("cmpps      $%d, %s, %s",
+             predicate, nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_CMPPS_VpsWpsIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(predicate);
+    }
+
+    void shufps_irr(int mask, XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("shufps     $0x%x, %s, %s",
+             mask, nameFPReg(src), nameFPReg(dst));
+        m_formatter.twoByteOp(OP2_SHUFPS_VpsWpsIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(mask);
+    }
+
+    void pshufd_irr(int mask, XMMRegisterID src, XMMRegisterID dst)
+    {
+        spew("pshufd     $0x%x, %s, %s",
+             mask, nameFPReg(src), nameFPReg(dst));
+        m_formatter.prefix(PRE_SSE_66);
+        m_formatter.twoByteOp(OP2_PSHUFD_VdqWdqIb, (RegisterID)dst, (RegisterID)src);
+        m_formatter.immediate8(mask);
+    }
+
     void mulsd_rr(XMMRegisterID src, XMMRegisterID dst)
     {
         spew("mulsd      %s, %s",
@@ -3737,6 +4038,31 @@ private:
             registerModRM(reg, rm);
         }
 
+        void twoByteOp8(TwoByteOpcodeID opcode, RegisterID reg, RegisterID base, int offset)
+        {
+#if !WTF_CPU_X86_64
+            ASSERT(!byteRegRequiresRex(reg));
+#endif
+            m_buffer.ensureSpace(maxInstructionSize);
+            emitRexIf(byteRegRequiresRex(reg), reg, 0, base);
+            m_buffer.putByteUnchecked(OP_2BYTE_ESCAPE);
+            m_buffer.putByteUnchecked(opcode);
+            memoryModRM(reg, base, offset);
+        }
+
+        void twoByteOp8(TwoByteOpcodeID opcode, RegisterID reg, RegisterID base, RegisterID index,
+                        int scale, int offset)
+        {
+#if !WTF_CPU_X86_64
+            ASSERT(!byteRegRequiresRex(reg));
+#endif
+            m_buffer.ensureSpace(maxInstructionSize);
+            emitRexIf(byteRegRequiresRex(reg), reg, index, base);
+            m_buffer.putByteUnchecked(OP_2BYTE_ESCAPE);
+            m_buffer.putByteUnchecked(opcode);
+            memoryModRM(reg, base, index, scale, offset);
+        }
+
         void twoByteOp8(TwoByteOpcodeID opcode, GroupOpcodeID groupOp, RegisterID rm)
         {
             m_buffer.ensureSpace(maxInstructionSize);
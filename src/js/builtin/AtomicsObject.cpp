@@ -0,0 +1,628 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * JS Atomics pseudo-module.
+ *
+ * Every operation acts on one element of an integer typed array, normally
+ * one viewing a SharedArrayBuffer, and is sequentially consistent: the
+ * read-modify-write operations use the processor's locked instructions and
+ * plain loads and stores are fenced on both sides.
+ *
+ * Atomics.wait and Atomics.wake implement a futex: a thread can block until
+ * another thread, possibly in another runtime, wakes up waiters on the same
+ * element. All waiters in the process share a single lock.
+ */
+
+#include "builtin/AtomicsObject.h"
+
+#include "mozilla/FloatingPoint.h"
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+#include "jsapi.h"
+#include "jsfriendapi.h"
+#include "jsnum.h"
+#include "prmjtime.h"
+
+#include "vm/GlobalObject.h"
+#include "vm/TypedArrayObject.h"
+
+#include "jsobjinlines.h"
+
+using namespace js;
+
+const Class AtomicsObject::class_ = {
+    "Atomics",
+    JSCLASS_HAS_CACHED_PROTO(JSProto_Atomics),
+    JS_PropertyStub,         /* addProperty */
+    JS_DeletePropertyStub,   /* delProperty */
+    JS_PropertyStub,         /* getProperty */
+    JS_StrictPropertyStub,   /* setProperty */
+    JS_EnumerateStub,
+    JS_ResolveStub,
+    JS_ConvertStub
+};
+
+/*
+ * Primitive operations. GCC and clang provide the __sync builtins for every
+ * integer width; with MSVC, everything is built on the interlocked
+ * compare-and-swap intrinsics.
+ */
+
+static inline void
+AtomicFence()
+{
+#if defined(__GNUC__)
+    __sync_synchronize();
+#elif defined(_MSC_VER)
+    MemoryBarrier();
+#else
+# error "No memory fence for this compiler"
+#endif
+}
+
+template <typename T>
+static inline T
+AtomicLoad(T *addr)
+{
+    AtomicFence();
+    T v = *static_cast<volatile T *>(addr);
+    AtomicFence();
+    return v;
+}
+
+template <typename T>
+static inline void
+AtomicStore(T *addr, T v)
+{
+    AtomicFence();
+    *static_cast<volatile T *>(addr) = v;
+    AtomicFence();
+}
+
+template <typename T>
+static inline T
+AtomicCompareExchange(T *addr, T oldval, T newval)
+{
+#if defined(__GNUC__)
+    return __sync_val_compare_and_swap(addr, oldval, newval);
+#elif defined(_MSC_VER)
+    switch (sizeof(T)) {
+      case 1:
+        return T(_InterlockedCompareExchange8(reinterpret_cast<volatile char *>(addr),
+                                              char(newval), char(oldval)));
+      case 2:
+        return T(_InterlockedCompareExchange16(reinterpret_cast<volatile short *>(addr),
+                                               short(newval), short(oldval)));
+      default:
+        JS_STATIC_ASSERT(sizeof(long) == 4);
+        return T(_InterlockedCompareExchange(reinterpret_cast<volatile long *>(addr),
+                                             long(newval), long(oldval)));
+    }
+#else
+# error "No compare-and-swap for this compiler"
+#endif
+}
+
+#if defined(__GNUC__)
+# define DEFINE_ATOMIC_FETCH(name, expr)                                      \
+    template <typename T> static T fetch(T *addr, T v) { return name(addr, v); }
+#else
+# define DEFINE_ATOMIC_FETCH(name, expr)
+#endif
+
+#define DEFINE_ATOMIC_OP(Op, expr, builtin)                                   \
+    struct Op {                                                               \
+        template <typename T> static T apply(T a, T b) { return T(expr); }    \
+        DEFINE_ATOMIC_FETCH(builtin, expr)                                    \
+    };
+
+DEFINE_ATOMIC_OP(AtomicAdd, a + b, __sync_fetch_and_add)
+DEFINE_ATOMIC_OP(AtomicSub, a - b, __sync_fetch_and_sub)
+DEFINE_ATOMIC_OP(AtomicAnd, a & b, __sync_fetch_and_and)
+DEFINE_ATOMIC_OP(AtomicOr,  a | b, __sync_fetch_and_or)
+DEFINE_ATOMIC_OP(AtomicXor, a ^ b, __sync_fetch_and_xor)
+
+#undef DEFINE_ATOMIC_OP
+#undef DEFINE_ATOMIC_FETCH
+
+/* Apply |Op| to the element at |addr| and |v|, returning the old element. */
+template <typename Op, typename T>
+static inline T
+AtomicFetchAndApply(T *addr, T v)
+{
+#if defined(__GNUC__)
+    return Op::fetch(addr, v);
+#else
+    T old = *static_cast<volatile T *>(addr);
+    for (;;) {
+        T prev = AtomicCompareExchange(addr, old, Op::apply(old, v));
+        if (prev == old)
+            return old;
+        old = prev;
+    }
+#endif
+}
+
+/*
+ * Functors applied to the element being operated on, once its type is
+ * known. Each returns the value of the operation as the element type.
+ */
+
+struct LoadElement
+{
+    template <typename T> T operator()(T *addr) const { return AtomicLoad(addr); }
+};
+
+struct StoreElement
+{
+    int32_t value;
+    explicit StoreElement(int32_t value) : value(value) {}
+    template <typename T> T operator()(T *addr) const {
+        AtomicStore(addr, T(value));
+        return T(value);
+    }
+};
+
+struct CompareExchangeElement
+{
+    int32_t oldval, newval;
+    CompareExchangeElement(int32_t oldval, int32_t newval) : oldval(oldval), newval(newval) {}
+    template <typename T> T operator()(T *addr) const {
+        return AtomicCompareExchange(addr, T(oldval), T(newval));
+    }
+};
+
+template <typename Op>
+struct FetchAndApplyElement
+{
+    int32_t value;
+    explicit FetchAndApplyElement(int32_t value) : value(value) {}
+    template <typename T> T operator()(T *addr) const {
+        return AtomicFetchAndApply<Op>(addr, T(value));
+    }
+};
+
+static bool
+IsAtomicsArrayType(uint32_t type)
+{
+    switch (type) {
+      case ScalarTypeRepresentation::TYPE_INT8:
+      case ScalarTypeRepresentation::TYPE_UINT8:
+      case ScalarTypeRepresentation::TYPE_INT16:
+      case ScalarTypeRepresentation::TYPE_UINT16:
+      case ScalarTypeRepresentation::TYPE_INT32:
+      case ScalarTypeRepresentation::TYPE_UINT32:
+        return true;
+      default:
+        /* Clamping and floating point conversions have no atomic forms. */
+        return false;
+    }
+}
+
+template <typename F>
+static Value
+ApplyToElement(TypedArrayObject &view, uint32_t index, const F &f)
+{
+    void *data = view.viewData();
+    switch (view.type()) {
+      case ScalarTypeRepresentation::TYPE_INT8:
+        return NumberValue(f(static_cast<int8_t *>(data) + index));
+      case ScalarTypeRepresentation::TYPE_UINT8:
+        return NumberValue(f(static_cast<uint8_t *>(data) + index));
+      case ScalarTypeRepresentation::TYPE_INT16:
+        return NumberValue(f(static_cast<int16_t *>(data) + index));
+      case ScalarTypeRepresentation::TYPE_UINT16:
+        return NumberValue(f(static_cast<uint16_t *>(data) + index));
+      case ScalarTypeRepresentation::TYPE_INT32:
+        return NumberValue(f(static_cast<int32_t *>(data) + index));
+      case ScalarTypeRepresentation::TYPE_UINT32:
+        return NumberValue(f(static_cast<uint32_t *>(data) + index));
+      default:
+        MOZ_ASSUME_UNREACHABLE("not an atomics array type");
+    }
+}
+
+/*
+ * Check that |arrayv| is an integer typed array and convert |indexv|. The
+ * index is checked against the array's length separately, once all the
+ * arguments have been converted, as conversions may neuter the array.
+ */
+static bool
+GetAtomicsArguments(JSContext *cx, HandleValue arrayv, HandleValue indexv,
+                    MutableHandle<TypedArrayObject*> view, double *index)
+{
+    if (!arrayv.isObject() || !arrayv.toObject().is<TypedArrayObject>() ||
+        !IsAtomicsArrayType(arrayv.toObject().as<TypedArrayObject>().type()))
+    {
+        JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_ATOMICS_BAD_ARRAY);
+        return false;
+    }
+    view.set(&arrayv.toObject().as<TypedArrayObject>());
+
+    if (indexv.isInt32()) {
+        *index = indexv.toInt32();
+        return true;
+    }
+    return ToNumber(cx, indexv, index);
+}
+
+static bool
+CheckAtomicsIndex(JSContext *cx, TypedArrayObject &view, double index, uint32_t *result)
+{
+    if (!(index >= 0 && index < view.length() && index == uint32_t(index))) {
+        JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_ATOMICS_BAD_INDEX);
+        return false;
+    }
+    *result = uint32_t(index);
+    return true;
+}
+
+bool
+js::atomics_load(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+
+    args.rval().set(ApplyToElement(*view, index, LoadElement()));
+    return true;
+}
+
+bool
+js::atomics_store(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+
+    /* The value stored is returned as an integer, not as the element type. */
+    double integer;
+    if (!ToInteger(cx, args.get(2), &integer))
+        return false;
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+
+    ApplyToElement(*view, index, StoreElement(ToInt32(integer)));
+    args.rval().setNumber(integer);
+    return true;
+}
+
+bool
+js::atomics_compareExchange(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    int32_t oldval, newval;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+    if (!ToInt32(cx, args.get(2), &oldval) || !ToInt32(cx, args.get(3), &newval))
+        return false;
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+
+    args.rval().set(ApplyToElement(*view, index, CompareExchangeElement(oldval, newval)));
+    return true;
+}
+
+template <typename Op>
+static bool
+AtomicsFetchAndApply(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    int32_t value;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+    if (!ToInt32(cx, args.get(2), &value))
+        return false;
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+
+    args.rval().set(ApplyToElement(*view, index, FetchAndApplyElement<Op>(value)));
+    return true;
+}
+
+bool
+js::atomics_add(JSContext *cx, unsigned argc, Value *vp)
+{
+    return AtomicsFetchAndApply<AtomicAdd>(cx, argc, vp);
+}
+
+bool
+js::atomics_sub(JSContext *cx, unsigned argc, Value *vp)
+{
+    return AtomicsFetchAndApply<AtomicSub>(cx, argc, vp);
+}
+
+bool
+js::atomics_and(JSContext *cx, unsigned argc, Value *vp)
+{
+    return AtomicsFetchAndApply<AtomicAnd>(cx, argc, vp);
+}
+
+bool
+js::atomics_or(JSContext *cx, unsigned argc, Value *vp)
+{
+    return AtomicsFetchAndApply<AtomicOr>(cx, argc, vp);
+}
+
+bool
+js::atomics_xor(JSContext *cx, unsigned argc, Value *vp)
+{
+    return AtomicsFetchAndApply<AtomicXor>(cx, argc, vp);
+}
+
+/*
+ * Futexes.
+ *
+ * Each thread blocked in Atomics.wait has a FutexWaiter on its stack, linked
+ * into a circular list with a sentinel, and waits on its own condition
+ * variable. The list, and the waiters' |woken| flags, are protected by
+ * futexLock. Waiters are woken in the order in which they started waiting.
+ */
+
+#ifdef JS_THREADSAFE
+
+namespace {
+
+struct FutexWaiter
+{
+    int32_t *addr;
+    PRCondVar *cond;
+    bool woken;
+    FutexWaiter *prev;
+    FutexWaiter *next;
+};
+
+} /* anonymous namespace */
+
+static PRLock *futexLock = nullptr;
+static FutexWaiter futexWaiters;
+
+class AutoLockFutex
+{
+  public:
+    AutoLockFutex() { PR_Lock(futexLock); }
+    ~AutoLockFutex() { PR_Unlock(futexLock); }
+};
+
+static void
+RemoveWaiter(FutexWaiter *w)
+{
+    w->prev->next = w->next;
+    w->next->prev = w->prev;
+}
+
+#endif /* JS_THREADSAFE */
+
+/* static */ bool
+AtomicsObject::initialize()
+{
+#ifdef JS_THREADSAFE
+    if (!futexLock) {
+        futexLock = PR_NewLock();
+        if (!futexLock)
+            return false;
+        futexWaiters.prev = futexWaiters.next = &futexWaiters;
+    }
+#endif
+    return true;
+}
+
+/* static */ void
+AtomicsObject::destroy()
+{
+#ifdef JS_THREADSAFE
+    if (futexLock) {
+        JS_ASSERT(futexWaiters.next == &futexWaiters);
+        PR_DestroyLock(futexLock);
+        futexLock = nullptr;
+    }
+#endif
+}
+
+/*
+ * Atomics.wait(int32Array, index, value[, timeout])
+ *
+ * If the element is |value|, block until another thread wakes this one up
+ * with Atomics.wake, or until |timeout| milliseconds have passed. Returns
+ * "ok", "not-equal" or "timed-out". The wait cannot be interrupted by the
+ * operation callback.
+ */
+bool
+js::atomics_wait(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    int32_t value;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+    if (view->type() != ScalarTypeRepresentation::TYPE_INT32) {
+        JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_ATOMICS_BAD_ARRAY);
+        return false;
+    }
+    if (!ToInt32(cx, args.get(2), &value))
+        return false;
+
+    double timeout = mozilla::PositiveInfinity();
+    if (!args.get(3).isUndefined()) {
+        if (!ToNumber(cx, args.get(3), &timeout))
+            return false;
+        if (mozilla::IsNaN(timeout))
+            timeout = mozilla::PositiveInfinity();
+        else if (timeout < 0)
+            timeout = 0;
+    }
+
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+    int32_t *addr = static_cast<int32_t *>(view->viewData()) + index;
+
+#ifdef JS_THREADSAFE
+    AutoLockFutex lock;
+
+    if (*addr != value) {
+        args.rval().setString(cx->names().futexNotEqual);
+        return true;
+    }
+
+    FutexWaiter w;
+    w.addr = addr;
+    w.woken = false;
+    w.cond = PR_NewCondVar(futexLock);
+    if (!w.cond) {
+        js_ReportOutOfMemory(cx);
+        return false;
+    }
+    w.prev = futexWaiters.prev;
+    w.next = &futexWaiters;
+    w.prev->next = &w;
+    futexWaiters.prev = &w;
+
+    bool infinite = mozilla::IsInfinite(timeout);
+    int64_t deadline = infinite ? 0 : PRMJ_Now() + int64_t(timeout * PRMJ_USEC_PER_MSEC);
+    while (!w.woken) {
+        PRIntervalTime ticks = PR_INTERVAL_NO_TIMEOUT;
+        if (!infinite) {
+            int64_t now = PRMJ_Now();
+            if (now >= deadline)
+                break;
+            int64_t remaining = deadline - now;
+            ticks = PR_MicrosecondsToInterval(uint32_t(remaining < UINT32_MAX ? remaining : UINT32_MAX));
+        }
+        PR_WaitCondVar(w.cond, ticks);
+    }
+
+    /* A woken waiter has already been removed from the list by its waker. */
+    if (!w.woken)
+        RemoveWaiter(&w);
+    PR_DestroyCondVar(w.cond);
+
+    args.rval().setString(w.woken ? cx->names().futexOK : cx->names().futexTimedOut);
+    return true;
+#else
+    /* With no other threads, nothing can ever change the value. */
+    if (*addr != value) {
+        args.rval().setString(cx->names().futexNotEqual);
+        return true;
+    }
+    JS_ReportError(cx, "Atomics.wait would block forever");
+    return false;
+#endif
+}
+
+/*
+ * Atomics.wake(int32Array, index[, count])
+ *
+ * Wake up at most |count| threads waiting on the element, or all of them if
+ * |count| is undefined. Returns the number of threads woken.
+ */
+bool
+js::atomics_wake(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    Rooted<TypedArrayObject*> view(cx);
+    double d;
+    uint32_t index;
+    if (!GetAtomicsArguments(cx, args.get(0), args.get(1), &view, &d))
+        return false;
+    if (view->type() != ScalarTypeRepresentation::TYPE_INT32) {
+        JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_ATOMICS_BAD_ARRAY);
+        return false;
+    }
+
+    double count = mozilla::PositiveInfinity();
+    if (!args.get(2).isUndefined()) {
+        if (!ToInteger(cx, args.get(2), &count))
+            return false;
+        if (count < 0)
+            count = 0;
+    }
+
+    if (!CheckAtomicsIndex(cx, *view, d, &index))
+        return false;
+
+    uint32_t woken = 0;
+#ifdef JS_THREADSAFE
+    int32_t *addr = static_cast<int32_t *>(view->viewData()) + index;
+
+    AutoLockFutex lock;
+    FutexWaiter *w = futexWaiters.next;
+    while (w != &futexWaiters && woken < count) {
+        FutexWaiter *next = w->next;
+        if (w->addr == addr) {
+            RemoveWaiter(w);
+            w->woken = true;
+            PR_NotifyCondVar(w->cond);
+            woken++;
+        }
+        w = next;
+    }
+#endif
+
+    args.rval().setNumber(woken);
+    return true;
+}
+
+static const JSFunctionSpec atomics_static_methods[] = {
+    JS_FN("load",            atomics_load,            2, 0),
+    JS_FN("store",           atomics_store,           3, 0),
+    JS_FN("compareExchange", atomics_compareExchange, 4, 0),
+    JS_FN("add",             atomics_add,             3, 0),
+    JS_FN("sub",             atomics_sub,             3, 0),
+    JS_FN("and",             atomics_and,             3, 0),
+    JS_FN("or",              atomics_or,              3, 0),
+    JS_FN("xor",             atomics_xor,             3, 0),
+    JS_FN("wait",            atomics_wait,            4, 0),
+    JS_FN("wake",            atomics_wake,            3, 0),
+    JS_FS_END
+};
+
+JSObject *
+js_InitAtomicsClass(JSContext *cx, HandleObject obj)
+{
+    JS_ASSERT(obj->is<GlobalObject>());
+    Rooted<GlobalObject *> global(cx, &obj->as<GlobalObject>());
+    RootedObject objProto(cx, global->getOrCreateObjectPrototype(cx));
+    if (!objProto)
+        return nullptr;
+
+    RootedObject Atomics(cx, NewObjectWithGivenProto(cx, &AtomicsObject::class_, objProto,
+                                                     global, SingletonObject));
+    if (!Atomics)
+        return nullptr;
+
+    if (!JS_DefineFunctions(cx, Atomics, atomics_static_methods))
+        return nullptr;
+
+    RootedValue AtomicsValue(cx, ObjectValue(*Atomics));
+    if (!JSObject::defineProperty(cx, global, cx->names().Atomics, AtomicsValue,
+                                  JS_PropertyStub, JS_StrictPropertyStub, 0))
+    {
+        return nullptr;
+    }
+
+    global->setConstructor(JSProto_Atomics, AtomicsValue);
+    return Atomics;
+}
@@ -0,0 +1,49 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef builtin_AtomicsObject_h
+#define builtin_AtomicsObject_h
+
+#include "jsobj.h"
+
+namespace js {
+
+/*
+ * The Atomics object: sequentially consistent operations on the elements of
+ * integer typed arrays, for sharing memory between workers through
+ * SharedArrayBuffers, and wait/wake primitives to block on such memory.
+ */
+class AtomicsObject : public JSObject
+{
+  public:
+    static const Class class_;
+
+    /*
+     * Set up and tear down the process-wide state used by Atomics.wait and
+     * Atomics.wake. Called from JS_Init and JS_ShutDown.
+     */
+    static bool initialize();
+    static void destroy();
+};
+
+/* Natives, exposed so that Ion can recognize and inline them. */
+bool atomics_load(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_store(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_compareExchange(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_add(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_sub(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_and(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_or(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_xor(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_wait(JSContext *cx, unsigned argc, Value *vp);
+bool atomics_wake(JSContext *cx, unsigned argc, Value *vp);
+
+}  /* namespace js */
+
+extern JSObject *
+js_InitAtomicsClass(JSContext *cx, js::HandleObject obj);
+
+#endif /* builtin_AtomicsObject_h */
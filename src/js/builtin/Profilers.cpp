@@ -28,7 +28,10 @@
 # define getpid _getpid
 #endif
 
+#include "jsprf.h"
+
 #include "vm/Probes.h"
+#include "vm/SamplingProfiler.h"
 
 #include "jscntxtinlines.h"
 
@@ -202,7 +205,58 @@ JS_DumpProfile(const char *outfile, const char *profileName)
     return ok;
 }
 
-#ifdef MOZ_PROFILING
+JS_PUBLIC_API(bool)
+JS_StartSamplingProfiler(JSRuntime *rt, uint32_t intervalMilliseconds)
+{
+    if (rt->samplingProfiler) {
+        UnsafeError("The sampling profiler is already running");
+        return false;
+    }
+
+    SamplingProfiler *profiler = js_new<SamplingProfiler>(rt, intervalMilliseconds);
+    if (!profiler || !profiler->init()) {
+        js_delete(profiler);
+        UnsafeError("Failed to start the sampling profiler");
+        return false;
+    }
+
+    rt->samplingProfiler = profiler;
+    return true;
+}
+
+JS_PUBLIC_API(bool)
+JS_StopSamplingProfiler(JSRuntime *rt, const char *outfile)
+{
+    SamplingProfiler *profiler = rt->samplingProfiler;
+    if (!profiler) {
+        UnsafeError("The sampling profiler is not running");
+        return false;
+    }
+
+    profiler->stop();
+    rt->samplingProfiler = nullptr;
+
+    bool ok = true;
+    if (outfile) {
+        FILE *fp = fopen(outfile, "w");
+        if (fp) {
+            ok = profiler->write(fp);
+            if (fclose(fp) != 0)
+                ok = false;
+        } else {
+            ok = false;
+        }
+        if (!ok)
+            UnsafeError("Failed to write samples to %s", outfile);
+    }
+
+    js_delete(profiler);
+    return ok;
+}
+
+/* Sampling interval and output file name used by startProfiling/stopProfiling. */
+static const uint32_t DefaultSamplingInterval = 1;
+static const char DefaultSamplingProfileName[] = "jsprofile";
 
 struct RequiredStringArg {
     JSContext *mCx;
@@ -226,12 +280,39 @@ struct RequiredStringArg {
     }
 };
 
+/* Start the sampling profiler along with the platform profilers. */
+static bool
+StartAllProfilers(JSContext *cx, const char *profileName, pid_t pid)
+{
+    bool ok = JS_StartSamplingProfiler(cx->runtime(), DefaultSamplingInterval);
+    if (!JS_StartProfiling(profileName, pid))
+        ok = false;
+    return ok;
+}
+
+/*
+ * Stop all profilers, writing the samples taken by the sampling profiler to
+ * profileName.stacks, or to jsprofile.stacks if no name is given.
+ */
+static bool
+StopAllProfilers(JSContext *cx, const char *profileName)
+{
+    char outfile[4096];
+    JS_snprintf(outfile, sizeof(outfile), "%s.stacks",
+                profileName ? profileName : DefaultSamplingProfileName);
+
+    bool ok = JS_StopSamplingProfiler(cx->runtime(), outfile);
+    if (!JS_StopProfiling(profileName))
+        ok = false;
+    return ok;
+}
+
 static bool
 StartProfiling(JSContext *cx, unsigned argc, jsval *vp)
 {
     CallArgs args = CallArgsFromVp(argc, vp);
     if (args.length() == 0) {
-        args.rval().setBoolean(JS_StartProfiling(nullptr, getpid()));
+        args.rval().setBoolean(StartAllProfilers(cx, nullptr, getpid()));
         return true;
     }
 
@@ -240,7 +321,7 @@ StartProfiling(JSContext *cx, unsigned argc, jsval *vp)
         return false;
 
     if (args.length() == 1) {
-        args.rval().setBoolean(JS_StartProfiling(profileName.mBytes, getpid()));
+        args.rval().setBoolean(StartAllProfilers(cx, profileName.mBytes, getpid()));
         return true;
     }
 
@@ -249,7 +330,7 @@ StartProfiling(JSContext *cx, unsigned argc, jsval *vp)
         return false;
     }
     pid_t pid = static_cast<pid_t>(args[1].toInt32());
-    args.rval().setBoolean(JS_StartProfiling(profileName.mBytes, pid));
+    args.rval().setBoolean(StartAllProfilers(cx, profileName.mBytes, pid));
     return true;
 }
 
@@ -258,17 +339,19 @@ StopProfiling(JSContext *cx, unsigned argc, jsval *vp)
 {
     CallArgs args = CallArgsFromVp(argc, vp);
     if (args.length() == 0) {
-        args.rval().setBoolean(JS_StopProfiling(nullptr));
+        args.rval().setBoolean(StopAllProfilers(cx, nullptr));
         return true;
     }
 
     RequiredStringArg profileName(cx, args, 0, "stopProfiling");
     if (!profileName)
         return false;
-    args.rval().setBoolean(JS_StopProfiling(profileName.mBytes));
+    args.rval().setBoolean(StopAllProfilers(cx, profileName.mBytes));
     return true;
 }
 
+#ifdef MOZ_PROFILING
+
 static bool
 PauseProfilers(JSContext *cx, unsigned argc, jsval *vp)
 {
@@ -376,9 +459,12 @@ DumpCallgrind(JSContext *cx, unsigned argc, jsval *vp)
 }
 #endif
 
+#endif /* MOZ_PROFILING */
+
 static const JSFunctionSpec profiling_functions[] = {
     JS_FN("startProfiling",  StartProfiling,      1,0),
     JS_FN("stopProfiling",   StopProfiling,       1,0),
+#ifdef MOZ_PROFILING
     JS_FN("pauseProfilers",  PauseProfilers,      1,0),
     JS_FN("resumeProfilers", ResumeProfilers,     1,0),
     JS_FN("dumpProfile",     DumpProfile,         2,0),
@@ -394,22 +480,17 @@ static const JSFunctionSpec profiling_functions[] = {
     JS_FN("stopCallgrind",  StopCallgrind,        0,0),
     JS_FN("dumpCallgrind",  DumpCallgrind,        1,0),
 #endif
+#endif /* MOZ_PROFILING */
     JS_FS_END
 };
 
-#endif
-
 JS_PUBLIC_API(bool)
 JS_DefineProfilingFunctions(JSContext *cx, JSObject *objArg)
 {
     RootedObject obj(cx, objArg);
 
     assertSameCompartment(cx, obj);
-#ifdef MOZ_PROFILING
     return JS_DefineFunctions(cx, obj, profiling_functions);
-#else
-    return true;
-#endif
 }
 
 #ifdef MOZ_CALLGRIND
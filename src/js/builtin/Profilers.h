@@ -19,6 +19,8 @@ typedef int pid_t;
 #include <unistd.h>
 #endif
 
+struct JSRuntime;
+
 /**
  * Start any profilers that are available and have been configured on for this
  * platform. This is NOT thread safe.
@@ -61,6 +63,22 @@ JS_PauseProfilers(const char *profileName);
 extern JS_PUBLIC_API(bool)
 JS_ResumeProfilers(const char *profileName);
 
+/**
+ * Start the built-in sampling profiler, which records the stack of the main
+ * thread of |rt| about every |intervalMilliseconds|. Returns false if it is
+ * already running or no sampler thread could be started.
+ */
+extern JS_PUBLIC_API(bool)
+JS_StartSamplingProfiler(JSRuntime *rt, uint32_t intervalMilliseconds);
+
+/**
+ * Stop the sampling profiler and write the samples it took to |outfile|, one
+ * line per distinct stack in the collapsed-stack format used by flame graph
+ * tools. Passing nullptr discards the samples.
+ */
+extern JS_PUBLIC_API(bool)
+JS_StopSamplingProfiler(JSRuntime *rt, const char *outfile);
+
 /**
  * The profiling API calls are not able to report errors, so they use a
  * thread-unsafe global memory buffer to hold the last error encountered. This
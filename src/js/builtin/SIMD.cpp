@@ -202,10 +202,11 @@ CreateX4Class(JSContext *cx, Handle<GlobalObject*> global)
     if (!proto)
         return nullptr;
 
-    // Create type constructor itself.
+    // Create type constructor itself. It is a singleton so that the JIT
+    // knows which of its functions is being called, and can inline them.
 
     RootedObject x4(cx);
-    x4 = NewObjectWithClassProto(cx, &X4Type::class_, funcProto, global);
+    x4 = NewObjectWithClassProto(cx, &X4Type::class_, funcProto, global, SingletonObject);
     if (!x4 ||
         !InitializeCommonTypeDescriptorProperties(cx, x4, typeReprObj) ||
         !DefinePropertiesAndBrand(cx, proto, nullptr, nullptr))
@@ -926,3 +927,63 @@ const JSFunctionSpec js::Int32x4Methods[] = {
         JS_FN("bool", Int32x4Bool, 4, 0),
         JS_FS_END
 };
+
+static const struct {
+    JSNative native;
+    X4TypeRepresentation::Type type;
+    SimdOperation op;
+} SimdInlinableNatives[] = {
+#define F32(op, native) { native, X4TypeRepresentation::TYPE_FLOAT32, SimdOp_##op }
+#define I32(op, native) { native, X4TypeRepresentation::TYPE_INT32, SimdOp_##op }
+    F32(Abs, (Func<Float32x4, Abs<float, Float32x4>, Float32x4>)),
+    F32(Neg, (Func<Float32x4, Neg<float, Float32x4>, Float32x4>)),
+    F32(Reciprocal, (Func<Float32x4, Rec<float, Float32x4>, Float32x4>)),
+    F32(Sqrt, (Func<Float32x4, Sqrt<float, Float32x4>, Float32x4>)),
+    F32(Add, (Func<Float32x4, Add<float, Float32x4>, Float32x4>)),
+    F32(Sub, (Func<Float32x4, Sub<float, Float32x4>, Float32x4>)),
+    F32(Div, (Func<Float32x4, Div<float, Float32x4>, Float32x4>)),
+    F32(Mul, (Func<Float32x4, Mul<float, Float32x4>, Float32x4>)),
+    F32(Max, (Func<Float32x4, Maximum<float, Float32x4>, Float32x4>)),
+    F32(Min, (Func<Float32x4, Minimum<float, Float32x4>, Float32x4>)),
+    F32(LessThan, (Func<Float32x4, LessThan<float, Int32x4>, Int32x4>)),
+    F32(LessThanOrEqual, (Func<Float32x4, LessThanOrEqual<float, Int32x4>, Int32x4>)),
+    F32(GreaterThan, (Func<Float32x4, GreaterThan<float, Int32x4>, Int32x4>)),
+    F32(GreaterThanOrEqual, (Func<Float32x4, GreaterThanOrEqual<float, Int32x4>, Int32x4>)),
+    F32(Equal, (Func<Float32x4, Equal<float, Int32x4>, Int32x4>)),
+    F32(NotEqual, (Func<Float32x4, NotEqual<float, Int32x4>, Int32x4>)),
+    F32(Shuffle, (FuncShuffle<Float32x4, Shuffle<float, Float32x4>, Float32x4>)),
+    F32(Scale, (FuncWith<Float32x4, Scale<float, Float32x4>, Float32x4>)),
+    F32(Clamp, Float32x4Clamp),
+    F32(Convert, (FuncConvert<Float32x4, Int32x4>)),
+    F32(ConvertBits, (FuncConvertBits<Float32x4, Int32x4>)),
+    F32(Zero, (FuncZero<Float32x4>)),
+    F32(Splat, (FuncSplat<Float32x4>)),
+    I32(Not, (Func<Int32x4, Not<int32_t, Int32x4>, Int32x4>)),
+    I32(Neg, (Func<Int32x4, Neg<int32_t, Int32x4>, Int32x4>)),
+    I32(Add, (Func<Int32x4, Add<int32_t, Int32x4>, Int32x4>)),
+    I32(Sub, (Func<Int32x4, Sub<int32_t, Int32x4>, Int32x4>)),
+    I32(Xor, (Func<Int32x4, Xor<int32_t, Int32x4>, Int32x4>)),
+    I32(And, (Func<Int32x4, And<int32_t, Int32x4>, Int32x4>)),
+    I32(Or, (Func<Int32x4, Or<int32_t, Int32x4>, Int32x4>)),
+    I32(Shuffle, (FuncShuffle<Int32x4, Shuffle<int32_t, Int32x4>, Int32x4>)),
+    I32(Convert, (FuncConvert<Int32x4, Float32x4>)),
+    I32(ConvertBits, (FuncConvertBits<Int32x4, Float32x4>)),
+    I32(Zero, (FuncZero<Int32x4>)),
+    I32(Splat, (FuncSplat<Int32x4>)),
+    I32(Select, Int32x4Select)
+#undef F32
+#undef I32
+};
+
+bool
+js::GetSimdOperation(JSNative native, X4TypeRepresentation::Type *type, SimdOperation *op)
+{
+    for (size_t i = 0; i < ArrayLength(SimdInlinableNatives); i++) {
+        if (SimdInlinableNatives[i].native == native) {
+            *type = SimdInlinableNatives[i].type;
+            *op = SimdInlinableNatives[i].op;
+            return true;
+        }
+    }
+    return false;
+}
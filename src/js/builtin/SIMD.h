@@ -73,6 +73,45 @@ struct Int32x4 {
 template<typename V>
 JSObject *Create(JSContext *cx, typename V::Elem *data);
 
+// SIMD functions which the JIT knows how to compile inline. The natives in
+// SIMD.cpp give the reference semantics of each operation.
+enum SimdOperation {
+    SimdOp_Abs,
+    SimdOp_Neg,
+    SimdOp_Not,
+    SimdOp_Reciprocal,
+    SimdOp_Sqrt,
+    SimdOp_Add,
+    SimdOp_Sub,
+    SimdOp_Mul,
+    SimdOp_Div,
+    SimdOp_Min,
+    SimdOp_Max,
+    SimdOp_And,
+    SimdOp_Or,
+    SimdOp_Xor,
+    SimdOp_LessThan,
+    SimdOp_LessThanOrEqual,
+    SimdOp_GreaterThan,
+    SimdOp_GreaterThanOrEqual,
+    SimdOp_Equal,
+    SimdOp_NotEqual,
+    SimdOp_Scale,
+    SimdOp_Clamp,
+    SimdOp_Shuffle,
+    SimdOp_Select,
+    SimdOp_Convert,
+    SimdOp_ConvertBits,
+    SimdOp_Zero,
+    SimdOp_Splat
+};
+
+// If |native| is one of the SIMD functions listed above, return true and
+// fill in the type of vector it operates on and the operation it performs.
+// Shuffle and shuffleMix share a native and are told apart by argc.
+bool
+GetSimdOperation(JSNative native, X4TypeRepresentation::Type *type, SimdOperation *op);
+
 }  /* namespace js */
 
 JSObject *
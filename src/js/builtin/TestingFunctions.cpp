@@ -207,10 +207,11 @@ GC(JSContext *cx, unsigned argc, jsval *vp)
      * If the first argument is 'compartment', we collect any compartments
      * previously scheduled for GC via schedulegc. If the first argument is an
      * object, we collect the object's compartment (and any other compartments
-     * scheduled for GC). Otherwise, we collect all compartments.
+     * scheduled for GC). Otherwise, we collect all compartments. If the second
+     * argument is 'shrinking', a shrinking GC is performed.
      */
     bool compartment = false;
-    if (argc == 1) {
+    if (argc >= 1) {
         Value arg = vp[2];
         if (arg.isString()) {
             if (!JS_StringEqualsAscii(cx, arg.toString(), "compartment", &compartment))
@@ -221,6 +222,15 @@ GC(JSContext *cx, unsigned argc, jsval *vp)
         }
     }
 
+    bool shrinking = false;
+    if (argc >= 2) {
+        Value arg = vp[3];
+        if (arg.isString()) {
+            if (!JS_StringEqualsAscii(cx, arg.toString(), "shrinking", &shrinking))
+                return false;
+        }
+    }
+
 #ifndef JS_MORE_DETERMINISTIC
     size_t preBytes = cx->runtime()->gcBytes;
 #endif
@@ -229,7 +239,10 @@ GC(JSContext *cx, unsigned argc, jsval *vp)
         PrepareForDebugGC(cx->runtime());
     else
         PrepareForFullGC(cx->runtime());
-    GCForReason(cx->runtime(), gcreason::API);
+    if (shrinking)
+        ShrinkingGC(cx->runtime(), gcreason::API);
+    else
+        GCForReason(cx->runtime(), gcreason::API);
 
     char buf[256] = { '\0' };
 #ifndef JS_MORE_DETERMINISTIC
@@ -266,11 +279,13 @@ static const struct ParamPair {
     {"gcBytes",             JSGC_BYTES},
     {"gcNumber",            JSGC_NUMBER},
     {"sliceTimeBudget",     JSGC_SLICE_TIME_BUDGET},
-    {"markStackLimit",      JSGC_MARK_STACK_LIMIT}
+    {"markStackLimit",      JSGC_MARK_STACK_LIMIT},
+    {"parallelMarking",     JSGC_PARALLEL_MARKING},
+    {"compactingEnabled",   JSGC_COMPACTING}
 };
 
 // Keep this in sync with above params.
-#define GC_PARAMETER_ARGS_LIST "maxBytes, maxMallocBytes, gcBytes, gcNumber, sliceTimeBudget, or markStackLimit"
+#define GC_PARAMETER_ARGS_LIST "maxBytes, maxMallocBytes, gcBytes, gcNumber, sliceTimeBudget, markStackLimit, parallelMarking, or compactingEnabled"
  
 static bool
 GCParameter(JSContext *cx, unsigned argc, Value *vp)
@@ -1328,8 +1343,29 @@ Serialize(JSContext *cx, unsigned argc, jsval *vp)
 {
     CallArgs args = CallArgsFromVp(argc, vp);
 
+    JS::StructuredCloneScope scope = JS::AnyProcessCloneScope;
+    if (args.length() > 2) {
+        JSString *str = ToString<CanGC>(cx, args[2]);
+        if (!str)
+            return false;
+        bool sameProcess;
+        if (!JS_StringEqualsAscii(cx, str, "SameProcess", &sameProcess))
+            return false;
+        if (sameProcess) {
+            scope = JS::SameProcessCloneScope;
+        } else {
+            bool anyProcess;
+            if (!JS_StringEqualsAscii(cx, str, "AnyProcess", &anyProcess))
+                return false;
+            if (!anyProcess) {
+                JS_ReportError(cx, "serialize scope must be \"SameProcess\" or \"AnyProcess\"");
+                return false;
+            }
+        }
+    }
+
     JSAutoStructuredCloneBuffer clonebuf;
-    if (!clonebuf.write(cx, args.get(0), args.get(1)))
+    if (!clonebuf.write(cx, args.get(0), args.get(1), nullptr, nullptr, scope))
         return false;
 
     RootedObject obj(cx, CloneBufferObject::Create(cx, &clonebuf));
@@ -1412,10 +1448,11 @@ WorkerThreadCount(JSContext *cx, unsigned argc, jsval *vp)
 
 static const JSFunctionSpecWithHelp TestingFunctions[] = {
     JS_FN_HELP("gc", ::GC, 0, 0,
-"gc([obj] | 'compartment')",
+"gc([obj] | 'compartment' [, 'shrinking'])",
 "  Run the garbage collector. When obj is given, GC only its compartment.\n"
 "  If 'compartment' is given, GC any compartments that were scheduled for\n"
-"  GC via schedulegc."),
+"  GC via schedulegc. If 'shrinking' is passed as the second argument, run a\n"
+"  shrinking GC."),
 
     JS_FN_HELP("minorgc", ::MinorGC, 0, 0,
 "minorgc([aboutToOverflow])",
@@ -1621,9 +1658,10 @@ static const JSFunctionSpecWithHelp TestingFunctions[] = {
 "  (asm.js) programs."),
 
     JS_FN_HELP("serialize", Serialize, 1, 0,
-"serialize(data, [transferables])",
+"serialize(data, [transferables, [scope]])",
 "  Serialize 'data' using JS_WriteStructuredClone. Returns a structured\n"
-"  clone buffer object."),
+"  clone buffer object. If 'scope' is \"SameProcess\", large ArrayBuffers and\n"
+"  strings are kept out of line and the buffer can be deserialized only once."),
 
     JS_FN_HELP("deserialize", Deserialize, 1, 0,
 "deserialize(clonebuffer)",
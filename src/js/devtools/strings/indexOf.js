@@ -0,0 +1,53 @@
+// Microbenchmark for String.prototype.indexOf/split/replace with string
+// patterns, covering short and long needles in short and long haystacks.
+//
+// Usage: js devtools/strings/indexOf.js
+
+function makeText(len) {
+    var chunk = "lorem ipsum dolor sit amet, consectetur adipiscing elit ";
+    var s = "";
+    while (s.length < len)
+        s += chunk;
+    return s.substr(0, len);
+}
+
+function bench(name, text, needle, iterations) {
+    var haystack = text + needle;
+    var result = 0;
+    var t0 = dateNow();
+    for (var i = 0; i < iterations; i++)
+        result += haystack.indexOf(needle);
+    var elapsed = dateNow() - t0;
+    var mbs = (haystack.length * 2 * iterations) / (elapsed / 1000) / (1024 * 1024);
+    print(name + ": " + elapsed.toFixed(1) + " ms, " + mbs.toFixed(0) + " MB/s");
+    return result;
+}
+
+var needles = {
+    "1 char": "Z",
+    "4 chars": "ZQXW",
+    "16 chars": "needle-ZQXW-0123",
+    "64 chars": Array(5).join("needle-ZQXW-0123").substr(0, 64),
+    "300 chars": Array(20).join("needle-ZQXW-0123").substr(0, 300)
+};
+
+var haystacks = [
+    ["64 B", makeText(64), 200000],
+    ["4 KB", makeText(4096), 5000],
+    ["1 MB", makeText(1024 * 1024), 20]
+];
+
+for (var h = 0; h < haystacks.length; h++) {
+    for (var n in needles)
+        bench("indexOf " + haystacks[h][0] + " haystack, " + n + " needle",
+              haystacks[h][1], needles[n], haystacks[h][2]);
+}
+
+var log = makeText(4 * 1024 * 1024);
+var t0 = dateNow();
+var parts = log.split("elit ");
+print("split 4 MB: " + (dateNow() - t0).toFixed(1) + " ms, " + parts.length + " parts");
+
+t0 = dateNow();
+var replaced = log.replace("adipiscing elit ZZZ", "x");
+print("replace (no match) 4 MB: " + (dateNow() - t0).toFixed(1) + " ms");
@@ -12,6 +12,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#if defined(JS_THREADSAFE) && defined(_MSC_VER)
+# include <intrin.h>
+#endif
 
 #include "jspubtd.h"
 #include "jstypes.h"
@@ -96,6 +99,9 @@ struct Cell
     inline AllocKind tenuredGetAllocKind() const;
     MOZ_ALWAYS_INLINE bool isMarked(uint32_t color = BLACK) const;
     MOZ_ALWAYS_INLINE bool markIfUnmarked(uint32_t color = BLACK) const;
+#ifdef JS_THREADSAFE
+    MOZ_ALWAYS_INLINE bool markIfUnmarkedAtomic(uint32_t color = BLACK) const;
+#endif
     MOZ_ALWAYS_INLINE void unmark(uint32_t color) const;
 
     inline JSRuntime *runtimeFromMainThread() const;
@@ -713,6 +719,39 @@ struct ChunkBitmap
         return true;
     }
 
+#ifdef JS_THREADSAFE
+    /*
+     * Like markIfUnmarked, but safe to race with other threads marking cells
+     * whose bits share the same word. Only the thread which sets the bit gets
+     * true back, so every cell is scanned once during parallel marking.
+     */
+    MOZ_ALWAYS_INLINE bool markIfUnmarkedAtomic(const Cell *cell, uint32_t color) {
+        uintptr_t *word, mask;
+        getMarkWordAndMask(cell, BLACK, &word, &mask);
+        if ((*word & mask) || (AtomicFetchOr(word, mask) & mask))
+            return false;
+        if (color != BLACK) {
+            getMarkWordAndMask(cell, color, &word, &mask);
+            if (AtomicFetchOr(word, mask) & mask)
+                return false;
+        }
+        return true;
+    }
+
+  private:
+    static MOZ_ALWAYS_INLINE uintptr_t AtomicFetchOr(uintptr_t *word, uintptr_t mask) {
+# if defined(_MSC_VER) && JS_BITS_PER_WORD == 64
+        return _InterlockedOr64(reinterpret_cast<volatile __int64 *>(word), mask);
+# elif defined(_MSC_VER)
+        return _InterlockedOr(reinterpret_cast<volatile long *>(word), mask);
+# else
+        return __sync_fetch_and_or(word, mask);
+# endif
+    }
+
+  public:
+#endif
+
     MOZ_ALWAYS_INLINE void unmark(const Cell *cell, uint32_t color) {
         uintptr_t *word, mask;
         getMarkWordAndMask(cell, color, &word, &mask);
@@ -1009,6 +1048,16 @@ Cell::markIfUnmarked(uint32_t color /* = BLACK */) const
     return chunk()->bitmap.markIfUnmarked(this, color);
 }
 
+#ifdef JS_THREADSAFE
+bool
+Cell::markIfUnmarkedAtomic(uint32_t color /* = BLACK */) const
+{
+    JS_ASSERT(isTenured());
+    AssertValidColor(this, color);
+    return chunk()->bitmap.markIfUnmarkedAtomic(this, color);
+}
+#endif
+
 void
 Cell::unmark(uint32_t color) const
 {
@@ -8,6 +8,7 @@
 
 #include "mozilla/DebugOnly.h"
 
+#include "gc/ParallelMarking.h"
 #include "jit/IonCode.h"
 #include "js/SliceBudget.h"
 #include "vm/ArgumentsObject.h"
@@ -130,6 +131,13 @@ CheckMarkedThing(JSTracer *trc, T *thing)
     if (IsInsideNursery(trc->runtime, thing))
         return;
 
+    /* Nor in the old location of an object moved by a compacting GC. */
+    if (MapTypeToTraceKind<T>::kind == JSTRACE_OBJECT && trc->runtime->gcIsCompacting &&
+        IsForwarded(thing))
+    {
+        return;
+    }
+
     JS_ASSERT(thing->zone());
     JS_ASSERT(thing->zone()->runtimeFromMainThread() == trc->runtime);
     JS_ASSERT(trc->debugPrinter || trc->debugPrintArg);
@@ -757,13 +765,45 @@ gc::IsCellAboutToBeFinalized(Cell **thingp)
     JS_ASSERT((thing)->zone()->isGCMarking() ||                         \
               (rt)->isAtomsZone((thing)->zone()));
 
+/*
+ * Set the mark bit of |thing| and return whether it was unmarked. Parallel
+ * markers race to mark the same things, so they set the bits atomically.
+ */
+template <typename T>
+static MOZ_ALWAYS_INLINE bool
+MarkIfUnmarked(GCMarker *gcmarker, T *thing, uint32_t color)
+{
+#ifdef JS_THREADSAFE
+    if (JS_UNLIKELY(gcmarker->isMarkingInParallel()))
+        return thing->markIfUnmarkedAtomic(color);
+#endif
+    return thing->markIfUnmarked(color);
+}
+
+/*
+ * Helper markers leave the tracing of things which may not be traced off the
+ * main thread -- those with trace hooks, scripts and JIT code -- to the main
+ * thread. Return whether |thing| was handed over.
+ */
+static inline bool
+MaybeDeferToMainThread(GCMarker *gcmarker, Cell *thing, JSGCTraceKind kind)
+{
+#ifdef JS_THREADSAFE
+    if (gcmarker->isParallelHelper()) {
+        gcmarker->deferToMainThread(thing, kind);
+        return true;
+    }
+#endif
+    return false;
+}
+
 static void
 PushMarkStack(GCMarker *gcmarker, ObjectImpl *thing)
 {
     JS_COMPARTMENT_ASSERT(gcmarker->runtime, thing);
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         gcmarker->pushObject(thing);
 }
 
@@ -781,7 +821,7 @@ MaybePushMarkStackBetweenSlices(GCMarker *gcmarker, JSObject *thing)
     JS_COMPARTMENT_ASSERT(rt, thing);
     JS_ASSERT_IF(rt->isHeapBusy(), !IsInsideNursery(rt, thing));
 
-    if (!IsInsideNursery(rt, thing) && thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (!IsInsideNursery(rt, thing) && MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         gcmarker->pushObject(thing);
 }
 
@@ -791,7 +831,7 @@ PushMarkStack(GCMarker *gcmarker, JSFunction *thing)
     JS_COMPARTMENT_ASSERT(gcmarker->runtime, thing);
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         gcmarker->pushObject(thing);
 }
 
@@ -801,7 +841,7 @@ PushMarkStack(GCMarker *gcmarker, types::TypeObject *thing)
     JS_COMPARTMENT_ASSERT(gcmarker->runtime, thing);
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         gcmarker->pushType(thing);
 }
 
@@ -816,8 +856,11 @@ PushMarkStack(GCMarker *gcmarker, JSScript *thing)
      * refer to other scripts only indirectly (like via nested functions) and
      * we cannot get to deep recursion.
      */
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()) &&
+        !MaybeDeferToMainThread(gcmarker, thing, JSTRACE_SCRIPT))
+    {
         MarkChildren(gcmarker, thing);
+    }
 }
 
 static void
@@ -830,8 +873,11 @@ PushMarkStack(GCMarker *gcmarker, LazyScript *thing)
      * We mark lazy scripts directly rather than pushing on the stack as they
      * only refer to normal scripts and to strings, and cannot recurse.
      */
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()) &&
+        !MaybeDeferToMainThread(gcmarker, thing, JSTRACE_LAZY_SCRIPT))
+    {
         MarkChildren(gcmarker, thing);
+    }
 }
 
 static void
@@ -844,7 +890,7 @@ PushMarkStack(GCMarker *gcmarker, Shape *thing)
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
     /* We mark shapes directly rather than pushing on the stack. */
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         ScanShape(gcmarker, thing);
 }
 
@@ -854,7 +900,7 @@ PushMarkStack(GCMarker *gcmarker, jit::JitCode *thing)
     JS_COMPARTMENT_ASSERT(gcmarker->runtime, thing);
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         gcmarker->pushJitCode(thing);
 }
 
@@ -868,7 +914,7 @@ PushMarkStack(GCMarker *gcmarker, BaseShape *thing)
     JS_ASSERT(!IsInsideNursery(gcmarker->runtime, thing));
 
     /* We mark base shapes directly rather than pushing on the stack. */
-    if (thing->markIfUnmarked(gcmarker->getMarkColor()))
+    if (MarkIfUnmarked(gcmarker, thing, gcmarker->getMarkColor()))
         ScanBaseShape(gcmarker, thing);
 }
 
@@ -885,7 +931,7 @@ ScanShape(GCMarker *gcmarker, Shape *shape)
         PushMarkStack(gcmarker, JSID_TO_OBJECT(id));
 
     shape = shape->previous();
-    if (shape && shape->markIfUnmarked(gcmarker->getMarkColor()))
+    if (shape && MarkIfUnmarked(gcmarker, shape, gcmarker->getMarkColor()))
         goto restart;
 }
 
@@ -919,7 +965,7 @@ ScanBaseShape(GCMarker *gcmarker, BaseShape *base)
     if (base->isOwned()) {
         UnownedBaseShape *unowned = base->baseUnowned();
         JS_ASSERT(base->compartment() == unowned->compartment());
-        unowned->markIfUnmarked(gcmarker->getMarkColor());
+        MarkIfUnmarked(gcmarker, unowned, gcmarker->getMarkColor());
     }
 }
 
@@ -938,7 +984,7 @@ ScanLinearString(GCMarker *gcmarker, JSLinearString *str)
         str = str->base();
         JS_ASSERT(str->JSString::isLinear());
         JS_COMPARTMENT_ASSERT_STR(gcmarker->runtime, str);
-        if (!str->markIfUnmarked())
+        if (!MarkIfUnmarked(gcmarker, str, BLACK))
             break;
     }
 }
@@ -965,7 +1011,7 @@ ScanRope(GCMarker *gcmarker, JSRope *rope)
         JSRope *next = nullptr;
 
         JSString *right = rope->rightChild();
-        if (right->markIfUnmarked()) {
+        if (MarkIfUnmarked(gcmarker, right, BLACK)) {
             if (right->isLinear())
                 ScanLinearString(gcmarker, &right->asLinear());
             else
@@ -973,7 +1019,7 @@ ScanRope(GCMarker *gcmarker, JSRope *rope)
         }
 
         JSString *left = rope->leftChild();
-        if (left->markIfUnmarked()) {
+        if (MarkIfUnmarked(gcmarker, left, BLACK)) {
             if (left->isLinear()) {
                 ScanLinearString(gcmarker, &left->asLinear());
             } else {
@@ -1017,7 +1063,7 @@ PushMarkStack(GCMarker *gcmarker, JSString *str)
      * using the explicit stack when navigating the rope tree to avoid
      * dealing with strings on the stack in drainMarkStack.
      */
-    if (str->markIfUnmarked())
+    if (MarkIfUnmarked(gcmarker, str, BLACK))
         ScanString(gcmarker, str);
 }
 
@@ -1348,7 +1394,9 @@ GCMarker::processMarkStackOther(uintptr_t tag, uintptr_t addr)
         else
             pushObject(obj);
     } else if (tag == JitCodeTag) {
-        MarkChildren(this, reinterpret_cast<jit::JitCode *>(addr));
+        jit::JitCode *code = reinterpret_cast<jit::JitCode *>(addr);
+        if (!MaybeDeferToMainThread(this, code, JSTRACE_JITCODE))
+            MarkChildren(this, code);
     }
 }
 
@@ -1397,13 +1445,13 @@ GCMarker::processMarkStackTop(SliceBudget &budget)
             JSString *str = v.toString();
             JS_COMPARTMENT_ASSERT_STR(runtime, str);
             JS_ASSERT(runtime->isAtomsZone(str->zone()) || str->zone() == obj->zone());
-            if (str->markIfUnmarked())
+            if (MarkIfUnmarked(this, str, BLACK))
                 ScanString(this, str);
         } else if (v.isObject()) {
             JSObject *obj2 = &v.toObject();
             JS_COMPARTMENT_ASSERT(runtime, obj2);
             JS_ASSERT(obj->compartment() == obj2->compartment());
-            if (obj2->markIfUnmarked(getMarkColor())) {
+            if (MarkIfUnmarked(this, obj2, getMarkColor())) {
                 pushValueArray(obj, vp, end);
                 obj = obj2;
                 goto scan_obj;
@@ -1423,13 +1471,16 @@ GCMarker::processMarkStackTop(SliceBudget &budget)
         }
 
         types::TypeObject *type = obj->typeFromGC();
+        const Class *clasp = type->clasp();
+        if (clasp->trace && MaybeDeferToMainThread(this, obj, JSTRACE_OBJECT))
+            return;
+
         PushMarkStack(this, type);
 
         Shape *shape = obj->lastProperty();
         PushMarkStack(this, shape);
 
         /* Call the trace hook if necessary. */
-        const Class *clasp = type->clasp();
         if (clasp->trace) {
             JS_ASSERT_IF(runtime->gcMode() == JSGC_MODE_INCREMENTAL &&
                          runtime->gcIncrementalEnabled,
@@ -1511,6 +1562,43 @@ GCMarker::drainMarkStack(SliceBudget &budget)
     return true;
 }
 
+#ifdef JS_THREADSAFE
+/*
+ * The loop run by each thread of a parallel marking slice. It returns once
+ * all the markers are out of work, or when some marker ran out of budget, in
+ * which case whatever is left on the stacks is moved back to the runtime's
+ * marker by ParallelMarker::drainMarkStack.
+ */
+void
+GCMarker::drainMarkStackInParallel(SliceBudget &budget)
+{
+    JS_ASSERT(parallelMarker);
+    JS_ASSERT(color == BLACK);
+
+    for (;;) {
+        size_t steps = 0;
+        while (!stack.isEmpty()) {
+            processMarkStackTop(budget);
+            if (budget.isOverBudget()) {
+                parallelMarker->stop();
+                return;
+            }
+
+            if (++steps == ParallelMarker::PollInterval) {
+                steps = 0;
+                if (parallelMarker->isStopped())
+                    return;
+                if (parallelMarker->hasIdleMarkers())
+                    parallelMarker->shareWork(this);
+            }
+        }
+
+        if (!parallelMarker->getWork(this))
+            return;
+    }
+}
+#endif
+
 void
 js::TraceChildren(JSTracer *trc, void *thing, JSGCTraceKind kind)
 {
@@ -394,7 +394,7 @@ struct TenureCount
 // of potential collisions.
 struct Nursery::TenureCountCache
 {
-    TenureCount entries[16];
+    TenureCount entries[32];
 
     TenureCountCache() { PodZero(this); }
 
@@ -626,6 +626,31 @@ CheckHashTablesAfterMovingGC(JSRuntime *rt)
 #endif
 }
 
+/*
+ * Decide whether the allocation site for |entry.type| should allocate its
+ * objects directly in the tenured heap. Sites which count their nursery
+ * allocations are judged by the fraction of their objects which survived to
+ * this collection; this is their allocation count since the last collection
+ * which tenured any of their objects, so the objects which died in between
+ * count against them. Sites which don't count their allocations are only
+ * pretenured if we are promoting the nursery as a whole, or exhausted the
+ * store buffer with pointers to nursery things, which will force a
+ * collection well before the nursery is full.
+ */
+static bool
+ShouldPretenure(const TenureCount &entry, double promotionRate, JS::gcreason::Reason reason)
+{
+    static const int MinTenuredObjects = 100;
+    static const double MinSurvivalRate = 0.8;
+
+    uint32_t allocated = entry.type->takeNurseryAllocCount();
+    if (allocated)
+        return entry.count >= MinTenuredObjects && entry.count >= MinSurvivalRate * allocated;
+
+    return entry.count >= 3000 &&
+           (promotionRate > 0.8 || reason == JS::gcreason::FULL_STORE_BUFFER);
+}
+
 void
 js::Nursery::collect(JSRuntime *rt, JS::gcreason::Reason reason, TypeObjectList *pretenureTypes)
 {
@@ -673,14 +698,13 @@ js::Nursery::collect(JSRuntime *rt, JS::gcreason::Reason reason, TypeObjectList
     else if (promotionRate < 0.01)
         shrinkAllocableSpace();
 
-    // If we are promoting the nursery, or exhausted the store buffer with
-    // pointers to nursery things, which will force a collection well before
-    // the nursery is full, look for object types that are getting promoted
-    // excessively and try to pretenure them.
-    if (pretenureTypes && (promotionRate > 0.8 || reason == JS::gcreason::FULL_STORE_BUFFER)) {
+    // Look for allocation sites whose objects are getting promoted
+    // excessively and try to pretenure them, so that we stop copying their
+    // objects out of the nursery.
+    if (pretenureTypes) {
         for (size_t i = 0; i < ArrayLength(tenureCounts.entries); i++) {
             const TenureCount &entry = tenureCounts.entries[i];
-            if (entry.count >= 3000)
+            if (entry.type && ShouldPretenure(entry, promotionRate, reason))
                 pretenureTypes->append(entry.type); // ignore alloc failure
         }
     }
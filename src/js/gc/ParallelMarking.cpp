@@ -0,0 +1,463 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gc/ParallelMarking.h"
+
+#ifdef JS_THREADSAFE
+
+#include "prmjtime.h"
+
+#include "gc/Marking.h"
+#include "vm/Runtime.h"
+
+using namespace js;
+using namespace js::gc;
+
+/* Helpers hand deferred things to the main thread in batches of this size. */
+static const size_t DeferredBatchLength = 64;
+
+/* Slot arrays at least twice this long are split to be shared. */
+static const size_t MinSharedSlots = 256;
+
+/*
+ * Each thread gets its own copy of the slice budget. Time budgets all end at
+ * the same deadline, while work budgets are divided between the threads.
+ */
+static SliceBudget
+ThreadBudget(const SliceBudget &budget, size_t threads)
+{
+    SliceBudget threadBudget = budget;
+    if (budget.deadline == 0)
+        threadBudget.counter = budget.counter / threads;
+    return threadBudget;
+}
+
+ParallelMarker::ParallelMarker(JSRuntime *rt)
+  : runtime(rt),
+    mainWaitTime(0),
+    mainMarkTime(0),
+    activeMarkers(0),
+    mainThreadActive(false),
+    done(false),
+    idleMarkers(0),
+    stopped(0)
+{
+}
+
+ParallelMarker::~ParallelMarker()
+{
+    for (size_t i = 0; i < helpers.length(); i++)
+        js_delete(helpers[i]);
+    JS_ASSERT(packets.empty());
+}
+
+bool
+ParallelMarker::init()
+{
+    if (!Monitor::init())
+        return false;
+
+    uint32_t count = runtime->threadPool.numWorkers();
+    if (!helpers.reserve(count))
+        return false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        Helper *helper = js_new<Helper>(runtime);
+        if (!helper || !helper->init(runtime->gcMode())) {
+            js_delete(helper);
+            return false;
+        }
+        helper->parallelHelper = true;
+
+        /*
+         * Helpers are never stopped, as GCMarker::stop also discards the
+         * runtime's buffered gray roots.
+         */
+        helper->start();
+        helpers.infallibleAppend(helper);
+    }
+    return true;
+}
+
+bool
+ParallelMarker::drainMarkStack(SliceBudget &budget)
+{
+    GCMarker *marker = &runtime->gcMarker;
+    JS_ASSERT(marker->getMarkColor() == BLACK);
+
+    if (budget.isOverBudget())
+        return false;
+
+    for (;;) {
+        while (!marker->stack.isEmpty()) {
+            if (!markInParallel(budget)) {
+                marker->saveValueRanges();
+                return false;
+            }
+        }
+
+        if (!marker->hasDelayedChildren())
+            break;
+
+        /* Arenas whose marking overflowed the stacks are marked serially. */
+        if (!marker->markDelayedChildren(budget)) {
+            marker->saveValueRanges();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Run the markers on all threads until they run out of work or budget, then
+ * move anything left over back to the runtime's marker. Return false if the
+ * slice is over budget.
+ */
+bool
+ParallelMarker::markInParallel(SliceBudget &budget)
+{
+    GCMarker *marker = &runtime->gcMarker;
+    size_t threads = helpers.length() + 1;
+
+    mainBudget = ThreadBudget(budget, threads);
+    mainWaitTime = mainMarkTime = 0;
+    marker->parallelMarker = this;
+    for (size_t i = 0; i < helpers.length(); i++) {
+        Helper *helper = helpers[i];
+        JS_ASSERT(helper->isDrained());
+        if (helper->maxCapacity() != marker->maxCapacity())
+            helper->setMaxCapacity(marker->maxCapacity());
+        helper->budget = mainBudget;
+        helper->waitTime = helper->markTime = 0;
+        helper->parallelMarker = this;
+    }
+
+    activeMarkers = 0;
+    mainThreadActive = false;
+    done = false;
+    idleMarkers = 0;
+    stopped = 0;
+
+    ParallelResult result = runtime->threadPool.executeJob(nullptr, this, threads);
+
+    marker->parallelMarker = nullptr;
+    for (size_t i = 0; i < helpers.length(); i++) {
+        Helper *helper = helpers[i];
+        helper->parallelMarker = nullptr;
+        pushItems(marker, helper->stack.stack_, helper->stack.tos_);
+        helper->stack.reset();
+        traceDeferred(marker, helper->deferred);
+    }
+    for (size_t i = 0; i < packets.length(); i++) {
+        pushItems(marker, packets[i].items, packets[i].items + packets[i].length);
+        js_free(packets[i].items);
+    }
+    packets.clear();
+    traceDeferred(marker, deferred);
+
+    /* If the worker threads could not be started, mark on this thread. */
+    if (result != TP_SUCCESS)
+        return marker->drainMarkStack(budget);
+
+    runtime->gcStats.addMarkThreadTime(0, mainMarkTime);
+    for (size_t i = 0; i < helpers.length(); i++)
+        runtime->gcStats.addMarkThreadTime(i + 1, helpers[i]->markTime);
+
+    if (stopped) {
+        /* One of the threads ran out of budget, which ends the slice. */
+        budget.step(budget.counter + 1);
+        JS_ASSERT(budget.isOverBudget());
+        return false;
+    }
+
+    if (budget.deadline == 0) {
+        /* Charge the work done by all the threads to a work budget. */
+        intptr_t initial = ThreadBudget(budget, threads).counter;
+        intptr_t work = initial - mainBudget.counter;
+        for (size_t i = 0; i < helpers.length(); i++)
+            work += initial - helpers[i]->budget.counter;
+        budget.step(work);
+    }
+    return true;
+}
+
+bool
+ParallelMarker::executeFromWorker(uint16_t sliceId, uint32_t workerId, uintptr_t stackLimit)
+{
+    JS_ASSERT(workerId < helpers.length());
+    Helper *helper = helpers[workerId];
+
+    /* A worker which cannot be set up leaves the work to the others. */
+    PerThreadData thisThread(runtime);
+    if (!thisThread.init())
+        return true;
+#ifdef DEBUG
+    thisThread.gcMarkingHelper = true;
+#endif
+    TlsPerThreadData.set(&thisThread);
+
+    run(helper, helper->budget, &helper->markTime);
+
+    TlsPerThreadData.set(nullptr);
+    return true;
+}
+
+bool
+ParallelMarker::executeFromMainThread(uint16_t sliceId)
+{
+    run(&runtime->gcMarker, mainBudget, &mainMarkTime);
+    return true;
+}
+
+void
+ParallelMarker::run(GCMarker *marker, SliceBudget &budget, int64_t *markTime)
+{
+    /* A thread which steals another's slice after finishing its own is done. */
+    if (!enter(marker))
+        return;
+
+    int64_t start = PRMJ_Now();
+    int64_t waitTimeBefore = marker->isParallelHelper()
+                             ? static_cast<Helper *>(marker)->waitTime
+                             : mainWaitTime;
+
+    marker->drainMarkStackInParallel(budget);
+
+    int64_t waitTime = (marker->isParallelHelper()
+                        ? static_cast<Helper *>(marker)->waitTime
+                        : mainWaitTime) - waitTimeBefore;
+    *markTime += PRMJ_Now() - start - waitTime;
+}
+
+bool
+ParallelMarker::enter(GCMarker *marker)
+{
+    AutoLockMonitor lock(*this);
+    if (done || stopped)
+        return false;
+
+    activeMarkers++;
+    if (!marker->isParallelHelper())
+        mainThreadActive = true;
+    return true;
+}
+
+void
+ParallelMarker::stop()
+{
+    AutoLockMonitor lock(*this);
+    stopped = 1;
+    lock.notifyAll();
+}
+
+void
+ParallelMarker::shareWork(GCMarker *marker)
+{
+    uintptr_t *bottom = marker->stack.stack_;
+    uintptr_t *top = marker->stack.tos_;
+
+    AutoLockMonitor lock(*this);
+
+    /* One packet for each idle marker is enough to get them going again. */
+    if (packets.length() >= idleMarkers)
+        return;
+
+    /*
+     * Share the older half of the stack, whose items are likely to lead to
+     * more marking than the ones we are about to scan.
+     */
+    uintptr_t *split = top;
+    while (split > bottom && size_t(top - split) < size_t(top - bottom) / 2)
+        split -= GCMarker::stackItemLength(split[-1]);
+    JS_ASSERT(split >= bottom);
+
+    if (split == bottom) {
+        if (!splitValueArray(marker))
+            return;
+    } else {
+        if (!addPacket(bottom, split))
+            return;
+        size_t kept = top - split;
+        memmove(bottom, split, kept * sizeof(uintptr_t));
+        marker->stack.tos_ = bottom + kept;
+    }
+
+    lock.notifyAll();
+}
+
+/*
+ * When the stack's top item is all there is to share, share the upper half of
+ * its slots if it is a long slot array. Called with the lock held.
+ */
+bool
+ParallelMarker::splitValueArray(GCMarker *marker)
+{
+    uintptr_t *top = marker->stack.tos_;
+    if (top - marker->stack.stack_ < 3 ||
+        (top[-1] & GCMarker::StackTagMask) != GCMarker::ValueArrayTag)
+    {
+        return false;
+    }
+
+    HeapSlot *end = reinterpret_cast<HeapSlot *>(top[-3]);
+    HeapSlot *start = reinterpret_cast<HeapSlot *>(top[-2]);
+    if (size_t(end - start) < 2 * MinSharedSlots)
+        return false;
+
+    HeapSlot *middle = start + (end - start) / 2;
+    uintptr_t item[3] = {
+        reinterpret_cast<uintptr_t>(end),
+        reinterpret_cast<uintptr_t>(middle),
+        top[-1]
+    };
+    if (!addPacket(item, item + 3))
+        return false;
+
+    top[-3] = reinterpret_cast<uintptr_t>(middle);
+    return true;
+}
+
+/* Called with the lock held. */
+bool
+ParallelMarker::addPacket(const uintptr_t *begin, const uintptr_t *end)
+{
+    size_t length = end - begin;
+    uintptr_t *items = js_pod_malloc<uintptr_t>(length);
+    if (!items)
+        return false;
+
+    mozilla::PodCopy(items, begin, length);
+    Packet packet = { items, length };
+    if (!packets.append(packet)) {
+        js_free(items);
+        return false;
+    }
+    return true;
+}
+
+bool
+ParallelMarker::getWork(GCMarker *marker)
+{
+    Helper *helper = marker->isParallelHelper() ? static_cast<Helper *>(marker) : nullptr;
+    int64_t &waitTime = helper ? helper->waitTime : mainWaitTime;
+
+    Packet packet = { nullptr, 0 };
+    DeferredVector things;
+    {
+        AutoLockMonitor lock(*this);
+
+        if (helper && !helper->deferred.empty()) {
+            flushDeferred(helper);
+            lock.notifyAll();
+        }
+
+        idleMarkers++;
+        for (;;) {
+            if (done || stopped)
+                return false;
+
+            if (!packets.empty()) {
+                packet = packets.popCopy();
+                break;
+            }
+
+            if (!helper && !deferred.empty()) {
+                things.swap(deferred);
+                break;
+            }
+
+            /*
+             * Marking is over when every marker is out of work. Until the main
+             * thread has started, its marker still holds the slice's items.
+             */
+            if (mainThreadActive && idleMarkers == activeMarkers && deferred.empty()) {
+                done = true;
+                lock.notifyAll();
+                return false;
+            }
+
+            int64_t start = PRMJ_Now();
+            lock.wait();
+            waitTime += PRMJ_Now() - start;
+        }
+        idleMarkers--;
+    }
+
+    if (packet.items) {
+        pushItems(marker, packet.items, packet.items + packet.length);
+        js_free(packet.items);
+    }
+    traceDeferred(marker, things);
+    return true;
+}
+
+void
+GCMarker::deferToMainThread(Cell *thing, JSGCTraceKind kind)
+{
+    JS_ASSERT(parallelHelper);
+    parallelMarker->deferToMainThread(this, thing, kind);
+}
+
+void
+ParallelMarker::deferToMainThread(GCMarker *marker, Cell *thing, JSGCTraceKind kind)
+{
+    Helper *helper = static_cast<Helper *>(marker);
+    DeferredThing deferredThing = { thing, kind };
+    if (!helper->deferred.append(deferredThing)) {
+        /* The children of delayed cells are traced on the main thread too. */
+        delayMarkingChildren(thing);
+        return;
+    }
+
+    if (helper->deferred.length() >= DeferredBatchLength) {
+        AutoLockMonitor lock(*this);
+        flushDeferred(helper);
+        lock.notifyAll();
+    }
+}
+
+/* Called with the lock held. */
+void
+ParallelMarker::flushDeferred(Helper *helper)
+{
+    if (!deferred.appendAll(helper->deferred)) {
+        for (size_t i = 0; i < helper->deferred.length(); i++)
+            runtime->gcMarker.delayMarkingCell(helper->deferred[i].thing);
+    }
+    helper->deferred.clear();
+}
+
+void
+ParallelMarker::traceDeferred(GCMarker *marker, DeferredVector &things)
+{
+    JS_ASSERT_IF(!things.empty(), !marker->isParallelHelper());
+    for (size_t i = 0; i < things.length(); i++)
+        TraceChildren(marker, things[i].thing, things[i].kind);
+    things.clear();
+}
+
+void
+ParallelMarker::delayMarkingChildren(const Cell *cell)
+{
+    AutoLockMonitor lock(*this);
+    runtime->gcMarker.delayMarkingCell(cell);
+}
+
+void
+ParallelMarker::pushItems(GCMarker *marker, const uintptr_t *begin, const uintptr_t *end)
+{
+    if (marker->stack.pushRange(begin, end))
+        return;
+
+    /* If the stack is full, delay marking the things the items refer to. */
+    for (const uintptr_t *p = end; p > begin; p -= GCMarker::stackItemLength(p[-1])) {
+        uintptr_t addr = p[-1] & ~GCMarker::StackTagMask;
+        marker->delayMarkingChildren(reinterpret_cast<Cell *>(addr));
+    }
+}
+
+#endif /* JS_THREADSAFE */
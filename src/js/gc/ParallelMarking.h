@@ -0,0 +1,148 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef gc_ParallelMarking_h
+#define gc_ParallelMarking_h
+
+#ifdef JS_THREADSAFE
+
+#include "mozilla/Atomics.h"
+
+#include "jsalloc.h"
+#include "jsgc.h"
+
+#include "js/Vector.h"
+#include "vm/Monitor.h"
+#include "vm/ThreadPool.h"
+
+namespace js {
+namespace gc {
+
+/*
+ * Parallel marking.
+ *
+ * With JSGC_PARALLEL_MARKING set, black mark slices are run by the runtime's
+ * GCMarker together with a helper GCMarker for each worker thread of the
+ * runtime's ThreadPool. Every marker drains its own mark stack. Markers which
+ * run out of work go idle, and a busy marker which notices idle markers moves
+ * the older half of its stack -- or half of a large slot array -- into a
+ * shared pool of packets from which the idle markers take their next items.
+ *
+ * Mark bits are set atomically while marking in parallel, so each cell is
+ * still scanned once. Helpers only do the scanning that is done inline by
+ * Marking.cpp. Anything which needs a trace hook, and scripts and JIT code,
+ * are handed back to the main thread, which traces them as it would outside
+ * parallel marking.
+ *
+ * The threads share the slice budget. When one runs out, all the markers
+ * stop and the items left on their stacks and in the pool are moved back to
+ * the runtime's marker, which is where barriers push items between slices.
+ * Gray marking always runs on the main thread.
+ */
+class ParallelMarker : public ParallelJob, public Monitor
+{
+  public:
+    /* How many items markers process between polls of the shared state. */
+    static const size_t PollInterval = 256;
+
+    explicit ParallelMarker(JSRuntime *rt);
+    ~ParallelMarker();
+
+    bool init();
+
+    /* Drain the runtime's mark stack, as GCMarker::drainMarkStack does. */
+    bool drainMarkStack(SliceBudget &budget);
+
+    bool isStopped() const {
+        return stopped != 0;
+    }
+
+    bool hasIdleMarkers() const {
+        return idleMarkers != 0;
+    }
+
+    /* Stop all markers at the end of the slice budget. */
+    void stop();
+
+    /* Move some of |marker|'s items into the pool for idle markers. */
+    void shareWork(GCMarker *marker);
+
+    /*
+     * Wait until there is work for |marker|, and return false if all markers
+     * are done or the slice is stopped.
+     */
+    bool getWork(GCMarker *marker);
+
+    void deferToMainThread(GCMarker *helper, Cell *thing, JSGCTraceKind kind);
+    void delayMarkingChildren(const Cell *cell);
+
+    virtual bool executeFromWorker(uint16_t sliceId, uint32_t workerId, uintptr_t stackLimit);
+    virtual bool executeFromMainThread(uint16_t sliceId);
+
+  private:
+    struct DeferredThing
+    {
+        Cell *thing;
+        JSGCTraceKind kind;
+    };
+
+    typedef Vector<DeferredThing, 0, SystemAllocPolicy> DeferredVector;
+
+    /* A run of whole mark stack items shared by a busy marker. */
+    struct Packet
+    {
+        uintptr_t *items;
+        size_t length;
+    };
+
+    /* The marker run on a worker thread, and its state for the current slice. */
+    struct Helper : public GCMarker
+    {
+        explicit Helper(JSRuntime *rt) : GCMarker(rt), waitTime(0), markTime(0) {}
+
+        /* Things left for the main thread, not yet moved to the shared list. */
+        DeferredVector deferred;
+
+        SliceBudget budget;
+        int64_t waitTime;
+        int64_t markTime;
+    };
+
+    JSRuntime *runtime;
+    Vector<Helper *, 0, SystemAllocPolicy> helpers;
+
+    /* The main thread's share of the budget of the current slice. */
+    SliceBudget mainBudget;
+    int64_t mainWaitTime;
+    int64_t mainMarkTime;
+
+    /* The following are protected by the lock. */
+    Vector<Packet, 0, SystemAllocPolicy> packets;
+    DeferredVector deferred;
+    uint32_t activeMarkers;
+    bool mainThreadActive;
+    bool done;
+
+    mozilla::Atomic<uint32_t, mozilla::Relaxed> idleMarkers;
+    mozilla::Atomic<uint32_t, mozilla::Relaxed> stopped;
+
+    bool markInParallel(SliceBudget &budget);
+    void run(GCMarker *marker, SliceBudget &budget, int64_t *markTime);
+    bool enter(GCMarker *marker);
+
+    void flushDeferred(Helper *helper);
+    void traceDeferred(GCMarker *marker, DeferredVector &things);
+    void pushItems(GCMarker *marker, const uintptr_t *begin, const uintptr_t *end);
+    bool splitValueArray(GCMarker *marker);
+    bool addPacket(const uintptr_t *begin, const uintptr_t *end);
+};
+
+} /* namespace gc */
+} /* namespace js */
+
+#endif /* JS_THREADSAFE */
+
+#endif /* gc_ParallelMarking_h */
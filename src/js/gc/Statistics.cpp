@@ -308,6 +308,9 @@ static const PhaseInfo phases[] = {
     { PHASE_SWEEP_JITCODE, "Sweep JIT code", PHASE_SWEEP },
     { PHASE_FINALIZE_END, "Finalize End Callback", PHASE_SWEEP },
     { PHASE_DESTROY, "Deallocate", PHASE_SWEEP },
+    { PHASE_COMPACT, "Compact", PHASE_NO_PARENT },
+    { PHASE_COMPACT_MOVE, "Compact Move", PHASE_COMPACT },
+    { PHASE_COMPACT_UPDATE, "Compact Update", PHASE_COMPACT },
     { PHASE_GC_END, "End Callback", PHASE_NO_PARENT },
     { PHASE_LIMIT, nullptr, PHASE_NO_PARENT }
 };
@@ -321,6 +324,22 @@ FormatPhaseTimes(StatisticsSerializer &ss, const char *name, int64_t *times)
     ss.endObject();
 }
 
+static void
+FormatMarkThreadTimes(StatisticsSerializer &ss, const char *name, const int64_t *times,
+                      size_t length)
+{
+    ss.beginObject(name);
+    for (size_t i = 0; i < length; i++) {
+        char threadName[32];
+        if (i == 0)
+            JS_snprintf(threadName, sizeof(threadName), "Main Thread");
+        else
+            JS_snprintf(threadName, sizeof(threadName), "Helper %u", unsigned(i));
+        ss.appendDecimal(threadName, "ms", t(times[i]));
+    }
+    ss.endObject();
+}
+
 void
 Statistics::gcDuration(int64_t *total, int64_t *maxPause)
 {
@@ -376,6 +395,8 @@ Statistics::formatData(StatisticsSerializer &ss, uint64_t timestamp)
     ss.appendNumber("Allocated", "%u", "MB", unsigned(preBytes / 1024 / 1024));
     ss.appendNumber("+Chunks", "%d", "", counts[STAT_NEW_CHUNK]);
     ss.appendNumber("-Chunks", "%d", "", counts[STAT_DESTROY_CHUNK]);
+    if (counts[STAT_ARENA_RELOCATED] || ss.isJSON())
+        ss.appendNumber("Relocated Arenas", "%d", "", counts[STAT_ARENA_RELOCATED]);
     ss.endLine();
 
     if (slices.length() > 1 || ss.isJSON()) {
@@ -411,6 +432,12 @@ Statistics::formatData(StatisticsSerializer &ss, uint64_t timestamp)
         }
         ss.endArray();
     }
+    if (!markThreadTimes.empty()) {
+        ss.extra("    Parallel Mark: ");
+        FormatMarkThreadTimes(ss, "Parallel Mark", markThreadTimes.begin(),
+                              markThreadTimes.length());
+        ss.endLine();
+    }
     ss.extra("    Totals: ");
     FormatPhaseTimes(ss, "Totals", phaseTimes);
     ss.endObject();
@@ -519,6 +546,7 @@ Statistics::beginGC()
 
     slices.clearAndFree();
     sccTimes.clearAndFree();
+    markThreadTimes.clearAndFree();
     nonincrementalReason = nullptr;
 
     preBytes = runtime->gcBytes;
@@ -658,6 +686,15 @@ Statistics::endSCC(unsigned scc, int64_t start)
     sccTimes[scc] += PRMJ_Now() - start;
 }
 
+void
+Statistics::addMarkThreadTime(unsigned thread, int64_t time)
+{
+    if (thread >= markThreadTimes.length() && !markThreadTimes.resize(thread + 1))
+        return;
+
+    markThreadTimes[thread] += time;
+}
+
 /*
  * MMU (minimum mutator utilization) is a measure of how much garbage collection
  * is affecting the responsiveness of the system. MMU measurements are given
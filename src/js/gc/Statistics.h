@@ -60,6 +60,9 @@ enum Phase {
     PHASE_SWEEP_JITCODE,
     PHASE_FINALIZE_END,
     PHASE_DESTROY,
+    PHASE_COMPACT,
+    PHASE_COMPACT_MOVE,
+    PHASE_COMPACT_UPDATE,
     PHASE_GC_END,
 
     PHASE_LIMIT
@@ -68,6 +71,7 @@ enum Phase {
 enum Stat {
     STAT_NEW_CHUNK,
     STAT_DESTROY_CHUNK,
+    STAT_ARENA_RELOCATED,
 
     STAT_LIMIT
 };
@@ -95,6 +99,12 @@ struct Statistics {
     int64_t beginSCC();
     void endSCC(unsigned scc, int64_t start);
 
+    /*
+     * Record time spent marking by one of the threads of a parallel marking
+     * slice. Thread 0 is the main thread.
+     */
+    void addMarkThreadTime(unsigned thread, int64_t time);
+
     jschar *formatMessage();
     jschar *formatJSON(uint64_t timestamp);
 
@@ -160,6 +170,9 @@ struct Statistics {
     /* Sweep times for SCCs of compartments. */
     Vector<int64_t, 0, SystemAllocPolicy> sccTimes;
 
+    /* Time each thread spent marking in parallel marking slices. */
+    Vector<int64_t, 0, SystemAllocPolicy> markThreadTimes;
+
     void beginGC();
     void endGC();
 
@@ -0,0 +1,93 @@
+if (!this.hasOwnProperty("SIMD"))
+  quit();
+
+setJitCompilerOption("ion.usecount.trigger", 30);
+
+// Every SIMD operation Ion compiles inline must give exactly the results of
+// the interpreter. Each case is run until it is compiled, and its results
+// are compared lane by lane with those of the first, interpreted, run.
+
+var float32x4 = SIMD.float32x4;
+var int32x4 = SIMD.int32x4;
+
+var fa = float32x4(-0, 1.5, NaN, -Infinity);
+var fb = float32x4(0, -2.25, 3, NaN);
+var fc = float32x4(-3.75, 1e30, -1e-30, 7);
+var ia = int32x4(0, -1, 0x7fffffff, -0x80000000);
+var ib = int32x4(5, 0x55555555, 1, -1);
+var mask = int32x4(-1, 0, 0, -1);
+
+function lanes(v) {
+  return [v.x, v.y, v.z, v.w];
+}
+
+function check(name, fn) {
+  var expected = lanes(fn());
+  for (var i = 0; i < 150; i++) {
+    var actual = lanes(fn());
+    for (var j = 0; j < 4; j++)
+      assertEq(actual[j], expected[j], name + " lane " + j);
+  }
+}
+
+check("f.add", function() { return float32x4.add(fa, fc); });
+check("f.sub", function() { return float32x4.sub(fa, fc); });
+check("f.mul", function() { return float32x4.mul(fc, fb); });
+check("f.div", function() { return float32x4.div(fc, fa); });
+check("f.min", function() { return float32x4.min(fa, fb); });
+check("f.max", function() { return float32x4.max(fb, fa); });
+check("f.abs", function() { return float32x4.abs(fa); });
+check("f.neg", function() { return float32x4.neg(fc); });
+check("f.reciprocal", function() { return float32x4.reciprocal(fa); });
+check("f.sqrt", function() { return float32x4.sqrt(fc); });
+check("f.scale", function() { return float32x4.scale(fc, 0.1); });
+check("f.clamp", function() { return float32x4.clamp(fc, fa, fb); });
+check("f.lessThan", function() { return float32x4.lessThan(fa, fb); });
+check("f.lessThanOrEqual", function() { return float32x4.lessThanOrEqual(fa, fb); });
+check("f.greaterThan", function() { return float32x4.greaterThan(fc, fb); });
+check("f.greaterThanOrEqual", function() { return float32x4.greaterThanOrEqual(fa, fb); });
+check("f.equal", function() { return float32x4.equal(fa, fb); });
+check("f.notEqual", function() { return float32x4.notEqual(fa, fb); });
+check("f.shuffle", function() { return float32x4.shuffle(fc, 0x1b); });
+check("f.shuffleMix", function() { return float32x4.shuffleMix(fc, fb, 0x4e); });
+check("f.toInt32x4", function() { return float32x4.toInt32x4(fc); });
+check("f.bitsToInt32x4", function() { return float32x4.bitsToInt32x4(fc); });
+check("f.zero", function() { return float32x4.zero(); });
+check("f.splat", function() { return float32x4.splat(1.1); });
+
+check("i.add", function() { return int32x4.add(ia, ib); });
+check("i.sub", function() { return int32x4.sub(ia, ib); });
+check("i.and", function() { return int32x4.and(ia, ib); });
+check("i.or", function() { return int32x4.or(ia, ib); });
+check("i.xor", function() { return int32x4.xor(ia, ib); });
+check("i.not", function() { return int32x4.not(ia); });
+check("i.neg", function() { return int32x4.neg(ia); });
+check("i.shuffle", function() { return int32x4.shuffle(ib, 0xe4); });
+check("i.shuffleMix", function() { return int32x4.shuffleMix(ia, ib, 0x93); });
+check("i.toFloat32x4", function() { return int32x4.toFloat32x4(ib); });
+check("i.bitsToFloat32x4", function() { return int32x4.bitsToFloat32x4(ib); });
+check("i.zero", function() { return int32x4.zero(); });
+check("i.splat", function() { return int32x4.splat(-7); });
+check("i.splat double", function() { return int32x4.splat(4294967297.5); });
+check("i.select", function() { return int32x4.select(mask, fa, fc); });
+
+// Chains of operations keep their intermediate values unboxed.
+check("chain", function() {
+  var t = float32x4.add(fc, fc);
+  t = float32x4.mul(t, float32x4.splat(0.5));
+  return float32x4.toInt32x4(float32x4.max(t, float32x4.sub(t, fc)));
+});
+
+// Results live across a loop and an allocation stay intact.
+function accumulate(n) {
+  var acc = float32x4.zero();
+  var step = float32x4(1, 2, 3, 4);
+  for (var i = 0; i < n; i++)
+    acc = float32x4.add(acc, float32x4.scale(step, i));
+  return acc;
+}
+var sum = lanes(accumulate(1000));
+assertEq(sum[0], 499500);
+assertEq(sum[1], 999000);
+assertEq(sum[2], 1498500);
+assertEq(sum[3], 1998000);
@@ -0,0 +1,73 @@
+// Sorts with recognized numeric comparators must agree with calling the
+// comparator.
+
+function opaque(f) {
+    // Not recognizable as |return a - b| by bytecode.
+    return function (a, b) { var r = f(a, b); return r; };
+}
+
+function check(arr, cmp) {
+    var expected = arr.slice().sort(opaque(cmp)).map(String).join();
+    assertEq(arr.slice().sort(cmp).map(String).join(), expected);
+}
+
+var ints = [];
+var seed = 7;
+for (var i = 0; i < 2000; i++) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    ints.push((seed % 200001) - 100000);
+}
+ints.push(0x7fffffff, -0x80000000, 0, -1);
+
+check(ints, function (a, b) { return a - b; });
+check(ints, function (a, b) { return b - a; });
+check(ints.slice(0, 20), function (a, b) { return a - b; });
+check(ints.slice(0, 20), (a, b) => b - a);
+
+var doubles = ints.map(function (x) { return x / 8; });
+check(doubles, function (a, b) { return a - b; });
+check(doubles, (a, b) => b - a);
+
+// Sorting objects by a numeric property.
+function Point(x, y) { this.x = x; this.y = y; }
+var points = ints.map(function (x, i) { return new Point(x % 50, i); });
+function byX(a, b) { return a.x - b.x; }
+function byXDesc(a, b) { return b.x - a.x; }
+var sorted = points.slice().sort(byX);
+for (var i = 1; i < sorted.length; i++) {
+    assertEq(sorted[i - 1].x <= sorted[i].x, true);
+    // The sort is stable.
+    if (sorted[i - 1].x == sorted[i].x)
+        assertEq(sorted[i - 1].y < sorted[i].y, true);
+}
+assertEq(points.slice().sort(byXDesc).map(function (p) { return p.y; }).join(),
+         points.slice().sort(opaque(byXDesc)).map(function (p) { return p.y; }).join());
+check([[1, 2, 3], [1], [], [4, 5]], function (a, b) { return a.length - b.length; });
+
+// Getters must run on every comparison, so they are not read up front.
+var calls = 0;
+var withGetter = [{ x: 3 }, { x: 1 }, { get x() { calls++; return 2; } }];
+assertEq(withGetter.sort(byX).map(function (o) { return o.x; }).join(), "1,2,3");
+assertEq(calls > 1, true);
+
+// Non-numeric and missing keys fall back to calling the comparator.
+check([{ x: "3" }, { x: 1 }, { x: "2" }].map(function (o) { return o; }), byX);
+var mixed = [{ x: 2 }, { x: NaN }, { x: 1 }, {}];
+assertEq(mixed.slice().sort(byX).map(function (o) { return String(o.x); }).join(),
+         mixed.slice().sort(opaque(byX)).map(function (o) { return String(o.x); }).join());
+assertEq([3, { x: 1 }, 2].sort(byX).length, 3);
+
+// TypedArray.prototype.sort sorts numerically by default.
+var ta = new Int32Array([5, -3, 100, 0, -100000, 7]);
+assertEq(ta.sort(), ta);
+assertEq(Array.prototype.join.call(ta), "-100000,-3,0,5,7,100");
+var u8 = new Uint8ClampedArray([255, 3, 0, 128]);
+assertEq(Array.prototype.join.call(u8.sort()), "0,3,128,255");
+var f64 = new Float64Array([3.5, NaN, -0, 0, -Infinity, 1, NaN, -2]);
+f64.sort();
+assertEq(Array.prototype.map.call(f64, function (x) { return 1 / x === -Infinity ? "-0" : String(x); }).join(),
+         "-Infinity,-2,-0,0,1,3.5,NaN,NaN");
+var f32 = new Float32Array([2, 1, 0.5]);
+assertEq(Array.prototype.join.call(f32.sort(function (a, b) { return b - a; })), "2,1,0.5");
+var sub = new Uint16Array([9, 8, 7, 6, 5]).subarray(1, 4);
+assertEq(Array.prototype.join.call(sub.sort()), "6,7,8");
@@ -0,0 +1,71 @@
+// |jit-test| thread-count: 3
+// Large numeric sorts and typed array copies are split over the ThreadPool;
+// results must match sorting and copying on one thread.
+
+var N = 200000;
+var seed = 1;
+function random() {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed;
+}
+
+function checkSorted(a, lessOrEqual) {
+    for (var i = 1; i < a.length; i++) {
+        if (!lessOrEqual(a[i - 1], a[i]))
+            throw new Error("out of order at " + i + ": " + a[i - 1] + ", " + a[i]);
+    }
+}
+
+// Doubles sorted through a numeric comparator.
+var doubles = [];
+for (var i = 0; i < N; i++)
+    doubles.push(random() / 8);
+var sum = doubles.reduce(function (x, y) { return x + y; });
+doubles.sort(function (a, b) { return a - b; });
+checkSorted(doubles, function (x, y) { return x <= y; });
+assertEq(doubles.reduce(function (x, y) { return x + y; }), sum);
+
+// Sorting objects by a numeric key is stable across the split runs.
+var objects = [];
+for (var i = 0; i < N; i++)
+    objects.push({ key: random() % 100, index: i });
+objects.sort(function (a, b) { return b.key - a.key; });
+checkSorted(objects, function (x, y) {
+    return x.key > y.key || (x.key == y.key && x.index < y.index);
+});
+
+// Typed array default sort.
+var f64 = new Float64Array(N);
+for (var i = 0; i < N; i++)
+    f64[i] = (i % 1000 == 0) ? NaN : (random() % 2001) - 1000;
+f64[1] = -0;
+f64[2] = 0;
+f64.sort();
+checkSorted(f64, function (x, y) { return x < y || x === y || y !== y; });
+assertEq(f64[N - 1] !== f64[N - 1], true);
+var u16 = new Uint16Array(N);
+for (var i = 0; i < N; i++)
+    u16[i] = random();
+u16.sort();
+checkSorted(u16, function (x, y) { return x <= y; });
+
+// Large copies between typed arrays, with and without conversion.
+var src = new Float64Array(N * 4);
+for (var i = 0; i < src.length; i++)
+    src[i] = i - 300000.5;
+var same = new Float64Array(src.length + 10);
+same.set(src, 10);
+var ints = new Int32Array(src.length);
+ints.set(src);
+var clamped = new Uint8ClampedArray(src.length);
+clamped.set(src);
+for (var i = 0; i < src.length; i += 997) {
+    assertEq(same[i + 10], src[i]);
+    assertEq(ints[i], src[i] | 0);
+}
+assertEq(same[9], 0);
+assertEq(ints[src.length - 1], (src.length - 1 - 300000.5) | 0);
+assertEq(clamped[0], 0);
+assertEq(clamped[300100], 100);
+assertEq(clamped[300101], 100);
+assertEq(clamped[src.length - 1], 255);
@@ -0,0 +1,122 @@
+// Atomics operations on each integer array type, their errors, and the
+// results of inlined calls against the interpreter's.
+
+if (typeof SharedArrayBuffer == "undefined")
+    quit();
+
+var sab = new SharedArrayBuffer(64);
+assertEq(sab.byteLength, 64);
+assertEq(Object.prototype.toString.call(sab), "[object SharedArrayBuffer]");
+
+// Views over the same shared memory see each other's writes.
+var i32 = new Int32Array(sab);
+var u8 = new Uint8Array(sab);
+Atomics.store(i32, 0, 0x01020304);
+assertEq(u8[0], 4);
+assertEq(u8[3], 1);
+assertEq(new DataView(sab).getInt32(0, true), 0x01020304);
+
+function testArray(a, min, max) {
+    assertEq(Atomics.store(a, 1, 5), 5);
+    assertEq(Atomics.load(a, 1), 5);
+    assertEq(Atomics.add(a, 1, 3), 5);
+    assertEq(Atomics.sub(a, 1, 2), 8);
+    assertEq(Atomics.and(a, 1, 3), 6);
+    assertEq(Atomics.or(a, 1, 8), 2);
+    assertEq(Atomics.xor(a, 1, 3), 10);
+    assertEq(Atomics.load(a, 1), 9);
+    assertEq(Atomics.compareExchange(a, 1, 1, 7), 9);
+    assertEq(Atomics.compareExchange(a, 1, 9, 7), 9);
+    assertEq(a[1], 7);
+
+    // Results wrap around at the element width.
+    Atomics.store(a, 2, max);
+    assertEq(Atomics.add(a, 2, 1), max);
+    assertEq(a[2], min);
+    assertEq(Atomics.sub(a, 2, 1), min);
+    assertEq(a[2], max);
+}
+
+testArray(new Int8Array(sab), -128, 127);
+testArray(new Uint8Array(sab), 0, 255);
+testArray(new Int16Array(sab), -32768, 32767);
+testArray(new Uint16Array(sab), 0, 65535);
+testArray(new Int32Array(sab), -0x80000000, 0x7fffffff);
+testArray(new Uint32Array(sab), 0, 0xffffffff);
+
+// Plain ArrayBuffers work too.
+testArray(new Int32Array(16), -0x80000000, 0x7fffffff);
+
+function assertThrows(f, ctor) {
+    try {
+        f();
+    } catch (e) {
+        assertEq(e instanceof ctor, true);
+        return;
+    }
+    throw new Error("expected " + ctor.name);
+}
+
+assertThrows(function () { Atomics.load(new Float64Array(sab), 0); }, TypeError);
+assertThrows(function () { Atomics.load(new Uint8ClampedArray(sab), 0); }, TypeError);
+assertThrows(function () { Atomics.load([1, 2], 0); }, TypeError);
+assertThrows(function () { Atomics.load(i32, 16); }, RangeError);
+assertThrows(function () { Atomics.load(i32, -1); }, RangeError);
+assertThrows(function () { Atomics.store(i32, 1.5, 0); }, RangeError);
+assertThrows(function () { Atomics.wait(new Int16Array(sab), 0, 0); }, TypeError);
+assertThrows(function () { new SharedArrayBuffer(-1); }, RangeError);
+
+// Waiting on a value that is not there returns at once, as does a wait that
+// times out.
+Atomics.store(i32, 0, 1);
+assertEq(Atomics.wait(i32, 0, 0), "not-equal");
+assertEq(Atomics.wait(i32, 0, 1, 1), "timed-out");
+assertEq(Atomics.wake(i32, 0), 0);
+
+// Inlined operations must agree with the natives, including on the last
+// iterations, which go out of bounds and bail out.
+function inlined(a, n) {
+    var s = 0;
+    for (var i = 0; i < n; i++) {
+        var j = i & 7;
+        Atomics.store(a, j, i);
+        s += Atomics.load(a, j);
+        s += Atomics.add(a, j, 3);
+        s += Atomics.sub(a, j, 1);
+        s += Atomics.and(a, j, 0x3c);
+        s += Atomics.or(a, j, 0x41);
+        s += Atomics.xor(a, j, 0x5a);
+        s += Atomics.compareExchange(a, j, a[j], i & 0x7f);
+        s += Atomics.compareExchange(a, j, -1, 0);
+        s += a[j];
+    }
+    return s;
+}
+
+var arrays = [Int8Array, Uint8Array, Int16Array, Uint16Array, Int32Array];
+for (var k = 0; k < arrays.length; k++) {
+    var expected = inlined(new arrays[k](new SharedArrayBuffer(64)), 500);
+    var a = new arrays[k](new SharedArrayBuffer(64));
+    for (var i = 0; i < 10; i++)
+        assertEq(inlined(a, 500), expected);
+}
+
+function outOfBounds(a, i) {
+    return Atomics.add(a, i, 1);
+}
+var small = new Int32Array(new SharedArrayBuffer(16));
+for (var i = 0; i < 2000; i++)
+    outOfBounds(small, i & 3);
+assertThrows(function () { outOfBounds(small, 4); }, RangeError);
+assertEq(small[0], 500);
+
+// A clone shares the memory with the original.
+var clone = deserialize(serialize(sab));
+assertEq(clone instanceof SharedArrayBuffer, true);
+assertEq(clone.byteLength, 64);
+Atomics.store(new Int32Array(clone), 3, 42);
+assertEq(i32[3], 42);
+
+var cloned = serialize(sab);
+deserialize(cloned);
+assertThrows(function () { deserialize(cloned); }, Error);
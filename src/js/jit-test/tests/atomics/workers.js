@@ -0,0 +1,35 @@
+// Workers sharing memory through a SharedArrayBuffer: atomic counters and
+// a worker blocking in Atomics.wait until the main thread wakes it.
+
+if (typeof evalInWorker == "undefined" || typeof SharedArrayBuffer == "undefined")
+    quit();
+
+var sab = new SharedArrayBuffer(16);
+var ia = new Int32Array(sab);
+setSharedArrayBuffer(sab);
+
+var WORKERS = 3;
+var ITERATIONS = 10000;
+
+for (var i = 0; i < WORKERS; i++) {
+    evalInWorker("var ia = new Int32Array(getSharedArrayBuffer());" +
+                 "for (var i = 0; i < " + ITERATIONS + "; i++)" +
+                 "    Atomics.add(ia, 0, 1);" +
+                 "Atomics.add(ia, 1, 1);");
+}
+while (Atomics.load(ia, 1) != WORKERS)
+    ;
+assertEq(Atomics.load(ia, 0), WORKERS * ITERATIONS);
+
+// The worker announces that it is about to wait, and reports how the wait
+// ended once woken.
+evalInWorker("var ia = new Int32Array(getSharedArrayBuffer());" +
+             "Atomics.store(ia, 2, 1);" +
+             "var r = Atomics.wait(ia, 2, 1);" +
+             "Atomics.store(ia, 3, r == 'ok' || r == 'not-equal' ? 1 : -1);");
+while (Atomics.load(ia, 2) != 1)
+    ;
+Atomics.store(ia, 2, 0);
+while (Atomics.load(ia, 3) == 0)
+    Atomics.wake(ia, 2);
+assertEq(Atomics.load(ia, 3), 1);
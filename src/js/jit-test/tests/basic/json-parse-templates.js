@@ -0,0 +1,31 @@
+// Objects with the same keys as their predecessor share its shape and type,
+// and that type must still account for every value stored in them.
+
+function sum(records) {
+  var total = 0;
+  for (var i = 0; i < records.length; i++)
+    total += typeof records[i].v === "number" ? records[i].v : records[i].v.length;
+  return total;
+}
+
+var text = [];
+for (var i = 0; i < 3000; i++)
+  text.push('{"k":' + i + ',"v":' + (i < 2000 ? i : i < 2500 ? i + 0.5 : '"' + i + '"') + '}');
+var records = JSON.parse("[" + text.join(",") + "]");
+
+assertEq(sum(records.slice(0, 2000)), 1999000);
+assertEq(sum(records), 1999000 + 1125000 + 500 * 4);
+for (var i = 0; i < records.length; i++)
+  assertEq(records[i].k, i);
+
+// Keys in another order, repeated, or indexed don't reuse the shape.
+var mixed = JSON.parse('[{"a":1,"b":2},{"b":3,"a":4},{"a":5,"a":6},{"1":7,"a":8},{"a":9,"b":10}]');
+assertEq(JSON.stringify(mixed), '[{"a":1,"b":2},{"b":3,"a":4},{"a":6},{"1":7,"a":8},{"a":9,"b":10}]');
+assertEq(Object.keys(mixed[1]).join(), "b,a");
+
+// Nested records at several depths.
+var nested = JSON.parse('[{"p":{"q":[1]}},{"p":{"q":[2]}},{"p":{"q":"x"}},{"p":{"r":3}}]');
+assertEq(JSON.stringify(nested), '[{"p":{"q":[1]}},{"p":{"q":[2]}},{"p":{"q":"x"}},{"p":{"r":3}}]');
+nested[1].p.s = 4;
+delete nested[0].p.q;
+assertEq(JSON.stringify(nested), '[{"p":{}},{"p":{"q":[2],"s":4}},{"p":{"q":"x"}},{"p":{"r":3}}]');
@@ -0,0 +1,80 @@
+// parseJSONStream must produce the same values as JSON.parse, however the
+// input is split into chunks.
+
+function collect(chunks, arrayElements) {
+  var out = [];
+  parseJSONStream(chunks, function (v) { out.push(v); }, arrayElements);
+  return out;
+}
+
+// Feed |text| split at every position, and also one character at a time.
+// Chunks are encoded separately, so surrogate pairs are never split.
+function checkSplits(text, expected, arrayElements) {
+  var want = JSON.stringify(expected);
+  var chars = [];
+  for (var i = 0; i <= text.length; i++) {
+    if (i > 0 && i < text.length && /[\uD800-\uDBFF]/.test(text[i - 1]))
+      continue;
+    assertEq(JSON.stringify(collect([text.slice(0, i), text.slice(i)], arrayElements)), want);
+    if (i < text.length)
+      chars.push(text.slice(i, /[\uD800-\uDBFF]/.test(text[i]) ? i + 2 : i + 1));
+  }
+  assertEq(JSON.stringify(collect(chars, arrayElements)), want);
+}
+
+// Newline-delimited records, with strings, escapes and non-ASCII text.
+var records = [
+  { a: 1, b: [true, false, null], c: "x\"y\\z\n" },
+  "str]ing}, with [brackets{",
+  -12.5e3,
+  [],
+  {},
+  "é中😀",
+  0,
+  null
+];
+checkSplits(records.map(function (r) { return JSON.stringify(r); }).join("\n"), records);
+
+// Scalars and containers may also abut.
+checkSplits('1 2"a"[3]{"b":4}true', [1, 2, "a", [3], { b: 4 }, true]);
+checkSplits("", []);
+checkSplits("  \n\t ", []);
+
+// Array-elements mode delivers each element of one top-level array.
+checkSplits(' [ 1 , "two" , [3, [4]], {"five": [5]}, null ] ', [1, "two", [3, [4]], { five: [5] }, null], true);
+checkSplits("[]", [], true);
+checkSplits('[ "]" ]', ["]"], true);
+
+// A callback that throws stops the parse.
+var seen = 0;
+try {
+  parseJSONStream(["1 2 3"], function (v) { seen++; if (v == 2) throw "stop"; });
+  assertEq(true, false);
+} catch (e) {
+  assertEq(e, "stop");
+}
+assertEq(seen, 2);
+
+// Malformed or truncated input is a SyntaxError.
+function checkError(chunks, arrayElements) {
+  try {
+    collect(chunks, arrayElements);
+  } catch (e) {
+    assertEq(e instanceof SyntaxError, true);
+    return;
+  }
+  throw new Error("no error for " + uneval(chunks));
+}
+checkError(['{"a":']);
+checkError(['"unterminated']);
+checkError(["[1, 2"]);
+checkError(["]"]);
+checkError(["tru", "e x"]);
+checkError(["{1:2}"]);
+checkError(["1, 2"]);
+checkError(["[1, 2] 3"], true);
+checkError(["[1,, 2]"], true);
+checkError(["[1 2]"], true);
+checkError(["[1, ]"], true);
+checkError(["{}"], true);
+checkError(["[1"], true);
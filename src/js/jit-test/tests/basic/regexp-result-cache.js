@@ -0,0 +1,55 @@
+// Repeated replace/split with the same regexp and input hit the compartment's
+// result cache; results and RegExp statics must match the uncached ones.
+
+function checkReplace(s, re, repl, expected, lastMatch, leftContext) {
+    for (var i = 0; i < 3; i++) {
+        RegExp.lastMatch;  // Force any pending lazy statics.
+        "zzz".match(/z/);
+        assertEq(s.replace(re, repl), expected);
+        assertEq(RegExp.lastMatch, lastMatch);
+        assertEq(RegExp.leftContext, leftContext);
+    }
+}
+
+checkReplace("a-b-c", /-/g, "+", "a+b+c", "-", "a-b");
+checkReplace("a-b-c", /-/, "+", "a+b-c", "-", "a");
+checkReplace("a-b-c", /-/g, "", "abc", "-", "a-b");
+checkReplace("abc", /x*/g, "-", "-a-b-c-", "", "abc");
+checkReplace("a-b-c", /x/g, "+", "a-b-c", "z", "");
+
+// '$' patterns still see the captures.
+assertEq("a-b-c".replace(/(-)/g, "[$1]"), "a[-]b[-]c");
+assertEq("a-b-c".replace(/(-)/g, "[$1]"), "a[-]b[-]c");
+assertEq(RegExp.$1, "-");
+
+// A different replacement or regexp must not reuse the cached result.
+var s = "one two three";
+assertEq(s.replace(/ /g, "_"), "one_two_three");
+assertEq(s.replace(/ /g, "."), "one.two.three");
+assertEq(s.replace(/o/g, "."), ".ne tw. three");
+
+function checkSplit(s, re, limit, expected, lastMatch) {
+    for (var i = 0; i < 3; i++) {
+        "zzz".match(/z/);
+        var a = s.split(re, limit);
+        assertEq(a.join("|"), expected);
+        assertEq(RegExp.lastMatch, lastMatch);
+        // Callers may mutate the result; the next split must not see that.
+        a[0] = "mutated";
+        a.push("extra");
+    }
+}
+
+checkSplit("a, b,c", /,\s*/, undefined, "a|b|c", ",");
+checkSplit("a, b,c", /,\s*/, 2, "a|b", ",");
+checkSplit("abc", /(?:)/, undefined, "a|b|c", "");
+checkSplit("abc", /x/, undefined, "abc", "z");
+checkSplit("a1b2c", /(\d)/, undefined, "a|1|b|2|c", "2");
+
+// The cache is purged by GC.
+var words = "alpha beta gamma".split(/ /);
+gc();
+assertEq("alpha beta gamma".split(/ /).join(), words.join());
+assertEq("alpha beta gamma".replace(/ /g, "-"), "alpha-beta-gamma");
+gc();
+assertEq("alpha beta gamma".replace(/ /g, "-"), "alpha-beta-gamma");
@@ -0,0 +1,42 @@
+// Exercise StringMatch around the vectorized search's block boundaries.
+
+function naiveIndexOf(text, pat) {
+    for (var i = 0; i + pat.length <= text.length; i++) {
+        if (text.substr(i, pat.length) === pat)
+            return i;
+    }
+    return -1;
+}
+
+var alphabet = "abĀā";
+var seed = 1;
+function rand(n) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed % n;
+}
+function randomString(len) {
+    var s = "";
+    for (var i = 0; i < len; i++)
+        s += alphabet[rand(alphabet.length)];
+    return s;
+}
+
+for (var textLen = 0; textLen < 40; textLen++) {
+    for (var patLen = 1; patLen < 12; patLen++) {
+        var text = randomString(textLen);
+        var pat = randomString(patLen);
+        assertEq(text.indexOf(pat), naiveIndexOf(text, pat));
+
+        /* Plant the pattern at every position, including the scalar tail. */
+        for (var pos = 0; pos + patLen <= textLen; pos++) {
+            var planted = text.substr(0, pos) + pat + text.substr(pos + patLen);
+            assertEq(planted.indexOf(pat), naiveIndexOf(planted, pat));
+        }
+    }
+}
+
+/* First and last chars match but the middle does not. */
+assertEq("axxb axyb".indexOf("axyb"), 5);
+assertEq("abababababababababab".indexOf("abba"), -1);
+assertEq(Array(100).join("x").indexOf("xy"), -1);
+assertEq((Array(100).join("x") + "y").indexOf("xy"), 98);
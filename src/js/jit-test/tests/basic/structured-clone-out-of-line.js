@@ -0,0 +1,75 @@
+// Same-process clone buffers keep large ArrayBuffers and strings out of line.
+
+function bigString(n) {
+    var s = "abcdefghijklmnopqrstuvwxyzሴ";
+    while (s.length < n)
+        s += s;
+    return s.substring(0, n);
+}
+
+var big = new Uint8Array(1 << 20);
+for (var i = 0; i < big.length; i++)
+    big[i] = i * 7;
+var small = new Int16Array([1, -2, 3]);
+var str = bigString(100000);
+var key = bigString(5000);
+
+var obj = {
+    big: big,
+    alias: new Uint32Array(big.buffer, 16, 4),
+    small: small,
+    str: str,
+    strObj: new String(str),
+    re: new RegExp(bigString(3000).replace(/[^a-z]/g, "")),
+    list: [str, "short", big]
+};
+obj[key] = 42;
+
+function check(copy) {
+    assertEq(copy.big.length, big.length);
+    for (var i = 0; i < big.length; i += 4093)
+        assertEq(copy.big[i], big[i]);
+    assertEq(copy.alias.buffer, copy.big.buffer);
+    assertEq(copy.alias[0], new Uint32Array(big.buffer, 16, 4)[0]);
+    assertEq(Array.prototype.join.call(copy.small), "1,-2,3");
+    assertEq(copy.str, str);
+    assertEq(copy.strObj instanceof String, true);
+    assertEq(String(copy.strObj), str);
+    assertEq(copy.re.source, obj.re.source);
+    assertEq(copy.list[0], str);
+    assertEq(copy.list[2], copy.big);
+    assertEq(copy[key], 42);
+
+    // The copy does not share memory with the original.
+    copy.big[0] = 99;
+    assertEq(big[0], 0);
+}
+
+var buf = serialize(obj, undefined, "SameProcess");
+var anyBuf = serialize(obj);
+check(deserialize(buf));
+check(deserialize(anyBuf));
+check(deserialize(anyBuf));
+
+// The out-of-line data was handed over, so the buffer cannot be read again.
+var threw = false;
+try {
+    deserialize(buf);
+} catch (e) {
+    threw = true;
+}
+assertEq(threw, true);
+
+// Out-of-line data combines with transferables.
+var transferred = new ArrayBuffer(8192);
+new Uint8Array(transferred)[8191] = 5;
+var copy = deserialize(serialize([transferred, big, str], [transferred], "SameProcess"));
+assertEq(transferred.byteLength, 0);
+assertEq(new Uint8Array(copy[0])[8191], 5);
+assertEq(copy[1][5], big[5]);
+assertEq(copy[2], str);
+
+// Buffers that are never read free their data.
+for (var i = 0; i < 20; i++)
+    serialize([big, str], undefined, "SameProcess");
+gc();
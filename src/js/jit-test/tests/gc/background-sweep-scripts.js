@@ -0,0 +1,41 @@
+// Scripts are finalized on the background thread. Make sure dead scripts are
+// detached from the debugger and the JITs first, and that live scripts can be
+// found and run again while the sweep is still going on.
+
+var g = newGlobal();
+var dbg = new Debugger(g);
+
+function makeScripts(n) {
+    for (var i = 0; i < n; i++) {
+        g.eval("function f" + i + "(x) { return x + " + i + "; }");
+        g.eval("for (var j = 0; j < 20; j++) f" + i + "(j);");
+    }
+}
+
+makeScripts(200);
+var keep = g.f7;
+var hits = 0;
+dbg.findScripts({ global: g }).forEach(function (s) {
+    var offsets = s.getLineOffsets(s.startLine);
+    if (offsets.length)
+        s.setBreakpoint(offsets[0], { hit: function () { hits++; } });
+});
+
+// Drop most of the scripts, with their breakpoints.
+for (var i = 0; i < 200; i++) {
+    if (i != 7)
+        g.eval("f" + i + " = null;");
+}
+
+for (var round = 0; round < 5; round++) {
+    gc();
+    makeScripts(50);
+    assertEq(dbg.findScripts({ global: g }).length > 0, true);
+    assertEq(keep(1), 8);
+}
+
+for (var i = 0; i < 10; i++)
+    gcslice(100);
+gc();
+assertEq(keep(2), 9);
+assertEq(hits > 0, true);
@@ -0,0 +1,82 @@
+// A shrinking GC with compacting enabled moves objects out of sparsely used
+// arenas. Make sure everything that refers to a moved object still finds it.
+// Everything is tenured before two thirds of it is dropped, so that the
+// survivors are spread thinly across their arenas.
+
+gcparam('compactingEnabled', 1);
+assertEq(gcparam('compactingEnabled'), 1);
+
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+var proto = { describe: function () { return "p" + this.id; } };
+var g = newGlobal();
+var wm = new WeakMap();
+
+function build(n) {
+    var all = [];
+    for (var i = 0; i < n; i++) {
+        var o = Object.create(proto);
+        o.id = i;
+        o.arr = [i, i + 1, i + 2];
+        o.point = new Point(i, -i);
+        if (i % 10 == 0) {
+            // Dictionary mode.
+            o.a = 1;
+            o.b = 2;
+            delete o.a;
+        }
+        all.push(o);
+    }
+    gc();
+    var kept = [];
+    for (var i = 0; i < n; i += 3) {
+        kept.push(all[i]);
+        wm.set(all[i], { id: i });
+    }
+    return kept;
+}
+
+function check(kept) {
+    for (var i = 0; i < kept.length; i++) {
+        var o = kept[i];
+        var id = i * 3;
+        assertEq(o.id, id);
+        assertEq(Object.getPrototypeOf(o), proto);
+        assertEq(o.describe(), "p" + id);
+        assertEq(o.arr.length, 3);
+        assertEq(o.arr[2], id + 2);
+        assertEq(o.point instanceof Point, true);
+        assertEq(o.point.y, -id);
+        assertEq(wm.get(o).id, id);
+        if (id % 10 == 0) {
+            assertEq("a" in o, false);
+            assertEq(o.b, 2);
+            o.c = 3;
+            assertEq(o.c, 3);
+        }
+    }
+}
+
+var kept = build(3000);
+g.kept = kept;
+g.eval("var local = { value: 42 }; function peek(i) { return kept[i].id; }");
+var local = g.local;
+
+gc(undefined, 'shrinking');
+
+check(kept);
+assertEq(g.peek(30), 90);
+assertEq(local.value, 42);
+assertEq(g.local, local);
+assertEq(new Point(1, 2).x, 1);
+
+// Allocate into the compacted heap and collect again.
+var more = build(1000);
+gc(undefined, 'shrinking');
+check(kept);
+check(more);
+
+gcparam('compactingEnabled', 0);
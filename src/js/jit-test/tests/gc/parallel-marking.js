@@ -0,0 +1,56 @@
+// |jit-test| thread-count: 4
+// Mark a large graph with parallel marking, in full and incremental GCs.
+
+gcparam("parallelMarking", 1);
+assertEq(gcparam("parallelMarking"), 1);
+
+function Node(i) {
+    this.index = i;
+    this.name = "node" + i;
+    this.children = [];
+}
+
+var nodes = [];
+for (var i = 0; i < 20000; i++) {
+    var node = new Node(i);
+    if (i > 0)
+        nodes[(i - 1) >> 2].children.push(node);
+    nodes.push(node);
+}
+
+// A long slot array, which markers split to share.
+var big = [];
+for (var i = 0; i < 5000; i++)
+    big.push({ value: i, str: String(i) + "x", map: new Map([[i, i]]) });
+
+function check() {
+    var count = 0;
+    var stack = [nodes[0]];
+    while (stack.length) {
+        var node = stack.pop();
+        assertEq(node.name, "node" + node.index);
+        count++;
+        for (var j = 0; j < node.children.length; j++)
+            stack.push(node.children[j]);
+    }
+    assertEq(count, nodes.length);
+    for (var i = 0; i < big.length; i++) {
+        assertEq(big[i].str, i + "x");
+        assertEq(big[i].map.get(i), i);
+    }
+}
+
+for (var i = 0; i < 3; i++) {
+    gc();
+    check();
+}
+
+// Work budget slices are split between the threads.
+for (var i = 0; i < 100; i++)
+    gcslice(1000);
+check();
+gc();
+
+gcparam("parallelMarking", 0);
+gc();
+check();
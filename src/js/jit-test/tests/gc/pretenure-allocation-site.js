@@ -0,0 +1,35 @@
+// Objects from allocation sites which survive minor GCs get pretenured; make
+// sure that switching a site over while its objects are live is harmless.
+
+function Entry(key, value) {
+    this.key = key;
+    this.value = value;
+}
+
+function buildCache(n) {
+    var cache = [];
+    for (var i = 0; i < n; i++) {
+        var obj = { key: i, list: [i, i + 1], entry: new Entry(i, "v" + i) };
+        cache.push(obj);
+        if (i % 5000 == 0)
+            minorgc();
+    }
+    return cache;
+}
+
+function check(cache) {
+    for (var i = 0; i < cache.length; i++) {
+        var obj = cache[i];
+        assertEq(obj.key, i);
+        assertEq(obj.list[1], i + 1);
+        assertEq(obj.entry.value, "v" + i);
+    }
+}
+
+for (var j = 0; j < 4; j++) {
+    var cache = buildCache(30000);
+    minorgc();
+    check(cache);
+    gc();
+    check(cache);
+}
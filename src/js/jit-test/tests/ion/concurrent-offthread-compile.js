@@ -0,0 +1,35 @@
+// |jit-test| thread-count: 4
+// Off thread Ion compilations of many scripts may run at the same time, and
+// pending ones are taken hottest first. Make sure every script still computes
+// the right answer however its compilation was scheduled.
+
+var fns = [];
+for (var i = 0; i < 40; i++) {
+    fns.push(new Function("n", "k",
+        "var s = 0;" +
+        "for (var j = 0; j < n; j++)" +
+        "    s = (s + j * " + i + " + k) | 0;" +
+        "return s;"));
+}
+
+function expected(i, n, k) {
+    var s = 0;
+    for (var j = 0; j < n; j++)
+        s = (s + j * i + k) | 0;
+    return s;
+}
+
+// Warm every function up enough to be queued, but run only some of them
+// afterwards so that the rest go cold while waiting in the worklist.
+for (var round = 0; round < 30; round++) {
+    for (var i = 0; i < fns.length; i++) {
+        if (round > 10 && i % 3 != 0)
+            continue;
+        assertEq(fns[i](100 + round, i), expected(i, 100 + round, i));
+    }
+}
+
+// The cold functions must still work, whether or not their compilations
+// were dropped.
+for (var i = 0; i < fns.length; i++)
+    assertEq(fns[i](500, 1), expected(i, 500, 1));
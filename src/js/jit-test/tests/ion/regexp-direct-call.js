@@ -0,0 +1,91 @@
+// Ion calls the regexp JIT code directly for exec and test; results,
+// lastIndex and RegExp statics must match the VM paths.
+
+function testNonGlobal() {
+    var re = /b(c)?(x)?/;
+    for (var i = 0; i < 200; i++) {
+        re.lastIndex = 5;
+        var m = re.exec("abcabd");
+        assertEq(m.length, 3);
+        assertEq(m[0], "bc");
+        assertEq(m[1], "c");
+        assertEq(m[2], undefined);
+        assertEq(m.index, 1);
+        assertEq(m.input, "abcabd");
+        assertEq(re.lastIndex, 5);
+        assertEq(RegExp.leftContext, "a");
+        assertEq(RegExp.$1, "c");
+
+        assertEq(re.test("xxb"), true);
+        assertEq(re.lastIndex, 5);
+        assertEq(RegExp.lastMatch, "b");
+
+        assertEq(re.exec("xyz"), null);
+        assertEq(re.lastIndex, 0);
+        re.lastIndex = 3;
+        assertEq(re.test("xyz"), false);
+        assertEq(re.lastIndex, 0);
+    }
+}
+testNonGlobal();
+
+function testGlobal() {
+    var re = /a(\d)/g;
+    var s = "a1-a2-a3";
+    for (var i = 0; i < 200; i++) {
+        var digits = "";
+        var m;
+        while ((m = re.exec(s)))
+            digits += m[1] + re.lastIndex;
+        assertEq(digits, "122538");
+        assertEq(re.lastIndex, 0);
+
+        var count = 0;
+        while (re.test(s)) {
+            count++;
+            assertEq(RegExp.$1, String(count));
+        }
+        assertEq(count, 3);
+        assertEq(re.lastIndex, 0);
+
+        // Out-of-range and non-int32 lastIndex values.
+        re.lastIndex = 100;
+        assertEq(re.test(s), false);
+        assertEq(re.lastIndex, 0);
+        re.lastIndex = 3.5;
+        assertEq(re.exec(s)[0], "a2");
+        assertEq(re.lastIndex, 5);
+        re.lastIndex = { valueOf: function () { return 6; } };
+        assertEq(re.test(s), true);
+        assertEq(re.lastIndex, 8);
+        re.lastIndex = 0;
+    }
+}
+testGlobal();
+
+function testRopesAndCaptures() {
+    var many = /(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)(m)(n)(o)(p)(q)/;
+    for (var i = 0; i < 200; i++) {
+        var s = "x" + String(i) + "-abc";
+        var m = /(\d+)-(a)/.exec(s);
+        assertEq(m[1], String(i));
+        assertEq(m.index, 1);
+        assertEq(/c$/.test(s), true);
+
+        m = many.exec("--abcdefghijklmnopq");
+        assertEq(m.length, 18);
+        assertEq(m[17], "q");
+        assertEq(RegExp.$9, "i");
+
+        // Backreferences are not compiled; the VM interprets them.
+        assertEq(/(a)\1/.test("xaa"), true);
+        assertEq(/(a)\1/.exec("xaa")[0], "aa");
+
+        // Sticky regexps go through the VM.
+        var sticky = /b/y;
+        sticky.lastIndex = 1;
+        assertEq(sticky.test("abc"), true);
+        assertEq(sticky.lastIndex, 2);
+    }
+}
+testRopesAndCaptures();
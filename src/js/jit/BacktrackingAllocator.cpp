@@ -1128,7 +1128,8 @@ BacktrackingAllocator::populateSafepoints()
                              def->type() == LDefinition::GENERAL ||
                              def->type() == LDefinition::INT32 ||
                              def->type() == LDefinition::FLOAT32 ||
-                             def->type() == LDefinition::DOUBLE);
+                             def->type() == LDefinition::DOUBLE ||
+                             def->type() == LDefinition::SIMD128);
                 continue;
             }
 
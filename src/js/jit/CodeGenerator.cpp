@@ -30,6 +30,8 @@
 #include "jit/ParallelSafetyAnalysis.h"
 #include "jit/RangeAnalysis.h"
 #include "vm/ForkJoin.h"
+#include "vm/MatchPairs.h"
+#include "vm/RegExpObject.h"
 
 #include "jsboolinlines.h"
 
@@ -768,12 +770,141 @@ typedef bool (*RegExpExecRawFn)(JSContext *cx, HandleObject regexp,
                                 HandleString input, Value *vp);
 static const VMFunction RegExpExecRawInfo = FunctionInfo<RegExpExecRawFn>(regexp_exec_raw);
 
+typedef bool (*RegExpExecMatchedFn)(JSContext *cx, HandleString input, MatchPair *pairs,
+                                    uint32_t pairCount, MutableHandleValue rval);
+static const VMFunction RegExpExecMatchedInfo =
+    FunctionInfo<RegExpExecMatchedFn>(RegExpExecMatched);
+
+#if ENABLE_YARR_JIT
+// Number of match pairs RegExp exec reserves on the stack for the regexp's
+// JIT code to write into. Regexps with more captures go through the VM.
+static const size_t RegExpMaxDirectPairs = 16;
+static const size_t RegExpDirectPairsSize = RegExpMaxDirectPairs * sizeof(MatchPair);
+
+// Check that RegExp exec or test can call the regexp's JIT code directly at
+// |codeOffset| in its RegExpShared, and jump to |vmCall| if not. On the fast
+// path, leave the RegExpShared in |shared|, the index to start matching at in
+// |start| and the string's length in |length|.
+static void
+PrepareDirectRegExpCall(MacroAssembler &masm, Register regexp, Register string,
+                        Register shared, Register start, Register length,
+                        size_t codeOffset, Label *vmCall)
+{
+    // The RegExpShared is created, and may be discarded by GC, lazily.
+    masm.loadObjPrivate(regexp, RegExpObject::NFIXED_SLOTS, shared);
+    masm.branchTestPtr(Assembler::Zero, shared, shared, vmCall);
+
+    // Sticky regexps match against a displaced input, which is left to the VM.
+    Address flagsAddr(shared, RegExpShared::offsetOfFlags());
+    masm.branchTest32(Assembler::NonZero, flagsAddr, Imm32(StickyFlag), vmCall);
+
+    // The VM compiles the code on first use.
+    masm.branchPtr(Assembler::Equal, Address(shared, codeOffset), ImmWord(uintptr_t(0)), vmCall);
+
+    // The VM flattens ropes.
+    Address lengthAndFlagsAddr(string, JSString::offsetOfLengthAndFlags());
+    masm.branchTest32(Assembler::Zero, lengthAndFlagsAddr, Imm32(JSString::FLAGS_MASK), vmCall);
+    masm.loadPtr(lengthAndFlagsAddr, length);
+    masm.rshiftPtr(Imm32(JSString::LENGTH_SHIFT), length);
+
+    // Converting any other lastIndex to an integer may call into script.
+    Address lastIndexAddr(regexp, JSObject::getFixedSlotOffset(RegExpObject::lastIndexSlot()));
+    masm.branchTestInt32(Assembler::NotEqual, lastIndexAddr, vmCall);
+
+    // Only global regexps start at lastIndex; the VM handles one out of range.
+    Label haveStart;
+    masm.move32(Imm32(0), start);
+    masm.branchTest32(Assembler::Zero, flagsAddr, Imm32(GlobalFlag), &haveStart);
+    masm.unboxInt32(lastIndexAddr, start);
+    masm.branch32(Assembler::Above, start, length, vmCall);
+    masm.bind(&haveStart);
+}
+#endif
+
 bool
 CodeGenerator::visitRegExpExec(LRegExpExec *lir)
 {
-    pushArg(ToRegister(lir->string()));
-    pushArg(ToRegister(lir->regexp()));
-    return callVM(RegExpExecRawInfo, lir);
+    Register regexp = ToRegister(lir->regexp());
+    Register string = ToRegister(lir->string());
+    Label vmCall, done;
+
+#if ENABLE_YARR_JIT
+    if (SupportsDirectRegExpCalls) {
+        Register shared = ToRegister(lir->temp1());
+        Register start = ToRegister(lir->temp2());
+        Register length = ToRegister(lir->temp3());
+        ValueOperand output = ToOutValue(lir);
+
+        PrepareDirectRegExpCall(masm, regexp, string, shared, start, length,
+                                RegExpShared::offsetOfJitCode(), &vmCall);
+        masm.branch32(Assembler::AboveOrEqual, Address(shared, RegExpShared::offsetOfParenCount()),
+                      Imm32(RegExpMaxDirectPairs), &vmCall);
+
+        // Captures that do not participate in the match are left untouched,
+        // so start with every pair undefined.
+        uint32_t framePushed = masm.framePushed();
+        masm.reserveStack(RegExpDirectPairsSize);
+        for (size_t i = 0; i < RegExpDirectPairsSize; i += sizeof(int32_t))
+            masm.store32(Imm32(-1), Address(StackPointer, i));
+
+        // The JIT code follows the native ABI, so the operands need saving.
+        masm.push(regexp);
+        masm.push(string);
+        masm.push(shared);
+        masm.computeEffectiveAddress(Address(StackPointer, 3 * sizeof(void *)), regexp);
+        masm.loadPtr(Address(string, JSString::offsetOfChars()), string);
+        masm.setupUnalignedABICall(4, ReturnReg);
+        masm.passABIArg(string);
+        masm.passABIArg(start);
+        masm.passABIArg(length);
+        masm.passABIArg(regexp);
+        masm.callWithABI(Address(shared, RegExpShared::offsetOfJitCode()));
+        masm.pop(shared);
+        masm.pop(string);
+        masm.pop(regexp);
+
+        // The match start is returned in the low half of ReturnReg.
+        Label matched;
+        Address lastIndexAddr(regexp, JSObject::getFixedSlotOffset(RegExpObject::lastIndexSlot()));
+        masm.branch32(Assembler::NotEqual, ReturnReg, Imm32(-1), &matched);
+        masm.freeStack(RegExpDirectPairsSize);
+        masm.storeValue(Int32Value(0), lastIndexAddr);
+        masm.moveValue(NullValue(), output);
+        masm.jump(&done);
+
+        masm.bind(&matched);
+        masm.setFramePushed(framePushed + RegExpDirectPairsSize);
+
+        // Global regexps continue after the match: the limit of the first pair.
+        Label lastIndexUpdated;
+        masm.branchTest32(Assembler::Zero, Address(shared, RegExpShared::offsetOfFlags()),
+                          Imm32(GlobalFlag), &lastIndexUpdated);
+        masm.load32(Address(StackPointer, offsetof(MatchPair, limit)), start);
+        masm.storeValue(JSVAL_TYPE_INT32, start, lastIndexAddr);
+        masm.bind(&lastIndexUpdated);
+
+        // Update the statics and create the result array in the VM.
+        masm.movePtr(StackPointer, length);
+        masm.load32(Address(shared, RegExpShared::offsetOfParenCount()), start);
+        masm.add32(Imm32(1), start);
+        pushArg(start);
+        pushArg(length);
+        pushArg(string);
+        if (!callVM(RegExpExecMatchedInfo, lir))
+            return false;
+        masm.freeStack(RegExpDirectPairsSize);
+        masm.jump(&done);
+    }
+#endif
+
+    masm.bind(&vmCall);
+    pushArg(string);
+    pushArg(regexp);
+    if (!callVM(RegExpExecRawInfo, lir))
+        return false;
+
+    masm.bind(&done);
+    return true;
 }
 
 typedef bool (*RegExpTestRawFn)(JSContext *cx, HandleObject regexp,
@@ -783,9 +914,77 @@ static const VMFunction RegExpTestRawInfo = FunctionInfo<RegExpTestRawFn>(regexp
 bool
 CodeGenerator::visitRegExpTest(LRegExpTest *lir)
 {
-    pushArg(ToRegister(lir->string()));
-    pushArg(ToRegister(lir->regexp()));
-    return callVM(RegExpTestRawInfo, lir);
+    Register regexp = ToRegister(lir->regexp());
+    Register string = ToRegister(lir->string());
+    Label vmCall, done;
+
+#if ENABLE_YARR_JIT
+    if (SupportsDirectRegExpCalls) {
+        Register shared = ToRegister(lir->temp1());
+        Register start = ToRegister(lir->temp2());
+        Register length = ToRegister(lir->temp3());
+        Register output = ToRegister(lir->output());
+        JS_ASSERT(output == ReturnReg);
+
+        PrepareDirectRegExpCall(masm, regexp, string, shared, start, length,
+                                RegExpShared::offsetOfJitCodeMatchOnly(), &vmCall);
+
+        // The JIT code follows the native ABI, so the operands need saving.
+        masm.push(regexp);
+        masm.push(string);
+        masm.push(shared);
+        masm.push(start);
+        masm.loadPtr(Address(string, JSString::offsetOfChars()), string);
+        masm.setupUnalignedABICall(3, ReturnReg);
+        masm.passABIArg(string);
+        masm.passABIArg(start);
+        masm.passABIArg(length);
+        masm.callWithABI(Address(shared, RegExpShared::offsetOfJitCodeMatchOnly()));
+        masm.pop(start);
+        masm.pop(shared);
+        masm.pop(string);
+        masm.pop(regexp);
+
+        // The match start is returned in the low half of ReturnReg.
+        Label notFound;
+        Address lastIndexAddr(regexp, JSObject::getFixedSlotOffset(RegExpObject::lastIndexSlot()));
+        masm.branch32(Assembler::Equal, ReturnReg, Imm32(-1), &notFound);
+
+        // Global regexps continue after the match, whose limit is returned in
+        // the high half of ReturnReg.
+        Label lastIndexUpdated;
+        masm.branchTest32(Assembler::Zero, Address(shared, RegExpShared::offsetOfFlags()),
+                          Imm32(GlobalFlag), &lastIndexUpdated);
+        masm.rshiftPtr(Imm32(32), ReturnReg);
+        masm.storeValue(JSVAL_TYPE_INT32, ReturnReg, lastIndexAddr);
+        masm.bind(&lastIndexUpdated);
+
+        // Let the statics rerun the match if they are ever queried.
+        masm.setupUnalignedABICall(4, ReturnReg);
+        masm.loadJSContext(length);
+        masm.passABIArg(length);
+        masm.passABIArg(string);
+        masm.passABIArg(shared);
+        masm.passABIArg(start);
+        masm.callWithABI(JS_FUNC_TO_DATA_PTR(void *, RegExpTestMatched));
+        masm.move32(Imm32(1), output);
+        masm.jump(&done);
+
+        masm.bind(&notFound);
+        masm.storeValue(Int32Value(0), lastIndexAddr);
+        masm.move32(Imm32(0), output);
+        masm.jump(&done);
+    }
+#endif
+
+    masm.bind(&vmCall);
+    pushArg(string);
+    pushArg(regexp);
+    if (!callVM(RegExpTestRawInfo, lir))
+        return false;
+
+    masm.bind(&done);
+    return true;
 }
 
 typedef JSString *(*RegExpReplaceFn)(JSContext *, HandleString, HandleObject, HandleString);
@@ -1239,6 +1438,7 @@ CodeGenerator::visitMoveGroup(LMoveGroup *group)
           case LDefinition::INT32:   moveType = MoveOp::INT32;   break;
           case LDefinition::FLOAT32: moveType = MoveOp::FLOAT32; break;
           case LDefinition::DOUBLE:  moveType = MoveOp::DOUBLE;  break;
+          case LDefinition::SIMD128: moveType = MoveOp::SIMD128; break;
           default: MOZ_ASSUME_UNREACHABLE("Unexpected move type");
         }
 
@@ -3269,6 +3469,19 @@ bool CodeGenerator::visitHypot(LHypot *lir)
     return true;
 }
 
+// Count objects allocated inline in the nursery towards the survival rate of
+// their allocation site (see Nursery::collect). Objects allocated by the VM
+// fallbacks are counted there.
+static void
+CountNurseryAllocation(MacroAssembler &masm, JSObject *templateObject,
+                       gc::InitialHeap initialHeap)
+{
+    if (initialHeap != gc::DefaultHeap || templateObject->hasSingletonType())
+        return;
+    types::TypeObject *type = templateObject->type();
+    masm.add32(Imm32(1), AbsoluteAddress(type->addressOfNurseryAllocCount()));
+}
+
 bool
 CodeGenerator::visitNewArray(LNewArray *lir)
 {
@@ -3288,6 +3501,7 @@ CodeGenerator::visitNewArray(LNewArray *lir)
 
     masm.newGCThing(objReg, templateObject, ool->entry(), lir->mir()->initialHeap());
     masm.initGCThing(objReg, templateObject);
+    CountNurseryAllocation(masm, templateObject, lir->mir()->initialHeap());
 
     masm.bind(ool->rejoin());
     return true;
@@ -3374,6 +3588,7 @@ CodeGenerator::visitNewObject(LNewObject *lir)
 
     masm.newGCThing(objReg, templateObject, ool->entry(), lir->mir()->initialHeap());
     masm.initGCThing(objReg, templateObject);
+    CountNurseryAllocation(masm, templateObject, lir->mir()->initialHeap());
 
     masm.bind(ool->rejoin());
     return true;
@@ -3773,6 +3988,7 @@ CodeGenerator::visitCreateThisWithTemplate(LCreateThisWithTemplate *lir)
 
     // Allocate. If the FreeList is empty, call to VM, which may GC.
     masm.newGCThing(objReg, templateObject, ool->entry(), lir->mir()->initialHeap());
+    CountNurseryAllocation(masm, templateObject, lir->mir()->initialHeap());
 
     // Initialize based on the templateObject.
     masm.bind(ool->rejoin());
@@ -644,6 +644,19 @@ class IonBuilder : public MIRGenerator
     InliningStatus inlineNewDenseArrayForSequentialExecution(CallInfo &callInfo);
     InliningStatus inlineNewDenseArrayForParallelExecution(CallInfo &callInfo);
 
+    // Atomic natives.
+    bool atomicsMeetsPreconditions(CallInfo &callInfo, int *arrayType);
+    void atomicsCheckBounds(CallInfo &callInfo, MInstruction **elements, MDefinition **index);
+    InliningStatus inlineAtomicsLoad(CallInfo &callInfo);
+    InliningStatus inlineAtomicsStore(CallInfo &callInfo);
+    InliningStatus inlineAtomicsCompareExchange(CallInfo &callInfo);
+    InliningStatus inlineAtomicsBinop(CallInfo &callInfo, MAtomicTypedArrayElementBinop::Operation op);
+
+    // SIMD natives.
+    InliningStatus inlineSimd(CallInfo &callInfo, JSNative native);
+    bool isSimdTypeSet(types::TemporaryTypeSet *types, MIRType type);
+    MDefinition *unboxSimd(MDefinition *ins, MIRType type);
+
     // Slot intrinsics.
     InliningStatus inlineUnsafeSetReservedSlot(CallInfo &callInfo);
     InliningStatus inlineUnsafeGetReservedSlot(CallInfo &callInfo);
@@ -735,6 +748,11 @@ class IonBuilder : public MIRGenerator
     // performed by FinishOffThreadBuilder().
     CodeGenerator *backgroundCodegen_;
 
+    // State recorded when the builder is added to the off thread worklist.
+    // Used to order pending compilations and to spot ones that went stale.
+    uint32_t useCountWhenQueued_;
+    uint64_t compilationsStartedWhenQueued_;
+
   public:
     void clearForBackEnd();
 
@@ -743,6 +761,13 @@ class IonBuilder : public MIRGenerator
     CodeGenerator *backgroundCodegen() const { return backgroundCodegen_; }
     void setBackgroundCodegen(CodeGenerator *codegen) { backgroundCodegen_ = codegen; }
 
+    void noteQueued(uint64_t compilationsStarted) {
+        useCountWhenQueued_ = script_->getUseCount();
+        compilationsStartedWhenQueued_ = compilationsStarted;
+    }
+    uint32_t useCountWhenQueued() const { return useCountWhenQueued_; }
+    uint64_t compilationsStartedWhenQueued() const { return compilationsStartedWhenQueued_; }
+
     AbortReason abortReason() { return abortReason_; }
 
     TypeRepresentationSetHash *getOrCreateReprSetHash(); // fallible
@@ -339,9 +339,13 @@ IonFrameIterator::machineState() const
     for (GeneralRegisterBackwardIterator iter(reader.allGprSpills()); iter.more(); iter++)
         machine.setRegisterLocation(*iter, --spill);
 
-    double *floatSpill = reinterpret_cast<double *>(spill);
-    for (FloatRegisterBackwardIterator iter(reader.allFloatSpills()); iter.more(); iter++)
-        machine.setRegisterLocation(*iter, --floatSpill);
+    // Float registers are spilled FloatRegisterSpillSize bytes apart, with
+    // their double value in the low bytes.
+    char *floatSpill = reinterpret_cast<char *>(spill);
+    for (FloatRegisterBackwardIterator iter(reader.allFloatSpills()); iter.more(); iter++) {
+        floatSpill -= FloatRegisterSpillSize;
+        machine.setRegisterLocation(*iter, reinterpret_cast<double *>(floatSpill));
+    }
 
     return machine;
 }
@@ -1577,14 +1581,14 @@ template bool InlineFrameIteratorMaybeGC<CanGC>::isFunctionFrame() const;
 
 MachineState
 MachineState::FromBailout(mozilla::Array<uintptr_t, Registers::Total> &regs,
-                          mozilla::Array<double, FloatRegisters::Total> &fpregs)
+                          mozilla::Array<FloatRegisterSpill, FloatRegisters::Total> &fpregs)
 {
     MachineState machine;
 
     for (unsigned i = 0; i < Registers::Total; i++)
         machine.setRegisterLocation(Register::FromCode(i), &regs[i]);
     for (unsigned i = 0; i < FloatRegisters::Total; i++)
-        machine.setRegisterLocation(FloatRegister::FromCode(i), &fpregs[i]);
+        machine.setRegisterLocation(FloatRegister::FromCode(i), &fpregs[i].d);
 
     return machine;
 }
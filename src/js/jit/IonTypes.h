@@ -82,7 +82,9 @@ enum MIRType
     MIRType_Elements,     // An elements vector
     MIRType_Pointer,      // An opaque pointer that receives no special treatment
     MIRType_Shape,        // A Shape pointer.
-    MIRType_ForkJoinSlice // js::ForkJoinSlice*
+    MIRType_ForkJoinSlice, // js::ForkJoinSlice*
+    MIRType_Int32x4,      // SIMD int32x4 value, unboxed from its typed object
+    MIRType_Float32x4     // SIMD float32x4 value, unboxed from its typed object
 };
 
 static inline MIRType
@@ -143,6 +145,15 @@ MIRTypeToTag(MIRType type)
     return JSVAL_TYPE_TO_TAG(ValueTypeFromMIRType(type));
 }
 
+// Size in bytes of a SIMD value, such as an int32x4 or a float32x4.
+static const uint32_t Simd128DataSize = 4 * sizeof(int32_t);
+
+static inline bool
+IsSimdType(MIRType type)
+{
+    return type == MIRType_Int32x4 || type == MIRType_Float32x4;
+}
+
 static inline const char *
 StringFromMIRType(MIRType type)
 {
@@ -177,6 +188,10 @@ StringFromMIRType(MIRType type)
       return "Pointer";
     case MIRType_ForkJoinSlice:
       return "ForkJoinSlice";
+    case MIRType_Int32x4:
+      return "Int32x4";
+    case MIRType_Float32x4:
+      return "Float32x4";
     default:
       MOZ_ASSUME_UNREACHABLE("Unknown MIRType.");
   }
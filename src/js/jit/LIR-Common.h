@@ -3200,15 +3200,19 @@ class LRegExp : public LCallInstructionHelper<1, 0, 0>
     }
 };
 
-class LRegExpExec : public LCallInstructionHelper<BOX_PIECES, 2, 0>
+class LRegExpExec : public LCallInstructionHelper<BOX_PIECES, 2, 3>
 {
   public:
     LIR_HEADER(RegExpExec)
 
-    LRegExpExec(const LAllocation &regexp, const LAllocation &string)
+    LRegExpExec(const LAllocation &regexp, const LAllocation &string,
+                const LDefinition &temp1, const LDefinition &temp2, const LDefinition &temp3)
     {
         setOperand(0, regexp);
         setOperand(1, string);
+        setTemp(0, temp1);
+        setTemp(1, temp2);
+        setTemp(2, temp3);
     }
 
     const LAllocation *regexp() {
@@ -3217,21 +3221,34 @@ class LRegExpExec : public LCallInstructionHelper<BOX_PIECES, 2, 0>
     const LAllocation *string() {
         return getOperand(1);
     }
+    const LDefinition *temp1() {
+        return getTemp(0);
+    }
+    const LDefinition *temp2() {
+        return getTemp(1);
+    }
+    const LDefinition *temp3() {
+        return getTemp(2);
+    }
 
     const MRegExpExec *mir() const {
         return mir_->toRegExpExec();
     }
 };
 
-class LRegExpTest : public LCallInstructionHelper<1, 2, 0>
+class LRegExpTest : public LCallInstructionHelper<1, 2, 3>
 {
   public:
     LIR_HEADER(RegExpTest)
 
-    LRegExpTest(const LAllocation &regexp, const LAllocation &string)
+    LRegExpTest(const LAllocation &regexp, const LAllocation &string,
+                const LDefinition &temp1, const LDefinition &temp2, const LDefinition &temp3)
     {
         setOperand(0, regexp);
         setOperand(1, string);
+        setTemp(0, temp1);
+        setTemp(1, temp2);
+        setTemp(2, temp3);
     }
 
     const LAllocation *regexp() {
@@ -3240,6 +3257,15 @@ class LRegExpTest : public LCallInstructionHelper<1, 2, 0>
     const LAllocation *string() {
         return getOperand(1);
     }
+    const LDefinition *temp1() {
+        return getTemp(0);
+    }
+    const LDefinition *temp2() {
+        return getTemp(1);
+    }
+    const LDefinition *temp3() {
+        return getTemp(2);
+    }
 
     const MRegExpTest *mir() const {
         return mir_->toRegExpTest();
@@ -201,6 +201,7 @@ static const char * const TypeChars[] =
     "s",            // SLOTS
     "f",            // FLOAT32
     "d",            // DOUBLE
+    "v",            // SIMD128
 #ifdef JS_NUNBOX32
     "t",            // TYPE
     "p"             // PAYLOAD
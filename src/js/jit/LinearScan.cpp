@@ -521,7 +521,8 @@ LinearScanAllocator::populateSafepoints()
                              def->type() == LDefinition::GENERAL ||
                              def->type() == LDefinition::INT32 ||
                              def->type() == LDefinition::FLOAT32 ||
-                             def->type() == LDefinition::DOUBLE);
+                             def->type() == LDefinition::DOUBLE ||
+                             def->type() == LDefinition::SIMD128);
                 continue;
             }
 
@@ -810,6 +811,8 @@ LinearScanAllocator::allocateSlotFor(const LiveInterval *interval)
     SlotList *freed;
     if (reg->type() == LDefinition::DOUBLE)
         freed = &finishedDoubleSlots_;
+    else if (reg->type() == LDefinition::SIMD128)
+        freed = &finishedQuadSlots_;
 #if JS_BITS_PER_WORD == 64
     else if (reg->type() == LDefinition::GENERAL ||
              reg->type() == LDefinition::OBJECT ||
@@ -903,6 +906,8 @@ LinearScanAllocator::freeAllocation(LiveInterval *interval, LAllocation *alloc)
         if (alloc->isStackSlot()) {
             if (mine->type() == LDefinition::DOUBLE)
                 finishedDoubleSlots_.append(interval);
+            else if (mine->type() == LDefinition::SIMD128)
+                finishedQuadSlots_.append(interval);
 #if JS_BITS_PER_WORD == 64
             else if (mine->type() == LDefinition::GENERAL ||
                      mine->type() == LDefinition::OBJECT ||
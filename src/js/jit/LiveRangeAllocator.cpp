@@ -470,6 +470,7 @@ AddRegisterToSafepoint(LSafepoint *safepoint, AnyRegister reg, const LDefinition
               def.type() == LDefinition::INT32 ||
               def.type() == LDefinition::DOUBLE ||
               def.type() == LDefinition::FLOAT32 ||
+              def.type() == LDefinition::SIMD128 ||
               def.type() == LDefinition::OBJECT);
 
     if (def.type() == LDefinition::OBJECT)
@@ -1919,8 +1919,20 @@ LIRGenerator::visitRegExpExec(MRegExpExec *ins)
     JS_ASSERT(ins->regexp()->type() == MIRType_Object);
     JS_ASSERT(ins->string()->type() == MIRType_String);
 
-    LRegExpExec *lir = new(alloc()) LRegExpExec(useRegisterAtStart(ins->regexp()),
-                                                useRegisterAtStart(ins->string()));
+    // Direct calls into the regexp's JIT code use the operands after the
+    // temps are written, and ReturnReg as a scratch register.
+    LRegExpExec *lir;
+    if (SupportsDirectRegExpCalls) {
+        lir = new(alloc()) LRegExpExec(useFixed(ins->regexp(), CallTempReg2),
+                                       useFixed(ins->string(), CallTempReg4),
+                                       tempFixed(CallTempReg1), tempFixed(CallTempReg5),
+                                       tempFixed(CallTempReg3));
+    } else {
+        lir = new(alloc()) LRegExpExec(useRegisterAtStart(ins->regexp()),
+                                       useRegisterAtStart(ins->string()),
+                                       LDefinition::BogusTemp(), LDefinition::BogusTemp(),
+                                       LDefinition::BogusTemp());
+    }
     return defineReturn(lir, ins) && assignSafepoint(lir, ins);
 }
 
@@ -1930,8 +1942,18 @@ LIRGenerator::visitRegExpTest(MRegExpTest *ins)
     JS_ASSERT(ins->regexp()->type() == MIRType_Object);
     JS_ASSERT(ins->string()->type() == MIRType_String);
 
-    LRegExpTest *lir = new(alloc()) LRegExpTest(useRegisterAtStart(ins->regexp()),
-                                                useRegisterAtStart(ins->string()));
+    LRegExpTest *lir;
+    if (SupportsDirectRegExpCalls) {
+        lir = new(alloc()) LRegExpTest(useFixed(ins->regexp(), CallTempReg2),
+                                       useFixed(ins->string(), CallTempReg4),
+                                       tempFixed(CallTempReg1), tempFixed(CallTempReg5),
+                                       tempFixed(CallTempReg3));
+    } else {
+        lir = new(alloc()) LRegExpTest(useRegisterAtStart(ins->regexp()),
+                                       useRegisterAtStart(ins->string()),
+                                       LDefinition::BogusTemp(), LDefinition::BogusTemp(),
+                                       LDefinition::BogusTemp());
+    }
     return defineReturn(lir, ins) && assignSafepoint(lir, ins);
 }
 
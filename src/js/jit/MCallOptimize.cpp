@@ -6,7 +6,10 @@
 
 #include "jsmath.h"
 
+#include "builtin/AtomicsObject.h"
+#include "builtin/SIMD.h"
 #include "builtin/TestingFunctions.h"
+#include "builtin/TypedObject.h"
 #include "jit/BaselineInspector.h"
 #include "jit/IonBuilder.h"
 #include "jit/Lowering.h"
@@ -162,6 +165,30 @@ IonBuilder::inlineNativeCall(CallInfo &callInfo, JSNative native)
     if (native == testingFunc_assertFloat32)
         return inlineAssertFloat32(callInfo);
 
+    // Atomic natives.
+    if (SupportsAtomics) {
+        if (native == atomics_load)
+            return inlineAtomicsLoad(callInfo);
+        if (native == atomics_store)
+            return inlineAtomicsStore(callInfo);
+        if (native == atomics_compareExchange)
+            return inlineAtomicsCompareExchange(callInfo);
+        if (native == atomics_add)
+            return inlineAtomicsBinop(callInfo, MAtomicTypedArrayElementBinop::Add);
+        if (native == atomics_sub)
+            return inlineAtomicsBinop(callInfo, MAtomicTypedArrayElementBinop::Sub);
+        if (native == atomics_and)
+            return inlineAtomicsBinop(callInfo, MAtomicTypedArrayElementBinop::And);
+        if (native == atomics_or)
+            return inlineAtomicsBinop(callInfo, MAtomicTypedArrayElementBinop::Or);
+        if (native == atomics_xor)
+            return inlineAtomicsBinop(callInfo, MAtomicTypedArrayElementBinop::Xor);
+    }
+
+    // SIMD natives.
+    if (SupportsSimd)
+        return inlineSimd(callInfo, native);
+
     return InliningStatus_NotInlined;
 }
 
@@ -1418,6 +1445,480 @@ IonBuilder::inlineNewDenseArrayForParallelExecution(CallInfo &callInfo)
     return InliningStatus_Inlined;
 }
 
+bool
+IonBuilder::isSimdTypeSet(types::TemporaryTypeSet *types, MIRType type)
+{
+    // Only typed objects proper are accepted: handles may be unattached, in
+    // which case they have no data to load.
+    if (!types || types->getKnownClass() != &TypedObject::class_)
+        return false;
+
+    TypeRepresentationSet typeReprs;
+    if (!typeSetToTypeRepresentationSet(types, &typeReprs, types::TypeTypedObject::Datum))
+        return false;
+    if (typeReprs.empty() || !typeReprs.singleton())
+        return false;
+
+    TypeRepresentation *typeRepr = typeReprs.getTypeRepresentation();
+    if (typeRepr->kind() != TypeRepresentation::X4)
+        return false;
+
+    X4TypeRepresentation::Type x4Type = typeRepr->asX4()->type();
+    if (type == MIRType_Float32x4)
+        return x4Type == X4TypeRepresentation::TYPE_FLOAT32;
+    return x4Type == X4TypeRepresentation::TYPE_INT32;
+}
+
+MDefinition *
+IonBuilder::unboxSimd(MDefinition *ins, MIRType type)
+{
+    // Values produced by another inlined SIMD call can be used directly.
+    if (ins->isSimdBox() && ins->toSimdBox()->input()->type() == type)
+        return ins->toSimdBox()->input();
+
+    MSimdUnbox *unbox = MSimdUnbox::New(alloc(), ins, type);
+    current->add(unbox);
+    return unbox;
+}
+
+bool
+IonBuilder::atomicsMeetsPreconditions(CallInfo &callInfo, int *arrayType)
+{
+    if (callInfo.constructing() || info().executionMode() != SequentialExecution)
+        return false;
+
+    // The result must fit in an int32, which rules out Uint32Array, and
+    // Uint8ClampedArray is rejected by the natives themselves.
+    if (getInlineReturnType() != MIRType_Int32)
+        return false;
+
+    types::TemporaryTypeSet *arrayTypes = callInfo.getArg(0)->resultTypeSet();
+    if (!arrayTypes)
+        return false;
+
+    *arrayType = arrayTypes->getTypedArrayType();
+    switch (*arrayType) {
+      case ScalarTypeRepresentation::TYPE_INT8:
+      case ScalarTypeRepresentation::TYPE_UINT8:
+      case ScalarTypeRepresentation::TYPE_INT16:
+      case ScalarTypeRepresentation::TYPE_UINT16:
+      case ScalarTypeRepresentation::TYPE_INT32:
+        break;
+      default:
+        return false;
+    }
+
+    // The index and values are converted by the natives, which may call
+    // valueOf; only inline when they are already int32.
+    for (uint32_t i = 1; i < callInfo.argc(); i++) {
+        if (callInfo.getArg(i)->type() != MIRType_Int32)
+            return false;
+    }
+    return true;
+}
+
+void
+IonBuilder::atomicsCheckBounds(CallInfo &callInfo, MInstruction **elements, MDefinition **index)
+{
+    // Accesses out of bounds bail out, and the native throws the RangeError.
+    MDefinition *obj = callInfo.getArg(0);
+
+    MInstruction *length = getTypedArrayLength(obj);
+    current->add(length);
+
+    *index = addBoundsCheck(callInfo.getArg(1), length);
+
+    *elements = getTypedArrayElements(obj);
+    current->add(*elements);
+}
+
+IonBuilder::InliningStatus
+IonBuilder::inlineAtomicsLoad(CallInfo &callInfo)
+{
+    int arrayType;
+    if (callInfo.argc() != 2 || !atomicsMeetsPreconditions(callInfo, &arrayType))
+        return InliningStatus_NotInlined;
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction *elements;
+    MDefinition *index;
+    atomicsCheckBounds(callInfo, &elements, &index);
+
+    // The barrier keeps the load from being hoisted or merged with another.
+    MMemoryBarrier *barrier = MMemoryBarrier::New(alloc(), false);
+    current->add(barrier);
+
+    MLoadTypedArrayElement *load = MLoadTypedArrayElement::New(alloc(), elements, index,
+                                                                ScalarTypeRepresentation::Type(arrayType));
+    load->setResultType(MIRType_Int32);
+    current->add(load);
+    current->push(load);
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningStatus
+IonBuilder::inlineAtomicsStore(CallInfo &callInfo)
+{
+    int arrayType;
+    if (callInfo.argc() != 3 || !atomicsMeetsPreconditions(callInfo, &arrayType))
+        return InliningStatus_NotInlined;
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction *elements;
+    MDefinition *index;
+    atomicsCheckBounds(callInfo, &elements, &index);
+
+    MDefinition *value = callInfo.getArg(2);
+    MStoreTypedArrayElement *store = MStoreTypedArrayElement::New(alloc(), elements, index, value,
+                                                                  arrayType);
+    current->add(store);
+
+    MMemoryBarrier *barrier = MMemoryBarrier::New(alloc(), true);
+    current->add(barrier);
+
+    current->push(value);
+    if (!resumeAfter(barrier))
+        return InliningStatus_Error;
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningStatus
+IonBuilder::inlineAtomicsCompareExchange(CallInfo &callInfo)
+{
+    int arrayType;
+    if (callInfo.argc() != 4 || !atomicsMeetsPreconditions(callInfo, &arrayType))
+        return InliningStatus_NotInlined;
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction *elements;
+    MDefinition *index;
+    atomicsCheckBounds(callInfo, &elements, &index);
+
+    MCompareExchangeTypedArrayElement *cas =
+        MCompareExchangeTypedArrayElement::New(alloc(), elements, index, callInfo.getArg(2),
+                                               callInfo.getArg(3), arrayType);
+    current->add(cas);
+    current->push(cas);
+    if (!resumeAfter(cas))
+        return InliningStatus_Error;
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningStatus
+IonBuilder::inlineAtomicsBinop(CallInfo &callInfo, MAtomicTypedArrayElementBinop::Operation op)
+{
+    int arrayType;
+    if (callInfo.argc() != 3 || !atomicsMeetsPreconditions(callInfo, &arrayType))
+        return InliningStatus_NotInlined;
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction *elements;
+    MDefinition *index;
+    atomicsCheckBounds(callInfo, &elements, &index);
+
+    MAtomicTypedArrayElementBinop *binop =
+        MAtomicTypedArrayElementBinop::New(alloc(), op, elements, index, callInfo.getArg(2),
+                                           arrayType);
+    current->add(binop);
+    current->push(binop);
+    if (!resumeAfter(binop))
+        return InliningStatus_Error;
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningStatus
+IonBuilder::inlineSimd(CallInfo &callInfo, JSNative native)
+{
+    X4TypeRepresentation::Type x4Type;
+    SimdOperation op;
+    if (!GetSimdOperation(native, &x4Type, &op))
+        return InliningStatus_NotInlined;
+
+    // SIMD values are always boxed again before they can be observed, and
+    // boxing calls into the VM, which is not possible in parallel code.
+    if (callInfo.constructing() || info().executionMode() != SequentialExecution)
+        return InliningStatus_NotInlined;
+
+    MIRType type = x4Type == X4TypeRepresentation::TYPE_FLOAT32
+                   ? MIRType_Float32x4
+                   : MIRType_Int32x4;
+    MIRType otherType = type == MIRType_Float32x4 ? MIRType_Int32x4 : MIRType_Float32x4;
+
+    // Check the arity, the type of each vector operand and the type of the
+    // result. Scalar operands are checked below.
+    uint32_t argc;
+    MIRType argTypes[3] = { type, type, type };
+    MIRType resultType = type;
+    switch (op) {
+      case SimdOp_Zero:
+        argc = 0;
+        break;
+      case SimdOp_Splat:
+        argc = 1;
+        argTypes[0] = MIRType_None;
+        break;
+      case SimdOp_Abs:
+      case SimdOp_Neg:
+      case SimdOp_Not:
+      case SimdOp_Reciprocal:
+      case SimdOp_Sqrt:
+        argc = 1;
+        break;
+      case SimdOp_Convert:
+      case SimdOp_ConvertBits:
+        argc = 1;
+        resultType = otherType;
+        break;
+      case SimdOp_Add:
+      case SimdOp_Sub:
+      case SimdOp_Mul:
+      case SimdOp_Div:
+      case SimdOp_Min:
+      case SimdOp_Max:
+      case SimdOp_And:
+      case SimdOp_Or:
+      case SimdOp_Xor:
+        argc = 2;
+        break;
+      case SimdOp_LessThan:
+      case SimdOp_LessThanOrEqual:
+      case SimdOp_GreaterThan:
+      case SimdOp_GreaterThanOrEqual:
+      case SimdOp_Equal:
+      case SimdOp_NotEqual:
+        argc = 2;
+        resultType = MIRType_Int32x4;
+        break;
+      case SimdOp_Scale:
+        argc = 2;
+        argTypes[1] = MIRType_None;
+        break;
+      case SimdOp_Shuffle:
+        // shuffle(v, mask) or shuffleMix(v1, v2, mask).
+        if (callInfo.argc() != 2 && callInfo.argc() != 3)
+            return InliningStatus_NotInlined;
+        argc = callInfo.argc();
+        argTypes[argc - 1] = MIRType_None;
+        break;
+      case SimdOp_Clamp:
+        argc = 3;
+        break;
+      case SimdOp_Select:
+        argc = 3;
+        argTypes[1] = argTypes[2] = resultType = MIRType_Float32x4;
+        break;
+      default:
+        MOZ_ASSUME_UNREACHABLE("unexpected SIMD operation");
+    }
+
+    if (callInfo.argc() != argc)
+        return InliningStatus_NotInlined;
+    if (!isSimdTypeSet(getInlineReturnTypeSet(), resultType))
+        return InliningStatus_NotInlined;
+    for (uint32_t i = 0; i < argc; i++) {
+        if (argTypes[i] != MIRType_None &&
+            !isSimdTypeSet(callInfo.getArg(i)->resultTypeSet(), argTypes[i]))
+        {
+            return InliningStatus_NotInlined;
+        }
+    }
+
+    int32_t shuffleMask = 0;
+    if (op == SimdOp_Shuffle) {
+        MDefinition *mask = callInfo.getArg(argc - 1);
+        if (!mask->isConstant() || !mask->toConstant()->value().isInt32())
+            return InliningStatus_NotInlined;
+        shuffleMask = mask->toConstant()->value().toInt32();
+        if (shuffleMask < 0 || shuffleMask > 0xff)
+            return InliningStatus_NotInlined;
+    }
+    if (op == SimdOp_Splat || op == SimdOp_Scale) {
+        if (!IsNumberType(callInfo.getArg(argc - 1)->type()))
+            return InliningStatus_NotInlined;
+    }
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MDefinition *args[3];
+    for (uint32_t i = 0; i < argc; i++)
+        args[i] = argTypes[i] != MIRType_None ? unboxSimd(callInfo.getArg(i), argTypes[i]) : nullptr;
+
+    MDefinition *result;
+    switch (op) {
+      case SimdOp_Zero:
+      case SimdOp_Splat: {
+        MDefinition *scalar;
+        if (op == SimdOp_Splat && type == MIRType_Int32x4 &&
+            callInfo.getArg(0)->type() == MIRType_Int32)
+        {
+            scalar = callInfo.getArg(0);
+        } else {
+            MInstruction *ins;
+            if (op == SimdOp_Zero && type == MIRType_Float32x4)
+                ins = MConstant::NewAsmJS(alloc(), DoubleValue(0.0), MIRType_Float32);
+            else if (op == SimdOp_Zero)
+                ins = MConstant::New(alloc(), Int32Value(0));
+            else if (type == MIRType_Float32x4)
+                ins = MToFloat32::New(alloc(), callInfo.getArg(0));
+            else
+                ins = MTruncateToInt32::New(alloc(), callInfo.getArg(0));
+            current->add(ins);
+            scalar = ins;
+        }
+        result = MSimdSplat::New(alloc(), scalar, type);
+        break;
+      }
+
+      case SimdOp_Abs: {
+        // Flip the sign bit of the negative lanes only, leaving -0 and NaN
+        // unchanged like the interpreter does.
+        MInstruction *zero = MConstant::NewAsmJS(alloc(), DoubleValue(0.0), MIRType_Float32);
+        current->add(zero);
+        MInstruction *zeros = MSimdSplat::New(alloc(), zero, MIRType_Float32x4);
+        current->add(zeros);
+        MInstruction *negative = MSimdBinaryComp::New(alloc(), args[0], zeros,
+                                                      MSimdBinaryComp::LessThan);
+        current->add(negative);
+        MInstruction *signBit = MConstant::New(alloc(), Int32Value(INT32_MIN));
+        current->add(signBit);
+        MInstruction *signBits = MSimdSplat::New(alloc(), signBit, MIRType_Int32x4);
+        current->add(signBits);
+        MInstruction *flips = MSimdBinaryArith::New(alloc(), negative, signBits,
+                                                    MSimdBinaryArith::And, MIRType_Int32x4);
+        current->add(flips);
+        MInstruction *bits = MSimdReinterpretCast::New(alloc(), args[0], MIRType_Int32x4);
+        current->add(bits);
+        MInstruction *abs = MSimdBinaryArith::New(alloc(), bits, flips,
+                                                  MSimdBinaryArith::Xor, MIRType_Int32x4);
+        current->add(abs);
+        result = MSimdReinterpretCast::New(alloc(), abs, MIRType_Float32x4);
+        break;
+      }
+
+      case SimdOp_Neg:
+      case SimdOp_Not: {
+        if (type == MIRType_Int32x4) {
+            // neg(v) is 0 - v and not(v) is v ^ -1.
+            MInstruction *scalar = MConstant::New(alloc(), Int32Value(op == SimdOp_Neg ? 0 : -1));
+            current->add(scalar);
+            MInstruction *splat = MSimdSplat::New(alloc(), scalar, type);
+            current->add(splat);
+            if (op == SimdOp_Neg)
+                result = MSimdBinaryArith::New(alloc(), splat, args[0], MSimdBinaryArith::Sub, type);
+            else
+                result = MSimdBinaryArith::New(alloc(), args[0], splat, MSimdBinaryArith::Xor, type);
+            break;
+        }
+        // The interpreter computes neg(v) as -1 * v.
+        MInstruction *minusOne = MConstant::NewAsmJS(alloc(), DoubleValue(-1.0), MIRType_Float32);
+        current->add(minusOne);
+        MInstruction *splat = MSimdSplat::New(alloc(), minusOne, type);
+        current->add(splat);
+        result = MSimdBinaryArith::New(alloc(), args[0], splat, MSimdBinaryArith::Mul, type);
+        break;
+      }
+
+      case SimdOp_Reciprocal: {
+        MInstruction *one = MConstant::NewAsmJS(alloc(), DoubleValue(1.0), MIRType_Float32);
+        current->add(one);
+        MInstruction *splat = MSimdSplat::New(alloc(), one, type);
+        current->add(splat);
+        result = MSimdBinaryArith::New(alloc(), splat, args[0], MSimdBinaryArith::Div, type);
+        break;
+      }
+
+      case SimdOp_Sqrt:
+        result = MSimdSqrt::New(alloc(), args[0]);
+        break;
+
+      case SimdOp_Convert:
+        result = MSimdConvert::New(alloc(), args[0], otherType);
+        break;
+
+      case SimdOp_ConvertBits:
+        result = MSimdReinterpretCast::New(alloc(), args[0], otherType);
+        break;
+
+      case SimdOp_Add:
+      case SimdOp_Sub:
+      case SimdOp_Mul:
+      case SimdOp_Div:
+      case SimdOp_Min:
+      case SimdOp_Max:
+      case SimdOp_And:
+      case SimdOp_Or:
+      case SimdOp_Xor: {
+        static const MSimdBinaryArith::Operation arith[] = {
+            MSimdBinaryArith::Add, MSimdBinaryArith::Sub, MSimdBinaryArith::Mul,
+            MSimdBinaryArith::Div, MSimdBinaryArith::Min, MSimdBinaryArith::Max,
+            MSimdBinaryArith::And, MSimdBinaryArith::Or, MSimdBinaryArith::Xor
+        };
+        result = MSimdBinaryArith::New(alloc(), args[0], args[1], arith[op - SimdOp_Add], type);
+        break;
+      }
+
+      case SimdOp_LessThan:
+        result = MSimdBinaryComp::New(alloc(), args[0], args[1], MSimdBinaryComp::LessThan);
+        break;
+      case SimdOp_LessThanOrEqual:
+        result = MSimdBinaryComp::New(alloc(), args[0], args[1], MSimdBinaryComp::LessThanOrEqual);
+        break;
+      case SimdOp_GreaterThan:
+        result = MSimdBinaryComp::New(alloc(), args[1], args[0], MSimdBinaryComp::LessThan);
+        break;
+      case SimdOp_GreaterThanOrEqual:
+        result = MSimdBinaryComp::New(alloc(), args[1], args[0], MSimdBinaryComp::LessThanOrEqual);
+        break;
+      case SimdOp_Equal:
+        result = MSimdBinaryComp::New(alloc(), args[0], args[1], MSimdBinaryComp::Equal);
+        break;
+      case SimdOp_NotEqual:
+        result = MSimdBinaryComp::New(alloc(), args[0], args[1], MSimdBinaryComp::NotEqual);
+        break;
+
+      case SimdOp_Scale: {
+        MInstruction *scalar = MToFloat32::New(alloc(), callInfo.getArg(1));
+        current->add(scalar);
+        MInstruction *splat = MSimdSplat::New(alloc(), scalar, type);
+        current->add(splat);
+        result = MSimdBinaryArith::New(alloc(), splat, args[0], MSimdBinaryArith::Mul, type);
+        break;
+      }
+
+      case SimdOp_Clamp: {
+        // min(upper, max(lower, v)), whose operand order gives the same
+        // results as the interpreter for NaN and signed zero lanes.
+        MInstruction *lower = MSimdBinaryArith::New(alloc(), args[1], args[0],
+                                                    MSimdBinaryArith::Max, type);
+        current->add(lower);
+        result = MSimdBinaryArith::New(alloc(), args[2], lower, MSimdBinaryArith::Min, type);
+        break;
+      }
+
+      case SimdOp_Shuffle:
+        result = MSimdShuffle::New(alloc(), args[0], argc == 3 ? args[1] : args[0],
+                                   shuffleMask, type);
+        break;
+
+      case SimdOp_Select:
+        result = MSimdSelect::New(alloc(), args[0], args[1], args[2]);
+        break;
+
+      default:
+        MOZ_ASSUME_UNREACHABLE("unexpected SIMD operation");
+    }
+    current->add(result->toInstruction());
+
+    MSimdBox *box = MSimdBox::New(alloc(), result, getInlineReturnTypeSet());
+    current->add(box);
+    current->push(box);
+    return InliningStatus_Inlined;
+}
+
 IonBuilder::InliningStatus
 IonBuilder::inlineUnsafeSetReservedSlot(CallInfo &callInfo)
 {
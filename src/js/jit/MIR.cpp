@@ -2282,6 +2282,69 @@ MToFloat32::foldsTo(TempAllocator &alloc, bool useValueNumbers)
     return this;
 }
 
+MDefinition *
+MSimdUnbox::foldsTo(TempAllocator &alloc, bool useValueNumbers)
+{
+    // Unboxing a value we just boxed gives back the original value.
+    if (object()->isSimdBox() && object()->toSimdBox()->input()->type() == type())
+        return object()->toSimdBox()->input();
+    return this;
+}
+
+MDefinition *
+MSimdReinterpretCast::foldsTo(TempAllocator &alloc, bool useValueNumbers)
+{
+    if (input()->isSimdReinterpretCast()) {
+        MDefinition *original = input()->toSimdReinterpretCast()->input();
+        if (original->type() == type())
+            return original;
+    }
+    return this;
+}
+
+static const char *
+SimdBinaryArithName(MSimdBinaryArith::Operation op)
+{
+    switch (op) {
+      case MSimdBinaryArith::Add: return "add";
+      case MSimdBinaryArith::Sub: return "sub";
+      case MSimdBinaryArith::Mul: return "mul";
+      case MSimdBinaryArith::Div: return "div";
+      case MSimdBinaryArith::Min: return "min";
+      case MSimdBinaryArith::Max: return "max";
+      case MSimdBinaryArith::And: return "and";
+      case MSimdBinaryArith::Or:  return "or";
+      case MSimdBinaryArith::Xor: return "xor";
+    }
+    MOZ_ASSUME_UNREACHABLE("unexpected SIMD operation");
+}
+
+void
+MSimdBinaryArith::printOpcode(FILE *fp) const
+{
+    MDefinition::printOpcode(fp);
+    fprintf(fp, " %s", SimdBinaryArithName(operation()));
+}
+
+static const char *
+SimdBinaryCompName(MSimdBinaryComp::Operation op)
+{
+    switch (op) {
+      case MSimdBinaryComp::LessThan:        return "lessThan";
+      case MSimdBinaryComp::LessThanOrEqual: return "lessThanOrEqual";
+      case MSimdBinaryComp::Equal:           return "equal";
+      case MSimdBinaryComp::NotEqual:        return "notEqual";
+    }
+    MOZ_ASSUME_UNREACHABLE("unexpected SIMD comparison");
+}
+
+void
+MSimdBinaryComp::printOpcode(FILE *fp) const
+{
+    MDefinition::printOpcode(fp);
+    fprintf(fp, " %s", SimdBinaryCompName(operation()));
+}
+
 MDefinition *
 MToString::foldsTo(TempAllocator &alloc, bool useValueNumbers)
 {
@@ -5457,6 +5457,387 @@ class MTypedObjectElements
     }
 };
 
+// Extracts the SIMD value held by a float32x4 or int32x4 typed object.
+class MSimdUnbox
+  : public MUnaryInstruction,
+    public SingleObjectPolicy
+{
+  private:
+    MSimdUnbox(MDefinition *object, MIRType type)
+      : MUnaryInstruction(object)
+    {
+        JS_ASSERT(IsSimdType(type));
+        setResultType(type);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdUnbox)
+
+    static MSimdUnbox *New(TempAllocator &alloc, MDefinition *object, MIRType type) {
+        return new(alloc) MSimdUnbox(object, type);
+    }
+
+    TypePolicy *typePolicy() {
+        return this;
+    }
+    MDefinition *object() const {
+        return getOperand(0);
+    }
+    MDefinition *foldsTo(TempAllocator &alloc, bool useValueNumbers);
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        // The typed object's memory is written like typed array elements.
+        return AliasSet::Load(AliasSet::TypedArrayElement);
+    }
+};
+
+// Allocates a new typed object holding a SIMD value. SIMD values never flow
+// into resume points unboxed: the results of inlined SIMD natives are always
+// boxed, and unused boxes are removed as dead code.
+class MSimdBox : public MUnaryInstruction
+{
+  private:
+    MSimdBox(MDefinition *input, types::TemporaryTypeSet *resultTypes)
+      : MUnaryInstruction(input)
+    {
+        JS_ASSERT(IsSimdType(input->type()));
+        setResultType(MIRType_Object);
+        setResultTypeSet(resultTypes);
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdBox)
+
+    static MSimdBox *New(TempAllocator &alloc, MDefinition *input,
+                         types::TemporaryTypeSet *resultTypes)
+    {
+        return new(alloc) MSimdBox(input, resultTypes);
+    }
+
+    MDefinition *input() const {
+        return getOperand(0);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+    bool possiblyCalls() const {
+        return true;
+    }
+};
+
+// Creates a SIMD value with all lanes set to the same float32 or int32 value.
+class MSimdSplat : public MUnaryInstruction
+{
+  private:
+    MSimdSplat(MDefinition *scalar, MIRType type)
+      : MUnaryInstruction(scalar)
+    {
+        JS_ASSERT_IF(type == MIRType_Float32x4, scalar->type() == MIRType_Float32);
+        JS_ASSERT_IF(type == MIRType_Int32x4, scalar->type() == MIRType_Int32);
+        setResultType(type);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdSplat)
+
+    static MSimdSplat *New(TempAllocator &alloc, MDefinition *scalar, MIRType type) {
+        return new(alloc) MSimdSplat(scalar, type);
+    }
+
+    MDefinition *scalar() const {
+        return getOperand(0);
+    }
+    bool canConsumeFloat32() const {
+        return type() == MIRType_Float32x4;
+    }
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
+// Lane-wise arithmetic and bitwise operations on two SIMD values of the same
+// type.
+class MSimdBinaryArith : public MBinaryInstruction
+{
+  public:
+    enum Operation {
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Min,
+        Max,
+        And,
+        Or,
+        Xor
+    };
+
+  private:
+    Operation operation_;
+
+    MSimdBinaryArith(MDefinition *lhs, MDefinition *rhs, Operation op, MIRType type)
+      : MBinaryInstruction(lhs, rhs),
+        operation_(op)
+    {
+        JS_ASSERT(IsSimdType(type));
+        JS_ASSERT(lhs->type() == type && rhs->type() == type);
+        JS_ASSERT_IF(type == MIRType_Int32x4, op != Mul && op != Div && op != Min && op != Max);
+        setResultType(type);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdBinaryArith)
+
+    static MSimdBinaryArith *New(TempAllocator &alloc, MDefinition *lhs, MDefinition *rhs,
+                                 Operation op, MIRType type)
+    {
+        return new(alloc) MSimdBinaryArith(lhs, rhs, op, type);
+    }
+
+    Operation operation() const {
+        return operation_;
+    }
+    bool congruentTo(MDefinition *ins) const {
+        if (!ins->isSimdBinaryArith() || ins->toSimdBinaryArith()->operation() != operation_)
+            return false;
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+    void printOpcode(FILE *fp) const;
+};
+
+// Lane-wise comparison of two float32x4 values, producing an int32x4 whose
+// lanes are all ones where the comparison holds and zero elsewhere.
+class MSimdBinaryComp : public MBinaryInstruction
+{
+  public:
+    // Greater-than comparisons are expressed by swapping the operands.
+    enum Operation {
+        LessThan,
+        LessThanOrEqual,
+        Equal,
+        NotEqual
+    };
+
+  private:
+    Operation operation_;
+
+    MSimdBinaryComp(MDefinition *lhs, MDefinition *rhs, Operation op)
+      : MBinaryInstruction(lhs, rhs),
+        operation_(op)
+    {
+        JS_ASSERT(lhs->type() == MIRType_Float32x4 && rhs->type() == MIRType_Float32x4);
+        setResultType(MIRType_Int32x4);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdBinaryComp)
+
+    static MSimdBinaryComp *New(TempAllocator &alloc, MDefinition *lhs, MDefinition *rhs,
+                                Operation op)
+    {
+        return new(alloc) MSimdBinaryComp(lhs, rhs, op);
+    }
+
+    Operation operation() const {
+        return operation_;
+    }
+    bool congruentTo(MDefinition *ins) const {
+        if (!ins->isSimdBinaryComp() || ins->toSimdBinaryComp()->operation() != operation_)
+            return false;
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+    void printOpcode(FILE *fp) const;
+};
+
+// Lane-wise square root of a float32x4 value.
+class MSimdSqrt : public MUnaryInstruction
+{
+  private:
+    MSimdSqrt(MDefinition *input)
+      : MUnaryInstruction(input)
+    {
+        JS_ASSERT(input->type() == MIRType_Float32x4);
+        setResultType(MIRType_Float32x4);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdSqrt)
+
+    static MSimdSqrt *New(TempAllocator &alloc, MDefinition *input) {
+        return new(alloc) MSimdSqrt(input);
+    }
+
+    MDefinition *input() const {
+        return getOperand(0);
+    }
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
+// Converts each lane of an int32x4 to float32, or truncates each lane of a
+// float32x4 to int32.
+class MSimdConvert : public MUnaryInstruction
+{
+  private:
+    MSimdConvert(MDefinition *input, MIRType toType)
+      : MUnaryInstruction(input)
+    {
+        JS_ASSERT(IsSimdType(input->type()) && IsSimdType(toType));
+        JS_ASSERT(input->type() != toType);
+        setResultType(toType);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdConvert)
+
+    static MSimdConvert *New(TempAllocator &alloc, MDefinition *input, MIRType toType) {
+        return new(alloc) MSimdConvert(input, toType);
+    }
+
+    MDefinition *input() const {
+        return getOperand(0);
+    }
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
+// Reinterprets the bits of a SIMD value as another SIMD type.
+class MSimdReinterpretCast : public MUnaryInstruction
+{
+  private:
+    MSimdReinterpretCast(MDefinition *input, MIRType toType)
+      : MUnaryInstruction(input)
+    {
+        JS_ASSERT(IsSimdType(input->type()) && IsSimdType(toType));
+        JS_ASSERT(input->type() != toType);
+        setResultType(toType);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdReinterpretCast)
+
+    static MSimdReinterpretCast *New(TempAllocator &alloc, MDefinition *input, MIRType toType) {
+        return new(alloc) MSimdReinterpretCast(input, toType);
+    }
+
+    MDefinition *input() const {
+        return getOperand(0);
+    }
+    MDefinition *foldsTo(TempAllocator &alloc, bool useValueNumbers);
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
+// Picks the two low lanes of the result from lhs and the two high lanes from
+// rhs, each lane being chosen by two bits of the mask, like shufps does.
+class MSimdShuffle : public MBinaryInstruction
+{
+  private:
+    uint32_t mask_;
+
+    MSimdShuffle(MDefinition *lhs, MDefinition *rhs, uint32_t mask, MIRType type)
+      : MBinaryInstruction(lhs, rhs),
+        mask_(mask)
+    {
+        JS_ASSERT(IsSimdType(type));
+        JS_ASSERT(lhs->type() == type && rhs->type() == type);
+        JS_ASSERT(mask <= 0xff);
+        setResultType(type);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdShuffle)
+
+    static MSimdShuffle *New(TempAllocator &alloc, MDefinition *lhs, MDefinition *rhs,
+                             uint32_t mask, MIRType type)
+    {
+        return new(alloc) MSimdShuffle(lhs, rhs, mask, type);
+    }
+
+    uint32_t mask() const {
+        return mask_;
+    }
+    bool congruentTo(MDefinition *ins) const {
+        if (!ins->isSimdShuffle() || ins->toSimdShuffle()->mask() != mask_)
+            return false;
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
+// Bitwise select: takes the bits of onTrue where the int32x4 mask is set and
+// the bits of onFalse elsewhere.
+class MSimdSelect : public MTernaryInstruction
+{
+  private:
+    MSimdSelect(MDefinition *mask, MDefinition *onTrue, MDefinition *onFalse)
+      : MTernaryInstruction(mask, onTrue, onFalse)
+    {
+        JS_ASSERT(mask->type() == MIRType_Int32x4);
+        JS_ASSERT(onTrue->type() == MIRType_Float32x4 && onFalse->type() == MIRType_Float32x4);
+        setResultType(MIRType_Float32x4);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(SimdSelect)
+
+    static MSimdSelect *New(TempAllocator &alloc, MDefinition *mask, MDefinition *onTrue,
+                            MDefinition *onFalse)
+    {
+        return new(alloc) MSimdSelect(mask, onTrue, onFalse);
+    }
+
+    MDefinition *mask() const {
+        return getOperand(0);
+    }
+    MDefinition *onTrue() const {
+        return getOperand(1);
+    }
+    MDefinition *onFalse() const {
+        return getOperand(2);
+    }
+    bool congruentTo(MDefinition *ins) const {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::None();
+    }
+};
+
 // Perform !-operation
 class MNot
   : public MUnaryInstruction,
@@ -6320,6 +6701,160 @@ class MStoreTypedArrayElementStatic :
     bool canConsumeFloat32() const { return typedArray_->type() == ScalarTypeRepresentation::TYPE_FLOAT32; }
 };
 
+// Full memory barrier around an inlined atomic access to typed array memory.
+// It only needs to emit code after a store; other accesses are made
+// sequentially consistent by their locked instructions or x86's ordering of
+// loads, but the barrier still keeps loads and stores from moving across it.
+class MMemoryBarrier : public MNullaryInstruction
+{
+    bool afterStore_;
+
+    MMemoryBarrier(bool afterStore)
+      : afterStore_(afterStore)
+    {
+        setGuard();
+    }
+
+  public:
+    INSTRUCTION_HEADER(MemoryBarrier);
+
+    static MMemoryBarrier *New(TempAllocator &alloc, bool afterStore) {
+        return new(alloc) MMemoryBarrier(afterStore);
+    }
+    bool afterStore() const {
+        return afterStore_;
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::Store(AliasSet::TypedArrayElement);
+    }
+};
+
+// Atomically replace an element of an integer typed array with the result of
+// an arithmetic or bitwise operation on it, yielding the old value.
+class MAtomicTypedArrayElementBinop
+  : public MAryInstruction<3>
+{
+  public:
+    enum Operation {
+        Add,
+        Sub,
+        And,
+        Or,
+        Xor
+    };
+
+  private:
+    Operation operation_;
+    int arrayType_;
+
+    MAtomicTypedArrayElementBinop(Operation op, MDefinition *elements, MDefinition *index,
+                                  MDefinition *value, int arrayType)
+      : operation_(op), arrayType_(arrayType)
+    {
+        JS_ASSERT(elements->type() == MIRType_Elements);
+        JS_ASSERT(index->type() == MIRType_Int32);
+        JS_ASSERT(value->type() == MIRType_Int32);
+        JS_ASSERT(arrayType >= 0 && arrayType <= ScalarTypeRepresentation::TYPE_INT32);
+        setOperand(0, elements);
+        setOperand(1, index);
+        setOperand(2, value);
+        setResultType(MIRType_Int32);
+        setGuard();
+    }
+
+  public:
+    INSTRUCTION_HEADER(AtomicTypedArrayElementBinop);
+
+    static MAtomicTypedArrayElementBinop *New(TempAllocator &alloc, Operation op,
+                                              MDefinition *elements, MDefinition *index,
+                                              MDefinition *value, int arrayType)
+    {
+        return new(alloc) MAtomicTypedArrayElementBinop(op, elements, index, value, arrayType);
+    }
+
+    Operation operation() const {
+        return operation_;
+    }
+    int arrayType() const {
+        return arrayType_;
+    }
+    bool isByteArray() const {
+        return (arrayType_ == ScalarTypeRepresentation::TYPE_INT8 ||
+                arrayType_ == ScalarTypeRepresentation::TYPE_UINT8);
+    }
+    MDefinition *elements() const {
+        return getOperand(0);
+    }
+    MDefinition *index() const {
+        return getOperand(1);
+    }
+    MDefinition *value() const {
+        return getOperand(2);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::Store(AliasSet::TypedArrayElement);
+    }
+};
+
+// Atomically store |newval| into an element of an integer typed array if the
+// element equals |oldval|, yielding the element's old value.
+class MCompareExchangeTypedArrayElement
+  : public MAryInstruction<4>
+{
+    int arrayType_;
+
+    MCompareExchangeTypedArrayElement(MDefinition *elements, MDefinition *index,
+                                      MDefinition *oldval, MDefinition *newval, int arrayType)
+      : arrayType_(arrayType)
+    {
+        JS_ASSERT(elements->type() == MIRType_Elements);
+        JS_ASSERT(index->type() == MIRType_Int32);
+        JS_ASSERT(oldval->type() == MIRType_Int32);
+        JS_ASSERT(newval->type() == MIRType_Int32);
+        JS_ASSERT(arrayType >= 0 && arrayType <= ScalarTypeRepresentation::TYPE_INT32);
+        setOperand(0, elements);
+        setOperand(1, index);
+        setOperand(2, oldval);
+        setOperand(3, newval);
+        setResultType(MIRType_Int32);
+        setGuard();
+    }
+
+  public:
+    INSTRUCTION_HEADER(CompareExchangeTypedArrayElement);
+
+    static MCompareExchangeTypedArrayElement *New(TempAllocator &alloc, MDefinition *elements,
+                                                  MDefinition *index, MDefinition *oldval,
+                                                  MDefinition *newval, int arrayType)
+    {
+        return new(alloc) MCompareExchangeTypedArrayElement(elements, index, oldval, newval,
+                                                            arrayType);
+    }
+
+    int arrayType() const {
+        return arrayType_;
+    }
+    bool isByteArray() const {
+        return (arrayType_ == ScalarTypeRepresentation::TYPE_INT8 ||
+                arrayType_ == ScalarTypeRepresentation::TYPE_UINT8);
+    }
+    MDefinition *elements() const {
+        return getOperand(0);
+    }
+    MDefinition *index() const {
+        return getOperand(1);
+    }
+    MDefinition *oldval() const {
+        return getOperand(2);
+    }
+    MDefinition *newval() const {
+        return getOperand(3);
+    }
+    AliasSet getAliasSet() const {
+        return AliasSet::Store(AliasSet::TypedArrayElement);
+    }
+};
+
 // Compute an "effective address", i.e., a compound computation of the form:
 //   base + index * scale + displacement
 class MEffectiveAddress : public MBinaryInstruction
@@ -129,6 +129,16 @@ namespace jit {
     _(TypedArrayLength)                                                     \
     _(TypedArrayElements)                                                   \
     _(TypedObjectElements)                                                  \
+    _(SimdUnbox)                                                            \
+    _(SimdBox)                                                              \
+    _(SimdSplat)                                                            \
+    _(SimdBinaryArith)                                                      \
+    _(SimdBinaryComp)                                                       \
+    _(SimdSqrt)                                                             \
+    _(SimdConvert)                                                          \
+    _(SimdReinterpretCast)                                                  \
+    _(SimdShuffle)                                                          \
+    _(SimdSelect)                                                           \
     _(InitializedLength)                                                    \
     _(SetInitializedLength)                                                 \
     _(Not)                                                                  \
@@ -148,6 +158,9 @@ namespace jit {
     _(StoreTypedArrayElement)                                               \
     _(StoreTypedArrayElementHole)                                           \
     _(StoreTypedArrayElementStatic)                                         \
+    _(MemoryBarrier)                                                        \
+    _(AtomicTypedArrayElementBinop)                                         \
+    _(CompareExchangeTypedArrayElement)                                     \
     _(EffectiveAddress)                                                     \
     _(ClampToUint8)                                                         \
     _(LoadFixedSlot)                                                        \
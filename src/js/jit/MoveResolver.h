@@ -118,7 +118,8 @@ class MoveOp
         GENERAL,
         INT32,
         FLOAT32,
-        DOUBLE
+        DOUBLE,
+        SIMD128
     };
 
   protected:
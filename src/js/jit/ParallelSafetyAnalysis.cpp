@@ -183,6 +183,16 @@ class ParallelSafetyVisitor : public MInstructionVisitor
     CUSTOM_OP(NewObject)
     CUSTOM_OP(NewCallObject)
     UNSAFE_OP(NewDerivedTypedObject)
+    SAFE_OP(SimdUnbox)
+    UNSAFE_OP(SimdBox)
+    SAFE_OP(SimdSplat)
+    SAFE_OP(SimdBinaryArith)
+    SAFE_OP(SimdBinaryComp)
+    SAFE_OP(SimdSqrt)
+    SAFE_OP(SimdConvert)
+    SAFE_OP(SimdReinterpretCast)
+    SAFE_OP(SimdShuffle)
+    SAFE_OP(SimdSelect)
     UNSAFE_OP(InitElem)
     UNSAFE_OP(InitElemGetterSetter)
     UNSAFE_OP(InitProp)
@@ -235,6 +245,9 @@ class ParallelSafetyVisitor : public MInstructionVisitor
     MAYBE_WRITE_GUARDED_OP(StoreTypedArrayElement, elements)
     WRITE_GUARDED_OP(StoreTypedArrayElementHole, elements)
     UNSAFE_OP(StoreTypedArrayElementStatic)
+    UNSAFE_OP(MemoryBarrier)
+    UNSAFE_OP(AtomicTypedArrayElementBinop)
+    UNSAFE_OP(CompareExchangeTypedArrayElement)
     UNSAFE_OP(ClampToUint8)
     SAFE_OP(LoadFixedSlot)
     WRITE_GUARDED_OP(StoreFixedSlot, object)
@@ -78,6 +78,14 @@ struct FloatRegister {
     }
 };
 
+// A float register as saved by MacroAssembler::PushRegsInMask. Its double
+// value is held in the low bytes.
+union FloatRegisterSpill
+{
+    double d;
+    uint8_t bytes[FloatRegisterSpillSize];
+};
+
 class RegisterDump
 {
   protected: // Silence Clang warning.
@@ -101,7 +109,7 @@ class MachineState
 
   public:
     static MachineState FromBailout(mozilla::Array<uintptr_t, Registers::Total> &regs,
-                                    mozilla::Array<double, FloatRegisters::Total> &fpregs);
+                                    mozilla::Array<FloatRegisterSpill, FloatRegisters::Total> &fpregs);
 
     void setRegisterLocation(Register reg, uintptr_t *up) {
         regs_[reg.code()] = up;
@@ -16,6 +16,7 @@ class StackSlotAllocator
 {
     js::Vector<uint32_t, 4, SystemAllocPolicy> normalSlots;
     js::Vector<uint32_t, 4, SystemAllocPolicy> doubleSlots;
+    js::Vector<uint32_t, 4, SystemAllocPolicy> quadSlots;
     uint32_t height_;
 
     void freeSlot(uint32_t index) {
@@ -24,6 +25,19 @@ class StackSlotAllocator
     void freeDoubleSlot(uint32_t index) {
         doubleSlots.append(index);
     }
+    void freeQuadSlot(uint32_t index) {
+        quadSlots.append(index);
+    }
+
+    uint32_t allocateQuadSlot() {
+        // SIMD values are always moved to and from the stack with unaligned
+        // accesses, so only keep the slot 8-byte aligned like doubles.
+        if (!quadSlots.empty())
+            return quadSlots.popCopy();
+        if (height_ % 8 != 0)
+            normalSlots.append(height_ += 4);
+        return height_ += 16;
+    }
 
     uint32_t allocateDoubleSlot() {
         if (!doubleSlots.empty())
@@ -69,6 +83,7 @@ class StackSlotAllocator
           case LDefinition::PAYLOAD:
 #endif
           case LDefinition::DOUBLE:  return freeDoubleSlot(index);
+          case LDefinition::SIMD128: return freeQuadSlot(index);
           default: MOZ_ASSUME_UNREACHABLE("Unknown slot type");
         }
     }
@@ -95,6 +110,7 @@ class StackSlotAllocator
           case LDefinition::PAYLOAD:
 #endif
           case LDefinition::DOUBLE:  return allocateDoubleSlot();
+          case LDefinition::SIMD128: return allocateQuadSlot();
           default: MOZ_ASSUME_UNREACHABLE("Unknown slot type");
         }
     }
@@ -14,7 +14,8 @@ using namespace js::jit;
 static inline uint32_t
 DefaultStackSlot(uint32_t vreg)
 {
-    return vreg * sizeof(Value);
+    // Every virtual register gets a slot wide enough for a SIMD value.
+    return vreg * 2 * sizeof(Value);
 }
 
 LAllocation *
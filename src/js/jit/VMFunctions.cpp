@@ -6,6 +6,7 @@
 
 #include "jit/VMFunctions.h"
 
+#include "builtin/RegExp.h"
 #include "builtin/TypedObject.h"
 #include "frontend/BytecodeCompiler.h"
 #include "jit/BaselineIC.h"
@@ -14,6 +15,7 @@
 #include "vm/ArrayObject.h"
 #include "vm/Debugger.h"
 #include "vm/Interpreter.h"
+#include "vm/RegExpStatics.h"
 
 #include "jsinferinlines.h"
 
@@ -281,8 +283,12 @@ NewInitArray(JSContext *cx, uint32_t count, types::TypeObject *typeArg)
 {
     RootedTypeObject type(cx, typeArg);
     NewObjectKind newKind = !type ? SingletonObject : GenericObject;
-    if (type && type->shouldPreTenure())
-        newKind = TenuredObject;
+    if (type) {
+        if (type->shouldPreTenure())
+            newKind = TenuredObject;
+        else
+            type->noteNurseryAllocation();
+    }
     RootedObject obj(cx, NewDenseAllocatedArray(cx, count, nullptr, newKind));
     if (!obj)
         return nullptr;
@@ -297,8 +303,12 @@ JSObject*
 NewInitObject(JSContext *cx, HandleObject templateObject)
 {
     NewObjectKind newKind = templateObject->hasSingletonType() ? SingletonObject : GenericObject;
-    if (!templateObject->hasLazyType() && templateObject->type()->shouldPreTenure())
-        newKind = TenuredObject;
+    if (!templateObject->hasLazyType()) {
+        if (templateObject->type()->shouldPreTenure())
+            newKind = TenuredObject;
+        else if (newKind == GenericObject)
+            templateObject->type()->noteNurseryAllocation();
+    }
     RootedObject obj(cx, CopyInitializerObject(cx, templateObject, newKind));
 
     if (!obj)
@@ -316,9 +326,11 @@ NewInitObjectWithClassPrototype(JSContext *cx, HandleObject templateObject)
     JS_ASSERT(!templateObject->hasSingletonType());
     JS_ASSERT(!templateObject->hasLazyType());
 
-    NewObjectKind newKind = templateObject->type()->shouldPreTenure()
-                            ? TenuredObject
-                            : GenericObject;
+    NewObjectKind newKind = GenericObject;
+    if (templateObject->type()->shouldPreTenure())
+        newKind = TenuredObject;
+    else
+        templateObject->type()->noteNurseryAllocation();
     JSObject *obj = NewObjectWithGivenProto(cx,
                                             templateObject->getClass(),
                                             templateObject->getProto(),
@@ -428,6 +440,32 @@ StringFromCharCode(JSContext *cx, int32_t code)
     return js_NewStringCopyN<CanGC>(cx, &c, 1);
 }
 
+// Finish a RegExp.prototype.exec whose regexp matched when called directly
+// from jitcode, which left the match pairs in |pairs|.
+bool
+RegExpExecMatched(JSContext *cx, HandleString input, MatchPair *pairs, uint32_t pairCount,
+                  MutableHandleValue rval)
+{
+    Rooted<JSLinearString*> linearInput(cx, &input->asLinear());
+    FixedMatchPairs matches(pairs, pairCount);
+
+    RegExpStatics *res = cx->global()->getRegExpStatics();
+    if (!res->updateFromMatchPairs(cx, linearInput, matches))
+        return false;
+
+    return CreateRegExpMatchResult(cx, linearInput, linearInput->chars(), linearInput->length(),
+                                   matches, rval);
+}
+
+// Called without an exit frame after RegExp.prototype.test matched from
+// jitcode, so this must not GC.
+void
+RegExpTestMatched(JSContext *cx, JSString *input, RegExpShared *shared, uint32_t lastIndex)
+{
+    RegExpStatics *res = cx->global()->getRegExpStatics();
+    res->updateLazily(cx, &input->asLinear(), shared, lastIndex);
+}
+
 bool
 SetProperty(JSContext *cx, HandleObject obj, HandlePropertyName name, HandleValue value,
             bool strict, jsbytecode *pc)
@@ -913,6 +951,17 @@ JSObject *CreateDerivedTypedObj(JSContext *cx, HandleObject type,
     return TypedObject::createDerived(cx, type, owner, offset);
 }
 
+JSObject *
+NewZeroedX4Object(JSContext *cx, int32_t type)
+{
+    RootedObject typeObj(cx);
+    if (type == X4TypeRepresentation::TYPE_FLOAT32)
+        typeObj = &cx->global()->float32x4TypeObject();
+    else
+        typeObj = &cx->global()->int32x4TypeObject();
+    return TypedObject::createZeroed(cx, typeObj, 0);
+}
+
 JSString *
 regexp_replace(JSContext *cx, HandleString string, HandleObject regexp, HandleString repl)
 {
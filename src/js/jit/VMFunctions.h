@@ -16,6 +16,8 @@ namespace js {
 
 class DeclEnvObject;
 class ForkJoinSlice;
+struct MatchPair;
+class RegExpShared;
 
 namespace jit {
 
@@ -607,6 +609,10 @@ JSObject *ArrayConcatDense(JSContext *cx, HandleObject obj1, HandleObject obj2,
 bool CharCodeAt(JSContext *cx, HandleString str, int32_t index, uint32_t *code);
 JSFlatString *StringFromCharCode(JSContext *cx, int32_t code);
 
+bool RegExpExecMatched(JSContext *cx, HandleString input, MatchPair *pairs, uint32_t pairCount,
+                       MutableHandleValue rval);
+void RegExpTestMatched(JSContext *cx, JSString *input, RegExpShared *shared, uint32_t lastIndex);
+
 bool SetProperty(JSContext *cx, HandleObject obj, HandlePropertyName name, HandleValue value,
                  bool strict, jsbytecode *pc);
 
@@ -661,6 +667,7 @@ bool InitBaselineFrameForOsr(BaselineFrame *frame, StackFrame *interpFrame,
 
 JSObject *CreateDerivedTypedObj(JSContext *cx, HandleObject type,
                                 HandleObject owner, int32_t offset);
+JSObject *NewZeroedX4Object(JSContext *cx, int32_t type);
 
 bool Recompile(JSContext *cx);
 JSString *regexp_replace(JSContext *cx, HandleString string, HandleObject regexp,
@@ -23,6 +23,18 @@ namespace jit {
 //   +8 for double spills
 static const uint32_t ION_FRAME_SLACK_SIZE   = 20;
 
+// Size in bytes of a float register saved by PushRegsInMask.
+static const uint32_t FloatRegisterSpillSize = sizeof(double);
+
+// SIMD operations are not compiled inline yet.
+static const bool SupportsSimd = false;
+
+// Atomics operations are not compiled inline yet.
+static const bool SupportsAtomics = false;
+
+// RegExp exec and test call Yarr's generated code from the VM.
+static const bool SupportsDirectRegExpCalls = false;
+
 // These offsets are specific to nunboxing, and capture offsets into the
 // components of a js::Value.
 static const int32_t NUNBOX32_TYPE_OFFSET    = 4;
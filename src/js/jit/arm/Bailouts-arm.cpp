@@ -77,7 +77,7 @@ class BailoutStack
     };
 
   private:
-    mozilla::Array<double, FloatRegisters::Total> fpregs_;
+    mozilla::Array<FloatRegisterSpill, FloatRegisters::Total> fpregs_;
     mozilla::Array<uintptr_t, Registers::Total> regs_;
 
     uintptr_t snapshotOffset_;
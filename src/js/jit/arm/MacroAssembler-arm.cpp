@@ -1847,6 +1847,15 @@ MacroAssemblerARMCompat::add32(Imm32 imm, const Address &dest)
     store32(ScratchRegister, dest);
 }
 
+void
+MacroAssemblerARMCompat::add32(Imm32 imm, AbsoluteAddress dest)
+{
+    ma_mov(Imm32((int32_t)dest.addr), ScratchRegister);
+    load32(Address(ScratchRegister, 0), secondScratchReg_);
+    ma_add(imm, secondScratchReg_, SetCond);
+    store32(secondScratchReg_, Address(ScratchRegister, 0));
+}
+
 void
 MacroAssemblerARMCompat::sub32(Imm32 imm, Register dest)
 {
@@ -1216,6 +1216,7 @@ class MacroAssemblerARMCompat : public MacroAssemblerARM
     void add32(Register src, Register dest);
     void add32(Imm32 imm, Register dest);
     void add32(Imm32 imm, const Address &dest);
+    void add32(Imm32 imm, AbsoluteAddress dest);
     void sub32(Imm32 imm, Register dest);
     void sub32(Register src, Register dest);
     void xor32(Imm32 imm, Register dest);
@@ -467,6 +467,14 @@ class AssemblerX86Shared
             MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
         }
     }
+    void movups(const Address &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.movups_mr(src.offset, src.base.code(), dest.code());
+    }
+    void movups(const FloatRegister &src, const Address &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.movups_rm(src.code(), dest.offset, dest.base.code());
+    }
     void cvtss2sd(const FloatRegister &src, const FloatRegister &dest) {
         JS_ASSERT(HasSSE2());
         masm.cvtss2sd_rr(src.code(), dest.code());
@@ -1119,6 +1127,70 @@ class AssemblerX86Shared
         }
     }
 
+    void xaddw(const Register &srcdest, const Operand &mem) {
+        switch (mem.kind()) {
+          case Operand::MEM_REG_DISP:
+            masm.xaddw_rm(srcdest.code(), mem.disp(), mem.base());
+            break;
+          case Operand::MEM_SCALE:
+            masm.xaddw_rm(srcdest.code(), mem.disp(), mem.base(), mem.index(), mem.scale());
+            break;
+          default:
+            MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
+        }
+    }
+    void xaddb(const Register &srcdest, const Operand &mem) {
+        switch (mem.kind()) {
+          case Operand::MEM_REG_DISP:
+            masm.xaddb_rm(srcdest.code(), mem.disp(), mem.base());
+            break;
+          case Operand::MEM_SCALE:
+            masm.xaddb_rm(srcdest.code(), mem.disp(), mem.base(), mem.index(), mem.scale());
+            break;
+          default:
+            MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
+        }
+    }
+    void lock_cmpxchgl(const Register &src, const Operand &mem) {
+        switch (mem.kind()) {
+          case Operand::MEM_REG_DISP:
+            masm.cmpxchgl_rm(src.code(), mem.disp(), mem.base());
+            break;
+          case Operand::MEM_SCALE:
+            masm.cmpxchgl_rm(src.code(), mem.disp(), mem.base(), mem.index(), mem.scale());
+            break;
+          default:
+            MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
+        }
+    }
+    void lock_cmpxchgw(const Register &src, const Operand &mem) {
+        switch (mem.kind()) {
+          case Operand::MEM_REG_DISP:
+            masm.cmpxchgw_rm(src.code(), mem.disp(), mem.base());
+            break;
+          case Operand::MEM_SCALE:
+            masm.cmpxchgw_rm(src.code(), mem.disp(), mem.base(), mem.index(), mem.scale());
+            break;
+          default:
+            MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
+        }
+    }
+    void lock_cmpxchgb(const Register &src, const Operand &mem) {
+        switch (mem.kind()) {
+          case Operand::MEM_REG_DISP:
+            masm.cmpxchgb_rm(src.code(), mem.disp(), mem.base());
+            break;
+          case Operand::MEM_SCALE:
+            masm.cmpxchgb_rm(src.code(), mem.disp(), mem.base(), mem.index(), mem.scale());
+            break;
+          default:
+            MOZ_ASSUME_UNREACHABLE("unexpected operand kind");
+        }
+    }
+    void mfence() {
+        masm.mfence();
+    }
+
     void push(const Imm32 imm) {
         masm.push_i32(imm.value);
     }
@@ -1178,6 +1250,18 @@ class AssemblerX86Shared
     void movzbl(const Register &src, const Register &dest) {
         masm.movzbl_rr(src.code(), dest.code());
     }
+    // Sign-extend byte to 32-bit integer.
+    void movsbl(const Register &src, const Register &dest) {
+        masm.movsbl_rr(src.code(), dest.code());
+    }
+    // Zero-extend 16-bit word to 32-bit integer.
+    void movzwl(const Register &src, const Register &dest) {
+        masm.movzwl_rr(src.code(), dest.code());
+    }
+    // Sign-extend 16-bit word to 32-bit integer.
+    void movswl(const Register &src, const Register &dest) {
+        masm.movswl_rr(src.code(), dest.code());
+    }
 
     void cdq() {
         masm.cdq();
@@ -1465,6 +1549,82 @@ class AssemblerX86Shared
         JS_ASSERT(HasSSE2());
         masm.andps_rr(src.code(), dest.code());
     }
+    void orps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.orps_rr(src.code(), dest.code());
+    }
+    void andnps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.andnps_rr(src.code(), dest.code());
+    }
+    void addps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.addps_rr(src.code(), dest.code());
+    }
+    void subps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.subps_rr(src.code(), dest.code());
+    }
+    void mulps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.mulps_rr(src.code(), dest.code());
+    }
+    void divps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.divps_rr(src.code(), dest.code());
+    }
+    void minps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.minps_rr(src.code(), dest.code());
+    }
+    void maxps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.maxps_rr(src.code(), dest.code());
+    }
+    void sqrtps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.sqrtps_rr(src.code(), dest.code());
+    }
+    void cvtdq2ps(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.cvtdq2ps_rr(src.code(), dest.code());
+    }
+    void cvttps2dq(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.cvttps2dq_rr(src.code(), dest.code());
+    }
+    void paddd(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.paddd_rr(src.code(), dest.code());
+    }
+    void psubd(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.psubd_rr(src.code(), dest.code());
+    }
+    void pand(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.pand_rr(src.code(), dest.code());
+    }
+    void por(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.por_rr(src.code(), dest.code());
+    }
+    void pxor(const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.pxor_rr(src.code(), dest.code());
+    }
+    void cmpps(const FloatRegister &src, const FloatRegister &dest, int predicate) {
+        JS_ASSERT(HasSSE2());
+        masm.cmpps_rr(src.code(), dest.code(), predicate);
+    }
+    void shufps(uint32_t mask, const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.shufps_irr(mask, src.code(), dest.code());
+    }
+    void pshufd(uint32_t mask, const FloatRegister &src, const FloatRegister &dest) {
+        JS_ASSERT(HasSSE2());
+        masm.pshufd_irr(mask, src.code(), dest.code());
+    }
     void sqrtsd(const FloatRegister &src, const FloatRegister &dest) {
         JS_ASSERT(HasSSE2());
         masm.sqrtsd_rr(src.code(), dest.code());
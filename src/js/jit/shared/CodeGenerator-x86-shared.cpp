@@ -9,6 +9,7 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MathAlgorithms.h"
 
+#include "builtin/TypedObject.h"
 #include "jit/IonFrames.h"
 #include "jit/JitCompartment.h"
 #include "jit/RangeAnalysis.h"
@@ -1803,6 +1804,326 @@ CodeGeneratorX86Shared::visitNegF(LNegF *ins)
     return true;
 }
 
+bool
+CodeGeneratorX86Shared::visitSimdUnbox(LSimdUnbox *ins)
+{
+    Register object = ToRegister(ins->object());
+    Register temp = ToRegister(ins->temp());
+    FloatRegister output = ToFloatRegister(ins->output());
+
+    // Typed object data is only guaranteed to be 8-byte aligned.
+    masm.loadPtr(Address(object, TypedObject::dataOffset()), temp);
+    masm.loadUnalignedSimd128(Address(temp, 0), output);
+    return true;
+}
+
+typedef JSObject *(*NewZeroedX4ObjectFn)(JSContext *, int32_t);
+static const VMFunction NewZeroedX4ObjectInfo =
+    FunctionInfo<NewZeroedX4ObjectFn>(NewZeroedX4Object);
+
+bool
+CodeGeneratorX86Shared::visitSimdBox(LSimdBox *ins)
+{
+    FloatRegister input = ToFloatRegister(ins->input());
+    Register output = ToRegister(ins->output());
+    Register temp = ToRegister(ins->temp());
+
+    X4TypeRepresentation::Type type = ins->mir()->input()->type() == MIRType_Float32x4
+                                      ? X4TypeRepresentation::TYPE_FLOAT32
+                                      : X4TypeRepresentation::TYPE_INT32;
+
+    // The input is live across the call, and register spills preserve the
+    // whole of the xmm register.
+    saveLive(ins);
+
+    pushArg(Imm32(type));
+    if (!callVM(NewZeroedX4ObjectInfo, ins))
+        return false;
+
+    if (ReturnReg != output)
+        masm.movePtr(ReturnReg, output);
+
+    restoreLive(ins);
+
+    masm.loadPtr(Address(output, TypedObject::dataOffset()), temp);
+    masm.storeUnalignedSimd128(input, Address(temp, 0));
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdSplat(LSimdSplat *ins)
+{
+    FloatRegister output = ToFloatRegister(ins->output());
+
+    if (ins->mir()->type() == MIRType_Int32x4) {
+        masm.movd(ToRegister(ins->scalar()), output);
+        masm.pshufd(0, output, output);
+        return true;
+    }
+
+    FloatRegister scalar = ToFloatRegister(ins->scalar());
+    if (scalar != output)
+        masm.movaps(scalar, output);
+    masm.shufps(0, output, output);
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdBinaryArith(LSimdBinaryArith *ins)
+{
+    FloatRegister lhs = ToFloatRegister(ins->lhs());
+    FloatRegister rhs = ToFloatRegister(ins->rhs());
+    JS_ASSERT(lhs == ToFloatRegister(ins->output()));
+
+    MSimdBinaryArith *mir = ins->mir();
+    if (mir->type() == MIRType_Int32x4) {
+        switch (mir->operation()) {
+          case MSimdBinaryArith::Add: masm.paddd(rhs, lhs); return true;
+          case MSimdBinaryArith::Sub: masm.psubd(rhs, lhs); return true;
+          case MSimdBinaryArith::And: masm.pand(rhs, lhs); return true;
+          case MSimdBinaryArith::Or:  masm.por(rhs, lhs); return true;
+          case MSimdBinaryArith::Xor: masm.pxor(rhs, lhs); return true;
+          default: break;
+        }
+        MOZ_ASSUME_UNREACHABLE("unexpected int32x4 operation");
+    }
+
+    // minps and maxps return their source operand when either input is NaN
+    // or both are zero, which matches the (l < r ? l : r) of the interpreter.
+    switch (mir->operation()) {
+      case MSimdBinaryArith::Add: masm.addps(rhs, lhs); return true;
+      case MSimdBinaryArith::Sub: masm.subps(rhs, lhs); return true;
+      case MSimdBinaryArith::Mul: masm.mulps(rhs, lhs); return true;
+      case MSimdBinaryArith::Div: masm.divps(rhs, lhs); return true;
+      case MSimdBinaryArith::Min: masm.minps(rhs, lhs); return true;
+      case MSimdBinaryArith::Max: masm.maxps(rhs, lhs); return true;
+      case MSimdBinaryArith::And: masm.andps(rhs, lhs); return true;
+      case MSimdBinaryArith::Or:  masm.orps(rhs, lhs); return true;
+      case MSimdBinaryArith::Xor: masm.xorps(rhs, lhs); return true;
+    }
+    MOZ_ASSUME_UNREACHABLE("unexpected float32x4 operation");
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdBinaryComp(LSimdBinaryComp *ins)
+{
+    FloatRegister lhs = ToFloatRegister(ins->lhs());
+    FloatRegister rhs = ToFloatRegister(ins->rhs());
+    JS_ASSERT(lhs == ToFloatRegister(ins->output()));
+
+    // Immediate predicates of cmpps.
+    enum { CmpEQ = 0, CmpLT = 1, CmpLE = 2, CmpNEQ = 4 };
+
+    switch (ins->mir()->operation()) {
+      case MSimdBinaryComp::LessThan:        masm.cmpps(rhs, lhs, CmpLT); return true;
+      case MSimdBinaryComp::LessThanOrEqual: masm.cmpps(rhs, lhs, CmpLE); return true;
+      case MSimdBinaryComp::Equal:           masm.cmpps(rhs, lhs, CmpEQ); return true;
+      case MSimdBinaryComp::NotEqual:        masm.cmpps(rhs, lhs, CmpNEQ); return true;
+    }
+    MOZ_ASSUME_UNREACHABLE("unexpected comparison");
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdSqrt(LSimdSqrt *ins)
+{
+    masm.sqrtps(ToFloatRegister(ins->input()), ToFloatRegister(ins->output()));
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdConvert(LSimdConvert *ins)
+{
+    FloatRegister input = ToFloatRegister(ins->input());
+    FloatRegister output = ToFloatRegister(ins->output());
+
+    if (ins->mir()->type() == MIRType_Int32x4)
+        masm.cvttps2dq(input, output);
+    else
+        masm.cvtdq2ps(input, output);
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdReinterpretCast(LSimdReinterpretCast *ins)
+{
+    JS_ASSERT(ToFloatRegister(ins->input()) == ToFloatRegister(ins->output()));
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdShuffle(LSimdShuffle *ins)
+{
+    FloatRegister lhs = ToFloatRegister(ins->lhs());
+    FloatRegister rhs = ToFloatRegister(ins->rhs());
+    JS_ASSERT(lhs == ToFloatRegister(ins->output()));
+
+    // The two low lanes are picked from lhs and the two high lanes from rhs.
+    masm.shufps(ins->mir()->mask(), rhs, lhs);
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitSimdSelect(LSimdSelect *ins)
+{
+    FloatRegister mask = ToFloatRegister(ins->mask());
+    FloatRegister onTrue = ToFloatRegister(ins->onTrue());
+    FloatRegister onFalse = ToFloatRegister(ins->onFalse());
+    FloatRegister temp = ToFloatRegister(ins->temp());
+    JS_ASSERT(mask == ToFloatRegister(ins->output()));
+
+    masm.movaps(mask, temp);
+    masm.andps(onTrue, temp);
+    masm.andnps(onFalse, mask);
+    masm.orps(temp, mask);
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitMemoryBarrier(LMemoryBarrier *ins)
+{
+    // x86 only reorders a load ahead of an older store, so a sequentially
+    // consistent store needs a fence after it. Locked instructions are full
+    // barriers already.
+    if (ins->mir()->afterStore())
+        masm.mfence();
+    return true;
+}
+
+// Sign or zero extend the old value of an element, left in eax, to int32.
+static void
+ExtendAtomicResult(MacroAssembler &masm, int arrayType, Register output)
+{
+    switch (arrayType) {
+      case ScalarTypeRepresentation::TYPE_INT8:
+        masm.movsbl(output, output);
+        break;
+      case ScalarTypeRepresentation::TYPE_UINT8:
+        masm.movzbl(output, output);
+        break;
+      case ScalarTypeRepresentation::TYPE_INT16:
+        masm.movswl(output, output);
+        break;
+      case ScalarTypeRepresentation::TYPE_UINT16:
+        masm.movzwl(output, output);
+        break;
+      case ScalarTypeRepresentation::TYPE_INT32:
+        break;
+      default:
+        MOZ_ASSUME_UNREACHABLE("invalid array type");
+    }
+}
+
+static void
+LockCmpxchg(MacroAssembler &masm, int width, Register src, const Operand &mem)
+{
+    switch (width) {
+      case 1:
+        masm.lock_cmpxchgb(src, mem);
+        break;
+      case 2:
+        masm.lock_cmpxchgw(src, mem);
+        break;
+      default:
+        masm.lock_cmpxchgl(src, mem);
+        break;
+    }
+}
+
+static Operand
+AtomicElementOperand(Register elements, const LAllocation *index, int width)
+{
+    if (index->isConstant())
+        return Operand(Address(elements, ToInt32(index) * width));
+    return Operand(BaseIndex(elements, ToRegister(index), ScaleFromElemWidth(width)));
+}
+
+bool
+CodeGeneratorX86Shared::visitAtomicTypedArrayElementBinop(LAtomicTypedArrayElementBinop *ins)
+{
+    MAtomicTypedArrayElementBinop *mir = ins->mir();
+    Register value = ToRegister(ins->value());
+    Register output = ToRegister(ins->output());
+    JS_ASSERT(output == eax);
+
+    int arrayType = mir->arrayType();
+    int width = TypedArrayObject::slotWidth(arrayType);
+    Operand mem = AtomicElementOperand(ToRegister(ins->elements()), ins->index(), width);
+
+    switch (mir->operation()) {
+      case MAtomicTypedArrayElementBinop::Add:
+      case MAtomicTypedArrayElementBinop::Sub:
+        masm.movl(value, output);
+        if (mir->operation() == MAtomicTypedArrayElementBinop::Sub)
+            masm.negl(output);
+        switch (width) {
+          case 1:
+            masm.xaddb(output, mem);
+            break;
+          case 2:
+            masm.xaddw(output, mem);
+            break;
+          default:
+            masm.xaddl(output, mem);
+            break;
+        }
+        break;
+
+      case MAtomicTypedArrayElementBinop::And:
+      case MAtomicTypedArrayElementBinop::Or:
+      case MAtomicTypedArrayElementBinop::Xor: {
+        // Retry until no other thread stored to the element between the load
+        // and the cmpxchg; a failed cmpxchg reloads eax with the new value.
+        Register temp = ToRegister(ins->temp());
+        switch (width) {
+          case 1:
+            masm.movzbl(mem, output);
+            break;
+          case 2:
+            masm.movzwl(mem, output);
+            break;
+          default:
+            masm.movl(mem, output);
+            break;
+        }
+
+        Label again;
+        masm.bind(&again);
+        masm.movl(output, temp);
+        if (mir->operation() == MAtomicTypedArrayElementBinop::And)
+            masm.andl(value, temp);
+        else if (mir->operation() == MAtomicTypedArrayElementBinop::Or)
+            masm.orl(value, temp);
+        else
+            masm.xorl(value, temp);
+        LockCmpxchg(masm, width, temp, mem);
+        masm.j(Assembler::NonZero, &again);
+        break;
+      }
+    }
+
+    ExtendAtomicResult(masm, arrayType, output);
+    return true;
+}
+
+bool
+CodeGeneratorX86Shared::visitCompareExchangeTypedArrayElement(LCompareExchangeTypedArrayElement *ins)
+{
+    Register output = ToRegister(ins->output());
+    JS_ASSERT(output == eax);
+
+    int arrayType = ins->mir()->arrayType();
+    int width = TypedArrayObject::slotWidth(arrayType);
+    Operand mem = AtomicElementOperand(ToRegister(ins->elements()), ins->index(), width);
+
+    // The comparison is made at the element's width, so |oldval| is compared
+    // after truncation, like the native does.
+    masm.movl(ToRegister(ins->oldval()), output);
+    LockCmpxchg(masm, width, ToRegister(ins->newval()), mem);
+
+    ExtendAtomicResult(masm, arrayType, output);
+    return true;
+}
+
 
 } // namespace jit
 } // namespace js
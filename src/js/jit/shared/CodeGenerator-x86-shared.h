@@ -128,6 +128,21 @@ class CodeGeneratorX86Shared : public CodeGeneratorShared
     bool visitNegD(LNegD *lir);
     bool visitNegF(LNegF *lir);
 
+    // SIMD operations.
+    bool visitSimdUnbox(LSimdUnbox *ins);
+    bool visitSimdBox(LSimdBox *ins);
+    bool visitSimdSplat(LSimdSplat *ins);
+    bool visitSimdBinaryArith(LSimdBinaryArith *ins);
+    bool visitSimdBinaryComp(LSimdBinaryComp *ins);
+    bool visitSimdSqrt(LSimdSqrt *ins);
+    bool visitSimdConvert(LSimdConvert *ins);
+    bool visitSimdReinterpretCast(LSimdReinterpretCast *ins);
+    bool visitSimdShuffle(LSimdShuffle *ins);
+    bool visitSimdSelect(LSimdSelect *ins);
+    bool visitMemoryBarrier(LMemoryBarrier *ins);
+    bool visitAtomicTypedArrayElementBinop(LAtomicTypedArrayElementBinop *ins);
+    bool visitCompareExchangeTypedArrayElement(LCompareExchangeTypedArrayElement *ins);
+
     // Out of line visitors.
     bool visitOutOfLineBailout(OutOfLineBailout *ool);
     bool visitOutOfLineUndoALUOperation(OutOfLineUndoALUOperation *ool);
@@ -329,6 +329,266 @@ class LMulI : public LBinaryMath<0, 1>
     }
 };
 
+// Loads the SIMD value held by a typed object.
+class LSimdUnbox : public LInstructionHelper<1, 1, 1>
+{
+  public:
+    LIR_HEADER(SimdUnbox)
+
+    LSimdUnbox(const LAllocation &object, const LDefinition &temp) {
+        setOperand(0, object);
+        setTemp(0, temp);
+    }
+    const LAllocation *object() {
+        return getOperand(0);
+    }
+    const LDefinition *temp() {
+        return getTemp(0);
+    }
+    MSimdUnbox *mir() const {
+        return mir_->toSimdUnbox();
+    }
+};
+
+// Allocates a typed object holding a SIMD value.
+class LSimdBox : public LInstructionHelper<1, 1, 1>
+{
+  public:
+    LIR_HEADER(SimdBox)
+
+    LSimdBox(const LAllocation &input, const LDefinition &temp) {
+        setOperand(0, input);
+        setTemp(0, temp);
+    }
+    const LAllocation *input() {
+        return getOperand(0);
+    }
+    const LDefinition *temp() {
+        return getTemp(0);
+    }
+    MSimdBox *mir() const {
+        return mir_->toSimdBox();
+    }
+};
+
+class LSimdSplat : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(SimdSplat)
+
+    LSimdSplat(const LAllocation &scalar) {
+        setOperand(0, scalar);
+    }
+    const LAllocation *scalar() {
+        return getOperand(0);
+    }
+    MSimdSplat *mir() const {
+        return mir_->toSimdSplat();
+    }
+};
+
+class LSimdBinaryArith : public LInstructionHelper<1, 2, 0>
+{
+  public:
+    LIR_HEADER(SimdBinaryArith)
+
+    LSimdBinaryArith(const LAllocation &lhs, const LAllocation &rhs) {
+        setOperand(0, lhs);
+        setOperand(1, rhs);
+    }
+    const LAllocation *lhs() {
+        return getOperand(0);
+    }
+    const LAllocation *rhs() {
+        return getOperand(1);
+    }
+    MSimdBinaryArith *mir() const {
+        return mir_->toSimdBinaryArith();
+    }
+};
+
+class LSimdBinaryComp : public LInstructionHelper<1, 2, 0>
+{
+  public:
+    LIR_HEADER(SimdBinaryComp)
+
+    LSimdBinaryComp(const LAllocation &lhs, const LAllocation &rhs) {
+        setOperand(0, lhs);
+        setOperand(1, rhs);
+    }
+    const LAllocation *lhs() {
+        return getOperand(0);
+    }
+    const LAllocation *rhs() {
+        return getOperand(1);
+    }
+    MSimdBinaryComp *mir() const {
+        return mir_->toSimdBinaryComp();
+    }
+};
+
+class LSimdSqrt : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(SimdSqrt)
+
+    LSimdSqrt(const LAllocation &input) {
+        setOperand(0, input);
+    }
+    const LAllocation *input() {
+        return getOperand(0);
+    }
+};
+
+class LSimdConvert : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(SimdConvert)
+
+    LSimdConvert(const LAllocation &input) {
+        setOperand(0, input);
+    }
+    const LAllocation *input() {
+        return getOperand(0);
+    }
+    MSimdConvert *mir() const {
+        return mir_->toSimdConvert();
+    }
+};
+
+// Reinterpreting a SIMD value reuses its register, so this emits no code.
+class LSimdReinterpretCast : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(SimdReinterpretCast)
+
+    LSimdReinterpretCast(const LAllocation &input) {
+        setOperand(0, input);
+    }
+    const LAllocation *input() {
+        return getOperand(0);
+    }
+};
+
+class LSimdShuffle : public LInstructionHelper<1, 2, 0>
+{
+  public:
+    LIR_HEADER(SimdShuffle)
+
+    LSimdShuffle(const LAllocation &lhs, const LAllocation &rhs) {
+        setOperand(0, lhs);
+        setOperand(1, rhs);
+    }
+    const LAllocation *lhs() {
+        return getOperand(0);
+    }
+    const LAllocation *rhs() {
+        return getOperand(1);
+    }
+    MSimdShuffle *mir() const {
+        return mir_->toSimdShuffle();
+    }
+};
+
+class LSimdSelect : public LInstructionHelper<1, 3, 1>
+{
+  public:
+    LIR_HEADER(SimdSelect)
+
+    LSimdSelect(const LAllocation &mask, const LAllocation &onTrue, const LAllocation &onFalse,
+                const LDefinition &temp)
+    {
+        setOperand(0, mask);
+        setOperand(1, onTrue);
+        setOperand(2, onFalse);
+        setTemp(0, temp);
+    }
+    const LAllocation *mask() {
+        return getOperand(0);
+    }
+    const LAllocation *onTrue() {
+        return getOperand(1);
+    }
+    const LAllocation *onFalse() {
+        return getOperand(2);
+    }
+    const LDefinition *temp() {
+        return getTemp(0);
+    }
+};
+
+class LMemoryBarrier : public LInstructionHelper<0, 0, 0>
+{
+  public:
+    LIR_HEADER(MemoryBarrier)
+
+    MMemoryBarrier *mir() const {
+        return mir_->toMemoryBarrier();
+    }
+};
+
+// The old value is always produced in eax, which lock xadd and lock cmpxchg
+// work with.
+class LAtomicTypedArrayElementBinop : public LInstructionHelper<1, 3, 1>
+{
+  public:
+    LIR_HEADER(AtomicTypedArrayElementBinop)
+
+    LAtomicTypedArrayElementBinop(const LAllocation &elements, const LAllocation &index,
+                                  const LAllocation &value, const LDefinition &temp)
+    {
+        setOperand(0, elements);
+        setOperand(1, index);
+        setOperand(2, value);
+        setTemp(0, temp);
+    }
+    const LAllocation *elements() {
+        return getOperand(0);
+    }
+    const LAllocation *index() {
+        return getOperand(1);
+    }
+    const LAllocation *value() {
+        return getOperand(2);
+    }
+    const LDefinition *temp() {
+        return getTemp(0);
+    }
+    MAtomicTypedArrayElementBinop *mir() const {
+        return mir_->toAtomicTypedArrayElementBinop();
+    }
+};
+
+class LCompareExchangeTypedArrayElement : public LInstructionHelper<1, 4, 0>
+{
+  public:
+    LIR_HEADER(CompareExchangeTypedArrayElement)
+
+    LCompareExchangeTypedArrayElement(const LAllocation &elements, const LAllocation &index,
+                                      const LAllocation &oldval, const LAllocation &newval)
+    {
+        setOperand(0, elements);
+        setOperand(1, index);
+        setOperand(2, oldval);
+        setOperand(3, newval);
+    }
+    const LAllocation *elements() {
+        return getOperand(0);
+    }
+    const LAllocation *index() {
+        return getOperand(1);
+    }
+    const LAllocation *oldval() {
+        return getOperand(2);
+    }
+    const LAllocation *newval() {
+        return getOperand(3);
+    }
+    MCompareExchangeTypedArrayElement *mir() const {
+        return mir_->toCompareExchangeTypedArrayElement();
+    }
+};
+
 } // namespace jit
 } // namespace js
 
@@ -346,3 +346,123 @@ LIRGeneratorX86Shared::lowerTruncateFToInt32(MTruncateToInt32 *ins)
     LDefinition maybeTemp = Assembler::HasSSE3() ? LDefinition::BogusTemp() : tempFloat32();
     return define(new(alloc()) LTruncateFToInt32(useRegister(opd), maybeTemp), ins);
 }
+
+bool
+LIRGeneratorX86Shared::visitSimdUnbox(MSimdUnbox *ins)
+{
+    JS_ASSERT(ins->object()->type() == MIRType_Object);
+
+    LSimdUnbox *lir = new(alloc()) LSimdUnbox(useRegister(ins->object()), temp());
+    return define(lir, ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdBox(MSimdBox *ins)
+{
+    // The new object is allocated with a VM call, which preserves the whole
+    // of the live SIMD registers.
+    LSimdBox *lir = new(alloc()) LSimdBox(useRegister(ins->input()), temp());
+    return define(lir, ins) && assignSafepoint(lir, ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdSplat(MSimdSplat *ins)
+{
+    return define(new(alloc()) LSimdSplat(useRegister(ins->scalar())), ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdBinaryArith(MSimdBinaryArith *ins)
+{
+    // Packed SSE instructions fault on unaligned memory operands, and stack
+    // slots are only 8-byte aligned, so keep both operands in registers.
+    LSimdBinaryArith *lir = new(alloc()) LSimdBinaryArith(useRegisterAtStart(ins->lhs()),
+                                                          useRegister(ins->rhs()));
+    return defineReuseInput(lir, ins, 0);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdBinaryComp(MSimdBinaryComp *ins)
+{
+    LSimdBinaryComp *lir = new(alloc()) LSimdBinaryComp(useRegisterAtStart(ins->lhs()),
+                                                        useRegister(ins->rhs()));
+    return defineReuseInput(lir, ins, 0);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdSqrt(MSimdSqrt *ins)
+{
+    return define(new(alloc()) LSimdSqrt(useRegisterAtStart(ins->input())), ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdConvert(MSimdConvert *ins)
+{
+    return define(new(alloc()) LSimdConvert(useRegisterAtStart(ins->input())), ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdReinterpretCast(MSimdReinterpretCast *ins)
+{
+    LSimdReinterpretCast *lir = new(alloc()) LSimdReinterpretCast(useRegisterAtStart(ins->input()));
+    return defineReuseInput(lir, ins, 0);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdShuffle(MSimdShuffle *ins)
+{
+    LSimdShuffle *lir = new(alloc()) LSimdShuffle(useRegisterAtStart(ins->lhs()),
+                                                  useRegister(ins->rhs()));
+    return defineReuseInput(lir, ins, 0);
+}
+
+bool
+LIRGeneratorX86Shared::visitSimdSelect(MSimdSelect *ins)
+{
+    LSimdSelect *lir = new(alloc()) LSimdSelect(useRegisterAtStart(ins->mask()),
+                                                useRegister(ins->onTrue()),
+                                                useRegister(ins->onFalse()),
+                                                temp(LDefinition::SIMD128));
+    return defineReuseInput(lir, ins, 0);
+}
+
+bool
+LIRGeneratorX86Shared::visitMemoryBarrier(MMemoryBarrier *ins)
+{
+    return add(new(alloc()) LMemoryBarrier(), ins);
+}
+
+bool
+LIRGeneratorX86Shared::visitAtomicTypedArrayElementBinop(MAtomicTypedArrayElementBinop *ins)
+{
+    // Add and Sub are a single lock xadd with eax. The bitwise operations
+    // retry a lock cmpxchg with eax holding the old value, and compute the
+    // new value in a temp, which must be a byte register for byte arrays.
+    LDefinition tempDef = LDefinition::BogusTemp();
+    if (ins->operation() != MAtomicTypedArrayElementBinop::Add &&
+        ins->operation() != MAtomicTypedArrayElementBinop::Sub)
+    {
+        tempDef = ins->isByteArray() ? tempFixed(ebx) : temp();
+    }
+
+    LAtomicTypedArrayElementBinop *lir =
+        new(alloc()) LAtomicTypedArrayElementBinop(useRegister(ins->elements()),
+                                                   useRegisterOrConstant(ins->index()),
+                                                   useRegister(ins->value()),
+                                                   tempDef);
+    return defineFixed(lir, ins, LAllocation(AnyRegister(eax)));
+}
+
+bool
+LIRGeneratorX86Shared::visitCompareExchangeTypedArrayElement(MCompareExchangeTypedArrayElement *ins)
+{
+    LAllocation newval = ins->isByteArray()
+                         ? useFixed(ins->newval(), ebx)
+                         : useRegister(ins->newval());
+    LCompareExchangeTypedArrayElement *lir =
+        new(alloc()) LCompareExchangeTypedArrayElement(useRegister(ins->elements()),
+                                                       useRegisterOrConstant(ins->index()),
+                                                       useRegister(ins->oldval()),
+                                                       newval);
+    return defineFixed(lir, ins, LAllocation(AnyRegister(eax)));
+}
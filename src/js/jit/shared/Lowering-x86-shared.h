@@ -47,6 +47,19 @@ class LIRGeneratorX86Shared : public LIRGeneratorShared
     bool lowerConstantFloat32(float d, MInstruction *ins);
     bool lowerTruncateDToInt32(MTruncateToInt32 *ins);
     bool lowerTruncateFToInt32(MTruncateToInt32 *ins);
+    bool visitSimdUnbox(MSimdUnbox *ins);
+    bool visitSimdBox(MSimdBox *ins);
+    bool visitSimdSplat(MSimdSplat *ins);
+    bool visitSimdBinaryArith(MSimdBinaryArith *ins);
+    bool visitSimdBinaryComp(MSimdBinaryComp *ins);
+    bool visitSimdSqrt(MSimdSqrt *ins);
+    bool visitSimdConvert(MSimdConvert *ins);
+    bool visitSimdReinterpretCast(MSimdReinterpretCast *ins);
+    bool visitSimdShuffle(MSimdShuffle *ins);
+    bool visitSimdSelect(MSimdSelect *ins);
+    bool visitMemoryBarrier(MMemoryBarrier *ins);
+    bool visitAtomicTypedArrayElementBinop(MAtomicTypedArrayElementBinop *ins);
+    bool visitCompareExchangeTypedArrayElement(MCompareExchangeTypedArrayElement *ins);
 };
 
 } // namespace jit
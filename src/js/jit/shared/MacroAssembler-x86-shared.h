@@ -465,6 +465,19 @@ class MacroAssemblerX86Shared : public Assembler
         movaps(src, dest);
     }
 
+    // SIMD values are 128 bits wide. Memory holding them, including stack
+    // slots, is not necessarily 16-byte aligned, so always use unaligned
+    // accesses.
+    void loadUnalignedSimd128(const Address &src, FloatRegister dest) {
+        movups(src, dest);
+    }
+    void storeUnalignedSimd128(FloatRegister src, const Address &dest) {
+        movups(src, dest);
+    }
+    void moveSimd128(FloatRegister src, FloatRegister dest) {
+        movaps(src, dest);
+    }
+
     // Checks whether a double is representable as a 32-bit integer. If so, the
     // integer is written to the output register. Otherwise, a bailout is taken to
     // the given snapshot. This function overwrites the scratch float register.
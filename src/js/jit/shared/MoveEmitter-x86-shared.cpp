@@ -135,6 +135,9 @@ MoveEmitterX86::emit(const MoveResolver &moves)
           case MoveOp::DOUBLE:
             emitDoubleMove(from, to);
             break;
+          case MoveOp::SIMD128:
+            emitSimd128Move(from, to);
+            break;
           case MoveOp::INT32:
             emitInt32Move(from, to);
             break;
@@ -156,8 +159,8 @@ Address
 MoveEmitterX86::cycleSlot()
 {
     if (pushedAtCycle_ == -1) {
-        // Reserve stack for cycle resolution
-        masm.reserveStack(sizeof(double));
+        // Reserve stack for cycle resolution, large enough for any value.
+        masm.reserveStack(Simd128DataSize);
         pushedAtCycle_ = masm.framePushed();
     }
 
@@ -241,6 +244,14 @@ MoveEmitterX86::breakCycle(const MoveOperand &to, MoveOp::Type type)
             masm.storeDouble(to.floatReg(), cycleSlot());
         }
         break;
+      case MoveOp::SIMD128:
+        if (to.isMemory()) {
+            masm.loadUnalignedSimd128(toAddress(to), ScratchFloatReg);
+            masm.storeUnalignedSimd128(ScratchFloatReg, cycleSlot());
+        } else {
+            masm.storeUnalignedSimd128(to.floatReg(), cycleSlot());
+        }
+        break;
 #ifdef JS_CPU_X64
       case MoveOp::INT32:
         // x64 can't pop to a 32-bit destination, so don't push.
@@ -293,6 +304,16 @@ MoveEmitterX86::completeCycle(const MoveOperand &to, MoveOp::Type type)
             masm.loadDouble(cycleSlot(), to.floatReg());
         }
         break;
+      case MoveOp::SIMD128:
+        JS_ASSERT(pushedAtCycle_ != -1);
+        JS_ASSERT(pushedAtCycle_ - pushedAtStart_ >= Simd128DataSize);
+        if (to.isMemory()) {
+            masm.loadUnalignedSimd128(cycleSlot(), ScratchFloatReg);
+            masm.storeUnalignedSimd128(ScratchFloatReg, toAddress(to));
+        } else {
+            masm.loadUnalignedSimd128(cycleSlot(), to.floatReg());
+        }
+        break;
 #ifdef JS_CPU_X64
       case MoveOp::INT32:
         JS_ASSERT(pushedAtCycle_ != -1);
@@ -417,6 +438,24 @@ MoveEmitterX86::emitDoubleMove(const MoveOperand &from, const MoveOperand &to)
     }
 }
 
+void
+MoveEmitterX86::emitSimd128Move(const MoveOperand &from, const MoveOperand &to)
+{
+    if (from.isFloatReg()) {
+        if (to.isFloatReg())
+            masm.moveSimd128(from.floatReg(), to.floatReg());
+        else
+            masm.storeUnalignedSimd128(from.floatReg(), toAddress(to));
+    } else if (to.isFloatReg()) {
+        masm.loadUnalignedSimd128(toAddress(from), to.floatReg());
+    } else {
+        // Memory to memory move.
+        JS_ASSERT(from.isMemory());
+        masm.loadUnalignedSimd128(toAddress(from), ScratchFloatReg);
+        masm.storeUnalignedSimd128(ScratchFloatReg, toAddress(to));
+    }
+}
+
 void
 MoveEmitterX86::assertDone()
 {
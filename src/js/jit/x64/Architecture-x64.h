@@ -18,6 +18,20 @@ namespace jit {
 //   +8 for double spills
 static const uint32_t ION_FRAME_SLACK_SIZE     = 24;
 
+// Size in bytes of a float register saved by PushRegsInMask. The whole xmm
+// register is saved, so that SIMD values survive out-of-line VM calls.
+static const uint32_t FloatRegisterSpillSize = 16;
+
+// SSE2 is required, so SIMD operations can always be compiled inline.
+static const bool SupportsSimd = true;
+
+// Atomics operations on typed arrays are compiled inline to locked instructions.
+static const bool SupportsAtomics = true;
+
+// Yarr's generated code follows the native ABI and returns the match start in
+// the low half of rax, so RegExp exec and test can call it directly.
+static const bool SupportsDirectRegExpCalls = true;
+
 #ifdef _WIN64
 static const uint32_t ShadowStackSpace = 32;
 #else
@@ -78,6 +78,7 @@ class MacroAssemblerX64 : public MacroAssemblerX86Shared
     using MacroAssemblerX86Shared::Pop;
     using MacroAssemblerX86Shared::callWithExitFrame;
     using MacroAssemblerX86Shared::branch32;
+    using MacroAssemblerX86Shared::add32;
 
     MacroAssemblerX64()
       : inCall_(false),
@@ -1144,6 +1145,15 @@ class MacroAssemblerX64 : public MacroAssemblerX86Shared
         cvtsq2ss(src, dest);
     }
 
+    void add32(Imm32 imm, AbsoluteAddress dest) {
+        if (JSC::X86Assembler::isAddressImmediate(dest.addr)) {
+            addl(imm, Operand(dest));
+        } else {
+            mov(ImmPtr(dest.addr), ScratchReg);
+            addl(imm, Operand(Address(ScratchReg, 0)));
+        }
+    }
+
     void inc64(AbsoluteAddress dest) {
         if (JSC::X86Assembler::isAddressImmediate(dest.addr)) {
             addPtr(Imm32(1), Operand(dest));
@@ -18,6 +18,20 @@ namespace jit {
 //   +8 for double spills
 static const uint32_t ION_FRAME_SLACK_SIZE    = 20;
 
+// Size in bytes of a float register saved by PushRegsInMask. The whole xmm
+// register is saved, so that SIMD values survive out-of-line VM calls.
+static const uint32_t FloatRegisterSpillSize = 16;
+
+// SSE2 is required, so SIMD operations can always be compiled inline.
+static const bool SupportsSimd = true;
+
+// Atomics operations on typed arrays are compiled inline to locked instructions.
+static const bool SupportsAtomics = true;
+
+// Yarr's generated code takes its arguments in registers (regparm) here, so
+// RegExp exec and test call it from the VM.
+static const bool SupportsDirectRegExpCalls = false;
+
 // Only Win64 requires shadow stack space.
 static const uint32_t ShadowStackSpace = 0;
 
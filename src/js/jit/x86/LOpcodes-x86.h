@@ -22,6 +22,19 @@
     _(AsmJSUInt32ToDouble)      \
     _(AsmJSUInt32ToFloat32)     \
     _(AsmJSLoadFuncPtr)         \
-    _(UDivOrMod)
+    _(UDivOrMod)                \
+    _(SimdUnbox)                \
+    _(SimdBox)                  \
+    _(SimdSplat)                \
+    _(SimdBinaryArith)          \
+    _(SimdBinaryComp)           \
+    _(SimdSqrt)                 \
+    _(SimdConvert)              \
+    _(SimdReinterpretCast)      \
+    _(SimdShuffle)              \
+    _(SimdSelect)               \
+    _(MemoryBarrier)            \
+    _(AtomicTypedArrayElementBinop) \
+    _(CompareExchangeTypedArrayElement)
 
 #endif /* jit_x86_LOpcodes_x86_h */
@@ -69,6 +69,7 @@ class MacroAssemblerX86 : public MacroAssemblerX86Shared
     using MacroAssemblerX86Shared::Pop;
     using MacroAssemblerX86Shared::callWithExitFrame;
     using MacroAssemblerX86Shared::branch32;
+    using MacroAssemblerX86Shared::add32;
 
     MacroAssemblerX86()
       : inCall_(false),
@@ -993,6 +994,10 @@ class MacroAssemblerX86 : public MacroAssemblerX86Shared
         addConstantFloat32(2147483648.f, dest);
     }
 
+    void add32(Imm32 imm, AbsoluteAddress dest) {
+        addl(imm, Operand(dest));
+    }
+
     void inc64(AbsoluteAddress dest) {
         addl(Imm32(1), Operand(dest));
         Label noOverflow;
@@ -468,7 +468,7 @@ GenerateBailoutThunk(JSContext *cx, MacroAssembler &masm, uint32_t frameClass)
 
     // Common size of stuff we've pushed.
     const uint32_t BailoutDataSize = sizeof(void *) + // frameClass
-                                   sizeof(double) * FloatRegisters::Total +
+                                   FloatRegisterSpillSize * FloatRegisters::Total +
                                    sizeof(void *) * Registers::Total;
 
     // Remove both the bailout frame and the topmost Ion frame's stack.
@@ -0,0 +1,118 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+
+/* A single-entry in-memory cache. */
+static char cachedKey[64];
+static uint8_t *cachedData = nullptr;
+static size_t cachedSize = 0;
+static unsigned cacheReads = 0, cacheHits = 0, cacheWrites = 0;
+
+static bool
+OpenEntryForRead(const char *key, size_t *size, const uint8_t **memory, intptr_t *handle)
+{
+    cacheReads++;
+    if (!cachedData || strcmp(key, cachedKey) != 0)
+        return false;
+    cacheHits++;
+    *size = cachedSize;
+    *memory = cachedData;
+    *handle = 0;
+    return true;
+}
+
+static void
+CloseEntryForRead(size_t size, const uint8_t *memory, intptr_t handle)
+{
+}
+
+static bool
+WriteEntry(const char *key, const uint8_t *memory, size_t size)
+{
+    cacheWrites++;
+    if (strlen(key) >= sizeof(cachedKey))
+        return false;
+    uint8_t *data = static_cast<uint8_t *>(js_malloc(size));
+    if (!data)
+        return false;
+    memcpy(data, memory, size);
+    js_free(cachedData);
+    cachedData = data;
+    cachedSize = size;
+    strcpy(cachedKey, key);
+    return true;
+}
+
+static const JS::BytecodeCacheOps cacheOps = {
+    OpenEntryForRead,
+    CloseEntryForRead,
+    WriteEntry,
+    nullptr
+};
+
+static JSScript *
+CompileWithCache(JSContext *cx, JS::HandleObject global, const char *bytes)
+{
+    JS::CompileOptions options(cx);
+    options.setFileAndLine("testBytecodeCache.js", 1)
+           .setCompileAndGo(true);
+    return JS::Compile(cx, global, options, bytes, strlen(bytes));
+}
+
+BEGIN_TEST(testBytecodeCache)
+{
+    JS::SetBytecodeCacheOps(rt, &cacheOps);
+
+    const char *s =
+        "function sum(a) { var t = 0; for (var i = 0; i < a.length; i++) t += a[i]; return t; }\n"
+        "sum([1, 2, 3, { valueOf: function () { return 4; } }]);\n";
+
+    // The first compilation misses and fills the cache.
+    JS::RootedScript script(cx, CompileWithCache(cx, global, s));
+    CHECK(script);
+    CHECK_EQUAL(cacheReads, 1);
+    CHECK_EQUAL(cacheHits, 0);
+    CHECK_EQUAL(cacheWrites, 1);
+
+    // The second is decoded from the cache and behaves the same.
+    script = CompileWithCache(cx, global, s);
+    CHECK(script);
+    CHECK_EQUAL(cacheReads, 2);
+    CHECK_EQUAL(cacheHits, 1);
+    CHECK_EQUAL(cacheWrites, 1);
+
+    JS::RootedValue v(cx);
+    CHECK(JS_ExecuteScript(cx, global, script, v.address()));
+    CHECK_SAME(v, INT_TO_JSVAL(10));
+
+    // Different source is a miss.
+    script = CompileWithCache(cx, global, "sum([5]);");
+    CHECK(script);
+    CHECK_EQUAL(cacheHits, 1);
+    CHECK_EQUAL(cacheWrites, 2);
+    CHECK(JS_ExecuteScript(cx, global, script, v.address()));
+    CHECK_SAME(v, INT_TO_JSVAL(5));
+
+    // A corrupt entry is found but rejected, and gets replaced.
+    script = CompileWithCache(cx, global, "sum([6]);");
+    CHECK(script);
+    cachedData[cachedSize - 1] ^= 0xff;
+    cachedSize--;
+    script = CompileWithCache(cx, global, "sum([6]);");
+    CHECK(script);
+    CHECK_EQUAL(cacheHits, 2);
+    CHECK_EQUAL(cacheWrites, 4);
+    CHECK(JS_ExecuteScript(cx, global, script, v.address()));
+    CHECK_SAME(v, INT_TO_JSVAL(6));
+
+    static const JS::BytecodeCacheOps noCacheOps = { nullptr, nullptr, nullptr, nullptr };
+    JS::SetBytecodeCacheOps(rt, &noCacheOps);
+    js_free(cachedData);
+    cachedData = nullptr;
+    return true;
+}
+END_TEST(testBytecodeCache)
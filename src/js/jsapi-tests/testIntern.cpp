@@ -22,6 +22,20 @@ BEGIN_TEST(testAtomizedIsNotInterned)
 }
 END_TEST(testAtomizedIsNotInterned)
 
+BEGIN_TEST(testAtomizeLatin1MatchesTwoByte)
+{
+    /* Latin-1 lookups must find atoms created from the widened chars. */
+    static const jschar twoByteChars[] = { 'c', 'a', 'f', 0xE9, ' ', 'l', 'a', 't', 'i', 'n', '1' };
+    static const JS::Latin1Char latin1Chars[] = { 'c', 'a', 'f', 0xE9, ' ', 'l', 'a', 't', 'i', 'n', '1' };
+    JS::Rooted<JSAtom*> atom(cx, js::AtomizeChars(cx, twoByteChars, ArrayLength(twoByteChars)));
+    CHECK(atom);
+    CHECK(js::AtomizeChars(cx, latin1Chars, ArrayLength(latin1Chars)) == atom);
+    CHECK(js::Atomize(cx, reinterpret_cast<const char *>(latin1Chars),
+                      ArrayLength(latin1Chars)) == atom);
+    return true;
+}
+END_TEST(testAtomizeLatin1MatchesTwoByte)
+
 struct StringWrapperStruct
 {
     JSString *str;
@@ -0,0 +1,110 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ *
+ * Tests the built-in sampling profiler on a JSRuntime
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jscntxt.h"
+
+#include "builtin/Profilers.h"
+#include "jsapi-tests/tests.h"
+#include "vm/SamplingProfiler.h"
+
+static const char *outfile = "testSamplingProfiler.stacks";
+
+static bool
+samples(JSContext *cx, unsigned argc, jsval *vp)
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    js::SamplingProfiler *profiler = cx->runtime()->samplingProfiler;
+    args.rval().setNumber(double(profiler ? profiler->samples() : 0));
+    return true;
+}
+
+/*
+ * Read back the profile written to |outfile| and remove it. Returns whether
+ * some stack contains |frames| and has |innermost| as its innermost frame,
+ * and sets |total| to the number of samples in the file.
+ */
+static bool
+FindStack(const char *frames, const char *innermost, uint64_t *total)
+{
+    FILE *fp = fopen(outfile, "r");
+    if (!fp)
+        return false;
+
+    char line[4096];
+    bool found = false;
+    *total = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char *count = strrchr(line, ' ');
+        if (!count)
+            continue;
+        *count = '\0';
+        *total += strtoull(count + 1, nullptr, 10);
+
+        const char *last = strrchr(line, ';');
+        if (strstr(line, frames) && last && strncmp(last + 1, innermost, strlen(innermost)) == 0)
+            found = true;
+    }
+    fclose(fp);
+    remove(outfile);
+    return found;
+}
+
+static js::ProfileEntry pstack[16];
+static uint32_t psize = 0;
+
+BEGIN_TEST(testSamplingProfiler_scriptFrames)
+{
+    CHECK(JS_DefineFunction(cx, global, "samples", samples, 0, 0));
+    EXEC("function inner(n) { var x = 0; for (var i = 0; i < n; i++) x += i; return x; }\n"
+         "function outer() { while (samples() < 20) inner(10000); }");
+
+    CHECK(JS_StartSamplingProfiler(rt, 1));
+    CHECK(!JS_StartSamplingProfiler(rt, 1));
+    EXEC("outer();");
+    uint64_t taken = rt->samplingProfiler->samples();
+    CHECK(taken >= 20);
+    CHECK(JS_StopSamplingProfiler(rt, outfile));
+    CHECK(!rt->samplingProfiler);
+    CHECK(!JS_StopSamplingProfiler(rt, nullptr));
+
+    /* Frames are written outermost first. */
+    uint64_t total;
+    CHECK(FindStack(";outer (", "inner (", &total));
+    CHECK(total == taken);
+    return true;
+}
+END_TEST(testSamplingProfiler_scriptFrames)
+
+BEGIN_TEST(testSamplingProfiler_pseudoStack)
+{
+    CHECK(JS_DefineFunction(cx, global, "samples", samples, 0, 0));
+    EXEC("function inner(n) { var x = 0; for (var i = 0; i < n; i++) x += i; return x; }\n"
+         "function outer() { while (samples() < 20) inner(10000); }");
+
+    js::SetRuntimeProfilingStack(rt, pstack, &psize, 16);
+    js::EnableRuntimeProfilingStack(rt, true);
+
+    CHECK(JS_StartSamplingProfiler(rt, 1));
+    EXEC("outer();");
+    uint64_t taken = rt->samplingProfiler->samples();
+    CHECK(JS_StopSamplingProfiler(rt, outfile));
+
+    js::EnableRuntimeProfilingStack(rt, false);
+    CHECK(psize == 0);
+
+    /* The native entry pushed when running script shows up as a frame. */
+    uint64_t total;
+    CHECK(FindStack("js::RunScript;", "inner (", &total));
+    CHECK(total == taken);
+    return true;
+}
+END_TEST(testSamplingProfiler_pseudoStack)
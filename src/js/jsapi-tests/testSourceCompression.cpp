@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/PodOperations.h"
+
+#include "jsapi-tests/tests.h"
+#include "vm/Compression.h"
+
+using js::LZ4Compressor;
+
+static const size_t NumChars = 3 * LZ4Compressor::CHUNK_SIZE / sizeof(jschar) + 17;
+
+static void
+FillSource(jschar *chars, size_t length)
+{
+    static const char text[] = "function f(x) { return x * 2 + g(x); }\n";
+    for (size_t i = 0; i < length; i++)
+        chars[i] = text[i % (sizeof(text) - 1)] + (i / 4096) % 3;
+}
+
+BEGIN_TEST(testSourceCompression_LZ4Chunks)
+{
+    js::ScopedJSFreePtr<jschar> chars(js_pod_malloc<jschar>(NumChars));
+    CHECK(chars);
+    FillSource(chars, NumChars);
+
+    size_t nbytes = NumChars * sizeof(jschar);
+    js::ScopedJSFreePtr<unsigned char> compressed(js_pod_malloc<unsigned char>(nbytes));
+    CHECK(compressed);
+
+    LZ4Compressor comp(reinterpret_cast<const unsigned char *>(chars.get()), nbytes);
+    comp.setOutput(compressed, nbytes);
+    LZ4Compressor::Status status;
+    size_t calls = 0;
+    do {
+        status = comp.compressMore();
+        calls++;
+    } while (status == LZ4Compressor::CONTINUE);
+    CHECK(status == LZ4Compressor::DONE);
+    CHECK_EQUAL(calls, LZ4Compressor::numChunks(nbytes));
+    CHECK(comp.outWritten() < nbytes);
+
+    // Whole-string decompression.
+    js::ScopedJSFreePtr<jschar> out(js_pod_malloc<jschar>(NumChars));
+    CHECK(out);
+    CHECK(js::DecompressLZ4String(compressed, comp.outWritten(),
+                                  reinterpret_cast<unsigned char *>(out.get()), nbytes));
+    CHECK(mozilla::PodEqual(out.get(), chars.get(), NumChars));
+
+    // Random access to the last, partial chunk and to a middle chunk.
+    const size_t chunkChars = LZ4Compressor::CHUNK_SIZE / sizeof(jschar);
+    mozilla::PodZero(out.get(), NumChars);
+    CHECK(js::DecompressLZ4Chunks(compressed, comp.outWritten(), nbytes, 3, 3,
+                                  reinterpret_cast<unsigned char *>(out.get())));
+    CHECK(mozilla::PodEqual(out.get(), chars.get() + 3 * chunkChars, NumChars - 3 * chunkChars));
+    CHECK(js::DecompressLZ4Chunks(compressed, comp.outWritten(), nbytes, 1, 1,
+                                  reinterpret_cast<unsigned char *>(out.get())));
+    CHECK(mozilla::PodEqual(out.get(), chars.get() + chunkChars, chunkChars));
+    return true;
+}
+END_TEST(testSourceCompression_LZ4Chunks)
+
+BEGIN_TEST(testSourceCompression_LZ4Incompressible)
+{
+    // Output that would not be smaller than the input is rejected.
+    static const size_t length = 4096;
+    unsigned char input[length];
+    uint32_t seed = 1;
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245 + 12345;
+        input[i] = uint8_t(seed >> 16);
+    }
+    unsigned char output[length];
+    LZ4Compressor comp(input, length);
+    comp.setOutput(output, length);
+    CHECK(comp.compressMore() == LZ4Compressor::OUTPUT_FULL);
+    return true;
+}
+END_TEST(testSourceCompression_LZ4Incompressible)
@@ -267,3 +267,36 @@ BEGIN_TEST(testXDR_sourceMap)
     return true;
 }
 END_TEST(testXDR_sourceMap)
+
+BEGIN_TEST(testXDR_lazyFunctionsAndObjectLiterals)
+{
+    const char *s =
+        "function f(a) { return { x: a, y: [1, , 'three'], z: { w: -0.5 } }; }\n"
+        "var o = { p: f(2), q: [null, undefined, true] };\n"
+        "o.p.x + o.p.y.length + o.p.z.w + (1 in o.p.y ? 100 : 0) + o.q.length;\n";
+
+    // Compile-and-go scripts with saved source parse |f| lazily and keep
+    // their literals as template objects.
+    JS::CompileOptions options(cx);
+    options.setFileAndLine(__FILE__, __LINE__)
+           .setCompileAndGo(true);
+    JS::RootedScript script(cx, JS_CompileScript(cx, global, s, strlen(s), options));
+    CHECK(script);
+    CHECK(script->hasObjects());
+
+    script = FreezeThaw(cx, script);
+    CHECK(script);
+
+    JS::RootedValue v(cx);
+    CHECK(JS_ExecuteScript(cx, global, script, v.address()));
+    CHECK_SAME(v, DOUBLE_TO_JSVAL(7.5));
+
+    // Delazify |f| after the thaw.
+    EVAL("f('a').y[2] + typeof o.p.y[1]", v.address());
+    JSString *str = JSVAL_TO_STRING(v);
+    bool equal;
+    CHECK(JS_StringEqualsAscii(cx, str, "threeundefined", &equal));
+    CHECK(equal);
+    return true;
+}
+END_TEST(testXDR_lazyFunctionsAndObjectLiterals)
@@ -32,6 +32,7 @@
 #include "jsnum.h"
 #include "jsobj.h"
 #include "json.h"
+#include "jsonparser.h"
 #include "jsprf.h"
 #include "jsproxy.h"
 #include "jsscript.h"
@@ -49,6 +50,7 @@
 #if ENABLE_YARR_JIT
 #include "assembler/jit/ExecutableAllocator.h"
 #endif
+#include "builtin/AtomicsObject.h"
 #include "builtin/Eval.h"
 #include "builtin/Intl.h"
 #include "builtin/MapObject.h"
@@ -69,6 +71,7 @@
 #include "unicode/uclean.h"
 #include "unicode/utypes.h"
 #endif // ENABLE_INTL_API
+#include "vm/BytecodeCache.h"
 #include "vm/DateObject.h"
 #include "vm/Debugger.h"
 #include "vm/ErrorObject.h"
@@ -77,6 +80,7 @@
 #include "vm/RegExpStatics.h"
 #include "vm/Runtime.h"
 #include "vm/Shape.h"
+#include "vm/SharedArrayObject.h"
 #include "vm/StopIterationObject.h"
 #include "vm/StringBuffer.h"
 #include "vm/TypedArrayObject.h"
@@ -588,6 +592,9 @@ JS_Init(void)
     if (!ForkJoinSlice::initialize())
         return false;
 
+    if (!AtomicsObject::initialize())
+        return false;
+
 #if EXPOSE_INTL_API
     UErrorCode err = U_ZERO_ERROR;
     u_init(&err);
@@ -614,6 +621,8 @@ JS_ShutDown(void)
     }
 #endif
 
+    AtomicsObject::destroy();
+
     PRMJ_NowShutdown();
 
 #if EXPOSE_INTL_API
@@ -1996,6 +2005,12 @@ JS_SetGCParameter(JSRuntime *rt, JSGCParamKey key, uint32_t value)
       case JSGC_DECOMMIT_THRESHOLD:
         rt->gcDecommitThreshold = value * 1024 * 1024;
         break;
+      case JSGC_PARALLEL_MARKING:
+        rt->gcParallelMarkingEnabled = value;
+        break;
+      case JSGC_COMPACTING:
+        rt->gcCompactingEnabled = value;
+        break;
       default:
         JS_ASSERT(key == JSGC_MODE);
         rt->setGCMode(JSGCMode(value));
@@ -2044,6 +2059,10 @@ JS_GetGCParameter(JSRuntime *rt, JSGCParamKey key)
         return rt->gcDynamicMarkSlice;
       case JSGC_ALLOCATION_THRESHOLD:
         return rt->gcAllocationThreshold / 1024 / 1024;
+      case JSGC_PARALLEL_MARKING:
+        return rt->gcParallelMarkingEnabled;
+      case JSGC_COMPACTING:
+        return rt->gcCompactingEnabled;
       default:
         JS_ASSERT(key == JSGC_NUMBER);
         return uint32_t(rt->gcNumber);
@@ -4398,6 +4417,9 @@ JS::Compile(JSContext *cx, HandleObject obj, const ReadOnlyCompileOptions &optio
     JS_ASSERT_IF(options.principals(), cx->compartment()->principals == options.principals());
     AutoLastFrameCheck lfc(cx);
 
+    if (CanUseBytecodeCache(cx, options))
+        return CompileScriptWithBytecodeCache(cx, obj, options, chars, length);
+
     return frontend::CompileScript(cx, &cx->tempLifoAlloc(), obj, NullPtr(), options, chars, length);
 }
 
@@ -4472,6 +4494,32 @@ JS::FinishOffThreadScript(JSContext *maybecx, JSRuntime *rt, void *token)
 #endif
 }
 
+JS_PUBLIC_API(bool)
+JS::CompileOffThreadBatch(JSContext *cx, HandleObject obj,
+                          const OffThreadCompileSource *sources, size_t count,
+                          OffThreadCompileCallback callback, void *callbackData)
+{
+    JS_ASSERT(count);
+#ifdef DEBUG
+    for (size_t i = 0; i < count; i++)
+        JS_ASSERT(CanCompileOffThread(cx, *sources[i].options));
+#endif
+    return StartOffThreadParseScripts(cx, sources, count, obj, callback, callbackData);
+}
+
+JS_PUBLIC_API(bool)
+JS::FinishOffThreadScriptBatch(JSContext *cx, void *token, AutoScriptVector &scripts)
+{
+#ifdef JS_THREADSAFE
+    JS_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+    AutoLastFrameCheck lfc(cx);
+    return cx->runtime()->workerThreadState->finishParseTaskBatch(cx, token, scripts);
+#else
+    MOZ_ASSUME_UNREACHABLE("Off thread compilation is not available.");
+#endif
+}
+
 JS_PUBLIC_API(JSScript *)
 JS_CompileScript(JSContext *cx, JS::HandleObject obj, const char *ascii,
                  size_t length, const JS::CompileOptions &options)
@@ -5437,6 +5485,37 @@ JS_ParseJSONWithReviver(JSContext *cx, const jschar *chars, uint32_t len, Handle
     return ParseJSONWithReviver(cx, StableCharPtr(chars, len), len, reviver, vp);
 }
 
+JS_PUBLIC_API(JSONStreamParser *)
+JS_NewJSONStreamParser(JSContext *cx, unsigned flags, JSONStreamCallback callback, void *data)
+{
+    JSONStreamParser::Mode mode = (flags & JSON_STREAM_ARRAY_ELEMENTS)
+                                  ? JSONStreamParser::ArrayElements
+                                  : JSONStreamParser::Values;
+    return cx->new_<JSONStreamParser>(mode, callback, data);
+}
+
+JS_PUBLIC_API(bool)
+JS_FeedJSONStreamParser(JSContext *cx, JSONStreamParser *parser, const char *utf8, size_t length)
+{
+    AssertHeapIsIdle(cx);
+    CHECK_REQUEST(cx);
+    return parser->feed(cx, utf8, length);
+}
+
+JS_PUBLIC_API(bool)
+JS_FinishJSONStreamParser(JSContext *cx, JSONStreamParser *parser)
+{
+    AssertHeapIsIdle(cx);
+    CHECK_REQUEST(cx);
+    return parser->finish(cx);
+}
+
+JS_PUBLIC_API(void)
+JS_DestroyJSONStreamParser(JSONStreamParser *parser)
+{
+    js_delete(parser);
+}
+
 /************************************************************************/
 
 JS_PUBLIC_API(void)
@@ -6208,6 +6287,12 @@ JS::SetAsmJSCacheOps(JSRuntime *rt, const JS::AsmJSCacheOps *ops)
     rt->asmJSCacheOps = *ops;
 }
 
+JS_PUBLIC_API(void)
+JS::SetBytecodeCacheOps(JSRuntime *rt, const JS::BytecodeCacheOps *ops)
+{
+    rt->bytecodeCacheOps = *ops;
+}
+
 char *
 JSAutoByteString::encodeLatin1(ExclusiveContext *cx, JSString *str)
 {
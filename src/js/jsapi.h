@@ -2173,7 +2173,21 @@ typedef enum JSGCParamKey {
      * available to be decommitted, then JS_MaybeGC will trigger a shrinking GC
      * to decommit it.
      */
-    JSGC_DECOMMIT_THRESHOLD = 20
+    JSGC_DECOMMIT_THRESHOLD = 20,
+
+    /*
+     * If true, mark slices are run on the main thread and the runtime's worker
+     * threads together.
+     */
+    JSGC_PARALLEL_MARKING = 21,
+
+    /*
+     * If true, shrinking GCs move objects out of sparsely used arenas so that
+     * the arenas, and then their chunks, can be released. Embeddings which
+     * hold untraced or weak pointers to objects, for example by checking them
+     * with JS_IsAboutToBeFinalized, must not enable this.
+     */
+    JSGC_COMPACTING = 22
 } JSGCParamKey;
 
 typedef enum JSGCMode {
@@ -3673,6 +3687,37 @@ CompileOffThread(JSContext *cx, HandleObject obj, const ReadOnlyCompileOptions &
 extern JS_PUBLIC_API(JSScript *)
 FinishOffThreadScript(JSContext *maybecx, JSRuntime *rt, void *token);
 
+/*
+ * Batch off thread compilation, for loading many scripts at once.
+ *
+ * CompileOffThreadBatch starts a compilation of each source, spread over all
+ * worker threads. The callback is invoked once, off the main thread, with a
+ * token for the batch after all of them have finished. Afterwards,
+ * FinishOffThreadScriptBatch must be invoked on the main thread to move all
+ * the compiled scripts into obj's compartment and append them to |scripts| in
+ * the order of their sources. If any script failed to compile, the error for
+ * the first one is reported, |scripts| is left unchanged and false is
+ * returned.
+ *
+ * The options and characters of each source must remain live until the
+ * callback is invoked.
+ */
+
+struct OffThreadCompileSource
+{
+    const ReadOnlyCompileOptions *options;
+    const jschar *chars;
+    size_t length;
+};
+
+extern JS_PUBLIC_API(bool)
+CompileOffThreadBatch(JSContext *cx, HandleObject obj,
+                      const OffThreadCompileSource *sources, size_t count,
+                      OffThreadCompileCallback callback, void *callbackData);
+
+extern JS_PUBLIC_API(bool)
+FinishOffThreadScriptBatch(JSContext *cx, void *token, AutoScriptVector &scripts);
+
 extern JS_PUBLIC_API(JSFunction *)
 CompileFunction(JSContext *cx, JS::HandleObject obj, const ReadOnlyCompileOptions &options,
                 const char *name, unsigned nargs, const char *const *argnames,
@@ -4225,6 +4270,35 @@ JS_PUBLIC_API(bool)
 JS_ParseJSONWithReviver(JSContext *cx, const jschar *chars, uint32_t len, JS::HandleValue reviver,
                         JS::MutableHandleValue vp);
 
+/*
+ * Incremental JSON parsing, for input too large to hold in memory at once.
+ * UTF-8 text is fed to the parser in chunks of any size. Each time a
+ * top-level value is complete it is parsed, passed to the callback and its
+ * text discarded, so memory use is bounded by the largest value rather than
+ * by the whole input. Top-level values may follow each other separated by
+ * whitespace, as in newline-delimited JSON. With JSON_STREAM_ARRAY_ELEMENTS
+ * the input must instead be a single array, whose elements are passed to the
+ * callback one at a time.
+ *
+ * JS_FinishJSONStreamParser checks that the input did not stop in the middle
+ * of a value. After any call fails, the parser may only be destroyed.
+ */
+typedef bool (* JSONStreamCallback)(JSContext *cx, JS::HandleValue value, void *data);
+
+#define JSON_STREAM_ARRAY_ELEMENTS 0x1
+
+extern JS_PUBLIC_API(JSONStreamParser *)
+JS_NewJSONStreamParser(JSContext *cx, unsigned flags, JSONStreamCallback callback, void *data);
+
+extern JS_PUBLIC_API(bool)
+JS_FeedJSONStreamParser(JSContext *cx, JSONStreamParser *parser, const char *utf8, size_t length);
+
+extern JS_PUBLIC_API(bool)
+JS_FinishJSONStreamParser(JSContext *cx, JSONStreamParser *parser);
+
+extern JS_PUBLIC_API(void)
+JS_DestroyJSONStreamParser(JSONStreamParser *parser);
+
 /************************************************************************/
 
 /*
@@ -4732,6 +4806,44 @@ struct AsmJSCacheOps
 extern JS_PUBLIC_API(void)
 SetAsmJSCacheOps(JSRuntime *rt, const AsmJSCacheOps *callbacks);
 
+/*
+ * The bytecode cache lets JS::Compile skip parsing and bytecode emission for
+ * sources it has already compiled, in this or a previous process. Entries are
+ * keyed by a digest of the source chars, the compile options which affect the
+ * emitted bytecode, the XDR bytecode version and the embedding's buildId. The
+ * key is passed to the callbacks as a NUL-terminated hex string, which can be
+ * used directly as a file name.
+ *
+ * OpenBytecodeCacheEntryForReadOp works like OpenAsmJSCacheEntryForReadOp: if
+ * it returns 'true', the JS engine decodes the script directly out of the
+ * returned memory and then calls CloseBytecodeCacheEntryForReadOp, passing the
+ * same base address, size and handle. Inner functions which were lazily parsed
+ * stay lazy in the entry and are compiled from the saved source on first call.
+ *
+ * WriteBytecodeCacheEntryOp is called after a miss with the encoded script.
+ * The embedding must publish the entry atomically: a concurrent reader may
+ * never observe a partially written entry. Scripts which cannot be encoded
+ * are simply not cached.
+ */
+typedef bool
+(* OpenBytecodeCacheEntryForReadOp)(const char *key, size_t *size, const uint8_t **memory,
+                                    intptr_t *handle);
+typedef void
+(* CloseBytecodeCacheEntryForReadOp)(size_t size, const uint8_t *memory, intptr_t handle);
+typedef void
+(* WriteBytecodeCacheEntryOp)(const char *key, const uint8_t *memory, size_t size);
+
+struct BytecodeCacheOps
+{
+    OpenBytecodeCacheEntryForReadOp openEntryForRead;
+    CloseBytecodeCacheEntryForReadOp closeEntryForRead;
+    WriteBytecodeCacheEntryOp writeEntry;
+    BuildIdOp buildId;
+};
+
+extern JS_PUBLIC_API(void)
+SetBytecodeCacheOps(JSRuntime *rt, const BytecodeCacheOps *callbacks);
+
 } /* namespace JS */
 
 #endif /* jsapi_h */
@@ -10,6 +10,7 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/FloatingPoint.h"
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/Move.h"
 
 #include "jsapi.h"
 #include "jsatom.h"
@@ -28,6 +29,7 @@
 #include "vm/ForkJoin.h"
 #include "vm/Interpreter.h"
 #include "vm/NumericConversions.h"
+#include "vm/ParallelBulk.h"
 #include "vm/Shape.h"
 #include "vm/StringBuffer.h"
 
@@ -1659,13 +1661,40 @@ enum ComparatorMatchResult {
     Match_RightMinusLeft
 };
 
+/*
+ * Match one operand of a numeric comparator: an argument, optionally followed
+ * by a property access on it.
+ */
+static bool
+MatchComparatorOperand(JSScript *script, jsbytecode **pcp, uint16_t *argp, PropertyName **namep)
+{
+    jsbytecode *pc = *pcp;
+    if (JSOp(*pc) != JSOP_GETARG)
+        return false;
+    *argp = GET_ARGNO(pc);
+    pc += JSOP_GETARG_LENGTH;
+
+    *namep = nullptr;
+    if (JSOp(*pc) == JSOP_GETPROP || JSOp(*pc) == JSOP_LENGTH) {
+        *namep = script->getName(pc);
+        pc += GetBytecodeLength(pc);
+    }
+
+    *pcp = pc;
+    return true;
+}
+
 /*
  * Specialize behavior for comparator functions with particular common bytecode
- * patterns: namely, |return x - y| and |return y - x|.
+ * patterns: namely, |return x - y| and |return y - x|, and the same comparing
+ * a property of each argument, |return x.p - y.p| and |return y.p - x.p|. In
+ * the latter case the property's name is returned in |*keyp|.
  */
 ComparatorMatchResult
-MatchNumericComparator(JSContext *cx, const Value &v)
+MatchNumericComparator(JSContext *cx, const Value &v, PropertyName **keyp)
 {
+    *keyp = nullptr;
+
     if (!v.isObject())
         return Match_None;
 
@@ -1684,15 +1713,13 @@ MatchNumericComparator(JSContext *cx, const Value &v)
     jsbytecode *pc = script->code();
 
     uint16_t arg0, arg1;
-    if (JSOp(*pc) != JSOP_GETARG)
+    PropertyName *name0, *name1;
+    if (!MatchComparatorOperand(script, &pc, &arg0, &name0))
         return Match_None;
-    arg0 = GET_ARGNO(pc);
-    pc += JSOP_GETARG_LENGTH;
-
-    if (JSOp(*pc) != JSOP_GETARG)
+    if (!MatchComparatorOperand(script, &pc, &arg1, &name1))
+        return Match_None;
+    if (name0 != name1)
         return Match_None;
-    arg1 = GET_ARGNO(pc);
-    pc += JSOP_GETARG_LENGTH;
 
     if (JSOp(*pc) != JSOP_SUB)
         return Match_None;
@@ -1701,6 +1728,8 @@ MatchNumericComparator(JSContext *cx, const Value &v)
     if (JSOp(*pc) != JSOP_RETURN)
         return Match_None;
 
+    *keyp = name0;
+
     if (arg0 == 0 && arg1 == 1)
         return Match_LeftMinusRight;
 
@@ -1710,16 +1739,13 @@ MatchNumericComparator(JSContext *cx, const Value &v)
     return Match_None;
 }
 
-template<typename K, typename C>
-static inline bool
-MergeSortByKey(K keys, size_t len, K scratch, C comparator, AutoValueVector *vec)
+/* Reorder |vec| to match |keys|, which have been sorted. */
+template<typename K>
+static void
+ReorderByKeys(K keys, size_t len, AutoValueVector *vec)
 {
     MOZ_ASSERT(vec->length() >= len);
 
-    /* Sort keys. */
-    if (!MergeSort(keys, len, scratch, comparator))
-        return false;
-
     /*
      * Reorder vec by keys in-place, going element by element.  When an out-of-
      * place element is encountered, move that element to its proper position,
@@ -1751,7 +1777,37 @@ MergeSortByKey(K keys, size_t len, K scratch, C comparator, AutoValueVector *vec
         // the assertion vacuous, so don't bother, even in debug builds.
         (*vec)[i] = tv;
     }
+}
+
+template<typename K, typename C>
+static inline bool
+MergeSortByKey(K keys, size_t len, K scratch, C comparator, AutoValueVector *vec)
+{
+    MOZ_ASSERT(vec->length() >= len);
 
+    /* Sort keys. */
+    if (!MergeSort(keys, len, scratch, comparator))
+        return false;
+
+    ReorderByKeys(keys, len, vec);
+    return true;
+}
+
+/*
+ * As MergeSortByKey, but large arrays of keys are sorted on the ThreadPool, so
+ * |comparator| must be infallible and must not touch the GC heap.
+ */
+template<typename K, typename C>
+static inline bool
+ParallelMergeSortByKey(JSContext *cx, K keys, size_t len, K scratch, C comparator,
+                       AutoValueVector *vec)
+{
+    MOZ_ASSERT(vec->length() >= len);
+
+    if (!ParallelMergeSort(cx, keys, len, scratch, comparator))
+        return false;
+
+    ReorderByKeys(keys, len, vec);
     return true;
 }
 
@@ -1829,8 +1885,109 @@ SortNumerically(JSContext *cx, AutoValueVector *vec, size_t len, ComparatorMatch
     JS_ALWAYS_TRUE(numElements.resize(2 * len));
 
     /* Sort Values in vec numerically. */
-    return MergeSortByKey(numElements.begin(), len, numElements.begin() + len,
-                          SortComparatorNumerics[comp], vec);
+    return ParallelMergeSortByKey(cx, numElements.begin(), len, numElements.begin() + len,
+                                  SortComparatorNumerics[comp], vec);
+}
+
+/*
+ * Sort int32 Values numerically with an LSD radix sort over their bytes.
+ * Equal int32 Values are indistinguishable, so descending order is just the
+ * ascending order reversed.
+ */
+bool
+SortInt32s(JSContext *cx, AutoValueVector *vec, size_t len, ComparatorMatchResult comp)
+{
+    JS_ASSERT(vec->length() >= len);
+
+    /* Radix sorting only pays off once there are more keys than buckets. */
+    static const size_t MinRadixSortLength = 256;
+    if (len < MinRadixSortLength) {
+        JS_ALWAYS_TRUE(vec->resize(2 * len));
+        return MergeSort(vec->begin(), len, vec->begin() + len, SortComparatorInt32s[comp]);
+    }
+
+    Vector<uint32_t, 0, TempAllocPolicy> keys(cx);
+    if (!keys.resize(2 * len))
+        return false;
+
+    /* Flip the sign bit so that the keys order as unsigned integers. */
+    uint32_t *src = keys.begin();
+    uint32_t *dst = keys.begin() + len;
+    for (size_t i = 0; i < len; i++)
+        src[i] = uint32_t((*vec)[i].toInt32()) ^ 0x80000000;
+
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        size_t counts[256] = {};
+        for (size_t i = 0; i < len; i++)
+            counts[(src[i] >> shift) & 0xff]++;
+
+        /* Skip passes where every key has the same byte. */
+        if (counts[(src[0] >> shift) & 0xff] == len)
+            continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < 256; b++) {
+            size_t count = counts[b];
+            counts[b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < len; i++)
+            dst[counts[(src[i] >> shift) & 0xff]++] = src[i];
+        mozilla::Swap(src, dst);
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        size_t from = (comp == Match_LeftMinusRight) ? i : len - 1 - i;
+        (*vec)[i].setInt32(int32_t(src[from] ^ 0x80000000));
+    }
+    return true;
+}
+
+/*
+ * Sort objects by the numeric value of property |key|, for comparators of the
+ * form |return x.key - y.key|.
+ *
+ * The keys are read once up front, which is only unobservable when each
+ * element is an object whose property can be read without side effects and
+ * holds a number other than NaN. If any element does not qualify, |*sorted|
+ * is set to false and the caller falls back to calling the comparator.
+ */
+bool
+SortByNumericProperty(JSContext *cx, AutoValueVector *vec, size_t len, PropertyName *key,
+                      ComparatorMatchResult comp, bool *sorted)
+{
+    JS_ASSERT(vec->length() >= len);
+    *sorted = false;
+
+    Vector<NumericElement, 0, TempAllocPolicy> numElements(cx);
+
+    /* MergeSort uses the upper half as scratch space. */
+    if (!numElements.reserve(2 * len))
+        return false;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!JS_CHECK_OPERATION_LIMIT(cx))
+            return false;
+
+        const Value &v = (*vec)[i];
+        if (!v.isObject())
+            return true;
+
+        Value keyValue;
+        if (!GetPropertyPure(cx, &v.toObject(), key, &keyValue))
+            return true;
+        if (!keyValue.isNumber() || IsNaN(keyValue.toNumber()))
+            return true;
+
+        NumericElement el = { keyValue.toNumber(), i };
+        numElements.infallibleAppend(el);
+    }
+
+    JS_ALWAYS_TRUE(numElements.resize(2 * len));
+
+    *sorted = true;
+    return ParallelMergeSortByKey(cx, numElements.begin(), len, numElements.begin() + len,
+                                  SortComparatorNumerics[comp], vec);
 }
 
 } /* namespace anonymous */
@@ -1957,20 +2114,28 @@ js::array_sort(JSContext *cx, unsigned argc, Value *vp)
                     return false;
             }
         } else {
-            ComparatorMatchResult comp = MatchNumericComparator(cx, fval);
+            RootedPropertyName key(cx);
+            ComparatorMatchResult comp = MatchNumericComparator(cx, fval, key.address());
             if (comp == Match_Failure)
                 return false;
 
+            bool sorted = false;
             if (comp != Match_None) {
-                if (allInts) {
-                    JS_ALWAYS_TRUE(vec.resize(n * 2));
-                    if (!MergeSort(vec.begin(), n, vec.begin() + n, SortComparatorInt32s[comp]))
+                if (key) {
+                    if (!SortByNumericProperty(cx, &vec, n, key, comp, &sorted))
+                        return false;
+                } else if (allInts) {
+                    if (!SortInt32s(cx, &vec, n, comp))
                         return false;
+                    sorted = true;
                 } else {
                     if (!SortNumerically(cx, &vec, n, comp))
                         return false;
+                    sorted = true;
                 }
-            } else {
+            }
+
+            if (!sorted) {
                 FastInvokeGuard fig(cx, fval);
                 MOZ_ASSERT(!InParallelSection(),
                            "Array.sort() can't currently be used from parallel code");
@@ -13,6 +13,7 @@
 
 #include "gc/Barrier.h"
 #include "gc/Rooting.h"
+#include "js/CharacterEncoding.h"
 #include "vm/CommonPropertyNames.h"
 
 class JSAtom;
@@ -85,15 +86,32 @@ struct AtomHasher
 {
     struct Lookup
     {
-        const jschar    *chars;
+        union {
+            const jschar         *twoByteChars;
+            const JS::Latin1Char *latin1Chars;
+        };
+        bool            isLatin1;
         size_t          length;
         const JSAtom    *atom; /* Optional. */
 
-        Lookup(const jschar *chars, size_t length) : chars(chars), length(length), atom(nullptr) {}
+        Lookup(const jschar *chars, size_t length)
+          : twoByteChars(chars), isLatin1(false), length(length), atom(nullptr)
+        {}
+        Lookup(const JS::Latin1Char *chars, size_t length)
+          : latin1Chars(chars), isLatin1(true), length(length), atom(nullptr)
+        {}
         inline Lookup(const JSAtom *atom);
     };
 
-    static HashNumber hash(const Lookup &l) { return mozilla::HashString(l.chars, l.length); }
+    /*
+     * Both widths hash the same code unit values, so a Latin-1 lookup finds
+     * the atom created from the equivalent jschar sequence.
+     */
+    static HashNumber hash(const Lookup &l) {
+        return l.isLatin1
+               ? mozilla::HashString(l.latin1Chars, l.length)
+               : mozilla::HashString(l.twoByteChars, l.length);
+    }
     static inline bool match(const AtomStateEntry &entry, const Lookup &lookup);
     static void rekey(AtomStateEntry &k, const AtomStateEntry& newKey) { k = newKey; }
 };
@@ -207,6 +225,10 @@ extern JSAtom *
 AtomizeChars(ExclusiveContext *cx, const jschar *chars, size_t length,
              js::InternBehavior ib = js::DoNotInternAtom);
 
+extern JSAtom *
+AtomizeChars(ExclusiveContext *cx, const JS::Latin1Char *chars, size_t length,
+             js::InternBehavior ib = js::DoNotInternAtom);
+
 extern JSAtom *
 AtomizeString(ExclusiveContext *cx, JSString *str, js::InternBehavior ib = js::DoNotInternAtom);
 
@@ -138,7 +138,7 @@ IdToString(JSContext *cx, jsid id)
 
 inline
 AtomHasher::Lookup::Lookup(const JSAtom *atom)
-  : chars(atom->chars()), length(atom->length()), atom(atom)
+  : twoByteChars(atom->chars()), isLatin1(false), length(atom->length()), atom(atom)
 {}
 
 inline bool
@@ -149,7 +149,9 @@ AtomHasher::match(const AtomStateEntry &entry, const Lookup &lookup)
         return lookup.atom == key;
     if (key->length() != lookup.length)
         return false;
-    return mozilla::PodEqual(key->chars(), lookup.chars, lookup.length);
+    if (lookup.isLatin1)
+        return EqualChars(key->chars(), lookup.latin1Chars, lookup.length);
+    return mozilla::PodEqual(key->chars(), lookup.twoByteChars, lookup.length);
 }
 
 inline Handle<PropertyName*>
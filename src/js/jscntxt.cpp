@@ -45,6 +45,7 @@
 #endif
 #include "js/CharacterEncoding.h"
 #include "js/OldDebugAPI.h"
+#include "vm/SamplingProfiler.h"
 #include "vm/Shape.h"
 #include "yarr/BumpPointerAllocator.h"
 
@@ -109,6 +110,24 @@ JSCompartment::sweepCallsiteClones()
     }
 }
 
+void
+JSCompartment::fixupCallsiteClones()
+{
+    if (!callsiteClones.initialized())
+        return;
+
+    for (CallsiteCloneTable::Enum e(callsiteClones); !e.empty(); e.popFront()) {
+        CallsiteCloneKey key = e.front().key();
+        JSFunction **funp = e.front().value().unsafeGet();
+        if (IsForwarded(*funp))
+            *funp = Forwarded(*funp);
+        if (IsForwarded(key.original)) {
+            key.original = Forwarded(key.original);
+            e.rekeyFront(key);
+        }
+    }
+}
+
 JSFunction *
 js::ExistingCloneFunctionAtCallsite(const CallsiteCloneTable &table, JSFunction *fun,
                                     JSScript *script, jsbytecode *pc)
@@ -1029,6 +1048,10 @@ js_InvokeOperationCallback(JSContext *cx)
     jit::AttachFinishedCompilations(cx);
 #endif
 
+    /* The sampling profiler's thread may have asked for a sample. */
+    if (rt->samplingProfiler)
+        rt->samplingProfiler->maybeSample(cx);
+
     /*
      * Important: Additional callbacks can occur inside the callback handler
      * if it re-enters the JS engine. The embedding must ensure that the
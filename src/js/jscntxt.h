@@ -58,6 +58,8 @@ struct CallsiteCloneKey {
     static inline bool match(const CallsiteCloneKey &a, const CallsiteCloneKey &b) {
         return a.script == b.script && a.offset == b.offset && a.original == b.original;
     }
+
+    static void rekey(CallsiteCloneKey &k, const CallsiteCloneKey &newKey) { k = newKey; }
 };
 
 typedef HashMap<CallsiteCloneKey,
@@ -285,6 +287,7 @@ struct ThreadSafeContext : ContextFriendFields,
     bool useHelperThreads() { return runtime_->useHelperThreads(); }
     unsigned cpuCount() { return runtime_->cpuCount(); }
     size_t workerThreadCount() { return runtime_->workerThreadCount(); }
+    SourceCompression sourceCompression() { return runtime_->sourceCompression; }
     void *runtimeAddressForJit() { return runtime_; }
     void *stackLimitAddress(StackKind kind) { return &runtime_->mainThread.nativeStackLimit[kind]; }
     size_t gcSystemPageSize() { return runtime_->gcSystemPageSize; }
@@ -646,6 +646,36 @@ void
 JSCompartment::purge()
 {
     dtoaCache.purge();
+    regExps.resultCache().purge();
+}
+
+void
+JSCompartment::fixupCrossCompartmentWrappers()
+{
+    for (WrapperMap::Enum e(crossCompartmentWrappers); !e.empty(); e.popFront()) {
+        CrossCompartmentKey key = e.front().key();
+        if (key.kind != CrossCompartmentKey::ObjectWrapper)
+            continue;
+
+        JSObject *wrapped = static_cast<JSObject *>(key.wrapped);
+        if (IsForwarded(wrapped)) {
+            key.wrapped = Forwarded(wrapped);
+            e.rekeyFront(key);
+        }
+    }
+}
+
+void
+JSCompartment::fixupAfterMovingGC()
+{
+    fixupCrossCompartmentWrappers();
+    fixupBaseShapeTable();
+    fixupInitialShapeTable();
+    fixupNewTypeObjectTable(newTypeObjects);
+    fixupNewTypeObjectTable(lazyTypeObjects);
+    fixupCallsiteClones();
+    types.fixupAfterMovingGC();
+    regExps.fixupAfterMovingGC();
 }
 
 void
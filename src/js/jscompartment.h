@@ -238,15 +238,18 @@ struct JSCompartment
     /* Set of all unowned base shapes in the compartment. */
     js::BaseShapeSet             baseShapes;
     void sweepBaseShapeTable();
+    void fixupBaseShapeTable();
 
     /* Set of initial shapes in the compartment. */
     js::InitialShapeSet          initialShapes;
     void sweepInitialShapeTable();
+    void fixupInitialShapeTable();
 
     /* Set of default 'new' or lazy types in the compartment. */
     js::types::TypeObjectWithNewScriptSet newTypeObjects;
     js::types::TypeObjectWithNewScriptSet lazyTypeObjects;
     void sweepNewTypeObjectTable(js::types::TypeObjectWithNewScriptSet &table);
+    void fixupNewTypeObjectTable(js::types::TypeObjectWithNewScriptSet &table);
 #if defined(JSGC_GENERATIONAL) and defined(JS_GC_ZEAL)
     void checkNewTypeObjectTableAfterMovingGC();
     void checkInitialShapesTableAfterMovingGC();
@@ -260,6 +263,7 @@ struct JSCompartment
      */
     js::CallsiteCloneTable callsiteClones;
     void sweepCallsiteClones();
+    void fixupCallsiteClones();
 
     /* During GC, stores the index of this compartment in rt->compartments. */
     unsigned                     gcIndex;
@@ -331,6 +335,10 @@ struct JSCompartment
     void sweep(js::FreeOp *fop, bool releaseTypes);
     void sweepCrossCompartmentWrappers();
     void purge();
+
+    /* Update tables keyed on object addresses after a compacting GC. */
+    void fixupAfterMovingGC();
+    void fixupCrossCompartmentWrappers();
     void clearTables();
 
     bool hasObjectMetadataCallback() const { return objectMetadataCallback; }
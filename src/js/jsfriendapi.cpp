@@ -59,6 +59,16 @@ js::ForgetSourceHook(JSRuntime *rt)
     return rt->sourceHook.forget();
 }
 
+JS_FRIEND_API(void)
+js::SetSourceCompression(JSRuntime *rt, SourceCompression codec)
+{
+#ifndef USE_ZLIB
+    if (codec == SourceCompression_Zlib)
+        codec = SourceCompression_LZ4;
+#endif
+    rt->sourceCompression = codec;
+}
+
 JS_FRIEND_API(void)
 JS_SetGrayGCRootsTracer(JSRuntime *rt, JSTraceDataOp traceOp, void *data)
 {
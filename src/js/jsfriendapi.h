@@ -262,6 +262,23 @@ SetSourceHook(JSRuntime *rt, SourceHook *hook);
 extern JS_FRIEND_API(SourceHook *)
 ForgetSourceHook(JSRuntime *rt);
 
+/* Codecs available for compressing retained script source off-thread. */
+enum SourceCompression {
+    SourceCompression_None,
+    SourceCompression_LZ4,
+    SourceCompression_Zlib
+};
+
+/*
+ * Select the codec |rt| uses for compressing script sources. LZ4 is the
+ * default: it compresses less than zlib, but is several times faster both to
+ * compress and to decompress, and lets lazily compiled functions decompress
+ * only the part of the source that contains them. Builds without zlib
+ * support use LZ4 when SourceCompression_Zlib is requested.
+ */
+extern JS_FRIEND_API(void)
+SetSourceCompression(JSRuntime *rt, SourceCompression codec);
+
 extern JS_FRIEND_API(JS::Zone *)
 GetCompartmentZone(JSCompartment *comp);
 
@@ -358,7 +358,8 @@ js::XDRInterpretedFunction(XDRState<mode> *xdr, HandleObject enclosingScope, Han
 {
     enum FirstWordFlag {
         HasAtom = 0x1,
-        IsStarGenerator = 0x2
+        IsStarGenerator = 0x2,
+        IsLazy = 0x4
     };
 
     /* NB: Keep this in sync with CloneFunctionAndScript. */
@@ -369,6 +370,7 @@ js::XDRInterpretedFunction(XDRState<mode> *xdr, HandleObject enclosingScope, Han
     JSContext *cx = xdr->cx();
     RootedFunction fun(cx);
     RootedScript script(cx);
+    Rooted<LazyScript *> lazy(cx);
     if (mode == XDR_ENCODE) {
         fun = &objp->as<JSFunction>();
         if (!fun->isInterpreted()) {
@@ -383,9 +385,20 @@ js::XDRInterpretedFunction(XDRState<mode> *xdr, HandleObject enclosingScope, Han
             firstword |= HasAtom;
         if (fun->isStarGenerator())
             firstword |= IsStarGenerator;
-        script = fun->getOrCreateScript(cx);
-        if (!script)
-            return false;
+
+        /*
+         * Keep lazy functions lazy when the decoder can find their source:
+         * either through the enclosing script, or, for the inner functions
+         * of a lazy script, once that script is compiled.
+         */
+        if (CanXDRLazily(fun) && (enclosingScript || !fun->lazyScript()->sourceObject())) {
+            firstword |= IsLazy;
+            lazy = fun->lazyScript();
+        } else {
+            script = fun->getOrCreateScript(cx);
+            if (!script)
+                return false;
+        }
         atom = fun->displayAtom();
         flagsword = (fun->nargs() << 16) | fun->flags();
     }
@@ -414,18 +427,28 @@ js::XDRInterpretedFunction(XDRState<mode> *xdr, HandleObject enclosingScope, Han
     if (!xdr->codeUint32(&flagsword))
         return false;
 
-    if (!XDRScript(xdr, enclosingScope, enclosingScript, fun, &script))
-        return false;
+    if (firstword & IsLazy) {
+        if (!XDRLazyScript(xdr, enclosingScope, enclosingScript, fun, &lazy))
+            return false;
+    } else {
+        if (!XDRScript(xdr, enclosingScope, enclosingScript, fun, &script))
+            return false;
+    }
 
     if (mode == XDR_DECODE) {
+        /* initLazyScript expects the INTERPRETED flag the function was created with. */
+        if (firstword & IsLazy)
+            fun->initLazyScript(lazy);
         fun->setArgCount(flagsword >> 16);
         fun->setFlags(uint16_t(flagsword));
         fun->initAtom(atom);
-        fun->initScript(script);
-        script->setFunction(fun);
+        if (!(firstword & IsLazy)) {
+            fun->initScript(script);
+            script->setFunction(fun);
+            JS_ASSERT(fun->nargs() == fun->nonLazyScript()->bindings.numArgs());
+        }
         if (!JSFunction::setTypeForScriptedFunction(cx, fun))
             return false;
-        JS_ASSERT(fun->nargs() == fun->nonLazyScript()->bindings.numArgs());
         objp.set(fun);
     }
 
@@ -1207,11 +1230,16 @@ JSFunction::createScriptForLazilyInterpretedFunction(JSContext *cx, HandleFuncti
 
         // Parse and compile the script from source.
         SourceDataCache::AutoSuppressPurge asp(cx);
-        const jschar *chars = lazy->source()->chars(cx, asp);
+        // The token stream uses the start of the function's first line as
+        // its initial line base, so make sure that part is available too.
+        ScopedJSFreePtr<jschar> holder;
+        size_t lineStart = lazy->begin() - Min(size_t(lazy->column()), size_t(lazy->begin()));
+        const jschar *chars = lazy->source()->chars(cx, asp, lineStart,
+                                                    lazy->end() - lineStart, holder);
         if (!chars)
             return false;
 
-        const jschar *lazyStart = chars + lazy->begin();
+        const jschar *lazyStart = chars + (lazy->begin() - lineStart);
         size_t lazyLength = lazy->end() - lazy->begin();
 
         if (!frontend::CompileLazyFunction(cx, lazy, lazyStart, lazyLength))
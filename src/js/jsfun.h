@@ -633,6 +633,19 @@ bool
 XDRInterpretedFunction(XDRState<mode> *xdr, HandleObject enclosingScope,
                        HandleScript enclosingScript, MutableHandleObject objp);
 
+/*
+ * Lazily parsed functions which have not been compiled yet are XDR'd as their
+ * LazyScript, leaving compilation to the first call after decoding.
+ */
+inline bool
+CanXDRLazily(JSFunction *fun)
+{
+    if (!fun->isInterpretedLazy())
+        return false;
+    LazyScript *lazy = fun->lazyScriptOrNull();
+    return lazy && !lazy->maybeScript();
+}
+
 extern JSObject *
 CloneFunctionAndScript(JSContext *cx, HandleObject enclosingScope, HandleFunction fun);
 
@@ -201,10 +201,12 @@
 #include "TraceLogging.h"
 #endif
 
+#include "ds/Sort.h"
 #include "gc/FindSCCs.h"
 #include "gc/GCInternals.h"
 #include "gc/Marking.h"
 #include "gc/Memory.h"
+#include "gc/ParallelMarking.h"
 #ifdef JS_ION
 # include "jit/BaselineJIT.h"
 #endif
@@ -315,31 +317,23 @@ static const AllocKind FinalizePhaseStrings[] = {
     FINALIZE_EXTERNAL_STRING
 };
 
-static const AllocKind FinalizePhaseScripts[] = {
-    FINALIZE_SCRIPT,
-    FINALIZE_LAZY_SCRIPT
-};
-
 static const AllocKind FinalizePhaseJitCode[] = {
     FINALIZE_JITCODE
 };
 
 static const AllocKind * const FinalizePhases[] = {
     FinalizePhaseStrings,
-    FinalizePhaseScripts,
     FinalizePhaseJitCode
 };
 static const int FinalizePhaseCount = sizeof(FinalizePhases) / sizeof(AllocKind*);
 
 static const int FinalizePhaseLength[] = {
     sizeof(FinalizePhaseStrings) / sizeof(AllocKind),
-    sizeof(FinalizePhaseScripts) / sizeof(AllocKind),
     sizeof(FinalizePhaseJitCode) / sizeof(AllocKind)
 };
 
 static const gcstats::Phase FinalizePhaseStatsPhase[] = {
     gcstats::PHASE_SWEEP_STRING,
-    gcstats::PHASE_SWEEP_SCRIPT,
     gcstats::PHASE_SWEEP_JITCODE
 };
 
@@ -356,6 +350,11 @@ static const AllocKind BackgroundPhaseObjects[] = {
     FINALIZE_OBJECT16_BACKGROUND
 };
 
+static const AllocKind BackgroundPhaseScripts[] = {
+    FINALIZE_SCRIPT,
+    FINALIZE_LAZY_SCRIPT
+};
+
 static const AllocKind BackgroundPhaseStrings[] = {
     FINALIZE_SHORT_STRING,
     FINALIZE_STRING
@@ -369,6 +368,7 @@ static const AllocKind BackgroundPhaseShapes[] = {
 
 static const AllocKind * const BackgroundPhases[] = {
     BackgroundPhaseObjects,
+    BackgroundPhaseScripts,
     BackgroundPhaseStrings,
     BackgroundPhaseShapes
 };
@@ -376,6 +376,7 @@ static const int BackgroundPhaseCount = sizeof(BackgroundPhases) / sizeof(AllocK
 
 static const int BackgroundPhaseLength[] = {
     sizeof(BackgroundPhaseObjects) / sizeof(AllocKind),
+    sizeof(BackgroundPhaseScripts) / sizeof(AllocKind),
     sizeof(BackgroundPhaseStrings) / sizeof(AllocKind),
     sizeof(BackgroundPhaseShapes) / sizeof(AllocKind)
 };
@@ -1149,6 +1150,11 @@ js_FinishGC(JSRuntime *rt)
     FinishVerifier(rt);
 #endif
 
+#ifdef JS_THREADSAFE
+    js_delete(rt->gcParallelMarker);
+    rt->gcParallelMarker = nullptr;
+#endif
+
     /* Delete all remaining zones. */
     for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next()) {
         for (CompartmentsInZoneIter comp(zone); !comp.done(); comp.next())
@@ -1572,6 +1578,12 @@ ArenaLists::backgroundFinalize(FreeOp *fop, ArenaHeader *listHead, bool onBackgr
         lists->backgroundFinalizeState[thingKind] = BFS_DONE;
 
     lists->arenaListsToSweep[thingKind] = nullptr;
+
+#ifdef JS_THREADSAFE
+    /* Wake up the main thread if it waits for these things to be finalized. */
+    if (onBackgroundThread)
+        PR_NotifyAllCondVar(fop->runtime()->gcHelperThread.done);
+#endif
 }
 
 void
@@ -1609,8 +1621,8 @@ void
 ArenaLists::queueScriptsForSweep(FreeOp *fop)
 {
     gcstats::AutoPhase ap(fop->runtime()->gcStats, gcstats::PHASE_SWEEP_SCRIPT);
-    queueForForegroundSweep(fop, FINALIZE_SCRIPT);
-    queueForForegroundSweep(fop, FINALIZE_LAZY_SCRIPT);
+    queueForBackgroundSweep(fop, FINALIZE_SCRIPT);
+    queueForBackgroundSweep(fop, FINALIZE_LAZY_SCRIPT);
 }
 
 void
@@ -1817,7 +1829,9 @@ GCMarker::GCMarker(JSRuntime *rt)
     started(false),
     unmarkedArenaStackTop(nullptr),
     markLaterArenas(0),
-    grayBufferState(GRAY_BUFFER_UNUSED)
+    grayBufferState(GRAY_BUFFER_UNUSED),
+    parallelMarker(nullptr),
+    parallelHelper(false)
 {
     InitTracer(this, rt, nullptr);
 }
@@ -1915,6 +1929,19 @@ void
 GCMarker::delayMarkingChildren(const void *thing)
 {
     const Cell *cell = reinterpret_cast<const Cell *>(thing);
+#ifdef JS_THREADSAFE
+    /* Parallel markers share the runtime marker's list of delayed arenas. */
+    if (parallelMarker) {
+        parallelMarker->delayMarkingChildren(cell);
+        return;
+    }
+#endif
+    delayMarkingCell(cell);
+}
+
+void
+GCMarker::delayMarkingCell(const Cell *cell)
+{
     cell->arenaHeader()->markOverflow = 1;
     delayMarkingArena(cell->arenaHeader());
 }
@@ -2632,6 +2659,22 @@ GCHelperThread::waitBackgroundSweepEnd()
 #endif /* JS_THREADSAFE */
 }
 
+void
+GCHelperThread::waitBackgroundFinalize(Zone *zone, AllocKind kind)
+{
+    if (!rt->useHelperThreads()) {
+        JS_ASSERT(state == IDLE);
+        return;
+    }
+
+#ifdef JS_THREADSAFE
+    /* ArenaLists::backgroundFinalize notifies |done| after each kind. */
+    AutoLockGC lock(rt);
+    while (state == SWEEPING && !zone->allocator.arenas.doneBackgroundFinalize(kind))
+        wait(done);
+#endif /* JS_THREADSAFE */
+}
+
 void
 GCHelperThread::waitBackgroundSweepOrAllocEnd()
 {
@@ -3892,6 +3935,13 @@ BeginSweepingZoneGroup(JSRuntime *rt)
         JS_ASSERT(zone->isGCMarking());
         zone->setGCState(Zone::Sweep);
 
+        /*
+         * Turn off the zone's Ion barriers while its scripts are still in the
+         * arena lists: they are finalized on the background thread, which may
+         * be running when the slice ends.
+         */
+        zone->setNeedsBarrier(false, Zone::UpdateIon);
+
         /* Purge the ArenaLists before sweeping. */
         zone->allocator.arenas.purge();
 
@@ -3966,6 +4016,8 @@ BeginSweepingZoneGroup(JSRuntime *rt)
     for (GCZoneGroupIter zone(rt); !zone.done(); zone.next()) {
         gcstats::AutoSCC scc(rt->gcStats, rt->gcZoneGroupIndex);
         zone->allocator.arenas.queueScriptsForSweep(&fop);
+        zone->allocator.arenas.gcScriptArenasToSweep =
+            zone->allocator.arenas.arenaListsToSweep[FINALIZE_SCRIPT];
     }
 #ifdef JS_ION
     for (GCZoneGroupIter zone(rt); !zone.done(); zone.next()) {
@@ -4008,7 +4060,7 @@ EndSweepingZoneGroup(JSRuntime *rt)
 }
 
 static void
-BeginSweepPhase(JSRuntime *rt, bool lastGC)
+BeginSweepPhase(JSRuntime *rt, JSGCInvocationKind gckind, bool lastGC)
 {
     /*
      * Sweep phase.
@@ -4024,8 +4076,14 @@ BeginSweepPhase(JSRuntime *rt, bool lastGC)
 
     gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_SWEEP);
 
+    /*
+     * Objects are only moved once everything has been finalized, so a
+     * compacting GC sweeps on the main thread.
+     */
+    rt->gcIsCompacting = rt->gcCompactingEnabled && gckind == GC_SHRINK && !lastGC;
+
 #ifdef JS_THREADSAFE
-    rt->gcSweepOnBackgroundThread = !lastGC && rt->useHelperThreads();
+    rt->gcSweepOnBackgroundThread = !lastGC && !rt->gcIsCompacting && rt->useHelperThreads();
 #endif
 
 #ifdef DEBUG
@@ -4054,11 +4112,40 @@ ArenaLists::foregroundFinalize(FreeOp *fop, AllocKind thingKind, SliceBudget &sl
     return FinalizeArenas(fop, &arenaListsToSweep[thingKind], dest, thingKind, sliceBudget);
 }
 
+#ifdef JS_THREADSAFE
+/*
+ * Return the runtime's parallel marker, creating it on first use, or null if
+ * marking has to stay on the main thread.
+ */
+static ParallelMarker *
+GetParallelMarker(JSRuntime *rt)
+{
+    if (!rt->gcParallelMarkingEnabled || !rt->useHelperThreads())
+        return nullptr;
+    if (rt->threadPool.numWorkers() == 0 || rt->threadPool.isMainThreadActive())
+        return nullptr;
+
+    if (!rt->gcParallelMarker) {
+        ParallelMarker *marker = js_new<ParallelMarker>(rt);
+        if (!marker || !marker->init()) {
+            js_delete(marker);
+            return nullptr;
+        }
+        rt->gcParallelMarker = marker;
+    }
+    return rt->gcParallelMarker;
+}
+#endif
+
 static bool
 DrainMarkStack(JSRuntime *rt, SliceBudget &sliceBudget, gcstats::Phase phase)
 {
     /* Run a marking slice and return whether the stack is now empty. */
     gcstats::AutoPhase ap(rt->gcStats, phase);
+#ifdef JS_THREADSAFE
+    if (ParallelMarker *marker = GetParallelMarker(rt))
+        return marker->drainMarkStack(sliceBudget);
+#endif
     return rt->gcMarker.drainMarkStack(sliceBudget);
 }
 
@@ -4093,25 +4180,44 @@ SweepPhase(JSRuntime *rt, SliceBudget &sliceBudget)
             rt->gcSweepZone = rt->gcCurrentZoneGroup;
         }
 
-        /* Remove dead shapes from the shape tree, but don't finalize them yet. */
-        {
-            gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_SWEEP_SHAPE);
+        /*
+         * Detach dead scripts from the runtime and remove dead shapes from the
+         * shape tree, but leave finalizing them to the background thread.
+         */
+        for (; rt->gcSweepZone; rt->gcSweepZone = rt->gcSweepZone->nextNodeInGroup()) {
+            Zone *zone = rt->gcSweepZone;
 
-            for (; rt->gcSweepZone; rt->gcSweepZone = rt->gcSweepZone->nextNodeInGroup()) {
-                Zone *zone = rt->gcSweepZone;
-                while (ArenaHeader *arena = zone->allocator.arenas.gcShapeArenasToSweep) {
+            if (zone->allocator.arenas.gcScriptArenasToSweep) {
+                gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_SWEEP_SCRIPT);
+
+                while (ArenaHeader *arena = zone->allocator.arenas.gcScriptArenasToSweep) {
                     for (CellIterUnderGC i(arena); !i.done(); i.next()) {
-                        Shape *shape = i.get<Shape>();
-                        if (!shape->isMarked())
-                            shape->sweep();
+                        JSScript *script = i.get<JSScript>();
+                        if (!script->isMarked())
+                            script->sweep(&fop);
                     }
 
-                    zone->allocator.arenas.gcShapeArenasToSweep = arena->next;
-                    sliceBudget.step(Arena::thingsPerArena(Arena::thingSize(FINALIZE_SHAPE)));
+                    zone->allocator.arenas.gcScriptArenasToSweep = arena->next;
+                    sliceBudget.step(Arena::thingsPerArena(Arena::thingSize(FINALIZE_SCRIPT)));
                     if (sliceBudget.isOverBudget())
                         return false;  /* Yield to the mutator. */
                 }
             }
+
+            gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_SWEEP_SHAPE);
+
+            while (ArenaHeader *arena = zone->allocator.arenas.gcShapeArenasToSweep) {
+                for (CellIterUnderGC i(arena); !i.done(); i.next()) {
+                    Shape *shape = i.get<Shape>();
+                    if (!shape->isMarked())
+                        shape->sweep();
+                }
+
+                zone->allocator.arenas.gcShapeArenasToSweep = arena->next;
+                sliceBudget.step(Arena::thingsPerArena(Arena::thingSize(FINALIZE_SHAPE)));
+                if (sliceBudget.isOverBudget())
+                    return false;  /* Yield to the mutator. */
+            }
         }
 
         EndSweepingZoneGroup(rt);
@@ -4262,6 +4368,322 @@ EndSweepPhase(JSRuntime *rt, JSGCInvocationKind gckind, bool lastGC)
     rt->gcLastGCTime = PRMJ_Now();
 }
 
+/*
+ * Compacting
+ *
+ * A full shrinking GC may, if JSGC_COMPACTING is set, move objects out of
+ * sparsely used arenas once sweeping has finished so that those arenas and
+ * then their chunks can be returned to the system. Sweeping happens on the
+ * main thread in this case so that every arena list is final before anything
+ * moves.
+ *
+ * Only objects of the nursery allocable kinds are moved, and of those only
+ * plain native objects: singletons, globals, watched objects and objects
+ * with private data or a finalizer stay where they are, as something outside
+ * the heap may refer to them. Zones holding JIT code that cannot be discarded
+ * are skipped, and nothing is moved while a debugger is present or JIT code is
+ * on the stack.
+ *
+ * A moved object leaves a MovedCellOverlay behind in its old cell. The hash
+ * tables keyed on object addresses are rekeyed first, then all other pointers
+ * are updated by tracing the roots and the whole heap with a callback tracer,
+ * and finally the emptied arenas are released.
+ */
+
+static bool
+CanRelocateObject(JSObject *obj)
+{
+    const Class *clasp = obj->getClass();
+    return obj->isNative() &&
+           !obj->is<GlobalObject>() &&
+           !obj->hasSingletonType() &&
+           !obj->watched() &&
+           !(clasp->flags & JSCLASS_HAS_PRIVATE) &&
+           !clasp->finalize;
+}
+
+namespace {
+
+struct ArenaUsage
+{
+    ArenaHeader *aheader;
+    size_t usedCells;
+    bool movable;
+    bool selected;
+};
+
+struct ArenaUsageComparator
+{
+    bool operator()(const ArenaUsage *a, const ArenaUsage *b, bool *lessOrEqualp) {
+        *lessOrEqualp = a->usedCells <= b->usedCells;
+        return true;
+    }
+};
+
+} /* anonymous namespace */
+
+static void
+RelocateCell(Cell *src, Cell *dst, size_t thingSize)
+{
+    JSObject *srcObj = static_cast<JSObject *>(src);
+    JSObject *dstObj = static_cast<JSObject *>(dst);
+
+    memcpy(dst, src, thingSize);
+    dstObj->fixupAfterMovingGC(srcObj);
+
+    if (src->isMarked(GRAY))
+        dst->markIfUnmarked(GRAY);
+    else if (src->isMarked(BLACK))
+        dst->markIfUnmarked(BLACK);
+
+    MovedCellOverlay::fromCell(src)->forwardTo(dst);
+}
+
+ArenaHeader *
+ArenaLists::relocateArenas(AllocKind thingKind, ArenaHeader *relocated)
+{
+    JS_ASSERT(freeLists[thingKind].isEmpty());
+    JS_ASSERT(!arenaListsToSweep[thingKind]);
+    JS_ASSERT(backgroundFinalizeState[thingKind] == BFS_DONE);
+
+    ArenaList *al = &arenaLists[thingKind];
+    size_t thingSize = Arena::thingSize(thingKind);
+    size_t thingsPerArena = Arena::thingsPerArena(thingSize);
+
+    /* Work out how full each arena is and whether everything in it can move. */
+    Vector<ArenaUsage, 0, SystemAllocPolicy> usage;
+    size_t freeCells = 0;
+    for (ArenaHeader *aheader = al->head; aheader; aheader = aheader->next) {
+        ArenaUsage u = { aheader, 0, true, false };
+        for (CellIterUnderGC i(aheader); !i.done(); i.next()) {
+            u.usedCells++;
+            if (u.movable && !CanRelocateObject(i.get<JSObject>()))
+                u.movable = false;
+        }
+        freeCells += thingsPerArena - u.usedCells;
+        if (!usage.append(u))
+            return relocated;
+    }
+
+    Vector<ArenaUsage *, 0, SystemAllocPolicy> candidates;
+    for (size_t i = 0; i < usage.length(); i++) {
+        if (usage[i].movable && usage[i].usedCells < thingsPerArena) {
+            if (!candidates.append(&usage[i]))
+                return relocated;
+        }
+    }
+    if (candidates.empty())
+        return relocated;
+
+    size_t ncandidates = candidates.length();
+    if (!candidates.resize(ncandidates * 2))
+        return relocated;
+    MOZ_ALWAYS_TRUE(MergeSort(candidates.begin(), ncandidates, candidates.begin() + ncandidates,
+                              ArenaUsageComparator()));
+
+    /*
+     * Select the emptiest arenas for as long as the cells left in the
+     * remaining arenas can take their contents. Selecting an arena removes its
+     * own free cells from the space available.
+     */
+    size_t movedCells = 0;
+    size_t lostCells = 0;
+    size_t selectedCount = 0;
+    for (size_t i = 0; i < ncandidates; i++) {
+        ArenaUsage *u = candidates[i];
+        size_t arenaFree = thingsPerArena - u->usedCells;
+        if (movedCells + u->usedCells > freeCells - lostCells - arenaFree)
+            break;
+        u->selected = true;
+        movedCells += u->usedCells;
+        lostCells += arenaFree;
+        selectedCount++;
+    }
+    if (!selectedCount)
+        return relocated;
+
+    /* Move the contents of the selected arenas into the others, in list order. */
+    size_t dest = 0;
+    FreeSpan span;
+    span.initAsEmpty();
+    for (size_t i = 0; i < usage.length(); i++) {
+        if (!usage[i].selected)
+            continue;
+        for (CellIterUnderGC iter(usage[i].aheader); !iter.done(); iter.next()) {
+            void *thing;
+            while (!(thing = span.allocate(thingSize))) {
+                if (dest > 0)
+                    usage[dest - 1].aheader->setAsFullyUsed();
+                while (usage[dest].selected)
+                    dest++;
+                JS_ASSERT(dest < usage.length());
+                span = usage[dest].aheader->getFirstFreeSpan();
+                dest++;
+            }
+            RelocateCell(iter.getCell(), static_cast<Cell *>(thing), thingSize);
+        }
+    }
+    if (dest > 0) {
+        ArenaHeader *last = usage[dest - 1].aheader;
+        if (span.isEmpty())
+            last->setAsFullyUsed();
+        else
+            last->setFirstFreeSpan(&span);
+    }
+
+    /* Rebuild the arena list and hand back the arenas that are now empty. */
+    al->clear();
+    for (size_t i = 0; i < usage.length(); i++) {
+        ArenaHeader *aheader = usage[i].aheader;
+        if (usage[i].selected) {
+            aheader->next = relocated;
+            relocated = aheader;
+        } else {
+            al->insert(aheader);
+        }
+    }
+
+    return relocated;
+}
+
+ArenaHeader *
+ArenaLists::relocateArenas(ArenaHeader *relocated)
+{
+    for (size_t i = 0; i < FINALIZE_LIMIT; i++) {
+        AllocKind thingKind = AllocKind(i);
+        if (IsBackgroundFinalized(thingKind) && IsNurseryAllocable(thingKind))
+            relocated = relocateArenas(thingKind, relocated);
+    }
+    return relocated;
+}
+
+static bool
+ShouldCompactZone(JSRuntime *rt, Zone *zone)
+{
+    if (rt->isSelfHostingZone(zone) || zone->isPreservingCode())
+        return false;
+
+    for (CompartmentsInZoneIter comp(zone); !comp.done(); comp.next()) {
+        if (comp->debugMode() || comp->debugScopes)
+            return false;
+    }
+    return true;
+}
+
+static bool
+CanCompact(JSRuntime *rt)
+{
+    if (!rt->debuggerList.isEmpty() || rt->exclusiveThreadsPresent())
+        return false;
+
+    for (ActivationIterator iter(rt); !iter.done(); ++iter) {
+        if (iter.activation()->isJit())
+            return false;
+    }
+    return true;
+}
+
+static void
+UpdateRelocatedPointer(JSTracer *trc, void **thingp, JSGCTraceKind kind)
+{
+    if (kind != JSTRACE_OBJECT)
+        return;
+
+    JSObject *obj = static_cast<JSObject *>(*thingp);
+    if (IsForwarded(obj))
+        *thingp = Forwarded(obj);
+}
+
+static void
+UpdatePointersToRelocatedObjects(JSRuntime *rt)
+{
+    /*
+     * Rekey the tables first, while the things they are keyed on still hold
+     * the old addresses their hashes were computed from.
+     */
+    for (CompartmentsIter comp(rt, SkipAtoms); !comp.done(); comp.next())
+        comp->fixupAfterMovingGC();
+
+    /* Proxies check their referents' wrapper map entries as they are traced. */
+    AutoDisableProxyCheck noProxyCheck(rt);
+
+    JSTracer trc;
+    JS_TracerInit(&trc, rt, UpdateRelocatedPointer);
+    trc.eagerlyTraceWeakMaps = TraceWeakMapKeysValues;
+
+    MarkRuntime(&trc);
+
+    for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next()) {
+        for (size_t i = 0; i < FINALIZE_LIMIT; i++) {
+            AllocKind thingKind = AllocKind(i);
+            JSGCTraceKind traceKind = MapAllocToTraceKind(thingKind);
+            if (traceKind == JSTRACE_STRING)
+                continue;
+            for (CellIterUnderGC iter(zone, thingKind); !iter.done(); iter.next())
+                JS_TraceChildren(&trc, iter.getCell(), traceKind);
+        }
+    }
+
+#ifdef JS_GC_ZEAL
+    for (JSObject **p = rt->gcSelectedForMarking.begin(); p != rt->gcSelectedForMarking.end(); p++)
+        *p = MaybeForwarded(*p);
+#endif
+}
+
+static void
+Compact(JSRuntime *rt)
+{
+    gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_COMPACT);
+
+    if (!CanCompact(rt))
+        return;
+
+    PurgeRuntime(rt);
+
+    ArenaHeader *relocated = nullptr;
+    {
+        gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_COMPACT_MOVE);
+        FreeOp fop(rt, false);
+        for (ZonesIter zone(rt, SkipAtoms); !zone.done(); zone.next()) {
+            if (!ShouldCompactZone(rt, zone))
+                continue;
+            zone->discardJitCode(&fop);
+            zone->allocator.arenas.purge();
+            relocated = zone->allocator.arenas.relocateArenas(relocated);
+        }
+    }
+
+    if (!relocated)
+        return;
+
+    {
+        gcstats::AutoPhase ap(rt->gcStats, gcstats::PHASE_COMPACT_UPDATE);
+        UpdatePointersToRelocatedObjects(rt);
+    }
+
+    while (relocated) {
+        ArenaHeader *aheader = relocated;
+        relocated = aheader->next;
+
+        Chunk *chunk = aheader->chunk();
+        memset(chunk->bitmap.arenaBits(aheader), 0, ArenaBitmapWords * sizeof(uintptr_t));
+        size_t firstThing = Arena::firstThingOffset(aheader->getAllocKind());
+        JS_POISON(reinterpret_cast<void *>(aheader->arenaAddress() + firstThing),
+                  JS_FREE_PATTERN, ArenaSize - firstThing);
+
+        rt->gcStats.count(gcstats::STAT_ARENA_RELOCATED);
+        chunk->releaseArena(aheader);
+    }
+
+    {
+        AutoLockGC lock(rt);
+        ExpireChunksAndArenas(rt, true);
+    }
+
+    for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next())
+        zone->setGCLastBytes(zone->gcBytes, GC_SHRINK);
+}
+
 namespace {
 
 /* ...while this class is to be used only for garbage collection. */
@@ -4644,7 +5066,7 @@ IncrementalCollectSlice(JSRuntime *rt,
          * This runs to completion, but we don't continue if the budget is
          * now exhasted.
          */
-        BeginSweepPhase(rt, lastGC);
+        BeginSweepPhase(rt, gckind, lastGC);
         if (sliceBudget.isOverBudget())
             break;
 
@@ -4668,6 +5090,12 @@ IncrementalCollectSlice(JSRuntime *rt,
         if (rt->gcSweepOnBackgroundThread)
             rt->gcHelperThread.startBackgroundSweep(gckind == GC_SHRINK);
 
+        if (rt->gcIsCompacting) {
+            if (rt->gcIsFull)
+                Compact(rt);
+            rt->gcIsCompacting = false;
+        }
+
         rt->gcIncrementalState = NO_INCREMENTAL;
         break;
       }
@@ -5057,6 +5485,12 @@ js::gc::FinishBackgroundFinalize(JSRuntime *rt)
     rt->gcHelperThread.waitBackgroundSweepEnd();
 }
 
+void
+js::gc::FinishBackgroundFinalize(Zone *zone, AllocKind kind)
+{
+    zone->runtimeFromMainThread()->gcHelperThread.waitBackgroundFinalize(zone, kind);
+}
+
 AutoFinishGC::AutoFinishGC(JSRuntime *rt)
 {
     if (JS::IsIncrementalGCInProgress(rt)) {
@@ -11,6 +11,7 @@
 
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/PodOperations.h"
 
 #include "jslock.h"
 #include "jsobj.h"
@@ -56,6 +57,8 @@ namespace jit {
 
 namespace gc {
 
+class ParallelMarker;
+
 enum State {
     NO_INCREMENTAL,
     MARK_ROOTS,
@@ -198,8 +201,8 @@ IsBackgroundFinalized(AllocKind kind)
         true,      /* FINALIZE_OBJECT12_BACKGROUND */
         false,     /* FINALIZE_OBJECT16 */
         true,      /* FINALIZE_OBJECT16_BACKGROUND */
-        false,     /* FINALIZE_SCRIPT */
-        false,     /* FINALIZE_LAZY_SCRIPT */
+        true,      /* FINALIZE_SCRIPT */
+        true,      /* FINALIZE_LAZY_SCRIPT */
         true,      /* FINALIZE_SHAPE */
         true,      /* FINALIZE_BASE_SHAPE */
         true,      /* FINALIZE_TYPE_OBJECT */
@@ -409,7 +412,8 @@ class ArenaLists
     /* For each arena kind, a list of arenas remaining to be swept. */
     ArenaHeader *arenaListsToSweep[FINALIZE_LIMIT];
 
-    /* Shape arenas to be swept in the foreground. */
+    /* Script and shape arenas to be swept in the foreground. */
+    ArenaHeader *gcScriptArenasToSweep;
     ArenaHeader *gcShapeArenasToSweep;
 
   public:
@@ -420,6 +424,7 @@ class ArenaLists
             backgroundFinalizeState[i] = BFS_DONE;
         for (size_t i = 0; i != FINALIZE_LIMIT; ++i)
             arenaListsToSweep[i] = nullptr;
+        gcScriptArenasToSweep = nullptr;
         gcShapeArenasToSweep = nullptr;
     }
 
@@ -608,6 +613,14 @@ class ArenaLists
     bool foregroundFinalize(FreeOp *fop, AllocKind thingKind, SliceBudget &sliceBudget);
     static void backgroundFinalize(FreeOp *fop, ArenaHeader *listHead, bool onBackgroundThread);
 
+    /*
+     * Move objects out of the sparsely used arenas of the relocatable kinds
+     * and into free cells of the other arenas of the same kind. The emptied
+     * arenas are removed from the lists and prepended to |relocated|, which is
+     * returned.
+     */
+    ArenaHeader *relocateArenas(ArenaHeader *relocated);
+
   private:
     inline void finalizeNow(FreeOp *fop, AllocKind thingKind);
     inline void queueForForegroundSweep(FreeOp *fop, AllocKind thingKind);
@@ -618,6 +631,8 @@ class ArenaLists
 
     inline void normalizeBackgroundFinalizeState(AllocKind thingKind);
 
+    ArenaHeader *relocateArenas(AllocKind thingKind, ArenaHeader *relocated);
+
     friend class js::Nursery;
 };
 
@@ -853,6 +868,12 @@ class GCHelperThread {
     /* Must be called without the GC lock taken. */
     void waitBackgroundSweepOrAllocEnd();
 
+    /*
+     * Wait only until the |kind| things of |zone| are finalized, rather than
+     * for the whole sweep. Must be called without the GC lock taken.
+     */
+    void waitBackgroundFinalize(JS::Zone *zone, gc::AllocKind kind);
+
     /* Must be called with the GC lock taken. */
     inline void startBackgroundAllocationIfIdle();
 
@@ -1011,6 +1032,17 @@ struct MarkStack {
         return true;
     }
 
+    bool pushRange(const T *begin, const T *end) {
+        size_t count = end - begin;
+        while (size_t(end_ - tos_) < count) {
+            if (!enlarge())
+                return false;
+        }
+        mozilla::PodCopy(tos_, begin, count);
+        tos_ += count;
+        return true;
+    }
+
     bool isEmpty() const {
         return tos_ == stack_;
     }
@@ -1103,6 +1135,14 @@ struct GCMarker : public JSTracer {
         JS_STATIC_ASSERT(StackTagMask <= gc::CellMask);
     }
 
+    /* The number of stack words taken by the item whose top word is |word|. */
+    static size_t stackItemLength(uintptr_t word) {
+        uintptr_t tag = word & StackTagMask;
+        return (tag == ValueArrayTag || tag == SavedValueArrayTag) ? 3 : 1;
+    }
+
+    friend class gc::ParallelMarker;
+
   public:
     explicit GCMarker(JSRuntime *rt);
     bool init(JSGCMode gcMode);
@@ -1163,6 +1203,26 @@ struct GCMarker : public JSTracer {
 
     bool drainMarkStack(SliceBudget &budget);
 
+    /*
+     * While a parallel marking slice runs (see gc/ParallelMarking.h), the
+     * runtime's marker and the helper marker of each worker thread drain their
+     * own stacks, sharing work through their ParallelMarker.
+     */
+    bool isMarkingInParallel() const {
+        return !!parallelMarker;
+    }
+
+    bool isParallelHelper() const {
+        return parallelHelper;
+    }
+
+#ifdef JS_THREADSAFE
+    void drainMarkStackInParallel(SliceBudget &budget);
+
+    /* Have the main thread trace the children of |thing| for this helper. */
+    void deferToMainThread(gc::Cell *thing, JSGCTraceKind kind);
+#endif
+
     /*
      * Gray marking must be done after all black marking is complete. However,
      * we do not have write barriers on XPConnect roots. Therefore, XPConnect
@@ -1193,6 +1253,8 @@ struct GCMarker : public JSTracer {
     void checkZone(void *p) {}
 #endif
 
+    void delayMarkingCell(const gc::Cell *cell);
+
     void pushTaggedPtr(StackTag tag, void *ptr) {
         checkZone(ptr);
         uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
@@ -1246,6 +1308,12 @@ struct GCMarker : public JSTracer {
     };
 
     GrayBufferState grayBufferState;
+
+    /* The parallel marking slice this marker is taking part in, if any. */
+    gc::ParallelMarker *parallelMarker;
+
+    /* Whether this marker belongs to a worker thread rather than the runtime. */
+    bool parallelHelper;
 };
 
 void
@@ -1336,6 +1404,10 @@ SetFullCompartmentChecks(JSContext *cx, bool enabled);
 void
 FinishBackgroundFinalize(JSRuntime *rt);
 
+/* Wait for the background thread to finish finalizing |kind| things in |zone|. */
+void
+FinishBackgroundFinalize(JS::Zone *zone, AllocKind kind);
+
 /*
  * Merge all contents of source into target. This can only be used if source is
  * the only compartment in its zone.
@@ -1343,6 +1415,66 @@ FinishBackgroundFinalize(JSRuntime *rt);
 void
 MergeCompartments(JSCompartment *source, JSCompartment *target);
 
+/*
+ * When a compacting GC moves an object, its old cell is overwritten with a
+ * MovedCellOverlay recording the new location. The overlays are valid until
+ * the emptied arenas are released at the end of the compacting phase.
+ */
+class MovedCellOverlay
+{
+    /* The low bit is set so this should never equal a shape pointer. */
+    static const uintptr_t Moved = uintptr_t(0xbad0bad3);
+
+    /* Set to Moved when moved. */
+    uintptr_t magic_;
+
+    /* The location |this| was moved to. */
+    Cell *newLocation_;
+
+  public:
+    static MovedCellOverlay *fromCell(Cell *cell) {
+        JS_ASSERT(cell->isTenured());
+        return reinterpret_cast<MovedCellOverlay *>(cell);
+    }
+
+    bool isForwarded() const {
+        return magic_ == Moved;
+    }
+
+    Cell *forwardingAddress() const {
+        JS_ASSERT(isForwarded());
+        return newLocation_;
+    }
+
+    void forwardTo(Cell *cell) {
+        JS_ASSERT(!isForwarded());
+        magic_ = Moved;
+        newLocation_ = cell;
+    }
+};
+
+/* These may only be used on objects, during the compacting phase of a GC. */
+template <typename T>
+inline bool
+IsForwarded(T *t)
+{
+    return MovedCellOverlay::fromCell(t)->isForwarded();
+}
+
+template <typename T>
+inline T *
+Forwarded(T *t)
+{
+    return static_cast<T *>(MovedCellOverlay::fromCell(t)->forwardingAddress());
+}
+
+template <typename T>
+inline T *
+MaybeForwarded(T *t)
+{
+    return t && IsForwarded(t) ? Forwarded(t) : t;
+}
+
 const int ZealPokeValue = 1;
 const int ZealAllocValue = 2;
 const int ZealFrameGCValue = 3;
@@ -278,7 +278,7 @@ class CellIter : public CellIterImpl
         if (IsBackgroundFinalized(kind) &&
             zone->allocator.arenas.needBackgroundFinalizeWait(kind))
         {
-            gc::FinishBackgroundFinalize(zone->runtimeFromMainThread());
+            gc::FinishBackgroundFinalize(zone, kind);
         }
 
 #ifdef JSGC_GENERATIONAL
@@ -4272,6 +4272,19 @@ TypeObject::sweep(FreeOp *fop)
     }
 }
 
+void
+TypeCompartment::fixupAfterMovingGC()
+{
+    if (!arrayTypeTable)
+        return;
+
+    for (ArrayTypeTable::Enum e(*arrayTypeTable); !e.empty(); e.popFront()) {
+        const ArrayTableKey &key = e.front().key();
+        if (key.proto && IsForwarded(key.proto))
+            e.rekeyFront(ArrayTableKey(key.type, Forwarded(key.proto)));
+    }
+}
+
 void
 TypeCompartment::sweep(FreeOp *fop)
 {
@@ -4379,6 +4392,29 @@ JSCompartment::sweepNewTypeObjectTable(TypeObjectWithNewScriptSet &table)
     }
 }
 
+void
+JSCompartment::fixupNewTypeObjectTable(TypeObjectWithNewScriptSet &table)
+{
+    if (!table.initialized())
+        return;
+
+    for (TypeObjectWithNewScriptSet::Enum e(table); !e.empty(); e.popFront()) {
+        TypeObjectWithNewScriptEntry entry = e.front();
+        TypeObject *type = *entry.object.unsafeGet();
+
+        TaggedProto proto = type->proto();
+        if (proto.isObject() && IsForwarded(proto.toObject()))
+            proto = TaggedProto(Forwarded(proto.toObject()));
+        JSFunction *newFunction = MaybeForwarded(entry.newFunction);
+
+        if (proto.raw() != type->proto().raw() || newFunction != entry.newFunction) {
+            entry.newFunction = newFunction;
+            TypeObjectWithNewScriptSet::Lookup lookup(type->clasp(), proto, newFunction);
+            e.rekeyFront(lookup, entry);
+        }
+    }
+}
+
 TypeCompartment::~TypeCompartment()
 {
     js_delete(arrayTypeTable);
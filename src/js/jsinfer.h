@@ -957,6 +957,14 @@ struct TypeObject : gc::BarrieredCell<TypeObject>
     /* Flags for this object. */
     TypeObjectFlags flags_;
 
+    /*
+     * Number of objects of this type allocated in the nursery since a minor
+     * GC last checked how many of them it had to tenure. This is bumped by
+     * the allocation sites which can pretenure their objects, including
+     * inline allocations in Ion code.
+     */
+    uint32_t nurseryAllocCount_;
+
     /*
      * This field allows various special classes of objects to attach
      * additional information to a type object:
@@ -1063,10 +1071,6 @@ struct TypeObject : gc::BarrieredCell<TypeObject>
     /* If this is an interpreted function, the function object. */
     HeapPtrFunction interpretedFunction;
 
-#if JS_BITS_PER_WORD == 32
-    uint32_t padding;
-#endif
-
     inline TypeObject(const Class *clasp, TaggedProto proto, TypeObjectFlags initialFlags);
 
     bool hasAnyFlags(TypeObjectFlags flags) {
@@ -1109,6 +1113,21 @@ struct TypeObject : gc::BarrieredCell<TypeObject>
         setFlags(cx, OBJECT_FLAG_PRE_TENURE);
     }
 
+    void noteNurseryAllocation() {
+        nurseryAllocCount_++;
+    }
+
+    uint32_t *addressOfNurseryAllocCount() {
+        return &nurseryAllocCount_;
+    }
+
+    /* Get the nursery allocation count and start counting afresh. */
+    uint32_t takeNurseryAllocCount() {
+        uint32_t count = nurseryAllocCount_;
+        nurseryAllocCount_ = 0;
+        return count;
+    }
+
     /*
      * Get or create a property of this object. Only call this for properties which
      * a script accesses explicitly.
@@ -1555,6 +1574,7 @@ struct TypeCompartment
     void markSetsUnknown(JSContext *cx, TypeObject *obj);
 
     void sweep(FreeOp *fop);
+    void fixupAfterMovingGC();
     void finalizeObjects();
 
     void addSizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf,
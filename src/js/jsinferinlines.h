@@ -693,6 +693,41 @@ TypeScript::InitObject(JSContext *cx, JSScript *script, jsbytecode *pc, JSProtoK
     return cx->compartment()->types.addAllocationSiteTypeObject(cx, key);
 }
 
+/*
+ * Get the kind of object to allocate for the initializer at pc. Objects from
+ * sites whose objects tend to survive minor GCs are allocated tenured; other
+ * nursery allocations are counted towards the site's survival rate.
+ */
+static inline NewObjectKind
+InitializerObjectKind(JSContext *cx, JSScript *script, jsbytecode *pc, const Class *clasp)
+{
+    JSProtoKey key = JSCLASS_CACHED_PROTO_KEY(clasp);
+    NewObjectKind kind = UseNewTypeForInitializer(script, pc, key);
+    if (kind == SingletonObject || !cx->typeInferenceEnabled() || !script->compileAndGo())
+        return kind;
+
+    AllocationSiteTable *table = cx->compartment()->types.allocationSiteTable;
+    uint32_t offset = script->pcToOffset(pc);
+    if (!table || offset >= AllocationSiteKey::OFFSET_LIMIT)
+        return kind;
+
+    AllocationSiteKey site;
+    site.script = script;
+    site.offset = offset;
+    site.kind = key;
+
+    /* The type is created along with the first object allocated here. */
+    AllocationSiteTable::Ptr p = table->lookup(site);
+    if (!p)
+        return kind;
+
+    TypeObject *type = p->value();
+    if (type->shouldPreTenure())
+        return TenuredObject;
+    type->noteNurseryAllocation();
+    return kind;
+}
+
 /* Set the type to use for obj according to the site it was allocated at. */
 static inline bool
 SetInitializerObjectType(JSContext *cx, HandleScript script, jsbytecode *pc, HandleObject obj, NewObjectKind kind)
@@ -702,7 +737,8 @@ SetInitializerObjectType(JSContext *cx, HandleScript script, jsbytecode *pc, Han
 
     JSProtoKey key = JSCLASS_CACHED_PROTO_KEY(obj->getClass());
     JS_ASSERT(key != JSProto_Null);
-    JS_ASSERT(kind == UseNewTypeForInitializer(script, pc, key));
+    JS_ASSERT((kind == SingletonObject) ==
+              (UseNewTypeForInitializer(script, pc, key) == SingletonObject));
 
     if (kind == SingletonObject) {
         JS_ASSERT(obj->hasSingletonType());
@@ -48,6 +48,7 @@
 #include "vm/ProxyObject.h"
 #include "vm/RegExpStaticsObject.h"
 #include "vm/Shape.h"
+#include "vm/Xdr.h"
 
 #include "jsatominlines.h"
 #include "jsboolinlines.h"
@@ -1521,6 +1522,13 @@ static inline JSObject *
 CreateThisForFunctionWithType(JSContext *cx, HandleTypeObject type, JSObject *parent,
                               NewObjectKind newKind)
 {
+    if (newKind == GenericObject) {
+        if (type->shouldPreTenure())
+            newKind = TenuredObject;
+        else
+            type->noteNurseryAllocation();
+    }
+
     if (type->hasNewScript()) {
         /*
          * Make an object with the type's associated finalize kind and shape,
@@ -1838,6 +1846,141 @@ js::CloneObjectLiteral(JSContext *cx, HandleObject parent, HandleObject srcObj)
     return NewReshapedObject(cx, typeObj, parent, kind, shape);
 }
 
+template<XDRMode mode>
+bool
+js::XDRObjectLiteral(XDRState<mode> *xdr, MutableHandleObject obj)
+{
+    /* NB: Keep this in sync with ParseNode::getConstantValue and EmitObject. */
+
+    JSContext *cx = xdr->cx();
+
+    uint32_t isArray = 0;
+    if (mode == XDR_ENCODE) {
+        JS_ASSERT(obj->is<ArrayObject>() || obj->getClass() == &JSObject::class_);
+        isArray = obj->is<ArrayObject>() ? 1 : 0;
+    }
+    if (!xdr->codeUint32(&isArray))
+        return false;
+
+    if (isArray) {
+        uint32_t length;
+        if (mode == XDR_ENCODE) {
+            length = obj->as<ArrayObject>().length();
+            JS_ASSERT(obj->getDenseInitializedLength() == length);
+        }
+        if (!xdr->codeUint32(&length))
+            return false;
+
+        if (mode == XDR_DECODE) {
+            obj.set(NewDenseAllocatedArray(cx, length, nullptr, TenuredObject));
+            if (!obj)
+                return false;
+        }
+
+        RootedValue value(cx);
+        for (uint32_t i = 0; i < length; i++) {
+            if (mode == XDR_ENCODE)
+                value = obj->getDenseElement(i);
+            if (!XDRScriptConst(xdr, &value))
+                return false;
+            if (mode == XDR_DECODE) {
+                RootedId id(cx, INT_TO_JSID(i));
+                if (!JSObject::defineGeneric(cx, obj, id, value, nullptr, nullptr,
+                                             JSPROP_ENUMERATE))
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (mode == XDR_DECODE)
+            FixArrayType(cx, obj);
+        return true;
+    }
+
+    /*
+     * Plain objects keep their fixed slot count, so that JSOP_NEWOBJECT
+     * templates allocate the same object size after decoding. Elements are
+     * coded in index order, followed by the named properties in slot order.
+     */
+    uint32_t kind, ndense, nslots;
+    if (mode == XDR_ENCODE) {
+        JS_ASSERT(!obj->inDictionaryMode());
+        kind = uint32_t(GetGCObjectKind(obj->numFixedSlots()));
+        ndense = obj->getDenseInitializedLength();
+        nslots = obj->slotSpan();
+    }
+    if (!xdr->codeUint32(&kind) || !xdr->codeUint32(&ndense) || !xdr->codeUint32(&nslots))
+        return false;
+
+    if (mode == XDR_DECODE) {
+        JS_ASSERT(kind <= uint32_t(FINALIZE_OBJECT_LAST));
+        obj.set(NewBuiltinClassInstance(cx, &JSObject::class_, AllocKind(kind), TenuredObject));
+        if (!obj)
+            return false;
+    }
+
+    RootedValue value(cx);
+    for (uint32_t i = 0; i < ndense; i++) {
+        if (mode == XDR_ENCODE)
+            value = obj->getDenseElement(i);
+        if (!XDRScriptConst(xdr, &value))
+            return false;
+        if (mode == XDR_DECODE && !value.isMagic(JS_ELEMENTS_HOLE)) {
+            if (!JSObject::defineElement(cx, obj, i, value, nullptr, nullptr, JSPROP_ENUMERATE))
+                return false;
+        }
+    }
+
+    AutoIdVector ids(cx);
+    if (mode == XDR_ENCODE) {
+        if (!ids.resize(nslots))
+            return false;
+        for (Shape *shape = obj->lastProperty(); !shape->isEmptyShape(); shape = shape->previous()) {
+            JS_ASSERT(shape->hasDefaultGetter() && shape->hasDefaultSetter());
+            JS_ASSERT(shape->enumerable() && shape->writable());
+            ids[shape->slot()] = shape->propid();
+        }
+    }
+
+    RootedId id(cx);
+    for (uint32_t i = 0; i < nslots; i++) {
+        uint32_t idIsIndex;
+        RootedAtom atom(cx);
+        uint32_t index = 0;
+        if (mode == XDR_ENCODE) {
+            id = ids[i];
+            idIsIndex = JSID_IS_INT(id) ? 1 : 0;
+            if (idIsIndex)
+                index = uint32_t(JSID_TO_INT(id));
+            else
+                atom = JSID_TO_ATOM(id);
+            value = obj->getSlot(i);
+        }
+        if (!xdr->codeUint32(&idIsIndex))
+            return false;
+        if (idIsIndex ? !xdr->codeUint32(&index) : !XDRAtom(xdr, &atom))
+            return false;
+        if (!XDRScriptConst(xdr, &value))
+            return false;
+        if (mode == XDR_DECODE) {
+            id = idIsIndex ? INT_TO_JSID(int32_t(index)) : AtomToId(atom);
+            if (!JSObject::defineGeneric(cx, obj, id, value, nullptr, nullptr, JSPROP_ENUMERATE))
+                return false;
+        }
+    }
+
+    if (mode == XDR_DECODE)
+        FixObjectType(cx, obj);
+    return true;
+}
+
+template bool
+js::XDRObjectLiteral(XDRState<XDR_ENCODE> *, MutableHandleObject);
+
+template bool
+js::XDRObjectLiteral(XDRState<XDR_DECODE> *, MutableHandleObject);
+
 struct JSObject::TradeGutsReserved {
     Vector<Value> avals;
     Vector<Value> bvals;
@@ -5753,7 +5896,8 @@ JSObject::addSizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::Objects
 #else
             sizes->mallocHeapElementsAsmJS += mallocSizeOf(elements);
 #endif
-        } else {
+        } else if (!elements->isSharedArrayBuffer()) {
+            // Shared buffers' memory is not owned by any one runtime.
             sizes->mallocHeapElementsNonAsmJS += mallocSizeOf(elements);
         }
     }
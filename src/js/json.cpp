@@ -7,6 +7,13 @@
 #include "json.h"
 
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/MathAlgorithms.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_JSON_QUOTE_SSE2
+# include <emmintrin.h>
+#endif
 
 #include "jsarray.h"
 #include "jsatom.h"
@@ -29,6 +36,7 @@ using namespace js;
 using namespace js::gc;
 using namespace js::types;
 
+using mozilla::CountTrailingZeroes32;
 using mozilla::IsFinite;
 using mozilla::Maybe;
 
@@ -54,6 +62,44 @@ static inline bool IsQuoteSpecialCharacter(jschar c)
     return c == '"' || c == '\\' || c < ' ';
 }
 
+/*
+ * Return the index of the first character of buf[start, len) which Quote must
+ * escape, or len if there is none. Most strings need no escapes at all, so
+ * with SSE2 eight characters are tested at a time.
+ */
+static inline size_t
+FindQuoteSpecialCharacter(const jschar *buf, size_t start, size_t len)
+{
+    size_t i = start;
+
+#ifdef JS_JSON_QUOTE_SSE2
+    const size_t lanes = sizeof(__m128i) / sizeof(jschar);
+    const __m128i quote = _mm_set1_epi16('"');
+    const __m128i backslash = _mm_set1_epi16('\\');
+    const __m128i lastControl = _mm_set1_epi16(' ' - 1);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + lanes <= len; i += lanes) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + i));
+
+        /* c < ' ' is tested as saturating c - (' ' - 1) == 0, which is unsigned. */
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(block, quote),
+                                                    _mm_cmpeq_epi16(block, backslash)),
+                                       _mm_cmpeq_epi16(_mm_subs_epu16(block, lastControl), zero));
+
+        /* Two mask bits per jschar lane. */
+        uint32_t mask = uint32_t(_mm_movemask_epi8(special));
+        if (mask)
+            return i + CountTrailingZeroes32(mask) / 2;
+    }
+#endif
+
+    for (; i < len; i++) {
+        if (IsQuoteSpecialCharacter(buf[i]))
+            break;
+    }
+    return i;
+}
+
 /* ES5 15.12.3 Quote. */
 static bool
 Quote(JSContext *cx, StringBuffer &sb, JSString *str)
@@ -72,10 +118,7 @@ Quote(JSContext *cx, StringBuffer &sb, JSString *str)
     for (size_t i = 0; i < len; ++i) {
         /* Batch-append maximal character sequences containing no escapes. */
         size_t mark = i;
-        do {
-            if (IsQuoteSpecialCharacter(buf[i]))
-                break;
-        } while (++i < len);
+        i = FindQuoteSpecialCharacter(buf, i, len);
         if (i > mark) {
             if (!sb.append(&buf[mark], i - mark))
                 return false;
@@ -116,6 +159,30 @@ Quote(JSContext *cx, StringBuffer &sb, JSString *str)
 
 namespace {
 
+/*
+ * The members JO writes for a plain object, in enumeration order: each own
+ * enumerable data property's id, slot and quoted name followed by ':'. The
+ * names are stored in StringifyContext::keyChars.
+ */
+struct ShapeMember
+{
+    jsid id;
+    uint32_t slot;
+    size_t keyStart;
+    size_t keyLength;
+};
+
+/*
+ * The range of StringifyContext::shapeMembers describing one shape, or
+ * !usable if objects with that shape must be stringified the generic way.
+ */
+struct ShapeMembers
+{
+    bool usable;
+    size_t start;
+    size_t length;
+};
+
 class StringifyContext
 {
   public:
@@ -125,18 +192,138 @@ class StringifyContext
         gap(gap),
         replacer(cx, replacer),
         propertyList(propertyList),
-        depth(0)
+        depth(0),
+        shapeCache(cx),
+        shapeMembers(cx),
+        keyChars(cx),
+        gcNumber(cx->runtime()->gcNumber)
     {}
 
+    bool init() {
+        return shapeCache.init(16);
+    }
+
+    bool lookupShapeMembers(JSContext *cx, Shape *shape, ShapeMembers *members);
+
     StringBuffer &sb;
     const StringBuffer &gap;
     RootedObject replacer;
     const AutoIdVector &propertyList;
     uint32_t depth;
+
+    /*
+     * Objects in a document usually share a handful of shapes, so JO caches
+     * the members of each shape it sees. Shapes freed by a GC may have their
+     * addresses reused, so the cache is emptied whenever a GC has happened;
+     * the member and name storage is kept, as callers may still be reading
+     * entries whose shapes they hold.
+     */
+    typedef HashMap<Shape *, ShapeMembers, DefaultHasher<Shape *> > ShapeCache;
+    ShapeCache shapeCache;
+    Vector<ShapeMember> shapeMembers;
+    StringBuffer keyChars;
+    uint64_t gcNumber;
 };
 
 } /* anonymous namespace */
 
+/*
+ * Whether looking up toJSON on |obj| is sure to find nothing, without running
+ * any hooks. This holds when every object on its prototype chain is native,
+ * has no lookup or resolve hooks and lacks a toJSON property.
+ */
+static bool
+LacksToJSON(JSContext *cx, JSObject *obj)
+{
+    jsid id = NameToId(cx->names().toJSON);
+    do {
+        if (!obj->isNative() || obj->getOps()->lookupGeneric ||
+            obj->getClass()->resolve != JS_ResolveStub)
+        {
+            return false;
+        }
+        if (obj->nativeLookup(cx, id))
+            return false;
+        obj = obj->getProto();
+    } while (obj);
+    return true;
+}
+
+/*
+ * Whether JO may read the members of |obj| from its shape rather than by
+ * enumerating and getting its properties, which give the same result here.
+ */
+static bool
+HasShapeMembers(JSObject *obj)
+{
+#ifdef JS_MORE_DETERMINISTIC
+    /* Enumeration sorts property names in these builds. */
+    return false;
+#else
+    /*
+     * Dictionary shapes are owned by their object and may be reused after
+     * the object is gone, so they are not cached. Enumeration skips a
+     * __proto__ property on objects without a prototype.
+     */
+    return obj->getClass() == &JSObject::class_ &&
+           !obj->inDictionaryMode() &&
+           !obj->isIndexed() &&
+           obj->getDenseInitializedLength() == 0 &&
+           obj->getTaggedProto().isObject();
+#endif
+}
+
+bool
+StringifyContext::lookupShapeMembers(JSContext *cx, Shape *shape, ShapeMembers *members)
+{
+    if (gcNumber != cx->runtime()->gcNumber) {
+        shapeCache.clear();
+        gcNumber = cx->runtime()->gcNumber;
+    }
+
+    ShapeCache::AddPtr p = shapeCache.lookupForAdd(shape);
+    if (p) {
+        *members = p->value();
+        return true;
+    }
+
+    /* Shapes list properties from the newest, so collect and then reverse. */
+    members->usable = true;
+    members->start = shapeMembers.length();
+    for (Shape::Range<NoGC> r(shape); !r.empty(); r.popFront()) {
+        Shape &prop = r.front();
+        if (!prop.enumerable())
+            continue;
+        if (!prop.hasSlot() || !prop.hasDefaultGetter() || !JSID_IS_ATOM(prop.propid())) {
+            members->usable = false;
+            break;
+        }
+        ShapeMember member;
+        member.id = prop.propid();
+        member.slot = prop.slot();
+        if (!shapeMembers.append(member))
+            return false;
+    }
+
+    if (members->usable) {
+        members->length = shapeMembers.length() - members->start;
+        ::Reverse(shapeMembers.begin() + members->start, shapeMembers.end());
+
+        for (size_t i = members->start; i < shapeMembers.length(); i++) {
+            ShapeMember &member = shapeMembers[i];
+            member.keyStart = keyChars.length();
+            if (!Quote(cx, keyChars, JSID_TO_ATOM(member.id)) || !keyChars.append(':'))
+                return false;
+            member.keyLength = keyChars.length() - member.keyStart;
+        }
+    } else {
+        shapeMembers.shrinkBy(shapeMembers.length() - members->start);
+        members->start = members->length = 0;
+    }
+
+    return shapeCache.add(p, shape, *members);
+}
+
 static bool Str(JSContext *cx, const Value &v, StringifyContext *scx);
 
 static bool
@@ -189,7 +376,7 @@ PreprocessValue(JSContext *cx, HandleObject holder, KeyType key, MutableHandleVa
     RootedString keyStr(cx);
 
     /* Step 2. */
-    if (vp.isObject()) {
+    if (vp.isObject() && !LacksToJSON(cx, &vp.toObject())) {
         RootedValue toJSON(cx);
         RootedObject obj(cx, &vp.toObject());
         if (!JSObject::getProperty(cx, obj, obj, cx->names().toJSON, &toJSON))
@@ -270,6 +457,56 @@ IsFilteredValue(const Value &v)
     return v.isUndefined() || js_IsCallable(v);
 }
 
+/*
+ * ES5 15.12.3 JO steps 8-10 and 12-13 for a plain object whose members have
+ * been read from |shape|. Values are read straight from their slots while
+ * the object keeps that shape; if a toJSON call changes it, the rest are got
+ * by id, as the generic path would.
+ */
+static bool
+JOShapeMembers(JSContext *cx, HandleObject obj, HandleShape shape, const ShapeMembers &members,
+               StringifyContext *scx)
+{
+    bool wroteMember = false;
+    RootedId id(cx);
+    RootedValue outputValue(cx);
+    for (size_t i = 0; i < members.length; i++) {
+        /* Copied, as stringifying values may grow scx->shapeMembers. */
+        ShapeMember member = scx->shapeMembers[members.start + i];
+        id = member.id;
+        if (obj->lastProperty() == shape) {
+            outputValue = obj->getSlot(member.slot);
+        } else {
+            if (!JSObject::getGeneric(cx, obj, obj, id, &outputValue))
+                return false;
+        }
+        if (!PreprocessValue(cx, obj, HandleId(id), &outputValue, scx))
+            return false;
+        if (IsFilteredValue(outputValue))
+            continue;
+
+        if (wroteMember && !scx->sb.append(','))
+            return false;
+        wroteMember = true;
+
+        if (!WriteIndent(cx, scx, scx->depth))
+            return false;
+
+        const jschar *key = scx->keyChars.begin() + member.keyStart;
+        if (!scx->sb.append(key, member.keyLength) ||
+            !(scx->gap.empty() || scx->sb.append(' ')) ||
+            !Str(cx, outputValue, scx))
+        {
+            return false;
+        }
+    }
+
+    if (wroteMember && !WriteIndent(cx, scx, scx->depth - 1))
+        return false;
+
+    return scx->sb.append('}');
+}
+
 /* ES5 15.12.3 JO. */
 static bool
 JO(JSContext *cx, HandleObject obj, StringifyContext *scx)
@@ -296,6 +533,16 @@ JO(JSContext *cx, HandleObject obj, StringifyContext *scx)
     if (!scx->sb.append('{'))
         return false;
 
+    /* Without a replacer, plain objects can be written from their shape. */
+    if (!scx->replacer && HasShapeMembers(obj)) {
+        RootedShape shape(cx, obj->lastProperty());
+        ShapeMembers members;
+        if (!scx->lookupShapeMembers(cx, shape, &members))
+            return false;
+        if (members.usable)
+            return JOShapeMembers(cx, obj, shape, members, scx);
+    }
+
     /* Steps 5-7. */
     Maybe<AutoIdVector> ids;
     const AutoIdVector *props;
@@ -406,8 +653,15 @@ JA(JSContext *cx, HandleObject obj, StringifyContext *scx)
              * and the replacer and maybe unboxing, and interpreting some
              * values as |null| in separate steps.
              */
-            if (!JSObject::getElement(cx, obj, obj, i, &outputValue))
-                return false;
+            /* Dense elements of arrays are plain data properties. */
+            if (obj->is<ArrayObject>() && i < obj->getDenseInitializedLength() &&
+                !obj->getDenseElement(i).isMagic(JS_ELEMENTS_HOLE))
+            {
+                outputValue = obj->getDenseElement(i);
+            } else {
+                if (!JSObject::getElement(cx, obj, obj, i, &outputValue))
+                    return false;
+            }
             if (!PreprocessValue(cx, obj, i, &outputValue, scx))
                 return false;
             if (IsFilteredValue(outputValue)) {
@@ -475,11 +729,7 @@ Str(JSContext *cx, const Value &v, StringifyContext *scx)
                 return scx->sb.append("null");
         }
 
-        StringBuffer sb(cx);
-        if (!NumberValueToStringBuffer(cx, v, sb))
-            return false;
-
-        return scx->sb.append(sb.begin(), sb.length());
+        return NumberValueToStringBuffer(cx, v, scx->sb);
     }
 
     /* Step 10. */
@@ -655,6 +905,8 @@ js_Stringify(JSContext *cx, MutableHandleValue vp, JSObject *replacer_, Value sp
 
     /* Step 11. */
     StringifyContext scx(cx, sb, gap, replacer, propertyList);
+    if (!scx.init())
+        return false;
     if (!PreprocessValue(cx, wrapper, HandleId(emptyId), vp, &scx))
         return false;
     if (IsFilteredValue(vp))
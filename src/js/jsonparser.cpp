@@ -15,6 +15,7 @@
 #include "jsnum.h"
 #include "jsprf.h"
 
+#include "js/CharacterEncoding.h"
 #include "vm/StringBuffer.h"
 
 #include "jsobjinlines.h"
@@ -55,6 +56,11 @@ JSONParser::trace(JSTracer *trc)
             }
         }
     }
+
+    for (size_t i = 0; i < objectTemplates.length(); i++) {
+        if (objectTemplates[i])
+            gc::MarkObjectRoot(trc, &objectTemplates[i], "JSONParser object template");
+    }
 }
 
 void
@@ -565,8 +571,86 @@ JSONParser::advanceAfterProperty()
     return token(Error);
 }
 
+/*
+ * Whether |templateObject| has exactly the given properties, in order and each
+ * in the slot given by its position, so that an object with these properties
+ * can take its shape.
+ */
+static bool
+MatchesObjectTemplate(JSObject *templateObject, const IdValuePair *properties, size_t nproperties)
+{
+    if (templateObject->inDictionaryMode() || templateObject->slotSpan() != nproperties)
+        return false;
+
+    Shape *shape = templateObject->lastProperty();
+    for (size_t i = nproperties; i > 0; i--) {
+        if (shape->propid().get() != properties[i - 1].id)
+            return false;
+        JS_ASSERT(shape->slot() == i - 1);
+        shape = shape->previous();
+    }
+    return true;
+}
+
+JSObject *
+JSONParser::createObjectFromTemplate(HandleObject templateObject, PropertyVector &properties)
+{
+    gc::AllocKind allocKind = gc::GetGCObjectKind(properties.length());
+    RootedObject obj(cx, NewBuiltinClassInstance(cx, &JSObject::class_, allocKind));
+    if (!obj)
+        return nullptr;
+
+    RootedShape shape(cx, templateObject->lastProperty());
+    if (!JSObject::setLastProperty(cx, obj, shape))
+        return nullptr;
+
+    for (size_t i = 0; i < properties.length(); i++)
+        obj->setSlot(i, properties[i].value);
+
+    /*
+     * The template's type already includes the types of the template's own
+     * values, so only values of other types need to be added to it.
+     */
+    if (cx->typeInferenceEnabled()) {
+        obj->setType(templateObject->type());
+        for (size_t i = 0; i < properties.length(); i++) {
+            const Value &value = properties[i].value;
+            if (types::GetValueType(value) != types::GetValueType(templateObject->getSlot(i)))
+                types::AddTypePropertyId(cx, obj, properties[i].id, value);
+        }
+    }
+
+    return obj;
+}
+
 JSObject *
 JSONParser::createFinishedObject(PropertyVector &properties)
+{
+    /*
+     * Objects at the same depth, such as the records of an array, usually
+     * have the same keys. Reuse the previous object's shape if they match.
+     */
+    JS_ASSERT(&properties == &stack.back().properties());
+    size_t depth = stack.length() - 1;
+    if (depth < objectTemplates.length() && objectTemplates[depth] &&
+        MatchesObjectTemplate(objectTemplates[depth], properties.begin(), properties.length()))
+    {
+        RootedObject templateObject(cx, objectTemplates[depth]);
+        return createObjectFromTemplate(templateObject, properties);
+    }
+
+    JSObject *obj = createObjectWithoutTemplate(properties);
+    if (!obj)
+        return nullptr;
+
+    if (depth >= objectTemplates.length() && !objectTemplates.resize(depth + 1))
+        return nullptr;
+    objectTemplates[depth] = obj;
+    return obj;
+}
+
+JSObject *
+JSONParser::createObjectWithoutTemplate(PropertyVector &properties)
 {
     /*
      * Look for an existing cached type and shape for objects with this set of
@@ -819,3 +903,204 @@ JSONParser::parse(MutableHandleValue vp)
     vp.set(value);
     return true;
 }
+
+bool
+JSONStreamParser::error(JSContext *cx, const char *msg)
+{
+    const size_t MaxWidth = sizeof("4294967295");
+    char columnNumber[MaxWidth];
+    JS_snprintf(columnNumber, sizeof columnNumber, "%lu", column);
+    char lineNumber[MaxWidth];
+    JS_snprintf(lineNumber, sizeof lineNumber, "%lu", line);
+
+    JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_JSON_BAD_PARSE,
+                         msg, lineNumber, columnNumber);
+#ifdef DEBUG
+    failed = true;
+#endif
+    return false;
+}
+
+bool
+JSONStreamParser::scanOutsideValue(JSContext *cx, char c, bool *startsValue)
+{
+    *startsValue = false;
+    if (IsJSONWhitespace(c))
+        return true;
+
+    switch (state) {
+      case BeforeArray:
+        if (c != '[')
+            return error(cx, "expected '[' at start of array stream");
+        state = BeforeFirstElement;
+        return true;
+
+      case BeforeFirstElement:
+        if (c == ']') {
+            state = AfterArray;
+            return true;
+        }
+        break;
+
+      case AfterElement:
+        if (c == ',') {
+            state = BeforeElement;
+            return true;
+        }
+        if (c == ']') {
+            state = AfterArray;
+            return true;
+        }
+        return error(cx, "expected ',' or ']' after array element");
+
+      case AfterArray:
+        return error(cx, "unexpected non-whitespace character after JSON data");
+
+      case BetweenValues:
+      case BeforeElement:
+        break;
+
+      case InValue:
+        MOZ_ASSUME_UNREACHABLE("not outside a value");
+    }
+
+    if (c == ',' || c == ':' || c == ']' || c == '}')
+        return error(cx, "unexpected character");
+
+    *startsValue = true;
+    return true;
+}
+
+bool
+JSONStreamParser::finishValue(JSContext *cx)
+{
+    JS_ASSERT(state == InValue);
+    JS_ASSERT(depth == 0 && !inString);
+
+    size_t length;
+    jschar *chars = JS::UTF8CharsToNewTwoByteCharsZ(cx, JS::UTF8Chars(buffer.begin(), buffer.length()),
+                                                    &length).get();
+    if (!chars) {
+#ifdef DEBUG
+        failed = true;
+#endif
+        return false;
+    }
+
+    RootedValue value(cx);
+    bool ok;
+    {
+        JSONParser parser(cx, JS::StableCharPtr(chars, length), length);
+        ok = parser.parse(&value);
+    }
+    js_free(chars);
+    if (!ok) {
+#ifdef DEBUG
+        failed = true;
+#endif
+        return false;
+    }
+
+    // Keep the buffer's storage, which is then only as large as the largest
+    // value seen so far.
+    buffer.clear();
+    state = mode == Values ? BetweenValues : AfterElement;
+    return callback(cx, value, data);
+}
+
+bool
+JSONStreamParser::feed(JSContext *cx, const char *bytes, size_t length)
+{
+    JS_ASSERT(!failed);
+
+    for (const char *p = bytes; p < bytes + length; p++) {
+        char c = *p;
+
+        // Numbers, true, false and null are only known to be complete once a
+        // character which cannot be part of them arrives.
+        if (state == InValue && depth == 0 && !inString &&
+            (IsJSONWhitespace(c) || c == ',' || c == ']' || c == '}' ||
+             c == '"' || c == '[' || c == '{'))
+        {
+            if (!finishValue(cx))
+                return false;
+        }
+
+        if (state != InValue) {
+            bool startsValue;
+            if (!scanOutsideValue(cx, c, &startsValue))
+                return false;
+            if (startsValue) {
+                JS_ASSERT(buffer.empty());
+                state = InValue;
+                depth = 0;
+                inString = false;
+                escaped = false;
+            }
+        }
+
+        if (state == InValue) {
+            if (inString) {
+                if (escaped)
+                    escaped = false;
+                else if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '[' || c == '{') {
+                depth++;
+            } else if (c == ']' || c == '}') {
+                JS_ASSERT(depth > 0);
+                depth--;
+            }
+
+            if (!buffer.append(c)) {
+                js_ReportOutOfMemory(cx);
+#ifdef DEBUG
+                failed = true;
+#endif
+                return false;
+            }
+        }
+
+        if (c == '\n') {
+            line++;
+            column = 1;
+        } else if ((c & 0xC0) != 0x80) {
+            // Count characters rather than bytes, skipping UTF-8 continuation
+            // bytes.
+            column++;
+        }
+
+        // Strings, arrays and objects end with their closing character.
+        if (state == InValue && depth == 0 && !inString &&
+            (buffer[0] == '"' || buffer[0] == '[' || buffer[0] == '{'))
+        {
+            if (!finishValue(cx))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool
+JSONStreamParser::finish(JSContext *cx)
+{
+    JS_ASSERT(!failed);
+
+    if (state == InValue) {
+        if (depth != 0 || inString)
+            return error(cx, "unexpected end of data");
+        if (!finishValue(cx))
+            return false;
+    }
+
+    if (state == BeforeArray || state == BeforeFirstElement || state == BeforeElement ||
+        state == AfterElement)
+    {
+        return error(cx, "unexpected end of data");
+    }
+    return true;
+}
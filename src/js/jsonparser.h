@@ -99,6 +99,12 @@ class MOZ_STACK_CLASS JSONParser : private AutoGCRooter
     Vector<ElementVector*, 5> freeElements;
     Vector<PropertyVector*, 5> freeProperties;
 
+    // The last object finished at each nesting depth, or nullptr. Objects in
+    // an array usually have the same keys as their predecessor, in which case
+    // the new object takes the previous one's final shape and type and fills
+    // its slots directly, without building its shape one property at a time.
+    Vector<JSObject*, 10> objectTemplates;
+
 #ifdef DEBUG
     Token lastToken;
 #endif
@@ -117,7 +123,8 @@ class MOZ_STACK_CLASS JSONParser : private AutoGCRooter
         errorHandling(errorHandling),
         stack(cx),
         freeElements(cx),
-        freeProperties(cx)
+        freeProperties(cx),
+        objectTemplates(cx)
 #ifdef DEBUG
       , lastToken(Error)
 #endif
@@ -198,6 +205,8 @@ class MOZ_STACK_CLASS JSONParser : private AutoGCRooter
     bool errorReturn();
 
     JSObject *createFinishedObject(PropertyVector &properties);
+    JSObject *createObjectWithoutTemplate(PropertyVector &properties);
+    JSObject *createObjectFromTemplate(HandleObject templateObject, PropertyVector &properties);
     bool finishObject(MutableHandleValue vp, PropertyVector &properties);
     bool finishArray(MutableHandleValue vp, ElementVector &elements);
 
@@ -213,4 +222,86 @@ class MOZ_STACK_CLASS JSONParser : private AutoGCRooter
 
 } /* namespace js */
 
+/*
+ * Incremental parser for a stream of UTF-8 JSON text that arrives in chunks
+ * of arbitrary size. Only the bytes of the top-level value currently being
+ * received are buffered: as soon as a value is complete it is parsed with
+ * JSONParser, handed to the callback and its text dropped. In ArrayElements
+ * mode the input must be a single array, and each of its elements is treated
+ * as a top-level value instead.
+ *
+ * The parser holds no GC things, so it can be kept on the heap across calls.
+ * After any call fails the parser must not be fed again.
+ */
+class JSONStreamParser
+{
+  public:
+    enum Mode { Values, ArrayElements };
+
+    JSONStreamParser(Mode mode, JSONStreamCallback callback, void *data)
+      : mode(mode),
+        callback(callback),
+        data(data),
+        state(mode == Values ? BetweenValues : BeforeArray),
+        depth(0),
+        inString(false),
+        escaped(false),
+        line(1),
+        column(1)
+#ifdef DEBUG
+      , failed(false)
+#endif
+    {}
+
+    /* Consume the next chunk of input, reporting any values it finishes. */
+    bool feed(JSContext *cx, const char *bytes, size_t length);
+
+    /* Signal the end of the input, which must not end inside a value. */
+    bool finish(JSContext *cx);
+
+  private:
+    enum State {
+        // Values mode: between two top-level values.
+        BetweenValues,
+
+        // ArrayElements mode: before the opening '[', before an element,
+        // after an element, and after the closing ']'.
+        BeforeArray,
+        BeforeElement,
+        BeforeFirstElement,
+        AfterElement,
+        AfterArray,
+
+        // Inside a value, whose bytes are accumulated in |buffer|.
+        InValue
+    };
+
+    const Mode mode;
+    const JSONStreamCallback callback;
+    void * const data;
+
+    State state;
+
+    // Bytes of the value being received.
+    js::Vector<char, 0, js::SystemAllocPolicy> buffer;
+
+    // Nesting of arrays and objects inside the value being received, and
+    // whether its next byte is inside a string or follows a backslash there.
+    uint32_t depth;
+    bool inString;
+    bool escaped;
+
+    // Position in the whole stream, for error messages.
+    uint32_t line;
+    uint32_t column;
+
+#ifdef DEBUG
+    bool failed;
+#endif
+
+    bool scanOutsideValue(JSContext *cx, char c, bool *startsValue);
+    bool finishValue(JSContext *cx);
+    bool error(JSContext *cx, const char *msg);
+};
+
 #endif /* jsonparser_h */
@@ -95,6 +95,8 @@ IF_INTL(real,imaginary) (Intl,                  36,     js_InitIntlClass,
 IF_BDATA(real,imaginary)(TypedObject,           37,     js_InitTypedObjectModuleObject,   OCLASP(TypedObjectModule)) \
     imaginary(GeneratorFunction,     38,     js_InitIteratorClasses, dummy) \
 IF_BDATA(real,imaginary)(SIMD,                  39,     js_InitSIMDClass, OCLASP(SIMD)) \
+    real(SharedArrayBuffer,     40,     js_InitSharedArrayBufferClass, &js::SharedArrayBufferObject::protoClass) \
+    real(Atomics,               41,     js_InitAtomicsClass,       OCLASP(Atomics)) \
 
 #define JS_FOR_EACH_PROTOTYPE(macro) JS_FOR_PROTOTYPES(macro,macro)
 
@@ -160,6 +160,7 @@ typedef struct JSStructuredCloneWriter      JSStructuredCloneWriter;
 typedef struct JSTracer                     JSTracer;
 
 class                                       JSFlatString;
+class                                       JSONStreamParser;
 class                                       JSStableString;  // long story
 
 #ifdef JS_THREADSAFE
@@ -281,7 +281,8 @@ js::XDRScriptConst(XDRState<mode> *xdr, MutableHandleValue vp)
     /*
      * A script constant can be an arbitrary primitive value as they are used
      * to implement JSOP_LOOKUPSWITCH. But they cannot be objects, see
-     * bug 407186.
+     * bug 407186. Objects and holes only appear as the contents of object
+     * literals, see XDRObjectLiteral.
      */
     enum ConstTag {
         SCRIPT_INT     = 0,
@@ -290,7 +291,9 @@ js::XDRScriptConst(XDRState<mode> *xdr, MutableHandleValue vp)
         SCRIPT_TRUE    = 3,
         SCRIPT_FALSE   = 4,
         SCRIPT_NULL    = 5,
-        SCRIPT_VOID    = 6
+        SCRIPT_VOID    = 6,
+        SCRIPT_OBJECT  = 7,
+        SCRIPT_HOLE    = 8
     };
 
     uint32_t tag;
@@ -307,6 +310,10 @@ js::XDRScriptConst(XDRState<mode> *xdr, MutableHandleValue vp)
             tag = SCRIPT_FALSE;
         } else if (vp.isNull()) {
             tag = SCRIPT_NULL;
+        } else if (vp.isObject()) {
+            tag = SCRIPT_OBJECT;
+        } else if (vp.isMagic(JS_ELEMENTS_HOLE)) {
+            tag = SCRIPT_HOLE;
         } else {
             JS_ASSERT(vp.isUndefined());
             tag = SCRIPT_VOID;
@@ -363,6 +370,20 @@ js::XDRScriptConst(XDRState<mode> *xdr, MutableHandleValue vp)
         if (mode == XDR_DECODE)
             vp.set(UndefinedValue());
         break;
+      case SCRIPT_OBJECT: {
+        RootedObject obj(cx);
+        if (mode == XDR_ENCODE)
+            obj = &vp.toObject();
+        if (!XDRObjectLiteral(xdr, &obj))
+            return false;
+        if (mode == XDR_DECODE)
+            vp.setObject(*obj);
+        break;
+      }
+      case SCRIPT_HOLE:
+        if (mode == XDR_DECODE)
+            vp.setMagic(JS_ELEMENTS_HOLE);
+        break;
     }
     return true;
 }
@@ -716,22 +737,33 @@ js::XDRScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enc
      */
     for (i = 0; i != nobjects; ++i) {
         HeapPtr<JSObject> *objp = &script->objects()->vector[i];
-        uint32_t isBlock;
+        enum ClassKind { CK_JSFunction, CK_BlockObject, CK_JSObject };
+        uint32_t classk;
         if (mode == XDR_ENCODE) {
             JSObject *obj = *objp;
-            JS_ASSERT(obj->is<JSFunction>() || obj->is<StaticBlockObject>());
-            isBlock = obj->is<BlockObject>() ? 1 : 0;
+            if (obj->is<JSFunction>())
+                classk = CK_JSFunction;
+            else if (obj->is<StaticBlockObject>())
+                classk = CK_BlockObject;
+            else
+                classk = CK_JSObject;
         }
-        if (!xdr->codeUint32(&isBlock))
+        if (!xdr->codeUint32(&classk))
             return false;
-        if (isBlock == 0) {
+        if (classk == CK_JSFunction) {
             /* Code the nested function's enclosing scope. */
             uint32_t funEnclosingScopeIndex = 0;
             if (mode == XDR_ENCODE) {
-                JSScript *innerScript = (*objp)->as<JSFunction>().getOrCreateScript(cx);
-                if (!innerScript)
-                    return false;
-                RootedObject staticScope(cx, innerScript->enclosingStaticScope());
+                JSFunction &innerFun = (*objp)->as<JSFunction>();
+                RootedObject staticScope(cx);
+                if (CanXDRLazily(&innerFun)) {
+                    staticScope = innerFun.lazyScript()->enclosingScope();
+                } else {
+                    JSScript *innerScript = innerFun.getOrCreateScript(cx);
+                    if (!innerScript)
+                        return false;
+                    staticScope = innerScript->enclosingStaticScope();
+                }
                 StaticScopeIter<NoGC> ssi(staticScope);
                 if (ssi.done() || ssi.type() == StaticScopeIter<NoGC>::FUNCTION) {
                     JS_ASSERT(ssi.done() == !fun);
@@ -757,9 +789,8 @@ js::XDRScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enc
             if (!XDRInterpretedFunction(xdr, funEnclosingScope, script, &tmp))
                 return false;
             *objp = tmp;
-        } else {
+        } else if (classk == CK_BlockObject) {
             /* Code the nested block's enclosing scope. */
-            JS_ASSERT(isBlock == 1);
             uint32_t blockEnclosingScopeIndex = 0;
             if (mode == XDR_ENCODE) {
                 if (StaticBlockObject *block = (*objp)->as<StaticBlockObject>().enclosingBlock())
@@ -783,6 +814,13 @@ js::XDRScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enc
             if (!XDRStaticBlockObject(xdr, blockEnclosingScope, tmp.address()))
                 return false;
             *objp = tmp;
+        } else {
+            /* Code the JSOP_NEWOBJECT template or JSOP_OBJECT singleton. */
+            JS_ASSERT(classk == CK_JSObject);
+            RootedObject tmp(cx, *objp);
+            if (!XDRObjectLiteral(xdr, &tmp))
+                return false;
+            *objp = tmp;
         }
     }
 
@@ -839,6 +877,144 @@ template bool
 js::XDRScript(XDRState<XDR_DECODE> *, HandleObject, HandleScript, HandleFunction,
               MutableHandleScript);
 
+template<XDRMode mode>
+bool
+js::XDRLazyScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enclosingScript,
+                  HandleFunction fun, MutableHandle<LazyScript *> lazy)
+{
+    /* NB: Keep this in sync with Parser::finishFunctionDefinition. */
+
+    enum LazyScriptBits {
+        Strict,
+        BindingsAccessedDynamically,
+        HasDebuggerStatement,
+        DirectlyInsideEval,
+        UsesArgumentsAndApply,
+        HasBeenCloned,
+        TreatAsRunOnce,
+        IsStarGenerator
+    };
+
+    JSContext *cx = xdr->cx();
+
+    uint32_t begin, end, lineno, column, version;
+    uint32_t numFreeVariables, numInnerFunctions;
+    uint32_t lazyBits = 0;
+    if (mode == XDR_ENCODE) {
+        JS_ASSERT(!lazy->maybeScript());
+        JS_ASSERT(lazy->functionNonDelazifying() == fun);
+
+        begin = lazy->begin();
+        end = lazy->end();
+        lineno = lazy->lineno();
+        column = lazy->column();
+        version = lazy->version();
+        numFreeVariables = lazy->numFreeVariables();
+        numInnerFunctions = lazy->numInnerFunctions();
+
+        if (lazy->strict())
+            lazyBits |= (1 << Strict);
+        if (lazy->bindingsAccessedDynamically())
+            lazyBits |= (1 << BindingsAccessedDynamically);
+        if (lazy->hasDebuggerStatement())
+            lazyBits |= (1 << HasDebuggerStatement);
+        if (lazy->directlyInsideEval())
+            lazyBits |= (1 << DirectlyInsideEval);
+        if (lazy->usesArgumentsAndApply())
+            lazyBits |= (1 << UsesArgumentsAndApply);
+        if (lazy->hasBeenCloned())
+            lazyBits |= (1 << HasBeenCloned);
+        if (lazy->treatAsRunOnce())
+            lazyBits |= (1 << TreatAsRunOnce);
+        if (lazy->isStarGenerator())
+            lazyBits |= (1 << IsStarGenerator);
+    }
+
+    if (!xdr->codeUint32(&begin) || !xdr->codeUint32(&end) ||
+        !xdr->codeUint32(&lineno) || !xdr->codeUint32(&column) ||
+        !xdr->codeUint32(&version) || !xdr->codeUint32(&lazyBits) ||
+        !xdr->codeUint32(&numFreeVariables) || !xdr->codeUint32(&numInnerFunctions))
+    {
+        return false;
+    }
+
+    /*
+     * Decode the free variables and inner functions before creating the lazy
+     * script, so that the GC never traces a partially initialized table.
+     */
+    AutoNameVector freeVariables(cx);
+    for (uint32_t i = 0; i < numFreeVariables; i++) {
+        RootedAtom atom(cx);
+        if (mode == XDR_ENCODE)
+            atom = lazy->freeVariables()[i];
+        if (!XDRAtom(xdr, &atom))
+            return false;
+        if (mode == XDR_DECODE && !freeVariables.append(atom->asPropertyName()))
+            return false;
+    }
+
+    /*
+     * Inner functions of a lazy script are lazy themselves, and only receive
+     * their enclosing scope and source object once this script is compiled.
+     */
+    AutoObjectVector innerFunctions(cx);
+    for (uint32_t i = 0; i < numInnerFunctions; i++) {
+        RootedObject innerFun(cx);
+        if (mode == XDR_ENCODE)
+            innerFun = lazy->innerFunctions()[i];
+        if (!XDRInterpretedFunction(xdr, fun, NullPtr(), &innerFun))
+            return false;
+        if (mode == XDR_DECODE && !innerFunctions.append(innerFun))
+            return false;
+    }
+
+    if (mode == XDR_DECODE) {
+        lazy.set(LazyScript::Create(cx, fun, numFreeVariables, numInnerFunctions,
+                                    JSVersion(version), begin, end, lineno, column));
+        if (!lazy)
+            return false;
+
+        for (uint32_t i = 0; i < numFreeVariables; i++)
+            lazy->freeVariables()[i].init(freeVariables[i]);
+        for (uint32_t i = 0; i < numInnerFunctions; i++)
+            lazy->innerFunctions()[i].init(&innerFunctions[i]->as<JSFunction>());
+
+        if (lazyBits & (1 << Strict))
+            lazy->setStrict();
+        if (lazyBits & (1 << BindingsAccessedDynamically))
+            lazy->setBindingsAccessedDynamically();
+        if (lazyBits & (1 << HasDebuggerStatement))
+            lazy->setHasDebuggerStatement();
+        if (lazyBits & (1 << DirectlyInsideEval))
+            lazy->setDirectlyInsideEval();
+        if (lazyBits & (1 << UsesArgumentsAndApply))
+            lazy->setUsesArgumentsAndApply();
+        if (lazyBits & (1 << HasBeenCloned))
+            lazy->setHasBeenCloned();
+        if (lazyBits & (1 << TreatAsRunOnce))
+            lazy->setTreatAsRunOnce();
+        if (lazyBits & (1 << IsStarGenerator))
+            lazy->setGeneratorKind(StarGenerator);
+
+        /* See the setParent call in EmitFunc. */
+        if (enclosingScript) {
+            ScriptSourceObject *sourceObject =
+                &enclosingScript->sourceObject()->as<ScriptSourceObject>();
+            lazy->setParent(enclosingScope, sourceObject);
+        }
+    }
+
+    return true;
+}
+
+template bool
+js::XDRLazyScript(XDRState<XDR_ENCODE> *, HandleObject, HandleScript, HandleFunction,
+                  MutableHandle<LazyScript *>);
+
+template bool
+js::XDRLazyScript(XDRState<XDR_DECODE> *, HandleObject, HandleScript, HandleFunction,
+                  MutableHandle<LazyScript *>);
+
 void
 JSScript::setSourceObject(JSObject *object)
 {
@@ -1138,18 +1314,29 @@ ScriptSource::chars(JSContext *cx, const SourceDataCache::AutoSuppressPurge &asp
         return chars;
     JS_ASSERT(ready());
 
-#ifdef USE_ZLIB
     if (compressed()) {
         if (const jschar *decompressed = cx->runtime()->sourceDataCache.lookup(this, asp))
             return decompressed;
-      
+
         const size_t nbytes = sizeof(jschar) * (length_ + 1);
         jschar *decompressed = static_cast<jschar *>(js_malloc(nbytes));
         if (!decompressed)
             return nullptr;
 
-        if (!DecompressString(data.compressed, compressedLength_,
-                              reinterpret_cast<unsigned char *>(decompressed), nbytes)) {
+        bool ok;
+#ifdef USE_ZLIB
+        if (codec_ == SourceCompression_Zlib) {
+            ok = DecompressString(data.compressed, compressedLength_,
+                                  reinterpret_cast<unsigned char *>(decompressed), nbytes);
+        } else
+#endif
+        {
+            JS_ASSERT(codec_ == SourceCompression_LZ4);
+            ok = DecompressLZ4String(data.compressed, compressedLength_,
+                                     reinterpret_cast<unsigned char *>(decompressed),
+                                     sizeof(jschar) * length_);
+        }
+        if (!ok) {
             JS_ReportOutOfMemory(cx);
             js_free(decompressed);
             return nullptr;
@@ -1165,19 +1352,59 @@ ScriptSource::chars(JSContext *cx, const SourceDataCache::AutoSuppressPurge &asp
 
         return decompressed;
     }
-#endif
     return data.source;
 }
 
+const jschar *
+ScriptSource::chars(JSContext *cx, const SourceDataCache::AutoSuppressPurge &asp,
+                    size_t begin, size_t len, ScopedJSFreePtr<jschar> &holder)
+{
+    JS_ASSERT(begin + len <= length_);
+
+    if (ready() && compressed() && codec_ == SourceCompression_LZ4 && len &&
+        !cx->runtime()->sourceDataCache.lookup(this, asp))
+    {
+        const size_t chunkChars = LZ4Compressor::CHUNK_SIZE / sizeof(jschar);
+        size_t firstChunk = begin / chunkChars;
+        size_t lastChunk = (begin + len - 1) / chunkChars;
+        size_t numChunks = LZ4Compressor::numChunks(sizeof(jschar) * length_);
+
+        // Once the range covers most of the source, decompress all of it so
+        // that chars() can cache the result for later calls.
+        if ((lastChunk - firstChunk + 1) * 2 <= numChunks) {
+            size_t rangeStart = firstChunk * chunkChars;
+            size_t rangeLength = Min((lastChunk + 1) * chunkChars, size_t(length_)) - rangeStart;
+            jschar *buf = cx->pod_malloc<jschar>(rangeLength);
+            if (!buf)
+                return nullptr;
+            holder = buf;
+            if (!DecompressLZ4Chunks(data.compressed, compressedLength_,
+                                     sizeof(jschar) * length_, firstChunk, lastChunk,
+                                     reinterpret_cast<unsigned char *>(buf)))
+            {
+                JS_ReportOutOfMemory(cx);
+                return nullptr;
+            }
+            return buf + (begin - rangeStart);
+        }
+    }
+
+    const jschar *chars = this->chars(cx, asp);
+    if (!chars)
+        return nullptr;
+    return chars + begin;
+}
+
 JSStableString *
 ScriptSource::substring(JSContext *cx, uint32_t start, uint32_t stop)
 {
     JS_ASSERT(start <= stop);
     SourceDataCache::AutoSuppressPurge asp(cx);
-    const jschar *chars = this->chars(cx, asp);
+    ScopedJSFreePtr<jschar> holder;
+    const jschar *chars = this->chars(cx, asp, start, stop - start, holder);
     if (!chars)
         return nullptr;
-    JSFlatString *flatStr = js_NewStringCopyN<CanGC>(cx, chars + start, stop - start);
+    JSFlatString *flatStr = js_NewStringCopyN<CanGC>(cx, chars, stop - start);
     if (!flatStr)
         return nullptr;
     return flatStr->ensureStable(cx);
@@ -1211,13 +1438,19 @@ ScriptSource::setSourceCopy(ExclusiveContext *cx, const jschar *src, uint32_t le
     //    thread (see WorkerThreadState::canStartParseTask) which would cause a
     //    deadlock if there wasn't a second worker thread that could make
     //    progress on our compression task.
+    //
+    // LZ4 sources are decompressed chunk by chunk when lazily compiling, so
+    // the size limit only applies to zlib.
     const size_t HUGE_SCRIPT = 5 * 1024 * 1024;
-    if (length < HUGE_SCRIPT &&
+    SourceCompression codec = cx->sourceCompression();
+    if (codec != SourceCompression_None &&
+        (length < HUGE_SCRIPT || codec == SourceCompression_LZ4) &&
         cx->cpuCount() > 1 &&
         cx->workerThreadCount() >= 2)
     {
         task->ss = this;
         task->chars = src;
+        task->codec = codec;
         ready_ = false;
         if (!StartOffThreadCompression(cx, task))
             return false;
@@ -1239,6 +1472,69 @@ ScriptSource::setSource(const jschar *src, size_t length)
     data.source = const_cast<jschar *>(src);
 }
 
+bool
+SourceCompressionTask::compressLZ4(size_t nbytes, size_t *compressedLength)
+{
+    // The output is only useful if it is smaller than the input, so never
+    // allocate more than the uncompressed size.
+    if (!ss->adjustDataSize(nbytes))
+        return false;
+    LZ4Compressor comp(reinterpret_cast<const unsigned char *>(chars), nbytes);
+    comp.setOutput(ss->data.compressed, nbytes);
+    LZ4Compressor::Status status;
+    do {
+        status = comp.compressMore();
+    } while (status == LZ4Compressor::CONTINUE && !abort_);
+    if (status == LZ4Compressor::DONE && !abort_ && comp.outWritten() < nbytes)
+        *compressedLength = comp.outWritten();
+    return true;
+}
+
+#ifdef USE_ZLIB
+bool
+SourceCompressionTask::compressZlib(size_t nbytes, size_t *compressedLength)
+{
+    // Try to keep the maximum memory usage down by only allocating half the
+    // size of the string, first.
+    size_t firstSize = nbytes / 2;
+    if (!ss->adjustDataSize(firstSize))
+        return false;
+    Compressor comp(reinterpret_cast<const unsigned char *>(chars), nbytes);
+    if (!comp.init())
+        return false;
+    comp.setOutput(ss->data.compressed, firstSize);
+    bool cont = !abort_;
+    while (cont) {
+        switch (comp.compressMore()) {
+          case Compressor::CONTINUE:
+            break;
+          case Compressor::MOREOUTPUT: {
+            if (comp.outWritten() == nbytes) {
+                cont = false;
+                break;
+            }
+
+            // The compressed output is greater than half the size of the
+            // original string. Reallocate to the full size.
+            if (!ss->adjustDataSize(nbytes))
+                return false;
+            comp.setOutput(ss->data.compressed, nbytes);
+            break;
+          }
+          case Compressor::DONE:
+            cont = false;
+            break;
+          case Compressor::OOM:
+            return false;
+        }
+        cont = cont && !abort_;
+    }
+    if (!abort_ && comp.outWritten() != nbytes)
+        *compressedLength = comp.outWritten();
+    return true;
+}
+#endif
+
 bool
 SourceCompressionTask::work()
 {
@@ -1253,49 +1549,23 @@ SourceCompressionTask::work()
     // Memory allocation functions on JSRuntime and JSContext are not
     // threadsafe. We have to use the js_* variants.
 
-#ifdef USE_ZLIB
     const size_t COMPRESS_THRESHOLD = 512;
     if (nbytes >= COMPRESS_THRESHOLD) {
-        // Try to keep the maximum memory usage down by only allocating half the
-        // size of the string, first.
-        size_t firstSize = nbytes / 2;
-        if (!ss->adjustDataSize(firstSize))
-            return false;
-        Compressor comp(reinterpret_cast<const unsigned char *>(chars), nbytes);
-        if (!comp.init())
-            return false;
-        comp.setOutput(ss->data.compressed, firstSize);
-        bool cont = !abort_;
-        while (cont) {
-            switch (comp.compressMore()) {
-              case Compressor::CONTINUE:
-                break;
-              case Compressor::MOREOUTPUT: {
-                if (comp.outWritten() == nbytes) {
-                    cont = false;
-                    break;
-                }
-
-                // The compressed output is greater than half the size of the
-                // original string. Reallocate to the full size.
-                if (!ss->adjustDataSize(nbytes))
-                    return false;
-                comp.setOutput(ss->data.compressed, nbytes);
-                break;
-              }
-              case Compressor::DONE:
-                cont = false;
-                break;
-              case Compressor::OOM:
+        switch (codec) {
+          case SourceCompression_LZ4:
+            if (!compressLZ4(nbytes, &compressedLength))
                 return false;
-            }
-            cont = cont && !abort_;
+            break;
+#ifdef USE_ZLIB
+          case SourceCompression_Zlib:
+            if (!compressZlib(nbytes, &compressedLength))
+                return false;
+            break;
+#endif
+          default:
+            break;
         }
-        compressedLength = comp.outWritten();
-        if (abort_ || compressedLength == nbytes)
-            compressedLength = 0;
     }
-#endif
     if (compressedLength == 0) {
         if (!ss->adjustDataSize(nbytes))
             return false;
@@ -1305,6 +1575,7 @@ SourceCompressionTask::work()
         JS_ALWAYS_TRUE(ss->adjustDataSize(compressedLength));
     }
     ss->compressedLength_ = compressedLength;
+    ss->codec_ = compressedLength ? codec : SourceCompression_None;
     return true;
 }
 
@@ -1359,6 +1630,18 @@ ScriptSource::performXDR(XDRState<mode> *xdr)
         if (!xdr->codeUint32(&compressedLength))
             return false;
 
+        uint8_t codec = codec_;
+        if (!xdr->codeUint8(&codec))
+            return false;
+        if (mode == XDR_DECODE && compressedLength) {
+            bool known = codec == SourceCompression_LZ4;
+#ifdef USE_ZLIB
+            known = known || codec == SourceCompression_Zlib;
+#endif
+            if (!known)
+                return false;
+        }
+
         uint8_t argumentsNotIncluded = argumentsNotIncluded_;
         if (!xdr->codeUint8(&argumentsNotIncluded))
             return false;
@@ -1377,6 +1660,7 @@ ScriptSource::performXDR(XDRState<mode> *xdr)
         }
         length_ = length;
         compressedLength_ = compressedLength;
+        codec_ = SourceCompression(codec);
         argumentsNotIncluded_ = argumentsNotIncluded;
     }
 
@@ -2115,19 +2399,18 @@ js::CallDestroyScriptHook(FreeOp *fop, JSScript *script)
 }
 
 void
-JSScript::finalize(FreeOp *fop)
+JSScript::sweep(FreeOp *fop)
 {
     // NOTE: this JSScript may be partially initialized at this point.  E.g. we
     // may have created it and partially initialized it with
     // JSScript::Create(), but not yet finished initializing it with
     // fullyInitFromEmitter() or fullyInitTrivial().
 
+    JS_ASSERT(!isMarked());
+
     CallDestroyScriptHook(fop, this);
     fop->runtime()->spsProfiler.onScriptFinalized(this);
 
-    if (types)
-        types->destroy();
-
 #ifdef JS_ION
     jit::DestroyIonScripts(fop, this);
 #endif
@@ -2135,12 +2418,22 @@ JSScript::finalize(FreeOp *fop)
     destroyScriptCounts(fop);
     destroyDebugScript(fop);
 
+    fop->runtime()->lazyScriptCache.remove(this);
+}
+
+void
+JSScript::finalize(FreeOp *fop)
+{
+    // Everything left to free is owned by this script alone; see sweep().
+    JS_ASSERT(!hasScriptCounts() && !hasDebugScript_);
+
+    if (types)
+        types->destroy();
+
     if (data) {
         JS_POISON(data, 0xdb, computedSizeOfData());
         fop->free_(data);
     }
-
-    fop->runtime()->lazyScriptCache.remove(this);
 }
 
 static const uint32_t GSN_CACHE_THRESHOLD = 100;
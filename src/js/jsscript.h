@@ -374,6 +374,7 @@ class ScriptSource
     uint32_t refs;
     uint32_t length_;
     uint32_t compressedLength_;
+    SourceCompression codec_;
     char *filename_;
     jschar *displayURL_;
     jschar *sourceMapURL_;
@@ -391,6 +392,7 @@ class ScriptSource
       : refs(0),
         length_(0),
         compressedLength_(0),
+        codec_(SourceCompression_None),
         filename_(nullptr),
         displayURL_(nullptr),
         sourceMapURL_(nullptr),
@@ -428,6 +430,12 @@ class ScriptSource
         return argumentsNotIncluded_;
     }
     const jschar *chars(JSContext *cx, const SourceDataCache::AutoSuppressPurge &asp);
+
+    // Return a pointer to the chars in [begin, begin + len). For LZ4 sources
+    // without cached decompressed chars, only the chunks containing the range
+    // are decompressed, into a buffer owned by |holder|.
+    const jschar *chars(JSContext *cx, const SourceDataCache::AutoSuppressPurge &asp,
+                        size_t begin, size_t len, ScopedJSFreePtr<jschar> &holder);
     JSStableString *substring(JSContext *cx, uint32_t start, uint32_t stop);
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
@@ -529,6 +537,16 @@ bool
 XDRScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enclosingScript,
           HandleFunction fun, MutableHandleScript scriptp);
 
+/*
+ * Code a function's LazyScript in place of its compiled script. Decoding with
+ * a null enclosingScript leaves the lazy script without a parent, as is the
+ * case for the inner functions of a lazy script.
+ */
+template<XDRMode mode>
+bool
+XDRLazyScript(XDRState<mode> *xdr, HandleObject enclosingScope, HandleScript enclosingScript,
+              HandleFunction fun, MutableHandle<LazyScript *> lazy);
+
 JSScript *
 CloneScript(JSContext *cx, HandleObject enclosingScope, HandleFunction fun, HandleScript script,
             NewObjectKind newKind = GenericObject);
@@ -540,6 +558,14 @@ template<XDRMode mode>
 bool
 XDRScriptConst(XDRState<mode> *xdr, MutableHandleValue vp);
 
+/*
+ * Code the object literal templates and singleton initialisers which
+ * compile-and-go scripts keep in their object array.
+ */
+template<XDRMode mode>
+bool
+XDRObjectLiteral(XDRState<mode> *xdr, MutableHandleObject obj);
+
 } /* namespace js */
 
 class JSScript : public js::gc::BarrieredCell<JSScript>
@@ -1495,6 +1521,12 @@ class JSScript : public js::gc::BarrieredCell<JSScript>
     uint32_t stepModeCount() { return hasDebugScript_ ? (debugScript()->stepMode & stepCountMask) : 0; }
 #endif
 
+    /*
+     * Dead scripts are finalized in two steps. sweep() releases everything
+     * shared with the runtime -- hooks, caches, debug and JIT data -- on the
+     * main thread, after which finalize() can run on the background thread.
+     */
+    void sweep(js::FreeOp *fop);
     void finalize(js::FreeOp *fop);
 
     static inline js::ThingRootKind rootKind() { return js::THING_ROOT_SCRIPT; }
@@ -20,11 +20,18 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/PodOperations.h"
 
 #include <ctype.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_STRING_MATCH_SSE2
+# include <emmintrin.h>
+#endif
+
 #include "jsapi.h"
 #include "jsarray.h"
 #include "jsatom.h"
@@ -59,6 +66,7 @@ using namespace js::types;
 using namespace js::unicode;
 
 using mozilla::CheckedInt;
+using mozilla::CountTrailingZeroes32;
 using mozilla::IsNaN;
 using mozilla::IsNegativeZero;
 using mozilla::PodCopy;
@@ -1022,6 +1030,62 @@ UnrolledMatch(const jschar *text, uint32_t textlen, const jschar *pat, uint32_t
     return -1;
 }
 
+#ifdef JS_STRING_MATCH_SSE2
+/*
+ * SSE2 first/last char filter. Each iteration compares eight candidate
+ * positions at once against the first and the last char of the pattern and
+ * only runs the full comparison for positions where both match, which makes
+ * false candidates much rarer than with a first-char-only scan.
+ *
+ * The caller must ensure that at least eight candidate positions exist, that
+ * is |textlen - patlen + 1 >= sSSE2MatchMinPositions|.
+ */
+static const uint32_t sSSE2MatchLanes = sizeof(__m128i) / sizeof(jschar);
+static const uint32_t sSSE2MatchMinPositions = sSSE2MatchLanes;
+
+static int
+SSE2Match(const jschar *text, uint32_t textlen, const jschar *pat, uint32_t patlen)
+{
+    JS_ASSERT(patlen > 0);
+    JS_ASSERT(textlen - patlen + 1 >= sSSE2MatchMinPositions);
+
+    const uint32_t positions = textlen - patlen + 1;
+    const uint32_t lastOffset = patlen - 1;
+    const __m128i first = _mm_set1_epi16(pat[0]);
+    const __m128i last = _mm_set1_epi16(pat[lastOffset]);
+
+    /* Both loads of a block stay in bounds as long as i + 8 <= positions. */
+    uint32_t i = 0;
+    for (; i + sSSE2MatchLanes <= positions; i += sSSE2MatchLanes) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+        __m128i blockLast =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + lastOffset));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi16(first, blockFirst),
+                                   _mm_cmpeq_epi16(last, blockLast));
+
+        /* Two mask bits per jschar lane. */
+        uint32_t mask = uint32_t(_mm_movemask_epi8(eq));
+        while (mask) {
+            uint32_t bit = CountTrailingZeroes32(mask);
+            uint32_t candidate = i + bit / 2;
+            if (patlen <= 2 || PodEqual(text + candidate + 1, pat + 1, patlen - 2))
+                return candidate;
+            mask &= ~(uint32_t(3) << bit);
+        }
+    }
+
+    /* Scalar tail for the last (positions % 8) candidates. */
+    for (; i < positions; i++) {
+        if (text[i] == pat[0] && text[i + lastOffset] == pat[lastOffset] &&
+            PodEqual(text + i, pat, patlen))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif /* JS_STRING_MATCH_SSE2 */
+
 static JS_ALWAYS_INLINE int
 StringMatch(const jschar *text, uint32_t textlen,
             const jschar *pat, uint32_t patlen)
@@ -1031,6 +1095,16 @@ StringMatch(const jschar *text, uint32_t textlen,
     if (textlen < patlen)
         return -1;
 
+#ifdef JS_STRING_MATCH_SSE2
+    /*
+     * SSE2 is part of the baseline instruction set wherever this is compiled
+     * in, so no runtime feature check is needed. Short texts with fewer than
+     * eight candidate positions fall through to the scalar paths below.
+     */
+    if (textlen - patlen + 1 >= sSSE2MatchMinPositions)
+        return SSE2Match(text, textlen, pat, patlen);
+#endif
+
 #if defined(__i386__) || defined(_M_IX86) || defined(__i386)
     /*
      * Given enough registers, the unrolled loop below is faster than the
@@ -2691,6 +2765,28 @@ AppendSubstrings(JSContext *cx, Handle<JSStableString*> stableStr,
     return rope.result();
 }
 
+/*
+ * Answer a replace whose replacement string has no '$' patterns from the
+ * compartment's result cache, if the last such replace had the same regexp,
+ * input and replacement.
+ */
+static bool
+LookupReplaceResultCache(JSContext *cx, RegExpShared &re, JSLinearString *input,
+                         JSLinearString *repstr, MutableHandleValue rval)
+{
+    RegExpResultCache &cache = cx->compartment()->regExps.resultCache();
+    size_t lastMatchIndex;
+    JSString *result = cache.lookupReplace(&re, input, repstr, &lastMatchIndex);
+    if (!result)
+        return false;
+
+    if (lastMatchIndex != RegExpResultCache::NoMatch)
+        cx->global()->getRegExpStatics()->updateLazily(cx, input, &re, lastMatchIndex);
+
+    rval.setString(result);
+    return true;
+}
+
 static bool
 StrReplaceRegexpRemove(JSContext *cx, HandleString str, RegExpShared &re, MutableHandleValue rval)
 {
@@ -2698,6 +2794,11 @@ StrReplaceRegexpRemove(JSContext *cx, HandleString str, RegExpShared &re, Mutabl
     if (!stableStr)
         return false;
 
+    JSLinearString *emptyString = cx->runtime()->emptyString;
+    if (LookupReplaceResultCache(cx, re, stableStr, emptyString, rval))
+        return true;
+    RegExpResultCache &cache = cx->compartment()->regExps.resultCache();
+
     Vector<StringRange, 16, SystemAllocPolicy> ranges;
 
     StableCharPtr chars = stableStr->chars();
@@ -2738,8 +2839,12 @@ StrReplaceRegexpRemove(JSContext *cx, HandleString str, RegExpShared &re, Mutabl
 
     /* If unmatched, return the input string. */
     if (!lastIndex) {
-        if (startIndex > 0)
+        size_t lastMatchIndex = RegExpResultCache::NoMatch;
+        if (startIndex > 0) {
             cx->global()->getRegExpStatics()->updateLazily(cx, stableStr, &re, lazyIndex);
+            lastMatchIndex = lazyIndex;
+        }
+        cache.cacheReplace(&re, stableStr, emptyString, str, lastMatchIndex);
         rval.setString(str);
         return true;
     }
@@ -2755,7 +2860,8 @@ StrReplaceRegexpRemove(JSContext *cx, HandleString str, RegExpShared &re, Mutabl
 
     /* Handle the empty string before calling .begin(). */
     if (ranges.empty()) {
-        rval.setString(cx->runtime()->emptyString);
+        cache.cacheReplace(&re, stableStr, emptyString, emptyString, lazyIndex);
+        rval.setString(emptyString);
         return true;
     }
 
@@ -2763,6 +2869,76 @@ StrReplaceRegexpRemove(JSContext *cx, HandleString str, RegExpShared &re, Mutabl
     if (!result)
         return false;
 
+    cache.cacheReplace(&re, stableStr, emptyString, result, lazyIndex);
+    rval.setString(result);
+    return true;
+}
+
+/*
+ * Replace with a string that has no '$' patterns: only the bounds of each
+ * match are needed, so the regexp runs match-only and the RegExpStatics are
+ * updated lazily, once, for the last match.
+ */
+static bool
+StrReplaceRegexpLiteral(JSContext *cx, HandleString str, RegExpShared &re,
+                        Handle<JSLinearString*> repstr, MutableHandleValue rval)
+{
+    Rooted<JSLinearString*> linearStr(cx, str->ensureLinear(cx));
+    if (!linearStr)
+        return false;
+
+    if (LookupReplaceResultCache(cx, re, linearStr, repstr, rval))
+        return true;
+
+    StringBuffer sb(cx);
+    const jschar *chars = linearStr->chars();
+    size_t charsLen = linearStr->length();
+
+    MatchPair match;
+    size_t startIndex = 0; /* Index used for iterating through the string. */
+    size_t lastIndex = 0;  /* Index after last successful match. */
+    size_t lastMatchIndex = RegExpResultCache::NoMatch; /* Where the last match was searched from. */
+
+    while (startIndex <= charsLen) {
+        if (!JS_CHECK_OPERATION_LIMIT(cx))
+            return false;
+
+        size_t searchIndex = startIndex;
+        RegExpRunStatus status = re.executeMatchOnly(cx, chars, charsLen, &startIndex, match);
+        if (status == RegExpRunStatus_Error)
+            return false;
+        if (status == RegExpRunStatus_Success_NotFound)
+            break;
+
+        /* Append the skipped-over portion and the replacement. */
+        if (!sb.append(chars + lastIndex, match.start - lastIndex) || !sb.append(repstr))
+            return false;
+
+        lastMatchIndex = searchIndex;
+        lastIndex = startIndex;
+
+        if (match.isEmpty())
+            startIndex++;
+
+        /* Non-global replacement executes at most once. */
+        if (!re.global())
+            break;
+    }
+
+    RootedString result(cx, str);
+    if (lastMatchIndex != RegExpResultCache::NoMatch) {
+        /* The last successful match updates the RegExpStatics. */
+        cx->global()->getRegExpStatics()->updateLazily(cx, linearStr, &re, lastMatchIndex);
+
+        if (!sb.append(chars + lastIndex, charsLen - lastIndex))
+            return false;
+        result = sb.finishString();
+        if (!result)
+            return false;
+    }
+
+    cx->compartment()->regExps.resultCache().cacheReplace(&re, linearStr, repstr, result,
+                                                          lastMatchIndex);
     rval.setString(result);
     return true;
 }
@@ -2785,10 +2961,14 @@ StrReplaceRegExp(JSContext *cx, ReplaceData &rdata, MutableHandleValue rval)
     if (re.global() && !rdata.g.zeroLastIndex(cx))
         return false;
 
-    /* Optimize removal. */
-    if (rdata.repstr && rdata.repstr->length() == 0) {
-        JS_ASSERT(!rdata.lambda && !rdata.elembase && !rdata.dollar);
-        return StrReplaceRegexpRemove(cx, rdata.str, re, rval);
+    /* Without '$' patterns in the replacement, captures are never needed. */
+    if (rdata.repstr && !rdata.dollar) {
+        JS_ASSERT(!rdata.lambda && !rdata.elembase);
+
+        /* Optimize removal. */
+        if (rdata.repstr->length() == 0)
+            return StrReplaceRegexpRemove(cx, rdata.str, re, rval);
+        return StrReplaceRegexpLiteral(cx, rdata.str, re, rdata.repstr, rval);
     }
 
     Rooted<JSLinearString*> linearStr(cx, rdata.str->ensureLinear(cx));
@@ -3269,6 +3449,48 @@ class SplitRegExpMatcher
     }
 };
 
+/*
+ * Matcher for regexps without captures: only the bounds of each separator are
+ * needed, so run the regexp match-only and update the RegExpStatics lazily.
+ */
+class SplitRegExpMatchOnlyMatcher
+{
+    RegExpShared &re;
+    RegExpStatics *res;
+    size_t *lastMatchIndex;
+
+  public:
+    SplitRegExpMatchOnlyMatcher(RegExpShared &re, RegExpStatics *res, size_t *lastMatchIndex)
+      : re(re), res(res), lastMatchIndex(lastMatchIndex)
+    {
+        JS_ASSERT(re.getParenCount() == 0);
+    }
+
+    static const bool returnsCaptures = false;
+
+    bool operator()(JSContext *cx, Handle<JSLinearString*> str, size_t index,
+                    SplitMatchResult *result) const
+    {
+        size_t searchIndex = index;
+        MatchPair match;
+        RegExpRunStatus status = re.executeMatchOnly(cx, str->chars(), str->length(),
+                                                     &index, match);
+        if (status == RegExpRunStatus_Error)
+            return false;
+
+        if (status == RegExpRunStatus_Success_NotFound) {
+            result->setFailure();
+            return true;
+        }
+
+        res->updateLazily(cx, str, &re, searchIndex);
+        *lastMatchIndex = searchIndex;
+
+        result->setResult(match.length(), index);
+        return true;
+    }
+};
+
 class SplitStringMatcher
 {
     Rooted<JSLinearString*> sep;
@@ -3373,8 +3595,36 @@ js::str_split(JSContext *cx, unsigned argc, Value *vp)
             aobj = SplitHelper(cx, linearStr, limit, matcher, type);
         }
     } else {
-        SplitRegExpMatcher matcher(*re, cx->global()->getRegExpStatics());
-        aobj = SplitHelper(cx, linearStr, limit, matcher, type);
+        if (!re->compileMatchOnlyIfNecessary(cx))
+            return false;
+
+        RegExpStatics *res = cx->global()->getRegExpStatics();
+        if (re->getParenCount() == 0) {
+            /*
+             * Splitting the same string by the same regexp again gives the
+             * same pieces, which are cached rather than matched again.
+             */
+            RegExpResultCache &cache = cx->compartment()->regExps.resultCache();
+            size_t lastMatchIndex;
+            if (const RegExpResultCache::ValueVector *elements =
+                cache.lookupSplit(re.re(), linearStr, limit, &lastMatchIndex))
+            {
+                if (lastMatchIndex != RegExpResultCache::NoMatch)
+                    res->updateLazily(cx, linearStr, re.re(), lastMatchIndex);
+                aobj = NewDenseCopiedArray(cx, elements->length(), elements->begin());
+            } else {
+                lastMatchIndex = RegExpResultCache::NoMatch;
+                SplitRegExpMatchOnlyMatcher matcher(*re, res, &lastMatchIndex);
+                aobj = SplitHelper(cx, linearStr, limit, matcher, type);
+                if (aobj) {
+                    cache.cacheSplit(re.re(), linearStr, limit, aobj->getDenseElements(),
+                                     aobj->getDenseInitializedLength(), lastMatchIndex);
+                }
+            }
+        } else {
+            SplitRegExpMatcher matcher(*re, res);
+            aobj = SplitHelper(cx, linearStr, limit, matcher, type);
+        }
     }
     if (!aobj)
         return false;
@@ -14,6 +14,7 @@
 #include "NamespaceImports.h"
 
 #include "gc/Rooting.h"
+#include "js/CharacterEncoding.h"
 #include "js/RootingAPI.h"
 #include "vm/Unicode.h"
 
@@ -200,6 +201,20 @@ EqualStrings(JSContext *cx, JSLinearString *str1, JSLinearString *str2, bool *re
 extern bool
 EqualStrings(JSLinearString *str1, JSLinearString *str2);
 
+/*
+ * Compare |len| jschars against |len| Latin-1 chars without inflating the
+ * latter into a temporary buffer.
+ */
+inline bool
+EqualChars(const jschar *s1, const JS::Latin1Char *s2, size_t len)
+{
+    for (const jschar *end = s1 + len; s1 != end; s1++, s2++) {
+        if (*s1 != *s2)
+            return false;
+    }
+    return true;
+}
+
 /*
  * Return less than, equal to, or greater than zero depending on whether
  * str1 is less than, equal to, or greater than str2.
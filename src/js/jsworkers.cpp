@@ -92,6 +92,7 @@ js::StartOffThreadIonCompile(JSContext *cx, jit::IonBuilder *builder)
 
     AutoLockWorkerThreadState lock(state);
 
+    builder->noteQueued(state.ionCompilationsStarted);
     if (!state.ionWorklist.append(builder))
         return false;
 
@@ -528,22 +529,118 @@ WorkerThreadState::canStartAsmJSCompile()
     return (!asmJSWorklist.empty() && !numAsmJSFailedJobs);
 }
 
+size_t
+WorkerThreadState::maxIonCompilationThreads() const
+{
+#if JS_TRACE_LOGGING
+    // Each concurrent compilation logs to its own trace logger.
+    return Min(numThreads, size_t(TraceLogging::NUM_ION_COMPILER_LOGGERS));
+#else
+    return numThreads;
+#endif
+}
+
 bool
 WorkerThreadState::canStartIonCompile()
 {
     // A worker thread can begin an Ion compilation if (a) there is some script
-    // which is waiting to be compiled, and (b) no other worker thread is
-    // currently compiling a script. The latter condition ensures that two
-    // compilations cannot simultaneously occur.
+    // which is waiting to be compiled, and (b) fewer than the maximum number
+    // of compilations are already in progress. Each builder has its own
+    // allocator and reads shared VM state under the compilation lock, so
+    // several of them may run at once.
+    JS_ASSERT(isLocked());
     if (ionWorklist.empty())
         return false;
+    size_t numBuilders = 0;
     for (size_t i = 0; i < numThreads; i++) {
         if (threads[i].ionBuilder)
-            return false;
+            numBuilders++;
     }
-    return true;
+    return numBuilders < maxIonCompilationThreads();
 }
 
+#ifdef JS_ION
+
+static bool
+IsIonRecompile(jit::IonBuilder *builder)
+{
+    // Note: this reads script->ion without synchronization, see hasIonScript.
+    JSScript *script = builder->script();
+    if (builder->info().executionMode() == SequentialExecution)
+        return script->hasIonScript();
+    return script->hasParallelIonScript();
+}
+
+static bool
+IonBuilderHasHigherPriority(jit::IonBuilder *first, jit::IonBuilder *second)
+{
+    // A script which has no Ion code yet is stuck in baseline until its
+    // compilation finishes, whereas a recompiled script still has working
+    // code to run in the meantime.
+    bool firstRecompile = IsIonRecompile(first);
+    if (firstRecompile != IsIonRecompile(second))
+        return !firstRecompile;
+
+    // Otherwise prefer the hotter script. Use counts keep changing while the
+    // builders are queued, so compare them now rather than when they were
+    // added, and scale by script length so that a short hot loop is not
+    // starved by a long function which has run just as often.
+    JSScript *firstScript = first->script();
+    JSScript *secondScript = second->script();
+    return uint64_t(firstScript->getUseCount()) * secondScript->length() >
+           uint64_t(secondScript->getUseCount()) * firstScript->length();
+}
+
+size_t
+WorkerThreadState::highestPriorityPendingIonCompile()
+{
+    JS_ASSERT(isLocked());
+    JS_ASSERT(!ionWorklist.empty());
+
+    // The worklist is short, so find the best entry with a linear scan
+    // instead of keeping it sorted while the priorities change under us.
+    size_t index = 0;
+    for (size_t i = 1; i < ionWorklist.length(); i++) {
+        if (IonBuilderHasHigherPriority(ionWorklist[i], ionWorklist[index]))
+            index = i;
+    }
+    return index;
+}
+
+/*
+ * A pending compilation is stale if its script has not run at all since it was
+ * queued, and this many other compilations have started in the meantime.
+ */
+static const uint64_t STALE_ION_COMPILE_AGE = 16;
+
+void
+WorkerThreadState::cancelStaleIonCompiles()
+{
+    // Compiling a script which has stopped running only delays the
+    // compilations behind it. Give such builders back to the main thread,
+    // which treats them like any other cancelled compilation; the script
+    // will be queued again if it warms back up.
+    JS_ASSERT(isLocked());
+    for (size_t i = 0; i < ionWorklist.length(); i++) {
+        jit::IonBuilder *builder = ionWorklist[i];
+
+        // Ion code does not bump use counts, so recompilations always look
+        // idle. Parallel compilations are waited on by ForkJoin.
+        if (builder->info().executionMode() != SequentialExecution || IsIonRecompile(builder))
+            continue;
+        if (ionCompilationsStarted - builder->compilationsStartedWhenQueued() < STALE_ION_COMPILE_AGE)
+            continue;
+        if (builder->script()->getUseCount() != builder->useCountWhenQueued())
+            continue;
+
+        FinishOffThreadIonCompile(builder);
+        ionWorklist[i--] = ionWorklist.back();
+        ionWorklist.popBack();
+    }
+}
+
+#endif // JS_ION
+
 bool
 WorkerThreadState::canStartParseTask()
 {
@@ -754,6 +851,26 @@ WorkerThread::handleAsmJSWorkload(WorkerThreadState &state)
 #endif // JS_ION
 }
 
+#if defined(JS_ION) && JS_TRACE_LOGGING
+static size_t
+UnusedIonLoggerSlot(WorkerThreadState &state, WorkerThread *thread)
+{
+    // Trace loggers are not thread safe, so concurrent compilations each log
+    // to their own one. maxIonCompilationThreads ensures there is a free slot.
+    for (size_t slot = 0; slot < TraceLogging::NUM_ION_COMPILER_LOGGERS; slot++) {
+        bool used = false;
+        for (size_t i = 0; i < state.numThreads; i++) {
+            WorkerThread *other = &state.threads[i];
+            if (other != thread && other->ionBuilder && other->ionLoggerSlot == slot)
+                used = true;
+        }
+        if (!used)
+            return slot;
+    }
+    MOZ_ASSUME_UNREACHABLE("No free Ion compiler trace logger");
+}
+#endif
+
 void
 WorkerThread::handleIonWorkload(WorkerThreadState &state)
 {
@@ -762,12 +879,23 @@ WorkerThread::handleIonWorkload(WorkerThreadState &state)
     JS_ASSERT(state.canStartIonCompile());
     JS_ASSERT(idle());
 
-    ionBuilder = state.ionWorklist.popCopy();
+    size_t index = state.highestPriorityPendingIonCompile();
+    ionBuilder = state.ionWorklist[index];
+    state.ionWorklist[index] = state.ionWorklist.back();
+    state.ionWorklist.popBack();
+    state.ionCompilationsStarted++;
+
+    // Now that another compilation has started, older entries which nobody
+    // is waiting for can be dropped from the worklist.
+    state.cancelStaleIonCompiles();
 
     DebugOnly<ExecutionMode> executionMode = ionBuilder->info().executionMode();
 
 #if JS_TRACE_LOGGING
-    AutoTraceLog logger(TraceLogging::getLogger(TraceLogging::ION_BACKGROUND_COMPILER),
+    ionLoggerSlot = UnusedIonLoggerSlot(state, this);
+    TraceLogging::Logger loggerId =
+        TraceLogging::Logger(TraceLogging::ION_BACKGROUND_COMPILER + ionLoggerSlot);
+    AutoTraceLog logger(TraceLogging::getLogger(loggerId),
                         TraceLogging::ION_COMPILE_START,
                         TraceLogging::ION_COMPILE_STOP,
                         ionBuilder->script());
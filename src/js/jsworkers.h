@@ -49,9 +49,16 @@ class WorkerThreadState
         PRODUCER
     };
 
-    /* Shared worklist for Ion worker threads. */
+    /*
+     * Shared worklist for Ion worker threads. This is not kept in any order;
+     * worker threads pick the highest priority entry when starting a
+     * compilation, see highestPriorityPendingIonCompile.
+     */
     Vector<jit::IonBuilder*, 0, SystemAllocPolicy> ionWorklist;
 
+    /* Number of Ion compilations started off thread, used to age pending ones. */
+    uint64_t ionCompilationsStarted;
+
     /* Worklist for AsmJS worker threads. */
     Vector<AsmJSParallelTask*, 0, SystemAllocPolicy> asmJSWorklist;
 
@@ -102,6 +109,10 @@ class WorkerThreadState
     bool canStartParseTask();
     bool canStartCompressionTask();
 
+    size_t maxIonCompilationThreads() const;
+    size_t highestPriorityPendingIonCompile();
+    void cancelStaleIonCompiles();
+
     uint32_t harvestFailedAsmJSJobs() {
         JS_ASSERT(isLocked());
         uint32_t n = numAsmJSFailedJobs;
@@ -127,6 +138,7 @@ class WorkerThreadState
     }
 
     JSScript *finishParseTask(JSContext *maybecx, JSRuntime *rt, void *token);
+    bool finishParseTaskBatch(JSContext *cx, void *token, AutoScriptVector &scripts);
     bool compressionInProgress(SourceCompressionTask *task);
     SourceCompressionTask *compressionTaskForSource(ScriptSource *ss);
 
@@ -175,6 +187,11 @@ struct WorkerThread
     /* Any builder currently being compiled by Ion on this thread. */
     jit::IonBuilder *ionBuilder;
 
+#if JS_TRACE_LOGGING
+    /* Which of the Ion compiler trace loggers ionBuilder is logging to. */
+    size_t ionLoggerSlot;
+#endif
+
     /* Any AsmJS data currently being optimized by Ion on this thread. */
     AsmJSParallelTask *asmData;
 
@@ -238,6 +255,16 @@ StartOffThreadParseScript(JSContext *cx, const ReadOnlyCompileOptions &options,
                           const jschar *chars, size_t length, HandleObject scopeChain,
                           JS::OffThreadCompileCallback callback, void *callbackData);
 
+/*
+ * Start parse/emit cycles for several streams of source at once, which may
+ * run concurrently on all worker threads. The callback is invoked once, after
+ * all of them have finished.
+ */
+bool
+StartOffThreadParseScripts(JSContext *cx, const JS::OffThreadCompileSource *sources,
+                           size_t count, HandleObject scopeChain,
+                           JS::OffThreadCompileCallback callback, void *callbackData);
+
 /*
  * Called at the end of GC to enqueue any Parse tasks that were waiting on an
  * atoms-zone GC to finish.
@@ -351,6 +378,14 @@ struct ParseTask
     JS::OffThreadCompileCallback callback;
     void *callbackData;
 
+    // For tasks started together by StartOffThreadParseScripts, the first
+    // task of the batch and the next one. The callback and token of the batch
+    // are those of its first task, which also counts the tasks of the batch
+    // that have not finished yet, under the worker thread state lock.
+    ParseTask *batchHead;
+    ParseTask *batchNext;
+    size_t batchPending;
+
     // Holds the final script between the invocation of the callback and the
     // point where FinishOffThreadScript is called, which will destroy the
     // ParseTask.
@@ -389,6 +424,7 @@ struct SourceCompressionTask
 
     ScriptSource *ss;
     const jschar *chars;
+    SourceCompression codec;
     bool oom;
 
     // Atomic flag to indicate to a worker thread that it should abort
@@ -401,7 +437,8 @@ struct SourceCompressionTask
 
   public:
     explicit SourceCompressionTask(ExclusiveContext *cx)
-      : cx(cx), ss(nullptr), chars(nullptr), oom(false), abort_(0)
+      : cx(cx), ss(nullptr), chars(nullptr), codec(SourceCompression_None), oom(false),
+        abort_(0)
     {
 #ifdef JS_THREADSAFE
         workerThread = nullptr;
@@ -420,6 +457,14 @@ struct SourceCompressionTask
     ScriptSource *source() { return ss; }
     const jschar *uncompressedChars() { return chars; }
     void setOOM() { oom = true; }
+
+  private:
+    // Compress the source into ss->data, setting |*compressedLength| to zero
+    // if compression did not pay off or was aborted.
+    bool compressLZ4(size_t nbytes, size_t *compressedLength);
+#ifdef USE_ZLIB
+    bool compressZlib(size_t nbytes, size_t *compressedLength);
+#endif
 };
 
 } /* namespace js */
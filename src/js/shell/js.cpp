@@ -69,6 +69,7 @@
 #include "vm/ArgumentsObject.h"
 #include "vm/Monitor.h"
 #include "vm/Shape.h"
+#include "vm/SharedArrayObject.h"
 #include "vm/TypedArrayObject.h"
 #include "vm/WrapperObject.h"
 
@@ -127,6 +128,7 @@ static bool printTiming = false;
 static const char *jsCacheDir = nullptr;
 static const char *jsCacheAsmJSPath = nullptr;
 mozilla::Atomic<int32_t> jsCacheOpened(false);
+static const char *bytecodeCacheDir = nullptr;
 
 static bool
 SetTimeoutValue(JSContext *cx, double t);
@@ -3434,6 +3436,105 @@ ReadRelativeToScript(JSContext *cx, unsigned argc, jsval *vp)
     return ReadFile(cx, argc, vp, true);
 }
 
+struct JSONStreamShellData
+{
+    HandleValue fun;
+    explicit JSONStreamShellData(HandleValue fun) : fun(fun) {}
+};
+
+static bool
+JSONStreamShellCallback(JSContext *cx, HandleValue value, void *data)
+{
+    JSONStreamShellData *shellData = static_cast<JSONStreamShellData *>(data);
+    RootedValue arg(cx, value);
+    RootedValue rval(cx);
+    return JS_CallFunctionValue(cx, nullptr, shellData->fun, 1, arg.address(), rval.address());
+}
+
+class AutoDestroyJSONStreamParser
+{
+    JSONStreamParser *parser;
+
+  public:
+    explicit AutoDestroyJSONStreamParser(JSONStreamParser *parser) : parser(parser) {}
+    ~AutoDestroyJSONStreamParser() { JS_DestroyJSONStreamParser(parser); }
+};
+
+static bool
+FeedJSONStreamString(JSContext *cx, JSONStreamParser *parser, JSString *str)
+{
+    JSAutoByteString bytes;
+    if (!bytes.encodeUtf8(cx, str))
+        return false;
+    return JS_FeedJSONStreamParser(cx, parser, bytes.ptr(), strlen(bytes.ptr()));
+}
+
+static bool
+ParseJSONStream(JSContext *cx, unsigned argc, jsval *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    if (args.length() < 2 || !args[1].isObject() || !JS_ObjectIsCallable(cx, &args[1].toObject()) ||
+        !(args[0].isString() || args[0].isObject()))
+    {
+        JS_ReportErrorNumber(cx, my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                             "parseJSONStream");
+        return false;
+    }
+
+    unsigned flags = (args.length() > 2 && ToBoolean(args[2])) ? JSON_STREAM_ARRAY_ELEMENTS : 0;
+    JSONStreamShellData data(args[1]);
+    JSONStreamParser *parser = JS_NewJSONStreamParser(cx, flags, JSONStreamShellCallback, &data);
+    if (!parser)
+        return false;
+    AutoDestroyJSONStreamParser autoDestroy(parser);
+
+    if (args[0].isString()) {
+        RootedString path(cx, args[0].toString());
+        RootedString str(cx, ResolvePath(cx, path, false));
+        if (!str)
+            return false;
+        JSAutoByteString filename(cx, str);
+        if (!filename)
+            return false;
+
+        FILE *file = fopen(filename.ptr(), "rb");
+        if (!file) {
+            JS_ReportError(cx, "can't open %s: %s", filename.ptr(), strerror(errno));
+            return false;
+        }
+        AutoCloseInputFile autoClose(file);
+
+        char buf[64 * 1024];
+        size_t cc;
+        while ((cc = fread(buf, 1, sizeof(buf), file)) > 0) {
+            if (!JS_FeedJSONStreamParser(cx, parser, buf, cc))
+                return false;
+        }
+        if (ferror(file)) {
+            JS_ReportError(cx, "can't read %s: %s", filename.ptr(), strerror(errno));
+            return false;
+        }
+    } else {
+        RootedObject chunks(cx, &args[0].toObject());
+        uint32_t length;
+        if (!JS_GetArrayLength(cx, chunks, &length))
+            return false;
+        RootedValue chunk(cx);
+        for (uint32_t i = 0; i < length; i++) {
+            if (!JS_GetElement(cx, chunks, i, &chunk))
+                return false;
+            JSString *str = ToString(cx, chunk);
+            if (!str || !FeedJSONStreamString(cx, parser, str))
+                return false;
+        }
+    }
+
+    if (!JS_FinishJSONStreamParser(cx, parser))
+        return false;
+    args.rval().setUndefined();
+    return true;
+}
+
 static bool
 redirect(JSContext *cx, FILE* fp, HandleString relFilename)
 {
@@ -3846,6 +3947,179 @@ NewGlobal(JSContext *cx, unsigned argc, jsval *vp)
     return true;
 }
 
+#ifdef JS_THREADSAFE
+
+/*
+ * Workers: evalInWorker(code) runs |code| on a new thread, in a runtime of
+ * its own. Workers share nothing with the main thread but SharedArrayBuffers,
+ * which are passed through a one-element mailbox. All workers are joined
+ * before the shell exits.
+ */
+
+static PRLock *gWorkersLock = nullptr;
+static Vector<PRThread *, 0, SystemAllocPolicy> gWorkerThreads;
+static js::SharedArrayRawBuffer *gSharedArrayBufferMailbox = nullptr;
+
+struct WorkerInput
+{
+    jschar *chars;
+    size_t length;
+};
+
+static void
+WorkerMain(void *arg)
+{
+    WorkerInput *input = static_cast<WorkerInput *>(arg);
+
+    JSRuntime *rt = JS_NewRuntime(8L * 1024L * 1024L, JS_NO_HELPER_THREADS);
+    if (!rt) {
+        js_free(input->chars);
+        js_delete(input);
+        return;
+    }
+    JS_SetNativeStackQuota(rt, gMaxStackSize);
+
+    JSContext *cx = NewContext(rt);
+    if (cx) {
+        {
+            JSAutoRequest ar(cx);
+            JS::CompartmentOptions compartmentOptions;
+            compartmentOptions.setVersion(JSVERSION_LATEST);
+            RootedObject global(cx, NewGlobalObject(cx, compartmentOptions));
+            if (global) {
+                JSAutoCompartment ac(cx, global);
+                jsval rval;
+                if (!JS_EvaluateUCScript(cx, global, input->chars, input->length,
+                                         "evalInWorker", 1, &rval))
+                {
+                    JS_ReportPendingException(cx);
+                }
+            }
+        }
+        DestroyContext(cx, true);
+    }
+
+    JS_DestroyRuntime(rt);
+    js_free(input->chars);
+    js_delete(input);
+}
+
+static bool
+EvalInWorker(JSContext *cx, unsigned argc, jsval *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    if (!args.get(0).isString()) {
+        JS_ReportError(cx, "Invalid arguments to evalInWorker");
+        return false;
+    }
+
+    JSString *str = args[0].toString();
+    const jschar *chars = JS_GetStringCharsZ(cx, str);
+    if (!chars)
+        return false;
+    size_t length = JS_GetStringLength(str);
+
+    WorkerInput *input = js_new<WorkerInput>();
+    if (!input) {
+        JS_ReportOutOfMemory(cx);
+        return false;
+    }
+    input->length = length;
+    input->chars = js_pod_malloc<jschar>(length);
+    if (!input->chars) {
+        js_delete(input);
+        JS_ReportOutOfMemory(cx);
+        return false;
+    }
+    PodCopy(input->chars, chars, length);
+
+    PR_Lock(gWorkersLock);
+    bool ok = gWorkerThreads.reserve(gWorkerThreads.length() + 1);
+    PRThread *thread = nullptr;
+    if (ok) {
+        thread = PR_CreateThread(PR_USER_THREAD, WorkerMain, input, PR_PRIORITY_NORMAL,
+                                 PR_GLOBAL_THREAD, PR_JOINABLE_THREAD,
+                                 gMaxStackSize + 128 * 1024);
+        if (thread)
+            gWorkerThreads.infallibleAppend(thread);
+    }
+    PR_Unlock(gWorkersLock);
+
+    if (!thread) {
+        js_free(input->chars);
+        js_delete(input);
+        JS_ReportError(cx, "Failed to start worker thread");
+        return false;
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
+static void
+JoinWorkers()
+{
+    for (;;) {
+        PR_Lock(gWorkersLock);
+        PRThread *thread = gWorkerThreads.empty() ? nullptr : gWorkerThreads.popCopy();
+        PR_Unlock(gWorkersLock);
+        if (!thread)
+            break;
+        PR_JoinThread(thread);
+    }
+}
+
+static bool
+SetSharedArrayBuffer(JSContext *cx, unsigned argc, jsval *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    js::SharedArrayRawBuffer *raw = nullptr;
+    if (args.get(0).isObject() && args[0].toObject().is<SharedArrayBufferObject>()) {
+        raw = args[0].toObject().as<SharedArrayBufferObject>().rawBufferObject();
+        raw->addReference();
+    } else if (!args.get(0).isNull()) {
+        JS_ReportError(cx, "Only a SharedArrayBuffer or null can be passed to setSharedArrayBuffer");
+        return false;
+    }
+
+    PR_Lock(gWorkersLock);
+    js::SharedArrayRawBuffer *old = gSharedArrayBufferMailbox;
+    gSharedArrayBufferMailbox = raw;
+    PR_Unlock(gWorkersLock);
+
+    if (old)
+        old->dropReference();
+    args.rval().setUndefined();
+    return true;
+}
+
+static bool
+GetSharedArrayBuffer(JSContext *cx, unsigned argc, jsval *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    PR_Lock(gWorkersLock);
+    js::SharedArrayRawBuffer *raw = gSharedArrayBufferMailbox;
+    if (raw)
+        raw->addReference();
+    PR_Unlock(gWorkersLock);
+
+    if (!raw) {
+        args.rval().setNull();
+        return true;
+    }
+
+    JSObject *obj = SharedArrayBufferObject::New(cx, raw);
+    raw->dropReference();
+    if (!obj)
+        return false;
+    args.rval().setObject(*obj);
+    return true;
+}
+
+#endif // JS_THREADSAFE
+
 static bool
 EnableStackWalkingAssertion(JSContext *cx, unsigned argc, jsval *vp)
 {
@@ -4218,6 +4492,14 @@ static const JSFunctionSpecWithHelp shell_functions[] = {
 "  Read filename into returned string. Filename is relative to the directory\n"
 "  containing the current script."),
 
+    JS_FN_HELP("parseJSONStream", ParseJSONStream, 2, 0,
+"parseJSONStream(source, callback, [arrayElements])",
+"  Parse JSON text incrementally, calling callback with each top-level value\n"
+"  as soon as it is complete. source is either a filename, read in chunks,\n"
+"  or an array of strings fed to the parser one at a time. If arrayElements\n"
+"  is true, source must hold a single array and callback is called with each\n"
+"  of its elements."),
+
     JS_FN_HELP("compile", Compile, 1, 0,
 "compile(code)",
 "  Compiles a string to bytecode, potentially throwing."),
@@ -4241,6 +4523,23 @@ static const JSFunctionSpecWithHelp shell_functions[] = {
 "  throw the appropriate exception; otherwise, run the script and return\n"
                "  its value."),
 
+#endif
+
+#ifdef JS_THREADSAFE
+    JS_FN_HELP("evalInWorker", EvalInWorker, 1, 0,
+"evalInWorker(code)",
+"  Evaluate 'code' on a new thread, in a separate runtime."),
+
+    JS_FN_HELP("setSharedArrayBuffer", SetSharedArrayBuffer, 1, 0,
+"setSharedArrayBuffer(sab)",
+"  Put the SharedArrayBuffer 'sab', or null, in the mailbox shared by all\n"
+"  workers."),
+
+    JS_FN_HELP("getSharedArrayBuffer", GetSharedArrayBuffer, 0, 0,
+"getSharedArrayBuffer()",
+"  Return a new SharedArrayBuffer object for the buffer in the mailbox, or\n"
+"  null if it is empty."),
+
 #endif
 
     JS_FN_HELP("timeout", Timeout, 1, 0,
@@ -5252,6 +5551,105 @@ static JS::AsmJSCacheOps asmJSCacheOps = {
     ShellBuildId
 };
 
+// Each bytecode cache entry lives in its own file, named after its key, in the
+// directory given by --bytecode-cache. Entries are mapped read-only and
+// decoded in place.
+static bool
+ShellOpenBytecodeCacheEntryForRead(const char *key, size_t *sizeOut, const uint8_t **memoryOut,
+                                   intptr_t *handleOut)
+{
+    char *path = JS_smprintf("%s/%s.jsbc", bytecodeCacheDir, key);
+    if (!path)
+        return false;
+    int fd = open(path, O_RDONLY);
+    JS_smprintf_free(path);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file contents alive after the descriptor is closed.
+    void *memory;
+#ifdef XP_WIN
+    HANDLE fdOsHandle = (HANDLE)_get_osfhandle(fd);
+    HANDLE fileMapping = CreateFileMapping(fdOsHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    memory = fileMapping ? MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (fileMapping)
+        CloseHandle(fileMapping);
+    close(fd);
+    if (!memory)
+        return false;
+#else
+    memory = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+#endif
+
+    *sizeOut = st.st_size;
+    *memoryOut = (const uint8_t *)memory;
+    *handleOut = 0;
+    return true;
+}
+
+static void
+ShellCloseBytecodeCacheEntryForRead(size_t size, const uint8_t *memory, intptr_t handle)
+{
+#ifdef XP_WIN
+    UnmapViewOfFile(const_cast<uint8_t*>(memory));
+#else
+    munmap(const_cast<uint8_t*>(memory), size);
+#endif
+}
+
+static void
+ShellWriteBytecodeCacheEntry(const char *key, const uint8_t *memory, size_t size)
+{
+    // Create the cache directory if it doesn't already exist.
+    struct stat dirStat;
+    if (stat(bytecodeCacheDir, &dirStat) == 0) {
+        if (!(dirStat.st_mode & S_IFDIR))
+            return;
+    } else {
+#ifdef XP_WIN
+        if (mkdir(bytecodeCacheDir) != 0)
+            return;
+#else
+        if (mkdir(bytecodeCacheDir, 0777) != 0)
+            return;
+#endif
+    }
+
+    // Write the entry under a per-process name and rename it into place, so
+    // that shells sharing the directory never map a partially written entry.
+    char *tmpPath = JS_smprintf("%s/%s.%u.tmp", bytecodeCacheDir, key, (unsigned)getpid());
+    char *path = JS_smprintf("%s/%s.jsbc", bytecodeCacheDir, key);
+    if (tmpPath && path) {
+        bool ok = false;
+        if (FILE *fp = fopen(tmpPath, "wb")) {
+            ok = fwrite(memory, 1, size, fp) == size;
+            ok = fclose(fp) == 0 && ok;
+        }
+        if (!ok || rename(tmpPath, path) != 0)
+            unlink(tmpPath);
+    }
+    if (tmpPath)
+        JS_smprintf_free(tmpPath);
+    if (path)
+        JS_smprintf_free(path);
+}
+
+static JS::BytecodeCacheOps bytecodeCacheOps = {
+    ShellOpenBytecodeCacheEntryForRead,
+    ShellCloseBytecodeCacheEntryForRead,
+    ShellWriteBytecodeCacheEntry,
+    ShellBuildId
+};
+
 /*
  * Avoid a reentrancy hazard.
  *
@@ -5433,6 +5831,10 @@ ProcessArgs(JSContext *cx, JSObject *obj_, OptionParser *op)
         jsCacheAsmJSPath = JS_smprintf("%s/asmjs.cache", jsCacheDir);
     }
 
+    bytecodeCacheDir = op->getStringOption("bytecode-cache");
+    if (bytecodeCacheDir)
+        JS::SetBytecodeCacheOps(cx->runtime(), &bytecodeCacheOps);
+
     if (op->getBoolOption('b'))
         printTiming = true;
 
@@ -5775,6 +6177,9 @@ main(int argc, char **argv, char **envp)
                                "the cache directory specified by --js-cache. This cache directory "
                                "will be removed when the js shell exits. This is useful for running "
                                "tests in parallel.")
+        || !op.addStringOption('\0', "bytecode-cache", "[path]",
+                               "Cache the bytecode of compiled scripts in the directory at [path] "
+                               "and reuse it when the same source is compiled again")
 #ifdef DEBUG
         || !op.addBoolOption('O', "print-alloc", "Print the number of allocations at exit")
 #endif
@@ -5936,6 +6341,10 @@ main(int argc, char **argv, char **envp)
 #ifdef JS_THREADSAFE
     if (!offThreadState.init())
         return 1;
+
+    gWorkersLock = PR_NewLock();
+    if (!gWorkersLock)
+        return 1;
 #endif
 
     if (!InitWatchdog(rt))
@@ -5964,6 +6373,13 @@ main(int argc, char **argv, char **envp)
 
     KillWatchdog();
 
+#ifdef JS_THREADSAFE
+    JoinWorkers();
+    if (gSharedArrayBufferMailbox)
+        gSharedArrayBufferMailbox->dropReference();
+    PR_DestroyLock(gWorkersLock);
+#endif
+
     JS_DestroyRuntime(rt);
     JS_ShutDown();
     return result;
@@ -0,0 +1,67 @@
+// Any copyright is dedicated to the Public Domain.
+// http://creativecommons.org/licenses/publicdomain/
+
+var gTestfile = 'stringify-shape-members.js';
+//-----------------------------------------------------------------------------
+var summary = "Plain objects and dense arrays stringify like any other object";
+
+print(summary);
+
+/**************
+ * BEGIN TEST *
+ **************/
+
+// Objects sharing a shape, in enumeration order, with names needing escapes.
+var objs = [];
+for (var i = 0; i < 5; i++)
+  objs.push({ b: i, a: "s" + i, "q\"\n\u0001": null, f: function() {}, u: undefined });
+assertEq(JSON.stringify(objs[4]), '{"b":4,"a":"s4","q\\"\\n\\u0001":null}');
+assertEq(JSON.stringify(objs, null, 1).split("\n").length, 27);
+
+// Non-enumerable properties are skipped; getters are called.
+var o = { x: 1, get y() { return 2; } };
+Object.defineProperty(o, "hidden", { value: 3, enumerable: false });
+assertEq(JSON.stringify(o), '{"x":1,"y":2}');
+
+// A toJSON call may reshape the object being written.
+var m = { a: { toJSON: function() { delete m.b; m.c = 4; m.d = 5; return 1; } }, b: 2, c: 3 };
+assertEq(JSON.stringify(m), '{"a":1,"c":4}');
+
+// toJSON is still found on prototypes, even when added later.
+var plain = { p: { q: 1 } };
+assertEq(JSON.stringify(plain), '{"p":{"q":1}}');
+Object.prototype.toJSON = function() { return "proto"; };
+assertEq(JSON.stringify(plain), '"proto"');
+delete Object.prototype.toJSON;
+Array.prototype.toJSON = function() { return this.length; };
+assertEq(JSON.stringify({ a: [1, 2, 3] }), '{"a":3}');
+delete Array.prototype.toJSON;
+
+// Holes in dense arrays are looked up on the prototype.
+Array.prototype[1] = "inherited";
+assertEq(JSON.stringify([0, , 2]), '[0,"inherited",2]');
+delete Array.prototype[1];
+assertEq(JSON.stringify([0, , 2]), '[0,null,2]');
+
+// Objects without a prototype don't write an own __proto__ property.
+var bare = Object.create(null);
+bare.x = 1;
+assertEq(JSON.stringify(bare), '{"x":1}');
+
+// Escapes are found anywhere in long strings.
+for (var len = 0; len < 40; len++) {
+  var base = Array(len + 1).join("a");
+  for (var pos = 0; pos <= len; pos++) {
+    var str = base.slice(0, pos) + "\"" + base.slice(pos) + "\u001f \\";
+    assertEq(JSON.stringify(str), JSON.stringify(str.split("")).replace(/","/g, "").slice(1, -1));
+    assertEq(JSON.parse(JSON.stringify(str)), str);
+  }
+}
+assertEq(JSON.stringify("\uffff\u8000\"\\\u0000"), '"\uffff\u8000\\"\\\\\\u0000"');
+
+/******************************************************************************/
+
+if (typeof reportCompare === "function")
+  reportCompare(true, true);
+
+print("Tests complete");
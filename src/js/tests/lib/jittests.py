@@ -128,7 +128,7 @@ class Test:
                             print("warning: couldn't parse exit status %s" % value)
                     elif name == 'thread-count':
                         try:
-                            test.jitflags.append('--thread-count=' + int(value, 0));
+                            test.jitflags.append('--thread-count=%d' % int(value, 0));
                         except ValueError:
                             print("warning: couldn't parse thread-count %s" % value)
                     else:
@@ -0,0 +1,200 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/BytecodeCache.h"
+
+#include "mozilla/Endian.h"
+#include "mozilla/SHA1.h"
+
+#include "jscntxt.h"
+#include "jscompartment.h"
+#include "jsscript.h"
+
+#include "frontend/BytecodeCompiler.h"
+#include "vm/Xdr.h"
+
+#include "jsobjinlines.h"
+
+using namespace js;
+
+using mozilla::LittleEndian;
+using mozilla::SHA1Sum;
+
+/* Each entry starts with the length of the XDR data following it. */
+static const size_t EntryHeaderLength = sizeof(uint32_t);
+
+/* A SHA-1 digest in hex, plus the terminating '\0'. */
+static const size_t KeyLength = 2 * SHA1Sum::HashSize + 1;
+
+static void
+HashUint32(SHA1Sum &sum, uint32_t u)
+{
+    sum.update(&u, sizeof(u));
+}
+
+static void
+HashBytes(SHA1Sum &sum, const void *bytes, size_t length)
+{
+    /* SHA1Sum::update takes a 32-bit length. */
+    const uint8_t *p = static_cast<const uint8_t *>(bytes);
+    while (length > 0) {
+        uint32_t n = uint32_t(Min(length, size_t(UINT32_MAX)));
+        sum.update(p, n);
+        p += n;
+        length -= n;
+    }
+}
+
+static bool
+ComputeKey(JSContext *cx, HandleObject scopeChain, const ReadOnlyCompileOptions &options,
+           const jschar *chars, size_t length, char (&key)[KeyLength])
+{
+    JS::BuildIdCharVector buildId;
+    if (JS::BuildIdOp op = cx->runtime()->bytecodeCacheOps.buildId) {
+        if (!op(&buildId)) {
+            js_ReportOutOfMemory(cx);
+            return false;
+        }
+    }
+
+    SHA1Sum sum;
+    HashUint32(sum, XDR_BYTECODE_VERSION);
+    HashUint32(sum, buildId.length());
+    HashBytes(sum, buildId.begin(), buildId.length());
+
+    /*
+     * Hash every option which is baked into the script or changes the
+     * bytecode we emit. Compile-and-go scripts also depend on whether they
+     * are compiled against the global, which selects the GNAME ops.
+     */
+    uint32_t flags = (options.compileAndGo << 0) |
+                     (options.noScriptRval << 1) |
+                     (options.canLazilyParse << 2) |
+                     (options.strictOption << 3) |
+                     (options.extraWarningsOption << 4) |
+                     (options.werrorOption << 5) |
+                     (options.asmJSOption << 6) |
+                     ((scopeChain && scopeChain == &scopeChain->global()) << 7) |
+                     (uint32_t(options.sourcePolicy) << 8);
+    HashUint32(sum, flags);
+    HashUint32(sum, uint32_t(options.version));
+    HashUint32(sum, options.lineno);
+    HashUint32(sum, options.column);
+
+    const char *filename = options.filename() ? options.filename() : "";
+    HashBytes(sum, filename, strlen(filename) + 1);
+
+    const jschar *sourceMapURL = options.sourceMapURL();
+    size_t sourceMapURLLength = sourceMapURL ? js_strlen(sourceMapURL) : 0;
+    HashUint32(sum, uint32_t(sourceMapURLLength));
+    HashBytes(sum, sourceMapURL, sourceMapURLLength * sizeof(jschar));
+
+    HashBytes(sum, chars, length * sizeof(jschar));
+
+    SHA1Sum::Hash hash;
+    sum.finish(hash);
+
+    static const char hexDigits[] = "0123456789abcdef";
+    for (size_t i = 0; i < SHA1Sum::HashSize; i++) {
+        key[2 * i] = hexDigits[hash[i] >> 4];
+        key[2 * i + 1] = hexDigits[hash[i] & 0xf];
+    }
+    key[KeyLength - 1] = '\0';
+    return true;
+}
+
+static JSScript *
+DecodeEntry(JSContext *cx, const ReadOnlyCompileOptions &options,
+            const uint8_t *memory, size_t size)
+{
+    /* Entries which were truncated on their way to or from disk are misses. */
+    if (size < EntryHeaderLength || size - EntryHeaderLength > size_t(UINT32_MAX))
+        return nullptr;
+    uint32_t dataLength = LittleEndian::readUint32(memory);
+    if (dataLength != size - EntryHeaderLength)
+        return nullptr;
+
+    XDRDecoder decoder(cx, memory + EntryHeaderLength, dataLength,
+                       options.principals(), options.originPrincipals());
+    RootedScript script(cx);
+    if (!decoder.codeScript(&script)) {
+        /* Let the caller recompile and overwrite the bad entry. */
+        cx->clearPendingException();
+        return nullptr;
+    }
+    return script;
+}
+
+static void
+EncodeEntry(JSContext *cx, HandleScript scriptArg, const char *key)
+{
+    XDREncoder encoder(cx);
+
+    /* Reserve the header, which is filled in once the length is known. */
+    uint32_t dataLength = 0;
+    if (!encoder.codeUint32(&dataLength))
+        return;
+
+    RootedScript script(cx, scriptArg);
+    if (!encoder.codeScript(&script)) {
+        /*
+         * Scripts which can't be encoded, for example because they contain an
+         * asm.js module, are compiled from source every time.
+         */
+        cx->clearPendingException();
+        return;
+    }
+
+    uint32_t length;
+    uint8_t *data = static_cast<uint8_t *>(const_cast<void *>(encoder.getData(&length)));
+    LittleEndian::writeUint32(data, length - EntryHeaderLength);
+    cx->runtime()->bytecodeCacheOps.writeEntry(key, data, length);
+}
+
+bool
+js::CanUseBytecodeCache(JSContext *cx, const ReadOnlyCompileOptions &options)
+{
+    const JS::BytecodeCacheOps &ops = cx->runtime()->bytecodeCacheOps;
+    return ops.openEntryForRead &&
+           ops.writeEntry &&
+           !options.forEval &&
+           !options.selfHostingMode &&
+           !options.element() &&
+           !cx->compartment()->debugMode();
+}
+
+JSScript *
+js::CompileScriptWithBytecodeCache(JSContext *cx, HandleObject scopeChain,
+                                   const ReadOnlyCompileOptions &options,
+                                   const jschar *chars, size_t length)
+{
+    JS_ASSERT(CanUseBytecodeCache(cx, options));
+    const JS::BytecodeCacheOps &ops = cx->runtime()->bytecodeCacheOps;
+
+    char key[KeyLength];
+    if (!ComputeKey(cx, scopeChain, options, chars, length, key))
+        return nullptr;
+
+    size_t size;
+    const uint8_t *memory;
+    intptr_t handle;
+    if (ops.openEntryForRead(key, &size, &memory, &handle)) {
+        RootedScript script(cx, DecodeEntry(cx, options, memory, size));
+        ops.closeEntryForRead(size, memory, handle);
+        if (script) {
+            frontend::MaybeCallSourceHandler(cx, options, chars, length);
+            return script;
+        }
+    }
+
+    RootedScript script(cx, frontend::CompileScript(cx, &cx->tempLifoAlloc(), scopeChain,
+                                                    NullPtr(), options, chars, length));
+    if (!script)
+        return nullptr;
+
+    EncodeEntry(cx, script, key);
+    return script;
+}
@@ -0,0 +1,36 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_BytecodeCache_h
+#define vm_BytecodeCache_h
+
+#include "NamespaceImports.h"
+
+namespace js {
+
+/*
+ * Whether JS::Compile should go through the embedding's bytecode cache (see
+ * JS::SetBytecodeCacheOps). Compilations whose result depends on more than
+ * the source and the compile options -- eval and self-hosted code, scripts
+ * attached to an element -- and compilations the debugger observes always
+ * start from source.
+ */
+bool
+CanUseBytecodeCache(JSContext *cx, const ReadOnlyCompileOptions &options);
+
+/*
+ * Compile |chars| like frontend::CompileScript, but decode the script from
+ * the bytecode cache on a hit and add the compiled script to the cache on a
+ * miss.
+ */
+JSScript *
+CompileScriptWithBytecodeCache(JSContext *cx, HandleObject scopeChain,
+                               const ReadOnlyCompileOptions &options,
+                               const jschar *chars, size_t length);
+
+} /* namespace js */
+
+#endif /* vm_BytecodeCache_h */
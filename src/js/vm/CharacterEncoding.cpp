@@ -85,6 +85,23 @@ DeflateStringToUTF8Buffer(js::ThreadSafeContext *cx, const jschar *src, size_t s
     size_t origDstlen = dstlen;
 
     while (srclen) {
+        /*
+         * Copy runs of ASCII chars directly: they need neither surrogate
+         * handling nor per-char space checks beyond the run length.
+         */
+        size_t asciiRun = 0;
+        size_t asciiMax = js::Min(srclen, dstlen);
+        while (asciiRun < asciiMax && src[asciiRun] < 0x80) {
+            dst[asciiRun] = char(src[asciiRun]);
+            asciiRun++;
+        }
+        src += asciiRun;
+        dst += asciiRun;
+        srclen -= asciiRun;
+        dstlen -= asciiRun;
+        if (!srclen)
+            break;
+
         uint32_t v;
         jschar c = *src++;
         srclen--;
@@ -75,6 +75,9 @@
     macro(float64, float64, "float64") \
     macro(format, format, "format") \
     macro(from, from, "from") \
+    macro(futexNotEqual, futexNotEqual, "not-equal") \
+    macro(futexOK, futexOK, "ok") \
+    macro(futexTimedOut, futexTimedOut, "timed-out") \
     macro(get, get, "get") \
     macro(getInternals, getInternals, "getInternals") \
     macro(getOwnPropertyDescriptor, getOwnPropertyDescriptor, "getOwnPropertyDescriptor") \
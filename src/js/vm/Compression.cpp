@@ -6,10 +6,126 @@
 
 #include "vm/Compression.h"
 
+#include "mozilla/Compression.h"
+
+#include <string.h>
+
+#include "jspubtd.h"
+#include "jsutil.h"
+
 #include "js/Utility.h"
 
 using namespace js;
 
+using mozilla::Compression::LZ4;
+
+JS_STATIC_ASSERT(LZ4Compressor::CHUNK_SIZE % sizeof(jschar) == 0);
+
+static const size_t LZ4_TABLE_ENTRY_SIZE = sizeof(uint32_t);
+
+LZ4Compressor::LZ4Compressor(const unsigned char *inp, size_t inplen)
+  : inp(inp),
+    inplen(inplen),
+    out(nullptr),
+    outlen(0),
+    outbytes(0),
+    chunk(0)
+{
+    JS_ASSERT(inplen > 0);
+}
+
+void
+LZ4Compressor::setOutput(unsigned char *out, size_t outlen)
+{
+    JS_ASSERT(outlen > outbytes);
+    this->out = out;
+    this->outlen = outlen;
+}
+
+LZ4Compressor::Status
+LZ4Compressor::compressMore()
+{
+    JS_ASSERT(out);
+
+    size_t nchunks = numChunks(inplen);
+    size_t tableSize = nchunks * LZ4_TABLE_ENTRY_SIZE;
+    JS_ASSERT(chunk < nchunks);
+    if (outlen < tableSize || inplen > UINT32_MAX)
+        return OUTPUT_FULL;
+
+    // Leave room for the offset table behind the compressed chunks.
+    size_t available = outlen - tableSize - outbytes;
+    size_t offset = chunk * CHUNK_SIZE;
+    size_t chunkSize = Min(inplen - offset, CHUNK_SIZE);
+    size_t written = 0;
+    if (available > 0) {
+        written = LZ4::compressLimitedOutput(reinterpret_cast<const char *>(inp + offset),
+                                             chunkSize,
+                                             reinterpret_cast<char *>(out + outbytes),
+                                             available);
+    }
+    if (written == 0)
+        return OUTPUT_FULL;
+    outbytes += written;
+
+    // Record where this chunk ends. The table is filled in as we go and
+    // becomes part of the output once the last chunk is written.
+    uint32_t end = uint32_t(outbytes);
+    memcpy(out + outlen - tableSize + chunk * LZ4_TABLE_ENTRY_SIZE, &end, sizeof(end));
+
+    if (++chunk < nchunks)
+        return CONTINUE;
+
+    // Move the table down so that it immediately follows the last chunk.
+    memmove(out + outbytes, out + outlen - tableSize, tableSize);
+    outbytes += tableSize;
+    return DONE;
+}
+
+static uint32_t
+LZ4ChunkEnd(const unsigned char *table, size_t chunk)
+{
+    uint32_t end;
+    memcpy(&end, table + chunk * LZ4_TABLE_ENTRY_SIZE, sizeof(end));
+    return end;
+}
+
+bool
+js::DecompressLZ4Chunks(const unsigned char *inp, size_t inplen, size_t uncompressedLength,
+                        size_t firstChunk, size_t lastChunk, unsigned char *out)
+{
+    size_t nchunks = LZ4Compressor::numChunks(uncompressedLength);
+    size_t tableSize = nchunks * LZ4_TABLE_ENTRY_SIZE;
+    JS_ASSERT(firstChunk <= lastChunk && lastChunk < nchunks);
+    JS_ASSERT(inplen > tableSize);
+
+    const unsigned char *table = inp + inplen - tableSize;
+    for (size_t chunk = firstChunk; chunk <= lastChunk; chunk++) {
+        size_t start = chunk ? LZ4ChunkEnd(table, chunk - 1) : 0;
+        size_t end = LZ4ChunkEnd(table, chunk);
+        size_t chunkSize = Min(uncompressedLength - chunk * LZ4Compressor::CHUNK_SIZE,
+                               LZ4Compressor::CHUNK_SIZE);
+        size_t decompressed;
+        if (!LZ4::decompress(reinterpret_cast<const char *>(inp + start), end - start,
+                             reinterpret_cast<char *>(out), chunkSize, &decompressed) ||
+            decompressed != chunkSize)
+        {
+            return false;
+        }
+        out += chunkSize;
+    }
+    return true;
+}
+
+bool
+js::DecompressLZ4String(const unsigned char *inp, size_t inplen,
+                        unsigned char *out, size_t outlen)
+{
+    JS_ASSERT(outlen);
+    size_t nchunks = LZ4Compressor::numChunks(outlen);
+    return DecompressLZ4Chunks(inp, inplen, outlen, 0, nchunks - 1, out);
+}
+
 #if USE_ZLIB
 static void *
 zlib_alloc(void *cx, uInt items, uInt size)
@@ -7,14 +7,72 @@
 #ifndef vm_Compression_h
 #define vm_Compression_h
 
-#ifdef USE_ZLIB
+#include "jstypes.h"
 
+#ifdef USE_ZLIB
 #include <zlib.h>
-
-#include "jstypes.h"
+#endif
 
 namespace js {
 
+/*
+ * LZ4 compressor for script sources. The input is compressed as a series of
+ * independent chunks of CHUNK_SIZE bytes each, so that any range of the
+ * original string can be recovered by decompressing only the chunks covering
+ * it. The output is laid out as
+ *
+ *   [chunk 0][chunk 1]...[chunk n - 1][end offset of each chunk (uint32_t)]
+ *
+ * The offset table comes last so that its position can be computed from the
+ * compressed and uncompressed lengths alone.
+ */
+class LZ4Compressor
+{
+  public:
+    /* Must be a multiple of sizeof(jschar) so chunks never split a char. */
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+  private:
+    const unsigned char *inp;
+    size_t inplen;
+    unsigned char *out;
+    size_t outlen;
+    size_t outbytes;
+    size_t chunk;
+
+  public:
+    enum Status {
+        CONTINUE,
+        DONE,
+        /* The output buffer is full; the caller should store the input raw. */
+        OUTPUT_FULL
+    };
+
+    LZ4Compressor(const unsigned char *inp, size_t inplen);
+    void setOutput(unsigned char *out, size_t outlen);
+    size_t outWritten() const { return outbytes; }
+    /* Compress one chunk of the input. Return CONTINUE if there is more. */
+    Status compressMore();
+
+    static size_t numChunks(size_t inplen) {
+        return (inplen + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    }
+};
+
+/*
+ * Decompress chunks [firstChunk, lastChunk] of LZ4Compressor output into
+ * |out|, which must hold their uncompressed size. |uncompressedLength| is the
+ * length of the whole original string.
+ */
+bool DecompressLZ4Chunks(const unsigned char *inp, size_t inplen, size_t uncompressedLength,
+                         size_t firstChunk, size_t lastChunk, unsigned char *out);
+
+/* Decompress all of the LZ4Compressor output |inp| into |out|. */
+bool DecompressLZ4String(const unsigned char *inp, size_t inplen,
+                         unsigned char *out, size_t outlen);
+
+#ifdef USE_ZLIB
+
 class Compressor
 {
     /* Number of bytes we should hand to zlib each compressMore() call. */
@@ -48,7 +106,8 @@ class Compressor
 bool DecompressString(const unsigned char *inp, size_t inplen,
                       unsigned char *out, size_t outlen);
 
+#endif /* USE_ZLIB */
+
 } /* namespace js */
 
-#endif /* USE_ZLIB */
 #endif /* vm_Compression_h */
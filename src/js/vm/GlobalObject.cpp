@@ -14,6 +14,7 @@
 #include "json.h"
 #include "jsweakmap.h"
 
+#include "builtin/AtomicsObject.h"
 #include "builtin/Eval.h"
 #if EXPOSE_INTL_API
 # include "builtin/Intl.h"
@@ -23,6 +24,7 @@
 #include "builtin/RegExp.h"
 #include "builtin/TypedObject.h"
 #include "vm/RegExpStatics.h"
+#include "vm/SharedArrayObject.h"
 
 #include "jscompartmentinlines.h"
 #include "jsobjinlines.h"
@@ -470,6 +472,8 @@ GlobalObject::initStandardClasses(JSContext *cx, Handle<GlobalObject*> global)
            js_InitRegExpClass(cx, global) &&
            js_InitStringClass(cx, global) &&
            js_InitTypedArrayClasses(cx, global) &&
+           js_InitSharedArrayBufferClass(cx, global) &&
+           js_InitAtomicsClass(cx, global) &&
            js_InitIteratorClasses(cx, global) &&
            js_InitDateClass(cx, global) &&
            js_InitWeakMapClass(cx, global) &&
@@ -147,6 +147,26 @@ class VectorMatchPairs : public MatchPairs
     bool allocOrExpandArray(size_t pairCount);
 };
 
+/*
+ * MatchPairs over a buffer filled in by the caller, such as the pairs that
+ * Ion's direct calls into the regexp JIT code write on the stack.
+ */
+class FixedMatchPairs : public MatchPairs
+{
+  public:
+    FixedMatchPairs(MatchPair *pairs, size_t pairCount) {
+        pairs_ = pairs;
+        pairCount_ = pairCount;
+    }
+
+    const MatchPair &operator[](size_t i) const { return pair(i); }
+
+  protected:
+    bool allocOrExpandArray(size_t pairCount) {
+        MOZ_ASSUME_UNREACHABLE("FixedMatchPairs cannot be reallocated");
+    }
+};
+
 /*
  * Passes either MatchPair or MatchPairs through ExecuteRegExp()
  * to avoid duplication of generic code.
@@ -762,7 +762,9 @@ class ObjectElements
 
         // Present only if these elements correspond to an array with
         // non-writable length; never present for non-arrays.
-        NONWRITABLE_ARRAY_LENGTH    = 0x8
+        NONWRITABLE_ARRAY_LENGTH    = 0x8,
+
+        SHARED_ARRAY_BUFFER         = 0x10
     };
 
   private:
@@ -770,6 +772,7 @@ class ObjectElements
     friend class ObjectImpl;
     friend class ArrayObject;
     friend class ArrayBufferObject;
+    friend class SharedArrayRawBuffer;
     friend class TypedArrayObject;
     friend class Nursery;
 
@@ -829,6 +832,12 @@ class ObjectElements
     void setIsNeuteredBuffer() {
         flags |= NEUTERED_BUFFER;
     }
+    bool isSharedArrayBuffer() const {
+        return flags & SHARED_ARRAY_BUFFER;
+    }
+    void setIsSharedArrayBuffer() {
+        flags |= SHARED_ARRAY_BUFFER;
+    }
     bool hasNonwritableArrayLength() const {
         return flags & NONWRITABLE_ARRAY_LENGTH;
     }
@@ -1443,6 +1452,17 @@ class ObjectImpl : public gc::BarrieredCell<ObjectImpl>
 
     void setFixedElements() { this->elements = fixedElements(); }
 
+    /*
+     * Repair pointers into the object itself after a compacting GC has copied
+     * it from |old|.
+     */
+    void fixupAfterMovingGC(ObjectImpl *old) {
+        if (old->hasFixedElements())
+            setFixedElements();
+        if (inDictionaryMode() && shape_->listp == &old->shape_)
+            shape_->listp = &shape_;
+    }
+
     inline bool hasDynamicElements() const {
         /*
          * Note: for objects with zero fixed slots this could potentially give
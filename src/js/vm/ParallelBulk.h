@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_ParallelBulk_h
+#define vm_ParallelBulk_h
+
+#include "mozilla/Move.h"
+
+#include "jscntxt.h"
+
+#include "ds/Sort.h"
+#include "vm/ThreadPool.h"
+
+/*
+ * Native bulk operations over large arrays, run on the runtime's ThreadPool.
+ *
+ * Unlike ForkJoin, these never run script: the work is split into slices of
+ * plain memory, and the operations passed in must not touch the GC heap or
+ * anything else owned by the main thread. Operations below a minimum size,
+ * and all operations in runtimes whose pool has no worker threads, run on the
+ * calling thread.
+ */
+
+namespace js {
+
+/* Sorts of fewer elements than this run on the calling thread. */
+static const size_t ParallelSortMinLength = 64 * 1024;
+
+/* Copies of fewer bytes than this run on the calling thread. */
+static const size_t ParallelCopyMinBytes = 1024 * 1024;
+
+namespace detail {
+
+/* Run |op(sliceId)| for each slice of a job, on all threads of the pool. */
+template<typename SliceOp>
+class ParallelSliceJob : public ParallelJob
+{
+    SliceOp &op_;
+
+  public:
+    explicit ParallelSliceJob(SliceOp &op)
+      : op_(op)
+    { }
+
+    bool executeFromWorker(uint16_t sliceId, uint32_t workerId, uintptr_t stackLimit) {
+        op_(sliceId);
+        return true;
+    }
+
+    bool executeFromMainThread(uint16_t sliceId) {
+        op_(sliceId);
+        return true;
+    }
+};
+
+/*
+ * Run |op| over at least |minSlices| slices. The pool hands each thread the
+ * same number of slices, so the count is rounded up to a multiple of the
+ * thread count and |op| must ignore slices past the ones it needs.
+ */
+template<typename SliceOp>
+static inline bool
+ExecuteSlices(JSContext *cx, SliceOp &op, size_t threads, size_t minSlices)
+{
+    size_t numSlices = ((minSlices + threads - 1) / threads) * threads;
+    JS_ASSERT(numSlices <= UINT16_MAX);
+
+    ParallelSliceJob<SliceOp> job(op);
+    return cx->runtime()->threadPool.executeJob(cx, &job, uint16_t(numSlices)) == TP_SUCCESS;
+}
+
+template<typename RangeOp>
+struct ForEachRangeSlice
+{
+    RangeOp &op;
+    size_t length;
+    size_t chunk;
+
+    ForEachRangeSlice(RangeOp &op, size_t length, size_t chunk)
+      : op(op), length(length), chunk(chunk)
+    { }
+
+    void operator()(uint16_t sliceId) {
+        size_t begin = sliceId * chunk;
+        if (begin < length)
+            op(begin, Min(begin + chunk, length));
+    }
+};
+
+template<typename T, typename Comparator>
+struct SortRunsSlice
+{
+    T *array;
+    T *scratch;
+    size_t nelems;
+    size_t runLength;
+    Comparator c;
+
+    SortRunsSlice(T *array, T *scratch, size_t nelems, size_t runLength, Comparator c)
+      : array(array), scratch(scratch), nelems(nelems), runLength(runLength), c(c)
+    { }
+
+    void operator()(uint16_t sliceId) {
+        size_t begin = sliceId * runLength;
+        if (begin >= nelems)
+            return;
+        size_t len = Min(runLength, nelems - begin);
+        JS_ALWAYS_TRUE(MergeSort(array + begin, len, scratch + begin, c));
+    }
+};
+
+template<typename T, typename Comparator>
+struct MergeRunsSlice
+{
+    const T *src;
+    T *dst;
+    size_t nelems;
+    size_t runLength;
+    Comparator c;
+
+    MergeRunsSlice(const T *src, T *dst, size_t nelems, size_t runLength, Comparator c)
+      : src(src), dst(dst), nelems(nelems), runLength(runLength), c(c)
+    { }
+
+    void operator()(uint16_t sliceId) {
+        size_t begin = sliceId * 2 * runLength;
+        if (begin >= nelems)
+            return;
+        size_t run1 = Min(runLength, nelems - begin);
+        size_t run2 = Min(runLength, nelems - begin - run1);
+        if (run2 == 0)
+            CopyNonEmptyArray(dst + begin, src + begin, run1);
+        else
+            JS_ALWAYS_TRUE(MergeArrayRuns(dst + begin, src + begin, run1, run2, c));
+    }
+};
+
+} /* namespace detail */
+
+/*
+ * Return the number of threads to split an operation on |length| items over,
+ * given the smallest length worth splitting.
+ */
+static inline size_t
+ParallelBulkThreads(JSContext *cx, size_t length, size_t minLength)
+{
+#ifdef JS_THREADSAFE
+    if (length >= minLength)
+        return cx->runtime()->threadPool.numWorkers() + 1;
+#endif
+    return 1;
+}
+
+/*
+ * Call |op(begin, end)| over disjoint ranges covering [0, length), in
+ * parallel if |length| is at least |minLength|.
+ */
+template<typename RangeOp>
+static inline bool
+ParallelForEachRange(JSContext *cx, size_t length, size_t minLength, RangeOp &op)
+{
+    size_t threads = ParallelBulkThreads(cx, length, minLength);
+    if (threads == 1) {
+        if (length)
+            op(0, length);
+        return true;
+    }
+
+    size_t chunk = (length + threads - 1) / threads;
+    detail::ForEachRangeSlice<RangeOp> slice(op, length, chunk);
+    return detail::ExecuteSlices(cx, slice, threads, threads);
+}
+
+/*
+ * Sort |array| as MergeSort does, in parallel for large arrays. |scratch|
+ * must hold |nelems| elements, and |c| must be infallible.
+ *
+ * Each thread merge sorts one run of the array, and then pairs of runs are
+ * merged in parallel rounds until one run is left.
+ */
+template<typename T, typename Comparator>
+static inline bool
+ParallelMergeSort(JSContext *cx, T *array, size_t nelems, T *scratch, Comparator c)
+{
+    size_t threads = ParallelBulkThreads(cx, nelems, ParallelSortMinLength);
+    if (threads == 1) {
+        JS_ALWAYS_TRUE(MergeSort(array, nelems, scratch, c));
+        return true;
+    }
+
+    size_t runLength = (nelems + threads - 1) / threads;
+    detail::SortRunsSlice<T, Comparator> sortRuns(array, scratch, nelems, runLength, c);
+    if (!detail::ExecuteSlices(cx, sortRuns, threads, threads))
+        return false;
+
+    T *src = array;
+    T *dst = scratch;
+    for (; runLength < nelems; runLength *= 2) {
+        size_t merges = (nelems + 2 * runLength - 1) / (2 * runLength);
+        detail::MergeRunsSlice<T, Comparator> mergeRuns(src, dst, nelems, runLength, c);
+        if (!detail::ExecuteSlices(cx, mergeRuns, threads, merges))
+            return false;
+        mozilla::Swap(src, dst);
+    }
+
+    if (src != array)
+        detail::CopyNonEmptyArray(array, src, nelems);
+    return true;
+}
+
+} /* namespace js */
+
+#endif /* vm_ParallelBulk_h */
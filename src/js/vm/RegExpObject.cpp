@@ -47,6 +47,7 @@ RegExpObjectBuilder::getOrCreate()
     if (!obj)
         return false;
     obj->initPrivate(nullptr);
+    JS_ASSERT(obj->numFixedSlots() == RegExpObject::NFIXED_SLOTS);
 
     reobj_ = &obj->as<RegExpObject>();
     return true;
@@ -66,6 +67,7 @@ RegExpObjectBuilder::getOrCreateClone(HandleTypeObject type)
     if (!clone)
         return false;
     clone->initPrivate(nullptr);
+    JS_ASSERT(clone->numFixedSlots() == RegExpObject::NFIXED_SLOTS);
 
     reobj_ = &clone->as<RegExpObject>();
     return true;
@@ -712,6 +714,7 @@ RegExpCompartment::sweep(JSRuntime *rt)
 #endif
 
     map_.clear();
+    resultCache_.purge();
 
     for (PendingSet::Enum e(inUse_); !e.empty(); e.popFront()) {
         RegExpShared *shared = e.front();
@@ -728,11 +731,21 @@ RegExpCompartment::sweep(JSRuntime *rt)
     }
 }
 
+void
+RegExpCompartment::fixupAfterMovingGC()
+{
+    JSObject **objp = matchResultTemplateObject_.unsafeGet();
+    if (*objp && gc::IsForwarded(*objp))
+        *objp = gc::Forwarded(*objp);
+    resultCache_.purge();
+}
+
 void
 RegExpCompartment::clearTables()
 {
     JS_ASSERT(inUse_.empty());
     map_.clear();
+    resultCache_.purge();
 }
 
 bool
@@ -784,6 +797,7 @@ RegExpCompartment::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf)
     size_t n = 0;
     n += map_.sizeOfExcludingThis(mallocSizeOf);
     n += inUse_.sizeOfExcludingThis(mallocSizeOf);
+    n += resultCache_.sizeOfExcludingThis(mallocSizeOf);
     return n;
 }
 
@@ -161,7 +161,6 @@ class RegExpShared
     bool compile(JSContext *cx, JSLinearString &pattern, bool matchOnly);
 
     bool compileIfNecessary(JSContext *cx);
-    bool compileMatchOnlyIfNecessary(JSContext *cx);
 
   public:
     RegExpShared(JSAtom *source, RegExpFlag flags, uint64_t gcNumber);
@@ -202,6 +201,12 @@ class RegExpShared
     RegExpRunStatus executeMatchOnly(JSContext *cx, const jschar *chars, size_t length,
                                      size_t *lastIndex, MatchPair &match);
 
+    /*
+     * Compile for executeMatchOnly ahead of use, for callers that need
+     * getParenCount() to pick between execute and executeMatchOnly.
+     */
+    bool compileMatchOnlyIfNecessary(JSContext *cx);
+
     /* Accessors */
 
     size_t getParenCount() const        { JS_ASSERT(isCompiled()); return parenCount; }
@@ -226,6 +231,18 @@ class RegExpShared
 #endif
     bool hasBytecode() const            { return bytecode != nullptr; }
     bool isCompiled() const             { return hasBytecode() || hasCode() || hasMatchOnlyCode(); }
+
+    /* Offsets for Ion, which calls the JIT code of simple regexps directly. */
+    static size_t offsetOfFlags()       { return offsetof(RegExpShared, flags); }
+    static size_t offsetOfParenCount()  { return offsetof(RegExpShared, parenCount); }
+#if ENABLE_YARR_JIT
+    static size_t offsetOfJitCode() {
+        return offsetof(RegExpShared, codeBlock) + YarrCodeBlock::offsetOf16BitCode();
+    }
+    static size_t offsetOfJitCodeMatchOnly() {
+        return offsetof(RegExpShared, codeBlock) + YarrCodeBlock::offsetOf16BitCodeMatchOnly();
+    }
+#endif
 };
 
 /*
@@ -283,6 +300,106 @@ class RegExpGuard
     RegExpShared &operator*() { return *re(); }
 };
 
+/*
+ * Single-entry caches for the last String.prototype.replace with a replacement
+ * string free of '$' patterns, and the last String.prototype.split by a regexp
+ * without captures. Scripts that apply the same regexp to the same string over
+ * and over get the previous result back without running the regexp again.
+ *
+ * Entries are keyed on the RegExpShared and the identity of the input string,
+ * and remember where the last successful match started so that RegExpStatics
+ * can be updated lazily on a hit. Like the DtoaCache, the entries do not keep
+ * anything alive and are purged on every GC.
+ */
+class RegExpResultCache
+{
+  public:
+    /* Stored as the last match index when the regexp never matched. */
+    static const size_t NoMatch = size_t(-1);
+
+    typedef Vector<Value, 0, SystemAllocPolicy> ValueVector;
+
+  private:
+    struct ReplaceEntry {
+        RegExpShared   *shared;   /* if shared==nullptr, the entry is not valid */
+        JSLinearString *input;
+        JSLinearString *replacement;
+        JSString       *result;
+        size_t         lastMatchIndex;
+    };
+
+    struct SplitEntry {
+        RegExpShared   *shared;   /* if shared==nullptr, the entry is not valid */
+        JSLinearString *input;
+        uint32_t       limit;
+        ValueVector    elements;
+        size_t         lastMatchIndex;
+    };
+
+    ReplaceEntry replace_;
+    SplitEntry split_;
+
+  public:
+    RegExpResultCache() {
+        purge();
+    }
+
+    void purge() {
+        replace_.shared = nullptr;
+        split_.shared = nullptr;
+        split_.elements.clearAndFree();
+    }
+
+    JSString *lookupReplace(RegExpShared *shared, JSLinearString *input,
+                            JSLinearString *replacement, size_t *lastMatchIndex) const
+    {
+        if (replace_.shared != shared || replace_.input != input ||
+            replace_.replacement != replacement)
+        {
+            return nullptr;
+        }
+        *lastMatchIndex = replace_.lastMatchIndex;
+        return replace_.result;
+    }
+
+    void cacheReplace(RegExpShared *shared, JSLinearString *input, JSLinearString *replacement,
+                      JSString *result, size_t lastMatchIndex)
+    {
+        replace_.shared = shared;
+        replace_.input = input;
+        replace_.replacement = replacement;
+        replace_.result = result;
+        replace_.lastMatchIndex = lastMatchIndex;
+    }
+
+    const ValueVector *lookupSplit(RegExpShared *shared, JSLinearString *input, uint32_t limit,
+                                   size_t *lastMatchIndex) const
+    {
+        if (split_.shared != shared || split_.input != input || split_.limit != limit)
+            return nullptr;
+        *lastMatchIndex = split_.lastMatchIndex;
+        return &split_.elements;
+    }
+
+    /* Failing to cache is not an error: the entry is simply left invalid. */
+    void cacheSplit(RegExpShared *shared, JSLinearString *input, uint32_t limit,
+                    const Value *elements, size_t length, size_t lastMatchIndex)
+    {
+        split_.shared = nullptr;
+        split_.elements.clear();
+        if (!split_.elements.append(elements, length))
+            return;
+        split_.shared = shared;
+        split_.input = input;
+        split_.limit = limit;
+        split_.lastMatchIndex = lastMatchIndex;
+    }
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) {
+        return split_.elements.sizeOfExcludingThis(mallocSizeOf);
+    }
+};
+
 class RegExpCompartment
 {
     struct Key {
@@ -325,12 +442,15 @@ class RegExpCompartment
      */
     ReadBarriered<JSObject> matchResultTemplateObject_;
 
+    RegExpResultCache resultCache_;
+
   public:
     RegExpCompartment(JSRuntime *rt);
     ~RegExpCompartment();
 
     bool init(JSContext *cx);
     void sweep(JSRuntime *rt);
+    void fixupAfterMovingGC();
     void clearTables();
 
     bool get(ExclusiveContext *cx, JSAtom *source, RegExpFlag flags, RegExpGuard *g);
@@ -341,6 +461,8 @@ class RegExpCompartment
     /* Get or create template object used to base the result of .exec() on. */
     JSObject *getOrCreateMatchResultTemplateObject(JSContext *cx);
 
+    RegExpResultCache &resultCache() { return resultCache_; }
+
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 };
 
@@ -356,6 +478,12 @@ class RegExpObject : public JSObject
   public:
     static const unsigned RESERVED_SLOTS = 6;
 
+    /*
+     * All RegExp objects have the same number of fixed slots, so jitcode can
+     * find the private RegExpShared pointer without looking at the shape.
+     */
+    static const unsigned NFIXED_SLOTS = 7;
+
     static const Class class_;
 
     /*
@@ -35,6 +35,7 @@
 #include "jit/AsmJSSignalHandlers.h"
 #include "jit/JitCompartment.h"
 #include "jit/PcScriptCache.h"
+#include "vm/SamplingProfiler.h"
 #include "js/MemoryMetrics.h"
 #include "js/SliceBudget.h"
 #include "yarr/BumpPointerAllocator.h"
@@ -77,6 +78,7 @@ PerThreadData::PerThreadData(JSRuntime *runtime)
     suppressGC(0),
 #ifdef DEBUG
     ionCompiling(false),
+    gcMarkingHelper(false),
 #endif
     activeCompilations(0)
 {}
@@ -184,6 +186,9 @@ JSRuntime::JSRuntime(JSUseHelperThreads useHelperThreads)
     gcMaxMallocBytes(0),
     gcNumArenasFreeCommitted(0),
     gcMarker(this),
+#ifdef JS_THREADSAFE
+    gcParallelMarker(nullptr),
+#endif
     gcVerifyPreData(nullptr),
     gcVerifyPostData(nullptr),
     gcChunkAllocationSinceLastGC(false),
@@ -200,6 +205,8 @@ JSRuntime::JSRuntime(JSUseHelperThreads useHelperThreads)
     gcLowFrequencyHeapGrowth(1.5),
     gcDynamicHeapGrowth(false),
     gcDynamicMarkSlice(false),
+    gcParallelMarkingEnabled(false),
+    gcCompactingEnabled(false),
     gcDecommitThreshold(32 * 1024 * 1024),
     gcShouldCleanUpEverything(false),
     gcGrayBitsValid(false),
@@ -216,6 +223,7 @@ JSRuntime::JSRuntime(JSUseHelperThreads useHelperThreads)
     gcIncrementalState(gc::NO_INCREMENTAL),
     gcLastMarkSlice(false),
     gcSweepOnBackgroundThread(false),
+    gcIsCompacting(false),
     gcFoundBlackGrayEdges(false),
     gcSweepingZones(nullptr),
     gcZoneGroupIndex(0),
@@ -260,8 +268,10 @@ JSRuntime::JSRuntime(JSUseHelperThreads useHelperThreads)
     negativeInfinityValue(DoubleValue(NegativeInfinity())),
     positiveInfinityValue(DoubleValue(PositiveInfinity())),
     emptyString(nullptr),
+    sourceCompression(SourceCompression_LZ4),
     debugMode(false),
     spsProfiler(thisFromCtor()),
+    samplingProfiler(nullptr),
     profilingScripts(false),
     alwaysPreserveCode(false),
     hadOutOfMemory(false),
@@ -329,6 +339,7 @@ JSRuntime::JSRuntime(JSUseHelperThreads useHelperThreads)
     PodZero(&atomState);
     PodArrayZero(nativeStackQuota);
     PodZero(&asmJSCacheOps);
+    PodZero(&bytecodeCacheOps);
 
 #if JS_STACK_GROWTH_DIRECTION > 0
     nativeStackLimit = UINTPTR_MAX;
@@ -445,6 +456,9 @@ JSRuntime::~JSRuntime()
     /* Free source hook early, as its destructor may want to delete roots. */
     sourceHook = nullptr;
 
+    /* Stop the sampler thread before it can interrupt a dying runtime. */
+    js_delete(samplingProfiler);
+
     /* Off thread compilation and parsing depend on atoms still existing. */
     for (CompartmentsIter comp(this, SkipAtoms); !comp.done(); comp.next())
         CancelOffThreadIonCompile(comp, nullptr);
@@ -932,6 +946,10 @@ js::CurrentThreadCanAccessRuntime(JSRuntime *rt)
 {
     DebugOnly<PerThreadData *> pt = js::TlsPerThreadData.get();
     JS_ASSERT(pt && pt->associatedWith(rt));
+#ifdef DEBUG
+    if (pt->gcMarkingHelper)
+        return true;
+#endif
     return rt->ownerThread_ == PR_GetCurrentThread() || InExclusiveParallelSection();
 }
 
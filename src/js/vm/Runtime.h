@@ -83,6 +83,7 @@ class Activation;
 class ActivationIterator;
 class AsmJSActivation;
 class MathCache;
+class SamplingProfiler;
 class WorkerThreadState;
 
 namespace jit {
@@ -581,6 +582,10 @@ class PerThreadData : public PerThreadDataFriendFields,
 #ifdef DEBUG
     // Whether this thread is actively Ion compiling.
     bool ionCompiling;
+
+    // Whether this thread is marking for the main thread's GC, which waits
+    // for it. See gc/ParallelMarking.h.
+    bool gcMarkingHelper;
 #endif
 
     // Number of active bytecode compilation on this thread.
@@ -985,6 +990,7 @@ struct JSRuntime : public JS::shadow::Runtime,
     bool isSelfHostingGlobal(js::HandleObject global) {
         return global == selfHostingGlobal_;
     }
+    bool isSelfHostingZone(JS::Zone *zone);
     bool cloneSelfHostedFunctionScript(JSContext *cx, js::Handle<js::PropertyName*> name,
                                        js::Handle<JSFunction*> targetFun);
     bool cloneSelfHostedValue(JSContext *cx, js::Handle<js::PropertyName*> name,
@@ -1082,6 +1088,10 @@ struct JSRuntime : public JS::shadow::Runtime,
      */
     mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire> gcNumArenasFreeCommitted;
     js::GCMarker        gcMarker;
+#ifdef JS_THREADSAFE
+    /* Helper markers for parallel marking slices, created on first use. */
+    js::gc::ParallelMarker *gcParallelMarker;
+#endif
     void                *gcVerifyPreData;
     void                *gcVerifyPostData;
     bool                gcChunkAllocationSinceLastGC;
@@ -1108,6 +1118,8 @@ struct JSRuntime : public JS::shadow::Runtime,
     double              gcLowFrequencyHeapGrowth;
     bool                gcDynamicHeapGrowth;
     bool                gcDynamicMarkSlice;
+    bool                gcParallelMarkingEnabled;
+    bool                gcCompactingEnabled;
     uint64_t            gcDecommitThreshold;
 
     /* During shutdown, the GC needs to clean up every possible object. */
@@ -1173,6 +1185,9 @@ struct JSRuntime : public JS::shadow::Runtime,
     /* Whether any sweeping will take place in the separate GC helper thread. */
     bool                gcSweepOnBackgroundThread;
 
+    /* Whether objects will be relocated once sweeping has finished. */
+    bool                gcIsCompacting;
+
     /* Whether any black->gray edges were found during marking. */
     bool                gcFoundBlackGrayEdges;
 
@@ -1391,6 +1406,9 @@ struct JSRuntime : public JS::shadow::Runtime,
 
     mozilla::ScopedDeletePtr<js::SourceHook> sourceHook;
 
+    /* Codec used to compress the source of newly compiled scripts. */
+    js::SourceCompression sourceCompression;
+
     /* Per runtime debug hooks -- see js/OldDebugAPI.h. */
     JSDebugHooks        debugHooks;
 
@@ -1400,6 +1418,9 @@ struct JSRuntime : public JS::shadow::Runtime,
     /* SPS profiling metadata */
     js::SPSProfiler     spsProfiler;
 
+    /* Sampling profiler, while one is running or holds unwritten samples. */
+    js::SamplingProfiler *samplingProfiler;
+
     /* If true, new scripts must be created with PC counter information. */
     bool                profilingScripts;
 
@@ -1489,6 +1510,9 @@ struct JSRuntime : public JS::shadow::Runtime,
     /* AsmJSCache callbacks are runtime-wide. */
     JS::AsmJSCacheOps asmJSCacheOps;
 
+    /* Bytecode cache callbacks, consulted by JS::Compile. */
+    JS::BytecodeCacheOps bytecodeCacheOps;
+
     /*
      * The propertyRemovals counter is incremented for every JSObject::clear,
      * and for each JSObject::remove method call that frees a slot in the given
@@ -0,0 +1,278 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/SamplingProfiler.h"
+
+#include "jsapi.h"
+#include "jscntxt.h"
+#include "jsfun.h"
+#include "jsprf.h"
+#include "jsscript.h"
+
+#include "js/ProfilingStack.h"
+#include "vm/SPSProfiler.h"
+#include "vm/Stack.h"
+
+#include "vm/Stack-inl.h"
+
+using namespace js;
+
+typedef Vector<char, 512, SystemAllocPolicy> StackBuffer;
+
+/*
+ * Append |c| to a frame label. ';' separates frames and a line ends a stack,
+ * so neither may appear inside a label; non-ASCII characters are replaced.
+ */
+static bool
+AppendLabelChar(StackBuffer &buf, jschar c)
+{
+    if (c == ';')
+        c = ':';
+    else if (c == '\n' || c == '\r')
+        c = ' ';
+    else if (c < 0x20 || c > 0x7e)
+        c = '?';
+    return buf.append(char(c));
+}
+
+static bool
+AppendLabel(StackBuffer &buf, const char *s)
+{
+    for (; *s; s++) {
+        if (!AppendLabelChar(buf, jschar((unsigned char) *s)))
+            return false;
+    }
+    return true;
+}
+
+static bool
+AppendNumber(StackBuffer &buf, uint32_t n)
+{
+    char digits[12];
+    JS_snprintf(digits, sizeof(digits), "%u", n);
+    return buf.append(digits, strlen(digits));
+}
+
+/* Append "name (file:line)", or "file:line" for top-level code. */
+static bool
+AppendScriptFrame(StackBuffer &buf, JSScript *script, JSFunction *fun, jsbytecode *pc)
+{
+    JSAtom *atom = fun ? fun->displayAtom() : nullptr;
+    if (atom) {
+        const jschar *chars = atom->chars();
+        for (size_t i = 0; i < atom->length(); i++) {
+            if (!AppendLabelChar(buf, chars[i]))
+                return false;
+        }
+        if (!buf.append(" (", 2))
+            return false;
+    }
+
+    if (!AppendLabel(buf, script->filename() ? script->filename() : "<unknown>"))
+        return false;
+    if (!buf.append(':'))
+        return false;
+    if (!AppendNumber(buf, pc ? PCToLineNumber(script, pc) : script->lineno()))
+        return false;
+
+    return !atom || buf.append(')');
+}
+
+/*
+ * Frames of one sample, each appended to |chars| and terminated by ';'. The
+ * frames may be added innermost or outermost first.
+ */
+struct SampleFrames
+{
+    StackBuffer chars;
+    Vector<size_t, 32, SystemAllocPolicy> ends;
+
+    bool endFrame() {
+        return chars.append(';') && ends.append(chars.length());
+    }
+
+    /* Join the frames outermost first into |out|, NUL-terminated. */
+    bool join(StackBuffer &out, bool innermostFirst) {
+        for (size_t i = 0; i < ends.length(); i++) {
+            size_t frame = innermostFirst ? ends.length() - 1 - i : i;
+            size_t begin = frame ? ends[frame - 1] : 0;
+            size_t end = ends[frame] - 1;
+            if (i && !out.append(';'))
+                return false;
+            if (!out.append(chars.begin() + begin, end - begin))
+                return false;
+        }
+        return out.append('\0');
+    }
+};
+
+SamplingProfiler::SamplingProfiler(JSRuntime *rt, uint32_t intervalMilliseconds)
+  : rt(rt),
+    intervalMilliseconds(intervalMilliseconds ? intervalMilliseconds : 1),
+    sampleRequested(0),
+#ifdef JS_THREADSAFE
+    thread(nullptr),
+#endif
+    stopping(false),
+    sampleCount(0)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+
+    if (stacks.initialized()) {
+        for (StackCountMap::Range r = stacks.all(); !r.empty(); r.popFront())
+            js_free(r.front().key());
+    }
+}
+
+bool
+SamplingProfiler::init()
+{
+#ifdef JS_THREADSAFE
+    if (!Monitor::init())
+        return false;
+    if (!stacks.init())
+        return false;
+
+    thread = PR_CreateThread(PR_USER_THREAD, threadMain, this, PR_PRIORITY_NORMAL,
+                             PR_GLOBAL_THREAD, PR_JOINABLE_THREAD, 0);
+    return thread != nullptr;
+#else
+    return false;
+#endif
+}
+
+void
+SamplingProfiler::stop()
+{
+#ifdef JS_THREADSAFE
+    if (!thread)
+        return;
+
+    {
+        AutoLockMonitor lock(*this);
+        stopping = true;
+        lock.notify();
+    }
+
+    PR_JoinThread(thread);
+    thread = nullptr;
+#endif
+}
+
+/* static */ void
+SamplingProfiler::threadMain(void *arg)
+{
+#ifdef JS_THREADSAFE
+    PR_SetCurrentThreadName("JS Sampler");
+#endif
+    static_cast<SamplingProfiler *>(arg)->threadLoop();
+}
+
+void
+SamplingProfiler::threadLoop()
+{
+#ifdef JS_THREADSAFE
+    uint32_t interval = PR_MillisecondsToInterval(intervalMilliseconds);
+
+    AutoLockMonitor lock(*this);
+    while (true) {
+        PR_WaitCondVar(condVar_, interval);
+        if (stopping)
+            break;
+
+        /*
+         * If the previous request has not been serviced yet the main thread
+         * is not running script, and there is nothing to attribute the time
+         * to, so don't interrupt it again.
+         */
+        if (!sampleRequested) {
+            sampleRequested = 1;
+            JS_TriggerOperationCallback(rt);
+        }
+    }
+#endif
+}
+
+bool
+SamplingProfiler::recordStack(JSContext *cx)
+{
+    SampleFrames frames;
+    bool innermostFirst;
+
+    SPSProfiler &sps = rt->spsProfiler;
+    if (sps.enabled()) {
+        innermostFirst = false;
+        uint32_t size = Min(*sps.sizePointer(), sps.maxSize());
+        for (uint32_t i = 0; i < size; i++) {
+            ProfileEntry &entry = sps.stack()[i];
+            if (entry.js()) {
+                JSScript *script = entry.script();
+                if (!AppendScriptFrame(frames.chars, script, script->functionNonDelazifying(),
+                                       entry.pc()))
+                {
+                    return false;
+                }
+            } else {
+                if (!AppendLabel(frames.chars, entry.label()))
+                    return false;
+            }
+            if (!frames.endFrame())
+                return false;
+        }
+    } else {
+        innermostFirst = true;
+        for (ScriptFrameIter iter(cx, ScriptFrameIter::GO_THROUGH_SAVED); !iter.done(); ++iter) {
+            if (!AppendScriptFrame(frames.chars, iter.script(), iter.maybeCallee(), iter.pc()))
+                return false;
+            if (!frames.endFrame())
+                return false;
+        }
+    }
+
+    /* Samples taken outside of any script are not interesting. */
+    if (frames.ends.empty())
+        return true;
+
+    StackBuffer stack;
+    if (!frames.join(stack, innermostFirst))
+        return false;
+    return addSample(stack.begin());
+}
+
+bool
+SamplingProfiler::addSample(const char *stack)
+{
+    StackCountMap::AddPtr p = stacks.lookupForAdd(stack);
+    if (!p) {
+        size_t length = strlen(stack);
+        char *key = js_pod_malloc<char>(length + 1);
+        if (!key)
+            return false;
+        memcpy(key, stack, length + 1);
+        if (!stacks.add(p, key, 0)) {
+            js_free(key);
+            return false;
+        }
+    }
+
+    p->value()++;
+    sampleCount++;
+    return true;
+}
+
+bool
+SamplingProfiler::write(FILE *fp)
+{
+    if (stacks.initialized()) {
+        for (StackCountMap::Range r = stacks.all(); !r.empty(); r.popFront())
+            fprintf(fp, "%s %llu\n", r.front().key(), (unsigned long long) r.front().value());
+    }
+    return !ferror(fp);
+}
@@ -0,0 +1,121 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_SamplingProfiler_h
+#define vm_SamplingProfiler_h
+
+#include "mozilla/Atomics.h"
+#include "mozilla/HashFunctions.h"
+
+#include <string.h>
+
+#include "jsalloc.h"
+#include "jslock.h"
+
+#include "js/HashTable.h"
+#include "vm/Monitor.h"
+
+struct JSContext;
+struct JSRuntime;
+
+/*
+ * Built-in sampling CPU profiler.
+ *
+ * A sampler thread wakes up at a fixed interval and requests an operation
+ * callback on the runtime, the same way the shell's watchdog interrupts
+ * running scripts. The main thread then records its stack the next time it
+ * services the callback: interpreter and Baseline code check for it at loop
+ * heads and function entries, and Ion code is stopped through its stack limit
+ * and memory protection. Sampling at these safepoints rather than from a
+ * signal handler means the stack can be walked with the ordinary frame
+ * iterators, including frames Ion has inlined, and that the strings of the
+ * SPS pseudo-stack are never read while the main thread may be freeing them.
+ *
+ * Each sample is a stack of frames, outermost first. When the SPS pseudo-stack
+ * is installed and enabled it is walked, so that labels pushed by the embedder
+ * for native code show up as frames; otherwise the script frames of the
+ * context are walked. Script frames are labelled "name (file:line)", or
+ * "file:line" for top-level code, where the line is the one executing when the
+ * sample was taken.
+ *
+ * Samples are aggregated by stack and written out in the collapsed-stack
+ * format read by flamegraph.pl and convertible to pprof: one line per distinct
+ * stack, with frames separated by ';' and followed by a space and the number
+ * of samples taken with that stack.
+ */
+
+namespace js {
+
+class SamplingProfiler : public Monitor
+{
+    /* Hash policy for the owned, NUL-terminated stack keys. */
+    struct StackHasher
+    {
+        typedef const char *Lookup;
+
+        static HashNumber hash(const char *s) {
+            return mozilla::HashString(s);
+        }
+        static bool match(const char *key, const char *lookup) {
+            return strcmp(key, lookup) == 0;
+        }
+    };
+
+    typedef HashMap<char *, uint64_t, StackHasher, SystemAllocPolicy> StackCountMap;
+
+    JSRuntime *rt;
+    uint32_t intervalMilliseconds;
+
+    /* Set by the sampler thread, cleared by the main thread when sampling. */
+    mozilla::Atomic<uint32_t> sampleRequested;
+
+#ifdef JS_THREADSAFE
+    PRThread *thread;
+#endif
+
+    /* Protected by the monitor's lock. */
+    bool stopping;
+
+    /* Main thread only. */
+    StackCountMap stacks;
+    uint64_t sampleCount;
+
+    static void threadMain(void *arg);
+    void threadLoop();
+
+    bool recordStack(JSContext *cx);
+    bool addSample(const char *stack);
+
+  public:
+    SamplingProfiler(JSRuntime *rt, uint32_t intervalMilliseconds);
+    ~SamplingProfiler();
+
+    /* Start the sampler thread. */
+    bool init();
+
+    /* Stop the sampler thread. Samples already taken are kept. */
+    void stop();
+
+    /*
+     * Called by the main thread while servicing an operation callback: take
+     * a sample if the sampler thread asked for one since the last call.
+     */
+    void maybeSample(JSContext *cx) {
+        if (sampleRequested) {
+            sampleRequested = 0;
+            recordStack(cx);
+        }
+    }
+
+    uint64_t samples() const { return sampleCount; }
+
+    /* Write the aggregated samples to |fp| in collapsed-stack format. */
+    bool write(FILE *fp);
+};
+
+} /* namespace js */
+
+#endif /* vm_SamplingProfiler_h */
@@ -825,6 +825,12 @@ JSRuntime::markSelfHostingGlobal(JSTracer *trc)
         MarkObjectRoot(trc, &selfHostingGlobal_, "self-hosting global");
 }
 
+bool
+JSRuntime::isSelfHostingZone(JS::Zone *zone)
+{
+    return selfHostingGlobal_ && selfHostingGlobal_->zoneFromAnyThread() == zone;
+}
+
 typedef AutoObjectObjectHashMap CloneMemory;
 static bool CloneValue(JSContext *cx, MutableHandleValue vp, CloneMemory &clonedObjects);
 
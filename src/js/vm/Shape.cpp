@@ -1544,6 +1544,44 @@ JSCompartment::sweepBaseShapeTable()
     }
 }
 
+void
+JSCompartment::fixupBaseShapeTable()
+{
+    if (!baseShapes.initialized())
+        return;
+
+    for (BaseShapeSet::Enum e(baseShapes); !e.empty(); e.popFront()) {
+        UnownedBaseShape *base = *e.front().unsafeGet();
+
+        /* Rebuild the lookup the entry was hashed with, then forward it. */
+        StackBaseShape lookup(base);
+        uint8_t attrs = (base->hasGetterObject() ? JSPROP_GETTER : 0) |
+                        (base->hasSetterObject() ? JSPROP_SETTER : 0);
+        lookup.updateGetterSetter(attrs, base->rawGetter, base->rawSetter);
+
+        bool moved = false;
+        if (lookup.parent && IsForwarded(lookup.parent)) {
+            lookup.parent = Forwarded(lookup.parent);
+            moved = true;
+        }
+        if (lookup.metadata && IsForwarded(lookup.metadata)) {
+            lookup.metadata = Forwarded(lookup.metadata);
+            moved = true;
+        }
+        if (base->hasGetterObject() && base->getterObj && IsForwarded(base->getterObj)) {
+            lookup.rawGetter = JS_DATA_TO_FUNC_PTR(PropertyOp, Forwarded(base->getterObj));
+            moved = true;
+        }
+        if (base->hasSetterObject() && base->setterObj && IsForwarded(base->setterObj)) {
+            lookup.rawSetter = JS_DATA_TO_FUNC_PTR(StrictPropertyOp, Forwarded(base->setterObj));
+            moved = true;
+        }
+
+        if (moved)
+            e.rekeyFront(&lookup, base);
+    }
+}
+
 void
 BaseShape::finalize(FreeOp *fop)
 {
@@ -1842,6 +1880,34 @@ JSCompartment::sweepInitialShapeTable()
     }
 }
 
+void
+JSCompartment::fixupInitialShapeTable()
+{
+    if (!initialShapes.initialized())
+        return;
+
+    for (InitialShapeSet::Enum e(initialShapes); !e.empty(); e.popFront()) {
+        const InitialShapeEntry &entry = e.front();
+        Shape *shape = *entry.shape.unsafeGet();
+
+        TaggedProto proto = entry.proto;
+        if (proto.isObject() && IsForwarded(proto.toObject()))
+            proto = TaggedProto(Forwarded(proto.toObject()));
+        JSObject *parent = MaybeForwarded(shape->getObjectParent());
+        JSObject *metadata = MaybeForwarded(shape->getObjectMetadata());
+
+        if (proto.raw() != entry.proto.raw() ||
+            parent != shape->getObjectParent() ||
+            metadata != shape->getObjectMetadata())
+        {
+            InitialShapeEntry::Lookup lookup(shape->getObjectClass(), proto, parent, metadata,
+                                             shape->numFixedSlots(), shape->getObjectFlags());
+            InitialShapeEntry newKey(entry.shape, proto);
+            e.rekeyFront(lookup, newKey);
+        }
+    }
+}
+
 void
 AutoRooterGetterSetter::Inner::trace(JSTracer *trc)
 {
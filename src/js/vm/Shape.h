@@ -546,6 +546,7 @@ class BaseShape : public gc::BarrieredCell<BaseShape>
     friend struct StackBaseShape;
     friend struct StackShape;
     friend void gc::MergeCompartments(JSCompartment *source, JSCompartment *target);
+    friend struct ::JSCompartment;
 
     enum Flag {
         /* Owned by the referring shape. */
@@ -845,6 +846,10 @@ struct StackBaseShape
 
     static inline HashNumber hash(const StackBaseShape *lookup);
     static inline bool match(UnownedBaseShape *key, const StackBaseShape *lookup);
+    static void rekey(ReadBarriered<UnownedBaseShape> &k,
+                      const ReadBarriered<UnownedBaseShape> &newKey) {
+        k = newKey;
+    }
 
     class AutoRooter : private JS::CustomAutoRooter
     {
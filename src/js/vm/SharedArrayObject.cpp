@@ -0,0 +1,248 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/SharedArrayObject.h"
+
+#include "jsfun.h"
+
+#include "vm/GlobalObject.h"
+
+#include "jsobjinlines.h"
+
+using namespace js;
+
+/*
+ * Unlike ArrayBuffers, shared buffers never keep their contents in fixed
+ * slots; the only slot needed is the one for the private delegate.
+ */
+static const uint8_t SHAREDARRAYBUFFER_RESERVED_SLOTS = 0;
+
+/* static */ SharedArrayRawBuffer *
+SharedArrayRawBuffer::New(uint32_t length)
+{
+    size_t size = sizeof(SharedArrayRawBuffer) + sizeof(ObjectElements) + length;
+    void *p = js_calloc(size);
+    if (!p)
+        return nullptr;
+
+    SharedArrayRawBuffer *buffer = new (p) SharedArrayRawBuffer(length);
+    ArrayBufferObject::initElementsHeader(buffer->header(), length);
+    buffer->header()->setIsSharedArrayBuffer();
+    JS_ASSERT(uintptr_t(buffer->dataPointer()) % sizeof(double) == 0);
+    return buffer;
+}
+
+void
+SharedArrayRawBuffer::addReference()
+{
+    JS_ASSERT(refcount > 0);
+    ++refcount;
+}
+
+void
+SharedArrayRawBuffer::dropReference()
+{
+    JS_ASSERT(refcount > 0);
+    if (--refcount == 0) {
+        this->~SharedArrayRawBuffer();
+        js_free(this);
+    }
+}
+
+bool
+js::IsSharedArrayBuffer(HandleValue v)
+{
+    return v.isObject() && v.toObject().is<SharedArrayBufferObject>();
+}
+
+/* static */ bool
+SharedArrayBufferObject::class_constructor(JSContext *cx, unsigned argc, Value *vp)
+{
+    int32_t nbytes = 0;
+    CallArgs args = CallArgsFromVp(argc, vp);
+    if (argc > 0 && !ToInt32(cx, args[0], &nbytes))
+        return false;
+
+    if (nbytes < 0) {
+        JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_BAD_ARRAY_LENGTH);
+        return false;
+    }
+
+    JSObject *bufobj = New(cx, uint32_t(nbytes));
+    if (!bufobj)
+        return false;
+    args.rval().setObject(*bufobj);
+    return true;
+}
+
+/* static */ JSObject *
+SharedArrayBufferObject::New(JSContext *cx, uint32_t nbytes)
+{
+    SharedArrayRawBuffer *buffer = SharedArrayRawBuffer::New(nbytes);
+    if (!buffer) {
+        js_ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    JSObject *obj = New(cx, buffer);
+
+    /* The object took its own reference, or failed and took none. */
+    buffer->dropReference();
+    return obj;
+}
+
+/* static */ JSObject *
+SharedArrayBufferObject::New(JSContext *cx, SharedArrayRawBuffer *buffer)
+{
+    /*
+     * The class has a finalizer, so these objects are always tenured and
+     * their finalizer always drops the reference taken here.
+     */
+    JSObject *obj = NewBuiltinClassInstance(cx, &class_);
+    if (!obj)
+        return nullptr;
+    JS_ASSERT(obj->isTenured());
+
+    buffer->addReference();
+    obj->as<SharedArrayBufferObject>().elements = buffer->elements();
+    JS_ASSERT(obj->as<SharedArrayBufferObject>().isSharedArrayBuffer());
+    return obj;
+}
+
+SharedArrayRawBuffer *
+SharedArrayBufferObject::rawBufferObject() const
+{
+    return SharedArrayRawBuffer::fromElements(getElementsHeader());
+}
+
+/* static */ void
+SharedArrayBufferObject::Finalize(FreeOp *fop, JSObject *obj)
+{
+    SharedArrayBufferObject &buffer = obj->as<SharedArrayBufferObject>();
+    if (!buffer.hasDynamicElements())
+        return;
+
+    /* Detach the shared memory first, so that JSObject::finish leaves it be. */
+    SharedArrayRawBuffer *raw = buffer.rawBufferObject();
+    buffer.setFixedElements();
+    raw->dropReference();
+}
+
+/* static */ bool
+SharedArrayBufferObject::byteLengthGetterImpl(JSContext *cx, CallArgs args)
+{
+    JS_ASSERT(IsSharedArrayBuffer(args.thisv()));
+    args.rval().setInt32(args.thisv().toObject().as<SharedArrayBufferObject>().byteLength());
+    return true;
+}
+
+/* static */ bool
+SharedArrayBufferObject::byteLengthGetter(JSContext *cx, unsigned argc, Value *vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    return CallNonGenericMethod<IsSharedArrayBuffer, byteLengthGetterImpl>(cx, args);
+}
+
+const Class SharedArrayBufferObject::protoClass = {
+    "SharedArrayBufferPrototype",
+    JSCLASS_HAS_PRIVATE |
+    JSCLASS_HAS_RESERVED_SLOTS(SHAREDARRAYBUFFER_RESERVED_SLOTS) |
+    JSCLASS_HAS_CACHED_PROTO(JSProto_SharedArrayBuffer),
+    JS_PropertyStub,         /* addProperty */
+    JS_DeletePropertyStub,   /* delProperty */
+    JS_PropertyStub,         /* getProperty */
+    JS_StrictPropertyStub,   /* setProperty */
+    JS_EnumerateStub,
+    JS_ResolveStub,
+    JS_ConvertStub
+};
+
+const Class SharedArrayBufferObject::class_ = {
+    "SharedArrayBuffer",
+    JSCLASS_HAS_PRIVATE |
+    JSCLASS_IMPLEMENTS_BARRIERS |
+    Class::NON_NATIVE |
+    JSCLASS_HAS_RESERVED_SLOTS(SHAREDARRAYBUFFER_RESERVED_SLOTS) |
+    JSCLASS_HAS_CACHED_PROTO(JSProto_SharedArrayBuffer),
+    JS_PropertyStub,         /* addProperty */
+    JS_DeletePropertyStub,   /* delProperty */
+    JS_PropertyStub,         /* getProperty */
+    JS_StrictPropertyStub,   /* setProperty */
+    JS_EnumerateStub,
+    JS_ResolveStub,
+    JS_ConvertStub,
+    SharedArrayBufferObject::Finalize,
+    nullptr,        /* checkAccess */
+    nullptr,        /* call        */
+    nullptr,        /* hasInstance */
+    nullptr,        /* construct   */
+    ArrayBufferObject::obj_trace,
+    JS_NULL_CLASS_EXT,
+    {
+        ArrayBufferObject::obj_lookupGeneric,
+        ArrayBufferObject::obj_lookupProperty,
+        ArrayBufferObject::obj_lookupElement,
+        ArrayBufferObject::obj_lookupSpecial,
+        ArrayBufferObject::obj_defineGeneric,
+        ArrayBufferObject::obj_defineProperty,
+        ArrayBufferObject::obj_defineElement,
+        ArrayBufferObject::obj_defineSpecial,
+        ArrayBufferObject::obj_getGeneric,
+        ArrayBufferObject::obj_getProperty,
+        ArrayBufferObject::obj_getElement,
+        ArrayBufferObject::obj_getSpecial,
+        ArrayBufferObject::obj_setGeneric,
+        ArrayBufferObject::obj_setProperty,
+        ArrayBufferObject::obj_setElement,
+        ArrayBufferObject::obj_setSpecial,
+        ArrayBufferObject::obj_getGenericAttributes,
+        ArrayBufferObject::obj_setGenericAttributes,
+        ArrayBufferObject::obj_deleteProperty,
+        ArrayBufferObject::obj_deleteElement,
+        ArrayBufferObject::obj_deleteSpecial,
+        nullptr, nullptr, /* watch/unwatch */
+        nullptr,          /* slice */
+        ArrayBufferObject::obj_enumerate,
+        nullptr,          /* thisObject      */
+    }
+};
+
+JSObject *
+js_InitSharedArrayBufferClass(JSContext *cx, HandleObject obj)
+{
+    JS_ASSERT(obj->isNative());
+    Rooted<GlobalObject*> global(cx, &obj->as<GlobalObject>());
+    RootedObject proto(cx, global->createBlankPrototype(cx, &SharedArrayBufferObject::protoClass));
+    if (!proto)
+        return nullptr;
+
+    RootedFunction ctor(cx, global->createConstructor(cx, SharedArrayBufferObject::class_constructor,
+                                                      cx->names().SharedArrayBuffer, 1));
+    if (!ctor)
+        return nullptr;
+
+    if (!LinkConstructorAndPrototype(cx, ctor, proto))
+        return nullptr;
+
+    RootedId byteLengthId(cx, NameToId(cx->names().byteLength));
+    unsigned flags = JSPROP_SHARED | JSPROP_GETTER | JSPROP_PERMANENT;
+    JSObject *getter = NewFunction(cx, NullPtr(), SharedArrayBufferObject::byteLengthGetter, 0,
+                                   JSFunction::NATIVE_FUN, global, NullPtr());
+    if (!getter)
+        return nullptr;
+
+    RootedValue value(cx, UndefinedValue());
+    if (!DefineNativeProperty(cx, proto, byteLengthId, value,
+                              JS_DATA_TO_FUNC_PTR(PropertyOp, getter), nullptr, flags, 0, 0))
+    {
+        return nullptr;
+    }
+
+    if (!DefineConstructorAndPrototype(cx, global, JSProto_SharedArrayBuffer, ctor, proto))
+        return nullptr;
+
+    return proto;
+}
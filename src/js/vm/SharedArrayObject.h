@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_SharedArrayObject_h
+#define vm_SharedArrayObject_h
+
+#include "mozilla/Atomics.h"
+
+#include "jsapi.h"
+
+#include "vm/ObjectImpl.h"
+#include "vm/TypedArrayObject.h"
+
+namespace js {
+
+/*
+ * SharedArrayRawBuffer
+ *
+ * The memory of a SharedArrayBufferObject, reference counted so that it can
+ * be shared by objects in any number of runtimes and threads. It is laid out
+ * as this header, then an ObjectElements header as used by ArrayBufferObject
+ * and then the data, so that SharedArrayBufferObjects can point their
+ * elements straight at the data.
+ *
+ * Each SharedArrayBufferObject holds a reference, as does a structured clone
+ * buffer holding a serialized SharedArrayBufferObject that has not been read
+ * yet. The memory is freed when the last reference is dropped.
+ */
+class SharedArrayRawBuffer
+{
+    mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire> refcount;
+    uint32_t length;
+
+    /* Keeps the data 8-byte aligned for Float64Array views. */
+    uint64_t padding_;
+
+    SharedArrayRawBuffer(uint32_t length)
+      : refcount(1), length(length), padding_(0)
+    {}
+
+    ObjectElements *header() {
+        return reinterpret_cast<ObjectElements *>(this + 1);
+    }
+
+  public:
+    /* Allocate a zeroed buffer of |length| bytes, holding one reference. */
+    static SharedArrayRawBuffer *New(uint32_t length);
+
+    static SharedArrayRawBuffer *fromElements(ObjectElements *header) {
+        JS_ASSERT(header->isSharedArrayBuffer());
+        return reinterpret_cast<SharedArrayRawBuffer *>(header) - 1;
+    }
+
+    uint8_t *dataPointer() {
+        return reinterpret_cast<uint8_t *>(header()->elements());
+    }
+
+    HeapSlot *elements() {
+        return header()->elements();
+    }
+
+    uint32_t byteLength() const {
+        return length;
+    }
+
+    void addReference();
+    void dropReference();
+};
+
+} /* namespace js */
+
+extern JSObject *
+js_InitSharedArrayBufferClass(JSContext *cx, js::HandleObject obj);
+
+#endif /* vm_SharedArrayObject_h */
@@ -31,6 +31,7 @@
 
 #include "mozilla/Endian.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/PodOperations.h"
 
 #include <algorithm>
 
@@ -39,6 +40,7 @@
 #include "jsdate.h"
 #include "jswrapper.h"
 
+#include "vm/SharedArrayObject.h"
 #include "vm/TypedArrayObject.h"
 #include "vm/WrapperObject.h"
 
@@ -50,6 +52,7 @@ using namespace js;
 using mozilla::IsNaN;
 using mozilla::LittleEndian;
 using mozilla::NativeEndian;
+using mozilla::PodCopy;
 using JS::CanonicalizeNaN;
 
 enum StructuredDataType {
@@ -92,6 +95,22 @@ enum StructuredDataType {
     SCTAG_TRANSFER_MAP_HEADER = 0xFFFF0200,
     SCTAG_TRANSFER_MAP_ENTRY,
 
+    /*
+     * A SharedArrayBuffer is written as its length and a pointer to its
+     * SharedArrayRawBuffer, which holds a reference on behalf of the clone
+     * buffer. Reading hands that reference over to the new object and clears
+     * the pointer, so such a clone buffer can only be read once; one that is
+     * discarded without being read keeps its shared memory alive.
+     */
+    SCTAG_SHARED_ARRAY_BUFFER_OBJECT,
+
+    /*
+     * An ArrayBuffer whose contents are held out of line, written only for
+     * SameProcessCloneScope. The data is the byte length; it is followed by
+     * the index of the transfer map entry owning the contents.
+     */
+    SCTAG_OUT_OF_LINE_ARRAY_BUFFER_OBJECT,
+
     SCTAG_END_OF_BUILTIN_TYPES
 };
 
@@ -114,8 +133,26 @@ enum TransferableObjectType {
 
     // Data is a pointer that can be freed
     SCTAG_TM_ALLOC_DATA = 2,
+
+    // Data is a pointer that can be freed, referred to by index from the
+    // clone data rather than standing for a transferred object
+    SCTAG_TM_OUT_OF_LINE_DATA = 3,
 };
 
+/*
+ * For SameProcessCloneScope, ArrayBuffer contents and string chars of at
+ * least this many bytes are written out of line.
+ */
+static const size_t SC_OUT_OF_LINE_THRESHOLD = 4096;
+
+/*
+ * Set in the length of an SCTAG_STRING or SCTAG_STRING_OBJECT whose chars are
+ * held out of line, in which case the index of their transfer map entry
+ * follows. A flag rather than a tag, so that the property names and RegExp
+ * sources, which must be SCTAG_STRINGs, can be written out of line too.
+ */
+static const uint32_t SC_OUT_OF_LINE_STRING_FLAG = 0x80000000;
+
 namespace js {
 
 struct SCOutput {
@@ -137,6 +174,9 @@ struct SCOutput {
 
     bool extractBuffer(uint64_t **datap, size_t *sizep);
 
+    // Insert nwords uninitialized words before the word at |index|.
+    bool insertWords(size_t index, size_t nwords);
+
     uint64_t count() const { return buf.length(); }
     uint64_t *rawBuffer() { return buf.begin(); }
 
@@ -194,6 +234,7 @@ struct JSStructuredCloneReader {
     explicit JSStructuredCloneReader(js::SCInput &in, const JSStructuredCloneCallbacks *cb,
                                      void *cbClosure)
         : in(in), objs(in.context()), allObjs(in.context()),
+          transferEntries(nullptr), numTransferEntries(0),
           callbacks(cb), closure(cbClosure) { }
 
     js::SCInput &input() { return in; }
@@ -203,11 +244,14 @@ struct JSStructuredCloneReader {
     JSContext *context() { return in.context(); }
 
     bool readTransferMap();
+    bool takeOutOfLineData(void **p);
 
     bool checkDouble(double d);
-    JSString *readString(uint32_t nchars);
+    JSString *readString(uint32_t data);
     bool readTypedArray(uint32_t arrayType, uint32_t nelems, js::Value *vp, bool v1Read = false);
     bool readArrayBuffer(uint32_t nbytes, js::Value *vp);
+    bool readOutOfLineArrayBuffer(uint32_t nbytes, js::Value *vp);
+    bool readSharedArrayBuffer(uint32_t nbytes, js::Value *vp);
     bool readV1ArrayBuffer(uint32_t arrayType, uint32_t nelems, js::Value *vp);
     bool readId(jsid *idp);
     bool startRead(js::Value *vp);
@@ -220,6 +264,11 @@ struct JSStructuredCloneReader {
     // Stack of all objects read during this deserialization
     js::AutoValueVector allObjs;
 
+    // The entries of the transfer map, through which out-of-line data is
+    // taken over by index.
+    uint64_t *transferEntries;
+    uint64_t numTransferEntries;
+
     // The user defined callbacks that will be used for cloning.
     const JSStructuredCloneCallbacks *callbacks;
 
@@ -234,11 +283,15 @@ struct JSStructuredCloneWriter {
     explicit JSStructuredCloneWriter(js::SCOutput &out,
                                      const JSStructuredCloneCallbacks *cb,
                                      void *cbClosure,
-                                     jsval tVal)
+                                     jsval tVal,
+                                     JS::StructuredCloneScope scope)
         : out(out), objs(out.context()),
           counts(out.context()), ids(out.context()),
           memory(out.context()), callbacks(cb), closure(cbClosure),
-          transferable(out.context(), tVal), transferableObjects(out.context()) { }
+          transferable(out.context(), tVal), transferableObjects(out.context()),
+          scope(scope), outOfLineData(out.context()) { }
+
+    ~JSStructuredCloneWriter();
 
     bool init() { return memory.init() && parseTransferable() && writeTransferMap(); }
 
@@ -251,9 +304,13 @@ struct JSStructuredCloneWriter {
 
     bool writeTransferMap();
 
+    bool writeOutOfLine(void *p);
+    bool writeOutOfLineData();
+
     bool writeString(uint32_t tag, JSString *str);
     bool writeId(jsid id);
     bool writeArrayBuffer(JS::HandleObject obj);
+    bool writeSharedArrayBuffer(JS::HandleObject obj);
     bool writeTypedArray(JS::HandleObject obj);
     bool startObject(JS::HandleObject obj, bool *backref);
     bool startWrite(const js::Value &v);
@@ -296,6 +353,12 @@ struct JSStructuredCloneWriter {
     JS::RootedValue transferable;
     JS::AutoObjectVector transferableObjects;
 
+    JS::StructuredCloneScope scope;
+
+    // Out-of-line data referred to so far, owned by the writer until it is
+    // added to the transfer map at the end of the write.
+    js::Vector<void *> outOfLineData;
+
     friend bool JS_WriteTypedArray(JSStructuredCloneWriter *w, JS::Value v);
 };
 
@@ -315,10 +378,10 @@ namespace js {
 bool
 WriteStructuredClone(JSContext *cx, HandleValue v, uint64_t **bufp, size_t *nbytesp,
                      const JSStructuredCloneCallbacks *cb, void *cbClosure,
-                     jsval transferable)
+                     jsval transferable, JS::StructuredCloneScope scope)
 {
     SCOutput out(cx);
-    JSStructuredCloneWriter w(out, cb, cbClosure, transferable);
+    JSStructuredCloneWriter w(out, cb, cbClosure, transferable, scope);
     return w.init() && w.write(v) && out.extractBuffer(bufp, nbytesp);
 }
 
@@ -336,7 +399,8 @@ ReadStructuredClone(JSContext *cx, uint64_t *data, size_t nbytes, MutableHandleV
 static void
 DiscardEntry(uint32_t mapEntryDescriptor, const uint64_t *ptr)
 {
-    JS_ASSERT(mapEntryDescriptor == SCTAG_TM_ALLOC_DATA);
+    JS_ASSERT(mapEntryDescriptor == SCTAG_TM_ALLOC_DATA ||
+              mapEntryDescriptor == SCTAG_TM_OUT_OF_LINE_DATA);
     uint64_t u = LittleEndian::readUint64(ptr);
     js_free(reinterpret_cast<void*>(u));
 }
@@ -353,18 +417,17 @@ Discard(const uint64_t *begin, const uint64_t *end)
     if (tag != SCTAG_TRANSFER_MAP_HEADER)
         return;
 
-    if (TransferableMapHeader(u) == SCTAG_TM_TRANSFERRED)
-        return;
-
+    // Even once the map has been read, out-of-line data that the reader did
+    // not get to is still owned by the buffer. Entries that were taken over
+    // are marked as unowned, so walk them all.
     uint64_t numTransferables = LittleEndian::readUint64(point++);
     while (numTransferables--) {
         uint64_t u = LittleEndian::readUint64(point++);
         JS_ASSERT(uint32_t(u >> 32) == SCTAG_TRANSFER_MAP_ENTRY);
         uint32_t mapEntryDescriptor = uint32_t(u);
-        if (mapEntryDescriptor >= SCTAG_TM_FIRST_OWNED) {
+        if (mapEntryDescriptor >= SCTAG_TM_FIRST_OWNED)
             DiscardEntry(mapEntryDescriptor, point);
-            point += 2; // Pointer and userdata
-        }
+        point += 2; // Pointer and userdata
     }
 }
 
@@ -667,6 +730,17 @@ SCOutput::writePtr(const void *p)
     return write(reinterpret_cast<uint64_t>(p));
 }
 
+bool
+SCOutput::insertWords(size_t index, size_t nwords)
+{
+    JS_ASSERT(index <= buf.length());
+    size_t oldLength = buf.length();
+    if (!buf.growByUninitialized(nwords))
+        return false;
+    memmove(&buf[index + nwords], &buf[index], (oldLength - index) * sizeof(uint64_t));
+    return true;
+}
+
 bool
 SCOutput::extractBuffer(uint64_t **datap, size_t *sizep)
 {
@@ -675,6 +749,14 @@ SCOutput::extractBuffer(uint64_t **datap, size_t *sizep)
 }
 
 JS_STATIC_ASSERT(JSString::MAX_LENGTH < UINT32_MAX);
+JS_STATIC_ASSERT(JSString::MAX_LENGTH < SC_OUT_OF_LINE_STRING_FLAG);
+
+JSStructuredCloneWriter::~JSStructuredCloneWriter()
+{
+    // Free the out-of-line data of a write that failed.
+    for (size_t i = 0; i < outOfLineData.length(); i++)
+        js_free(outOfLineData[i]);
+}
 
 bool
 JSStructuredCloneWriter::parseTransferable()
@@ -718,7 +800,7 @@ JSStructuredCloneWriter::parseTransferable()
             JS_ReportErrorNumber(context(), js_GetErrorMessage, nullptr, JSMSG_UNWRAP_DENIED);
             return false;
         }
-        if (!tObj->is<ArrayBufferObject>()) {
+        if (!tObj->is<ArrayBufferObject>() || tObj->as<ArrayBufferObject>().isSharedArrayBuffer()) {
             reportErrorTransferable();
             return false;
         }
@@ -745,6 +827,21 @@ JSStructuredCloneWriter::reportErrorTransferable()
         JS_ReportErrorNumber(context(), js_GetErrorMessage, nullptr, JSMSG_SC_NOT_TRANSFERABLE);
 }
 
+/*
+ * Take ownership of |p| and write the index of the transfer map entry it will
+ * be given.
+ */
+bool
+JSStructuredCloneWriter::writeOutOfLine(void *p)
+{
+    uint64_t index = transferableObjects.length() + outOfLineData.length();
+    if (!outOfLineData.append(p)) {
+        js_free(p);
+        return false;
+    }
+    return out.write(index);
+}
+
 bool
 JSStructuredCloneWriter::writeString(uint32_t tag, JSString *str)
 {
@@ -752,6 +849,21 @@ JSStructuredCloneWriter::writeString(uint32_t tag, JSString *str)
     const jschar *chars = str->getChars(context());
     if (!chars)
         return false;
+
+    if (scope == JS::SameProcessCloneScope &&
+        length * sizeof(jschar) >= SC_OUT_OF_LINE_THRESHOLD)
+    {
+        // Copy the chars into an allocation the reader can give to a new
+        // string as is, null terminator included.
+        jschar *copy = context()->pod_malloc<jschar>(length + 1);
+        if (!copy)
+            return false;
+        PodCopy(copy, chars, length);
+        copy[length] = 0;
+        return out.writePair(tag, uint32_t(length) | SC_OUT_OF_LINE_STRING_FLAG) &&
+               writeOutOfLine(copy);
+    }
+
     return out.writePair(tag, uint32_t(length)) && out.writeChars(chars, length);
 }
 
@@ -820,10 +932,39 @@ bool
 JSStructuredCloneWriter::writeArrayBuffer(HandleObject obj)
 {
     ArrayBufferObject &buffer = obj->as<ArrayBufferObject>();
+
+    if (scope == JS::SameProcessCloneScope && buffer.byteLength() >= SC_OUT_OF_LINE_THRESHOLD) {
+        // Copy the contents into an allocation the reader can give to a new
+        // ArrayBuffer as is. It is overwritten entirely, so need not be
+        // zeroed like JS_AllocateArrayBufferContents does.
+        uint32_t nbytes = buffer.byteLength();
+        ObjectElements *header =
+            static_cast<ObjectElements *>(context()->malloc_(sizeof(ObjectElements) + nbytes));
+        if (!header)
+            return false;
+        ArrayBufferObject::initElementsHeader(header, nbytes);
+        js_memcpy(header->elements(), buffer.dataPointer(), nbytes);
+        return out.writePair(SCTAG_OUT_OF_LINE_ARRAY_BUFFER_OBJECT, nbytes) &&
+               writeOutOfLine(header);
+    }
+
     return out.writePair(SCTAG_ARRAY_BUFFER_OBJECT, buffer.byteLength()) &&
            out.writeBytes(buffer.dataPointer(), buffer.byteLength());
 }
 
+bool
+JSStructuredCloneWriter::writeSharedArrayBuffer(HandleObject obj)
+{
+    SharedArrayRawBuffer *raw = obj->as<SharedArrayBufferObject>().rawBufferObject();
+    if (!out.writePair(SCTAG_SHARED_ARRAY_BUFFER_OBJECT, raw->byteLength()) ||
+        !out.writePtr(raw))
+    {
+        return false;
+    }
+    raw->addReference();
+    return true;
+}
+
 bool
 JSStructuredCloneWriter::startObject(HandleObject obj, bool *backref)
 {
@@ -920,6 +1061,8 @@ JSStructuredCloneWriter::startWrite(const Value &v)
             return out.writePair(SCTAG_DATE_OBJECT, 0) && out.writeDouble(d);
         } else if (obj->is<TypedArrayObject>()) {
             return writeTypedArray(obj);
+        } else if (obj->is<SharedArrayBufferObject>()) {
+            return writeSharedArrayBuffer(obj);
         } else if (obj->is<ArrayBufferObject>() && obj->as<ArrayBufferObject>().hasData()) {
             return writeArrayBuffer(obj);
         } else if (obj->is<JSObject>() || obj->is<ArrayObject>()) {
@@ -1013,6 +1156,40 @@ JSStructuredCloneWriter::transferOwnership()
     return true;
 }
 
+bool
+JSStructuredCloneWriter::writeOutOfLineData()
+{
+    if (outOfLineData.empty())
+        return true;
+
+    // The entries go at the end of the transfer map, after the transferables,
+    // so that the indexes written for them hold. The clone data is moved up to
+    // make room, but out-of-line data only exists in place of large payloads,
+    // so it is no bigger than the object graph.
+    size_t numTransferables = transferableObjects.length();
+    size_t numEntries = numTransferables + outOfLineData.length();
+    size_t start = numTransferables ? 2 + 3 * numTransferables : 0;
+    size_t nwords = (numTransferables ? 0 : 2) + 3 * outOfLineData.length();
+    if (!out.insertWords(start, nwords))
+        return false;
+
+    uint64_t *point = out.rawBuffer();
+    LittleEndian::writeUint64(point++, PairToUInt64(SCTAG_TRANSFER_MAP_HEADER, SCTAG_TM_UNREAD));
+    LittleEndian::writeUint64(point++, numEntries);
+
+    point = out.rawBuffer() + 2 + 3 * numTransferables;
+    for (size_t i = 0; i < outOfLineData.length(); i++) {
+        LittleEndian::writeUint64(point++, PairToUInt64(SCTAG_TRANSFER_MAP_ENTRY,
+                                                        SCTAG_TM_OUT_OF_LINE_DATA));
+        LittleEndian::writeUint64(point++, reinterpret_cast<uint64_t>(outOfLineData[i]));
+        LittleEndian::writeUint64(point++, 0);
+    }
+
+    // The buffer owns the data now.
+    outOfLineData.clear();
+    return true;
+}
+
 bool
 JSStructuredCloneWriter::write(const Value &v)
 {
@@ -1056,7 +1233,7 @@ JSStructuredCloneWriter::write(const Value &v)
     }
 
     memory.clear();
-    return transferOwnership();
+    return transferOwnership() && writeOutOfLineData();
 }
 
 bool
@@ -1098,13 +1275,26 @@ class Chars {
 } /* anonymous namespace */
 
 JSString *
-JSStructuredCloneReader::readString(uint32_t nchars)
+JSStructuredCloneReader::readString(uint32_t data)
 {
+    uint32_t nchars = data & ~SC_OUT_OF_LINE_STRING_FLAG;
     if (nchars > JSString::MAX_LENGTH) {
         JS_ReportErrorNumber(context(), js_GetErrorMessage, nullptr,
                              JSMSG_SC_BAD_SERIALIZED_DATA, "string length");
         return nullptr;
     }
+
+    if (data & SC_OUT_OF_LINE_STRING_FLAG) {
+        void *p;
+        if (!takeOutOfLineData(&p))
+            return nullptr;
+        jschar *chars = static_cast<jschar *>(p);
+        JSString *str = js_NewString<CanGC>(context(), chars, nchars);
+        if (!str)
+            js_free(chars);
+        return str;
+    }
+
     Chars chars(context());
     if (!chars.allocate(nchars) || !in.readChars(chars.get(), nchars))
         return nullptr;
@@ -1208,6 +1398,50 @@ JSStructuredCloneReader::readArrayBuffer(uint32_t nbytes, Value *vp)
     return in.readArray(buffer.dataPointer(), nbytes);
 }
 
+bool
+JSStructuredCloneReader::readOutOfLineArrayBuffer(uint32_t nbytes, Value *vp)
+{
+    void *contents;
+    if (!takeOutOfLineData(&contents))
+        return false;
+    JSObject *obj = JS_NewArrayBufferWithContents(context(), contents);
+    if (!obj) {
+        js_free(contents);
+        return false;
+    }
+    vp->setObject(*obj);
+    JS_ASSERT(obj->as<ArrayBufferObject>().byteLength() == nbytes);
+    return true;
+}
+
+bool
+JSStructuredCloneReader::readSharedArrayBuffer(uint32_t nbytes, Value *vp)
+{
+    uint64_t *pos = in.tell();
+    void *p;
+    if (!in.readPtr(&p))
+        return false;
+    if (!p) {
+        JS_ReportErrorNumber(context(), js_GetErrorMessage, nullptr,
+                             JSMSG_SC_BAD_SERIALIZED_DATA, "SharedArrayBuffer already read");
+        return false;
+    }
+
+    SharedArrayRawBuffer *raw = static_cast<SharedArrayRawBuffer *>(p);
+    JS_ASSERT(raw->byteLength() == nbytes);
+    JSObject *obj = SharedArrayBufferObject::New(context(), raw);
+    if (!obj)
+        return false;
+    vp->setObject(*obj);
+
+    /* The object has its own reference now; drop the clone buffer's. */
+    raw->dropReference();
+    in.seek(pos);
+    MOZ_ALWAYS_TRUE(in.replace(0));
+    in.seek(pos + 1);
+    return true;
+}
+
 static size_t
 bytesPerTypedArrayElement(uint32_t arrayType)
 {
@@ -1394,6 +1628,16 @@ JSStructuredCloneReader::startRead(Value *vp)
             return false;
         break;
 
+      case SCTAG_OUT_OF_LINE_ARRAY_BUFFER_OBJECT:
+        if (!readOutOfLineArrayBuffer(data, vp))
+            return false;
+        break;
+
+      case SCTAG_SHARED_ARRAY_BUFFER_OBJECT:
+        if (!readSharedArrayBuffer(data, vp))
+            return false;
+        break;
+
       case SCTAG_TYPED_ARRAY_OBJECT:
         // readTypedArray adds the array to allObjs
         uint64_t arrayType;
@@ -1482,13 +1726,16 @@ JSStructuredCloneReader::readTransferMap()
     if (!in.read(&numTransferables))
         return false;
 
+    transferEntries = in.tell();
+    numTransferEntries = numTransferables;
+
     for (uint64_t i = 0; i < numTransferables; i++) {
         uint64_t *pos = in.tell();
 
         if (!in.readPair(&tag, &data))
             return false;
         JS_ASSERT(tag == SCTAG_TRANSFER_MAP_ENTRY);
-        JS_ASSERT(data == SCTAG_TM_ALLOC_DATA);
+        JS_ASSERT(data == SCTAG_TM_ALLOC_DATA || data == SCTAG_TM_OUT_OF_LINE_DATA);
 
         void *content;
         if (!in.readPtr(&content))
@@ -1498,6 +1745,10 @@ JSStructuredCloneReader::readTransferMap()
         if (!in.read(&userdata))
             return false;
 
+        // Out-of-line data is taken over when the clone data refers to it.
+        if (data == SCTAG_TM_OUT_OF_LINE_DATA)
+            continue;
+
         RootedObject obj(context(), JS_NewArrayBufferWithContents(context(), content));
         if (!obj)
             return false;
@@ -1522,6 +1773,32 @@ JSStructuredCloneReader::readTransferMap()
     return true;
 }
 
+/*
+ * Read the index of an out-of-line transfer map entry and take over the data
+ * it owns.
+ */
+bool
+JSStructuredCloneReader::takeOutOfLineData(void **p)
+{
+    uint64_t index;
+    if (!in.read(&index))
+        return false;
+
+    if (index >= numTransferEntries ||
+        LittleEndian::readUint64(transferEntries + 3 * index) !=
+        PairToUInt64(SCTAG_TRANSFER_MAP_ENTRY, SCTAG_TM_OUT_OF_LINE_DATA))
+    {
+        JS_ReportErrorNumber(context(), js_GetErrorMessage, nullptr,
+                             JSMSG_SC_BAD_SERIALIZED_DATA, "out-of-line data");
+        return false;
+    }
+
+    uint64_t *entry = transferEntries + 3 * index;
+    *p = reinterpret_cast<void *>(LittleEndian::readUint64(entry + 1));
+    LittleEndian::writeUint64(entry, PairToUInt64(SCTAG_TRANSFER_MAP_ENTRY, SCTAG_TM_UNOWNED));
+    return true;
+}
+
 bool
 JSStructuredCloneReader::read(Value *vp)
 {
@@ -1576,7 +1853,8 @@ JS_ReadStructuredClone(JSContext *cx, uint64_t *buf, size_t nbytes,
 JS_PUBLIC_API(bool)
 JS_WriteStructuredClone(JSContext *cx, JS::HandleValue value, uint64_t **bufp, size_t *nbytesp,
                         const JSStructuredCloneCallbacks *optionalCallbacks,
-                        void *closure, JS::HandleValue transferable)
+                        void *closure, JS::HandleValue transferable,
+                        JS::StructuredCloneScope scope)
 {
     AssertHeapIsIdle(cx);
     CHECK_REQUEST(cx);
@@ -1586,7 +1864,8 @@ JS_WriteStructuredClone(JSContext *cx, JS::HandleValue value, uint64_t **bufp, s
         optionalCallbacks ?
         optionalCallbacks :
         cx->runtime()->structuredCloneCallbacks;
-    return WriteStructuredClone(cx, value, bufp, nbytesp, callbacks, closure, transferable);
+    return WriteStructuredClone(cx, value, bufp, nbytesp, callbacks, closure, transferable,
+                                scope);
 }
 
 JS_PUBLIC_API(bool)
@@ -1632,6 +1911,8 @@ JS_StructuredClone(JSContext *cx, JS::HandleValue value, JS::MutableHandleValue
         optionalCallbacks :
         cx->runtime()->structuredCloneCallbacks;
 
+    // The buffer is read once, right here, so large payloads need not be
+    // copied through it.
     JSAutoStructuredCloneBuffer buf;
     {
         // If we use Maybe<AutoCompartment> here, G++ can't tell that the
@@ -1639,11 +1920,17 @@ JS_StructuredClone(JSContext *cx, JS::HandleValue value, JS::MutableHandleValue
         // we get warnings about using uninitialized variables.
         if (value.isObject()) {
             AutoCompartment ac(cx, &value.toObject());
-            if (!buf.write(cx, value, callbacks, closure))
+            if (!buf.write(cx, value, JS::UndefinedHandleValue, callbacks, closure,
+                           JS::SameProcessCloneScope))
+            {
                 return false;
+            }
         } else {
-            if (!buf.write(cx, value, callbacks, closure))
+            if (!buf.write(cx, value, JS::UndefinedHandleValue, callbacks, closure,
+                           JS::SameProcessCloneScope))
+            {
                 return false;
+            }
         }
     }
 
@@ -1729,12 +2016,12 @@ bool
 JSAutoStructuredCloneBuffer::write(JSContext *cx, JS::HandleValue value,
                                    JS::HandleValue transferable,
                                    const JSStructuredCloneCallbacks *optionalCallbacks,
-                                   void *closure)
+                                   void *closure, JS::StructuredCloneScope scope)
 {
     clear();
     bool ok = !!JS_WriteStructuredClone(cx, value, &data_, &nbytes_,
                                         optionalCallbacks, closure,
-                                        transferable);
+                                        transferable, scope);
     if (!ok) {
         data_ = nullptr;
         nbytes_ = 0;
@@ -432,7 +432,7 @@ ThreadPool::lazyStartWorkers(JSContext *cx)
     // but workers_.length() is the number of *successfully
     // initialized* workers.
     for (uint32_t workerId = 0; workerId < numWorkers(); workerId++) {
-        ThreadPoolWorker *worker = cx->new_<ThreadPoolWorker>(workerId, this);
+        ThreadPoolWorker *worker = js_new<ThreadPoolWorker>(workerId, this);
         if (!worker || !workers_.append(worker)) {
             terminateWorkersAndReportOOM(cx);
             return false;
@@ -458,7 +458,8 @@ ThreadPool::terminateWorkersAndReportOOM(JSContext *cx)
 {
     terminateWorkers();
     MOZ_ASSERT(workers_.empty());
-    js_ReportOutOfMemory(cx);
+    if (cx)
+        js_ReportOutOfMemory(cx);
 }
 
 void
@@ -518,7 +519,7 @@ ThreadPool::executeJob(JSContext *cx, ParallelJob *job, uint16_t numSlices)
 
     // Create the main thread worker and off-main-thread workers if necessary.
     if (!mainWorker_) {
-        mainWorker_ = cx->new_<ThreadPoolMainWorker>(this);
+        mainWorker_ = js_new<ThreadPoolMainWorker>(this);
         if (!mainWorker_) {
             terminateWorkersAndReportOOM(cx);
             return TP_FATAL;
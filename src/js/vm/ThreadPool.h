@@ -146,7 +146,9 @@ class ThreadPool : public Monitor
     void terminate();
 
     // Execute the given ParallelJob using the main thread and any available worker.
-    // Blocks until the main thread has completed execution.
+    // Blocks until the main thread has completed execution. |cx| may be null
+    // when there is no context to report failure to start the workers to,
+    // as during GC.
     ParallelResult executeJob(JSContext *cx, ParallelJob *job, uint16_t numSlices);
 
     // Abort the current job.
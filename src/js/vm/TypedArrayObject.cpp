@@ -10,6 +10,7 @@
 #include "mozilla/FloatingPoint.h"
 #include "mozilla/PodOperations.h"
 
+#include <algorithm>
 #include <string.h>
 #ifndef XP_WIN
 # include <sys/mman.h>
@@ -35,6 +36,7 @@
 #include "vm/GlobalObject.h"
 #include "vm/Interpreter.h"
 #include "vm/NumericConversions.h"
+#include "vm/ParallelBulk.h"
 #include "vm/WrapperObject.h"
 
 #include "jsatominlines.h"
@@ -53,6 +55,7 @@ using namespace js::gc;
 using namespace js::types;
 
 using mozilla::IsNaN;
+using mozilla::IsNegative;
 using mozilla::PodCopy;
 using JS::CanonicalizeNaN;
 using JS::GenericNaN;
@@ -131,6 +134,13 @@ IsArrayBuffer(HandleValue v)
     return v.isObject() && v.toObject().hasClass(&ArrayBufferObject::class_);
 }
 
+/* As above, but also accepting SharedArrayBuffers, for creating views. */
+JS_ALWAYS_INLINE bool
+IsArrayBufferOrShared(HandleValue v)
+{
+    return v.isObject() && v.toObject().is<ArrayBufferObject>();
+}
+
 JS_ALWAYS_INLINE bool
 ArrayBufferObject::byteLengthGetterImpl(JSContext *cx, CallArgs args)
 {
@@ -608,6 +618,12 @@ ArrayBufferObject::addView(ArrayBufferViewObject *view)
     // This view should never have been associated with a buffer before
     JS_ASSERT(view->bufferLink() == UNSET_BUFFER_LINK);
 
+    // The header of a shared buffer is shared with other runtimes and cannot
+    // hold a view list. Such buffers are never neutered, so nothing needs to
+    // find their views.
+    if (isSharedArrayBuffer())
+        return;
+
     // Note that pre-barriers are not needed here because either the list was
     // previously empty, in which case no pointer is being overwritten, or the
     // list was nonempty and will be made weak during this call (and weak
@@ -673,7 +689,7 @@ ArrayBufferObject::createSlice(JSContext *cx, Handle<ArrayBufferObject*> arrayBu
 bool
 ArrayBufferObject::createDataViewForThisImpl(JSContext *cx, CallArgs args)
 {
-    JS_ASSERT(IsArrayBuffer(args.thisv()));
+    JS_ASSERT(IsArrayBufferOrShared(args.thisv()));
 
     /*
      * This method is only called for |DataView(alienBuf, ...)| which calls
@@ -698,7 +714,7 @@ bool
 ArrayBufferObject::createDataViewForThis(JSContext *cx, unsigned argc, Value *vp)
 {
     CallArgs args = CallArgsFromVp(argc, vp);
-    return CallNonGenericMethod<IsArrayBuffer, createDataViewForThisImpl>(cx, args);
+    return CallNonGenericMethod<IsArrayBufferOrShared, createDataViewForThisImpl>(cx, args);
 }
 
 bool
@@ -1407,6 +1423,77 @@ InitArrayBufferViewDataPointer(JSObject *obj, ArrayBufferObject *buffer, size_t
 
 namespace {
 
+/*
+ * Typed array sort's default comparator orders elements numerically, with -0
+ * before +0 and NaNs last.
+ */
+template<typename NativeType>
+struct TypedArrayElementLess
+{
+    bool operator()(NativeType a, NativeType b) const {
+        return a < b;
+    }
+};
+
+struct FloatingPointElementLess
+{
+    bool operator()(double a, double b) const {
+        if (IsNaN(b))
+            return !IsNaN(a);
+        if (a == 0 && b == 0)
+            return IsNegative(a) && !IsNegative(b);
+        return a < b;
+    }
+};
+
+template<>
+struct TypedArrayElementLess<float> : public FloatingPointElementLess {};
+
+template<>
+struct TypedArrayElementLess<double> : public FloatingPointElementLess {};
+
+/* The same order, as the comparator for MergeSort and ParallelMergeSort. */
+template<typename NativeType>
+struct TypedArrayElementLessOrEqual
+{
+    bool operator()(NativeType a, NativeType b, bool *lessOrEqualp) const {
+        *lessOrEqualp = !TypedArrayElementLess<NativeType>()(b, a);
+        return true;
+    }
+};
+
+/* Copy, converting, a range of elements between typed arrays. */
+template<typename DestType, typename SrcType>
+struct CopyElementsRange
+{
+    DestType *dest;
+    const SrcType *src;
+
+    CopyElementsRange(DestType *dest, const SrcType *src)
+      : dest(dest), src(src)
+    { }
+
+    void operator()(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            dest[i] = DestType(src[i]);
+    }
+};
+
+template<typename NativeType>
+struct CopyElementsRange<NativeType, NativeType>
+{
+    NativeType *dest;
+    const NativeType *src;
+
+    CopyElementsRange(NativeType *dest, const NativeType *src)
+      : dest(dest), src(src)
+    { }
+
+    void operator()(size_t begin, size_t end) {
+        js_memcpy(dest + begin, src + begin, (end - begin) * sizeof(NativeType));
+    }
+};
+
 template<typename NativeType>
 class TypedArrayObjectTemplate : public TypedArrayObject
 {
@@ -2028,6 +2115,43 @@ class TypedArrayObjectTemplate : public TypedArrayObject
                                     ThisTypedArrayObject::fun_move_impl>(cx, args);
     }
 
+    /* sort([comparefn]) */
+    static bool
+    fun_sort_impl(JSContext *cx, CallArgs args)
+    {
+        JS_ASSERT(IsThisClass(args.thisv()));
+
+        // Array.prototype.sort handles comparators, including specializing
+        // the common numeric ones.
+        if (args.hasDefined(0))
+            return array_sort(cx, args.length(), args.base());
+
+        Rooted<TypedArrayObject*> tarray(cx, &args.thisv().toObject().as<TypedArrayObject>());
+        NativeType *data = static_cast<NativeType*>(tarray->viewData());
+        uint32_t length = tarray->length();
+        args.rval().setObject(*tarray);
+
+        // Large arrays are merge sorted on the ThreadPool if it has workers.
+        if (ParallelBulkThreads(cx, length, ParallelSortMinLength) > 1) {
+            ScopedJSFreePtr<NativeType> scratch(cx->pod_malloc<NativeType>(length));
+            if (!scratch)
+                return false;
+            return ParallelMergeSort(cx, data, length, scratch.get(),
+                                     TypedArrayElementLessOrEqual<NativeType>());
+        }
+
+        std::sort(data, data + length, TypedArrayElementLess<NativeType>());
+        return true;
+    }
+
+    static bool
+    fun_sort(JSContext *cx, unsigned argc, Value *vp)
+    {
+        CallArgs args = CallArgsFromVp(argc, vp);
+        return CallNonGenericMethod<ThisTypedArrayObject::IsThisClass,
+                                    ThisTypedArrayObject::fun_sort_impl>(cx, args);
+    }
+
     /* set(array[, offset]) */
     static bool
     fun_set_impl(JSContext *cx, CallArgs args)
@@ -2378,68 +2502,43 @@ class TypedArrayObjectTemplate : public TypedArrayObject
             return copyFromWithOverlap(cx, thisTypedArray, tarray, offset);
 
         NativeType *dest = static_cast<NativeType*>(thisTypedArray->viewData()) + offset;
+        void *src = tarray->viewData();
+        uint32_t srclen = tarray->length();
 
-        if (tarray->type() == thisTypedArray->type()) {
-            js_memcpy(dest, tarray->viewData(), tarray->byteLength());
-            return true;
-        }
+        if (tarray->type() == thisTypedArray->type())
+            return copyElements(cx, dest, static_cast<NativeType*>(src), srclen);
 
-        unsigned srclen = tarray->length();
         switch (tarray->type()) {
-          case ScalarTypeRepresentation::TYPE_INT8: {
-            int8_t *src = static_cast<int8_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
+          case ScalarTypeRepresentation::TYPE_INT8:
+            return copyElements(cx, dest, static_cast<int8_t*>(src), srclen);
           case ScalarTypeRepresentation::TYPE_UINT8:
-          case ScalarTypeRepresentation::TYPE_UINT8_CLAMPED: {
-            uint8_t *src = static_cast<uint8_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_INT16: {
-            int16_t *src = static_cast<int16_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_UINT16: {
-            uint16_t *src = static_cast<uint16_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_INT32: {
-            int32_t *src = static_cast<int32_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_UINT32: {
-            uint32_t *src = static_cast<uint32_t*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_FLOAT32: {
-            float *src = static_cast<float*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
-          case ScalarTypeRepresentation::TYPE_FLOAT64: {
-            double *src = static_cast<double*>(tarray->viewData());
-            for (unsigned i = 0; i < srclen; ++i)
-                *dest++ = NativeType(*src++);
-            break;
-          }
+          case ScalarTypeRepresentation::TYPE_UINT8_CLAMPED:
+            return copyElements(cx, dest, static_cast<uint8_t*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_INT16:
+            return copyElements(cx, dest, static_cast<int16_t*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_UINT16:
+            return copyElements(cx, dest, static_cast<uint16_t*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_INT32:
+            return copyElements(cx, dest, static_cast<int32_t*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_UINT32:
+            return copyElements(cx, dest, static_cast<uint32_t*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_FLOAT32:
+            return copyElements(cx, dest, static_cast<float*>(src), srclen);
+          case ScalarTypeRepresentation::TYPE_FLOAT64:
+            return copyElements(cx, dest, static_cast<double*>(src), srclen);
           default:
             MOZ_ASSUME_UNREACHABLE("copyFrom with a TypedArrayObject of unknown type");
         }
+    }
 
-        return true;
+    // Copy elements between distinct buffers, on the ThreadPool for large
+    // copies.
+    template<typename SrcType>
+    static bool
+    copyElements(JSContext *cx, NativeType *dest, const SrcType *src, uint32_t count)
+    {
+        CopyElementsRange<NativeType, SrcType> op(dest, src);
+        return ParallelForEachRange(cx, count, ParallelCopyMinBytes / sizeof(NativeType), op);
     }
 
     static bool
@@ -2600,7 +2699,7 @@ bool
 ArrayBufferObject::createTypedArrayFromBufferImpl(JSContext *cx, CallArgs args)
 {
     typedef TypedArrayObjectTemplate<T> ArrayType;
-    JS_ASSERT(IsArrayBuffer(args.thisv()));
+    JS_ASSERT(IsArrayBufferOrShared(args.thisv()));
     JS_ASSERT(args.length() == 3);
 
     Rooted<JSObject*> buffer(cx, &args.thisv().toObject());
@@ -2623,7 +2722,7 @@ bool
 ArrayBufferObject::createTypedArrayFromBuffer(JSContext *cx, unsigned argc, Value *vp)
 {
     CallArgs args = CallArgsFromVp(argc, vp);
-    return CallNonGenericMethod<IsArrayBuffer, createTypedArrayFromBufferImpl<T> >(cx, args);
+    return CallNonGenericMethod<IsArrayBufferOrShared, createTypedArrayFromBufferImpl<T> >(cx, args);
 }
 
 void
@@ -3499,6 +3598,7 @@ const JSFunctionSpec _typedArray##Object::jsfuncs[] = {
     JS_SELF_HOSTED_FN("@@iterator", "ArrayValues", 0, 0),                          \
     JS_FN("subarray", _typedArray##Object::fun_subarray, 2, JSFUN_GENERIC_NATIVE), \
     JS_FN("set", _typedArray##Object::fun_set, 2, JSFUN_GENERIC_NATIVE),           \
+    JS_FN("sort", _typedArray##Object::fun_sort, 1, JSFUN_GENERIC_NATIVE),         \
     JS_FN("move", _typedArray##Object::fun_move, 3, JSFUN_GENERIC_NATIVE),         \
     JS_FS_END                                                                      \
 }
@@ -3508,6 +3608,7 @@ const JSFunctionSpec _typedArray##Object::jsfuncs[] = {
     JS_SELF_HOSTED_FN("@@iterator", "ArrayValues", 0, 0),                          \
     JS_FN("subarray", _typedArray##Object::fun_subarray, 2, JSFUN_GENERIC_NATIVE), \
     JS_FN("set", _typedArray##Object::fun_set, 2, JSFUN_GENERIC_NATIVE),           \
+    JS_FN("sort", _typedArray##Object::fun_sort, 1, JSFUN_GENERIC_NATIVE),         \
     JS_FS_END                                                                      \
 }
 #endif
@@ -3998,7 +4099,9 @@ js::IsTypedArrayConstructor(HandleValue v, uint32_t type)
 bool
 js::IsTypedArrayBuffer(HandleValue v)
 {
-    return v.isObject() && v.toObject().is<ArrayBufferObject>();
+    return v.isObject() &&
+           v.toObject().is<ArrayBufferObject>() &&
+           !v.toObject().as<ArrayBufferObject>().isSharedArrayBuffer();
 }
 
 /* JS Friend API */
@@ -4052,6 +4155,10 @@ JS_NeuterArrayBuffer(JSContext *cx, HandleObject obj)
     }
 
     Rooted<ArrayBufferObject*> buffer(cx, &obj->as<ArrayBufferObject>());
+    if (buffer->isSharedArrayBuffer()) {
+        JS_ReportError(cx, "SharedArrayBuffer objects cannot be neutered");
+        return false;
+    }
     if (!ArrayBufferObject::neuterViews(cx, buffer))
         return false;
     buffer->neuter(cx);
@@ -4112,7 +4219,7 @@ JS_StealArrayBufferContents(JSContext *cx, HandleObject objArg, void **contents,
     if (!obj)
         return false;
 
-    if (!obj->is<ArrayBufferObject>()) {
+    if (!obj->is<ArrayBufferObject>() || obj->as<ArrayBufferObject>().isSharedArrayBuffer()) {
         JS_ReportErrorNumber(cx, js_GetErrorMessage, nullptr, JSMSG_TYPED_ARRAY_BAD_ARGS);
         return false;
     }
@@ -24,6 +24,7 @@ typedef Vector<ArrayBufferObject *, 0, SystemAllocPolicy> ArrayBufferVector;
 //
 // - JSObject
 //   - ArrayBufferObject
+//     - SharedArrayBufferObject
 //   - ArrayBufferViewObject
 //     - DataViewObject
 //     - TypedArrayObject
@@ -216,7 +217,7 @@ class ArrayBufferObject : public JSObject
      * ArrayBuffer.prototype and neutered ArrayBuffers.
      */
     bool hasData() const {
-        return getClass() == &class_;
+        return getClass() == &class_ || isSharedArrayBuffer();
     }
 
     bool isAsmJSArrayBuffer() const {
@@ -225,11 +226,47 @@ class ArrayBufferObject : public JSObject
     bool isNeutered() const {
         return getElementsHeader()->isNeuteredBuffer();
     }
+    bool isSharedArrayBuffer() const {
+        return getElementsHeader()->isSharedArrayBuffer();
+    }
     static bool prepareForAsmJS(JSContext *cx, Handle<ArrayBufferObject*> buffer);
     static bool neuterAsmJSArrayBuffer(JSContext *cx, ArrayBufferObject &buffer);
     static void releaseAsmJSArrayBuffer(FreeOp *fop, JSObject *obj);
 };
 
+class SharedArrayRawBuffer;
+
+/*
+ * SharedArrayBufferObject
+ *
+ * An ArrayBufferObject whose memory is a SharedArrayRawBuffer, which may be
+ * referenced by SharedArrayBufferObjects in several runtimes at once. The
+ * elements header lives in the shared memory and is never written after the
+ * buffer is created, so shared buffers keep no list of their views; they can
+ * be neither neutered, transferred nor used as asm.js heaps.
+ */
+class SharedArrayBufferObject : public ArrayBufferObject
+{
+    static bool byteLengthGetterImpl(JSContext *cx, CallArgs args);
+
+  public:
+    static const Class class_;
+    static const Class protoClass;
+
+    static bool class_constructor(JSContext *cx, unsigned argc, Value *vp);
+    static bool byteLengthGetter(JSContext *cx, unsigned argc, Value *vp);
+
+    /* Create a new buffer of |nbytes| zeroed bytes. */
+    static JSObject *New(JSContext *cx, uint32_t nbytes);
+
+    /* Create an object for an existing buffer, taking a new reference to it. */
+    static JSObject *New(JSContext *cx, SharedArrayRawBuffer *buffer);
+
+    static void Finalize(FreeOp *fop, JSObject *obj);
+
+    SharedArrayRawBuffer *rawBufferObject() const;
+};
+
 /*
  * ArrayBufferViewObject
  *
@@ -416,6 +453,9 @@ IsTypedArrayConstructor(HandleValue v, uint32_t type);
 bool
 IsTypedArrayBuffer(HandleValue v);
 
+bool
+IsSharedArrayBuffer(HandleValue v);
+
 static inline unsigned
 TypedArrayShift(ArrayBufferView::ViewType viewType)
 {
@@ -589,6 +629,14 @@ bool ToDoubleForTypedArray(JSContext *cx, JS::HandleValue vp, double *d);
 
 } // namespace js
 
+template <>
+inline bool
+JSObject::is<js::ArrayBufferObject>() const
+{
+    return hasClass(&js::ArrayBufferObject::class_) ||
+           hasClass(&js::SharedArrayBufferObject::class_);
+}
+
 template <>
 inline bool
 JSObject::is<js::TypedArrayObject>() const
@@ -92,6 +92,14 @@ public:
     bool has16BitCodeMatchOnly() const { return m_matchOnly16.size(); }
     void set16BitCodeMatchOnly(MacroAssemblerCodeRef matchOnly) { m_matchOnly16 = matchOnly; }
 
+    // Offsets of the 16-bit entry points, which are null until compiled.
+    static size_t offsetOf16BitCode() {
+        return offsetof(YarrCodeBlock, m_ref16) + MacroAssemblerCodeRef::offsetOfCode();
+    }
+    static size_t offsetOf16BitCodeMatchOnly() {
+        return offsetof(YarrCodeBlock, m_matchOnly16) + MacroAssemblerCodeRef::offsetOfCode();
+    }
+
 #if YARR_8BIT_CHAR_SUPPORT
     MatchResult execute(const LChar* input, unsigned start, unsigned length, int* output)
     {